@@ -18,12 +18,14 @@
 #include "database/databasemanager.hpp"
 #include "declarations.hpp"
 #include "game/game.hpp"
+#include "game/highscore_ranking.hpp"
 #include "game/scheduling/dispatcher.hpp"
 #include "game/scheduling/events_scheduler.hpp"
 #include "game/zones/zone.hpp"
 #include "io/io_bosstiary.hpp"
 #include "io/iomarket.hpp"
 #include "io/ioprey.hpp"
+#include "lib/thread/task_graph.hpp"
 #include "lib/thread/thread_pool.hpp"
 #include "lua/creature/events.hpp"
 #include "lua/modules/modules.hpp"
@@ -81,6 +83,8 @@ int CanaryServer::run() {
 				loadModules();
 				setWorldType();
 				loadMaps();
+				IOMarket::getInstance().loadOffers();
+				g_highscoreRanking().load();
 
 				logger.info("Initializing gamestate...");
 				g_game().setGameState(GAME_STATE_INIT);
@@ -198,7 +202,8 @@ void CanaryServer::setWorldType() {
 
 void CanaryServer::loadMaps() const {
 	try {
-		g_game().loadMainMap(g_configManager().getString(MAP_NAME));
+		// Read along with the modules, see loadModules
+		g_game().loadMainMap();
 
 		// If "mapCustomEnabled" is true on config.lua, then load the custom map
 		if (g_configManager().getBoolean(TOGGLE_MAP_CUSTOM)) {
@@ -324,6 +329,11 @@ void CanaryServer::loadConfigLua() {
 
 	modulesLoadHelper(g_configManager().load(), g_configManager().getConfigFileLua());
 
+	g_dispatcher().setWorkStealing(g_configManager().getBoolean(TOGGLE_DISPATCHER_WORK_STEALING));
+	if (g_dispatcher().isWorkStealing()) {
+		logger.info("Dispatcher running parallel events with work stealing");
+	}
+
 #ifdef _WIN32
 	const std::string &defaultPriority = g_configManager().getString(DEFAULT_PRIORITY);
 	if (strcasecmp(defaultPriority.c_str(), "high") == 0) {
@@ -380,38 +390,73 @@ void CanaryServer::loadModules() {
 
 	logger.info("Loading modules and scripts...");
 
-	auto coreFolder = g_configManager().getString(CORE_DIRECTORY);
-	// Load appearances.dat first
-	modulesLoadHelper((g_game().loadAppearanceProtobuf(coreFolder + "/items/appearances.dat") == ERROR_NONE), "appearances.dat");
+	const auto coreFolder = g_configManager().getString(CORE_DIRECTORY);
+	const auto datapackFolder = g_configManager().getString(DATA_DIRECTORY);
 
-	// Load XML folder dependencies (order matters)
-	modulesLoadHelper(g_vocations().loadFromXml(), "XML/vocations.xml");
-	modulesLoadHelper(g_eventsScheduler().loadScheduleEventFromXml(), "XML/events.xml");
-	modulesLoadHelper(Outfits::getInstance().loadFromXml(), "XML/outfits.xml");
-	modulesLoadHelper(Familiars::getInstance().loadFromXml(), "XML/familiars.xml");
-	modulesLoadHelper(g_imbuements().loadFromXml(), "XML/imbuements.xml");
-	modulesLoadHelper(g_storages().loadFromXML(), "XML/storages.xml");
+	// Each module loads on the thread pool once those it needs are loaded, only the scripts are loaded by this
+	// thread, one after another as the Lua state is its own, while the rest loads around them
+	TaskGraph modules(g_threadPool());
+	const auto addModule = [this, &modules](const std::string &name, const std::function<bool()> &load, const std::vector<std::string> &dependencies = {}) {
+		modules.add(name, [this, name, load] { modulesLoadHelper(load(), name); }, dependencies);
+	};
+	std::vector<std::string> previousScripts;
+	const auto addScripts = [this, &modules, &previousScripts](const std::string &name, const std::function<bool()> &load) {
+		modules.addOnCaller(name, [this, name, load] { modulesLoadHelper(load(), name); }, previousScripts);
+		previousScripts = { name };
+	};
+
+	addModule("appearances.dat", [&coreFolder] { return g_game().loadAppearanceProtobuf(coreFolder + "/items/appearances.dat") == ERROR_NONE; });
+
+	// Load XML folder dependencies
+	addModule("XML/vocations.xml", [] { return g_vocations().loadFromXml(); });
+	addModule("XML/outfits.xml", [] { return Outfits::getInstance().loadFromXml(); }, { "appearances.dat" });
+	addModule("XML/familiars.xml", [] { return Familiars::getInstance().loadFromXml(); });
+	addModule("XML/imbuements.xml", [] { return g_imbuements().loadFromXml(); });
+	addModule("XML/storages.xml", [] { return g_storages().loadFromXML(); });
+
+	addModule("items.xml", [] { return Item::items.loadFromXml(); }, { "appearances.dat" });
+
+	// The tiles only need the item types, the houses, spawns and zones are loaded with the rest of the map
+	modules.add(
+		"world/" + g_configManager().getString(MAP_NAME) + ".otbm",
+		[] {
+			try {
+				g_game().readMainMap(g_configManager().getString(MAP_NAME));
+			} catch (const std::exception &err) {
+				throw FailedToInitializeCanary(err.what());
+			}
+		},
+		{ "items.xml" }
+	);
 
-	modulesLoadHelper(Item::items.loadFromXml(), "items.xml");
+	// The scripts may use anything loaded from XML
+	previousScripts = { "XML/vocations.xml", "XML/outfits.xml", "XML/familiars.xml", "XML/imbuements.xml", "XML/storages.xml", "items.xml" };
+	addScripts("XML/events.xml", [] { return g_eventsScheduler().loadScheduleEventFromXml(); });
 
-	const auto datapackFolder = g_configManager().getString(DATA_DIRECTORY);
-	logger.debug("Loading core scripts on folder: {}/", coreFolder);
 	// Load first core Lua libs
-	modulesLoadHelper((g_luaEnvironment().loadFile(coreFolder + "/core.lua", "core.lua") == 0), "core.lua");
-	modulesLoadHelper(g_scripts().loadScripts(coreFolder + "/scripts/lib", true, false), coreFolder + "/scripts/libs");
-	modulesLoadHelper(g_scripts().loadScripts(coreFolder + "/scripts", false, false), coreFolder + "/scripts");
-	modulesLoadHelper((g_npcs().load(true, false)), "npclib");
+	addScripts("core.lua", [&coreFolder] { return g_luaEnvironment().loadFile(coreFolder + "/core.lua", "core.lua") == 0; });
+	addScripts(coreFolder + "/scripts/libs", [&coreFolder] { return g_scripts().loadScripts(coreFolder + "/scripts/lib", true, false); });
+	addScripts(coreFolder + "/scripts", [&coreFolder] { return g_scripts().loadScripts(coreFolder + "/scripts", false, false); });
+	addScripts("npclib", [] { return g_npcs().load(true, false); });
 
-	modulesLoadHelper(g_events().loadFromXml(), "events/events.xml");
-	modulesLoadHelper(g_modules().loadFromXml(), "modules/modules.xml");
+	addScripts("events/events.xml", [] { return g_events().loadFromXml(); });
+	addScripts("modules/modules.xml", [] { return g_modules().loadFromXml(); });
 
-	logger.debug("Loading datapack scripts on folder: {}/", datapackFolder);
-	modulesLoadHelper(g_scripts().loadScripts(datapackFolder + "/scripts/lib", true, false), datapackFolder + "/scripts/libs");
+	addScripts(datapackFolder + "/scripts/libs", [&datapackFolder] { return g_scripts().loadScripts(datapackFolder + "/scripts/lib", true, false); });
 	// Load scripts
-	modulesLoadHelper(g_scripts().loadScripts(datapackFolder + "/scripts", false, false), datapackFolder + "/scripts");
+	addScripts(datapackFolder + "/scripts", [&datapackFolder] { return g_scripts().loadScripts(datapackFolder + "/scripts", false, false); });
 	// Load monsters
-	modulesLoadHelper(g_scripts().loadScripts(datapackFolder + "/monster", false, false), datapackFolder + "/monster");
-	modulesLoadHelper((g_npcs().load(false, true)), "npc");
+	addScripts(datapackFolder + "/monster", [&datapackFolder] { return g_scripts().loadScripts(datapackFolder + "/monster", false, false); });
+	addScripts("npc", [] { return g_npcs().load(false, true); });
+
+	// The scripts may make zones before the map task starts, they must not refresh them against the tiles being read
+	g_game().map.startReading();
+	modules.run();
+
+	logger.info("Loaded modules in {:.0f} milliseconds", modules.getDuration());
+	for (const auto &timing : modules.getTimings()) {
+		logger.info("  {:<40} {:>8.0f} ms, started at {:.0f} ms{}", timing.name, timing.duration, timing.start, timing.onCaller ? "" : " (thread pool)");
+	}
 
 	g_game().loadBoostedCreature();
 	g_ioBosstiary().loadBoostedBoss();
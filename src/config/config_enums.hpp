@@ -176,8 +176,10 @@ enum ConfigKey_t : uint16_t {
 	MYSQL_DB_BACKUP,
 	MYSQL_HOST,
 	MYSQL_PASS,
+	MYSQL_POOL_SIZE,
 	MYSQL_SOCK,
 	MYSQL_USER,
+	NETWORK_IO_THREADS,
 	OLD_PROTOCOL,
 	ONE_PLAYER_ON_ACCOUNT,
 	ONLY_INVITED_CAN_MOVE_HOUSE_ITEMS,
@@ -196,6 +198,7 @@ enum ConfigKey_t : uint16_t {
 	PARTY_LIST_MAX_DISTANCE,
 	PARTY_SHARE_LOOT_BOOSTS_DIMINISHING_FACTOR,
 	PARTY_SHARE_LOOT_BOOSTS,
+	PATHFINDING_MAX_NODES,
 	PREMIUM_DEPOT_LIMIT,
 	PREY_BONUS_REROLL_PRICE,
 	PREY_BONUS_TIME,
@@ -292,6 +295,7 @@ enum ConfigKey_t : uint16_t {
 	TIBIADROME_CONCOCTION_TICK_TYPE,
 	TOGGLE_ATTACK_SPEED_ONFIST,
 	TOGGLE_CHAIN_SYSTEM,
+	TOGGLE_DISPATCHER_WORK_STEALING,
 	TOGGLE_DOWNLOAD_MAP,
 	TOGGLE_FREE_QUEST,
 	TOGGLE_GOLD_POUCH_ALLOW_ANYTHING,
@@ -302,7 +306,10 @@ enum ConfigKey_t : uint16_t {
 	TOGGLE_IMBUEMENT_SHRINE_STORAGE,
 	TOGGLE_MAINTAIN_MODE,
 	TOGGLE_MAP_CUSTOM,
+	TOGGLE_MAP_SNAPSHOT,
 	TOGGLE_MOUNT_IN_PZ,
+	TOGGLE_PATHFINDING_BATCH,
+	TOGGLE_PATHFINDING_FLOW_FIELD,
 	TOGGLE_RECEIVE_REWARD,
 	TOGGLE_SAVE_ASYNC,
 	TOGGLE_SAVE_INTERVAL_CLEAN_MAP,
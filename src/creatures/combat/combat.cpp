@@ -28,9 +28,58 @@
 #include "lua/callbacks/events_callbacks.hpp"
 #include "lua/creature/events.hpp"
 #include "map/spectators.hpp"
+#include "server/network/protocol/protocolgame.hpp"
 #include "creatures/players/player.hpp"
 #include "creatures/players/components/wheel/wheel_definitions.hpp"
 
+namespace {
+	// Buffers of an area combat, kept between casts so that a warmed up server does not allocate for them
+	struct AreaScratch {
+		std::vector<std::shared_ptr<Tile>> tiles;
+		std::vector<bool> allowedTiles;
+		std::vector<std::shared_ptr<Creature>> targets;
+		// Index in tiles of each target
+		std::vector<size_t> targetTiles;
+
+		void clear() {
+			tiles.clear();
+			allowedTiles.clear();
+			targets.clear();
+			targetTiles.clear();
+		}
+	};
+
+	// Lua callbacks can cast while an area combat is running, each nesting level gets its own buffers
+	thread_local std::vector<std::unique_ptr<AreaScratch>> areaScratchFrames;
+	thread_local size_t areaScratchDepth = 0;
+
+	class AreaScratchLease {
+	public:
+		AreaScratchLease() {
+			if (areaScratchDepth == areaScratchFrames.size()) {
+				areaScratchFrames.emplace_back(std::make_unique<AreaScratch>());
+			}
+			scratch = areaScratchFrames[areaScratchDepth++].get();
+		}
+
+		~AreaScratchLease() {
+			// Drops the references to the tiles and creatures, the capacity is kept
+			scratch->clear();
+			--areaScratchDepth;
+		}
+
+		AreaScratchLease(const AreaScratchLease &) = delete;
+		AreaScratchLease &operator=(const AreaScratchLease &) = delete;
+
+		AreaScratch* operator->() const {
+			return scratch;
+		}
+
+	private:
+		AreaScratch* scratch;
+	};
+}
+
 int32_t Combat::getLevelFormula(const std::shared_ptr<Player> &player, const std::shared_ptr<Spell> &wheelSpell, const CombatDamage &damage) const {
 	if (!player) {
 		return 0;
@@ -886,7 +935,7 @@ void Combat::CombatNullFunc(const std::shared_ptr<Creature> &caster, const std::
 	CombatDispelFunc(caster, target, params, nullptr);
 }
 
-void Combat::combatTileEffects(const CreatureVector &spectators, const std::shared_ptr<Creature> &caster, const std::shared_ptr<Tile> &tile, const CombatParams &params) {
+void Combat::combatTileEffects(const Spectators &spectators, const std::shared_ptr<Creature> &caster, const std::shared_ptr<Tile> &tile, const CombatParams &params) {
 	if (params.itemId != 0) {
 		uint16_t itemId = params.itemId;
 		switch (itemId) {
@@ -1212,7 +1261,10 @@ bool Combat::doCombat(const std::shared_ptr<Creature> &caster, const Position &p
 }
 
 void Combat::CombatFunc(const std::shared_ptr<Creature> &caster, const Position &origin, const Position &toPos, const std::unique_ptr<AreaCombat> &area, const CombatParams &params, const CombatFunction &func, CombatDamage* data) {
-	std::vector<std::shared_ptr<Tile>> tileList;
+	// Every target's health, effect and damage text reaches a spectator as one packet
+	ProtocolGame::CombatBatch packetBatch;
+	AreaScratchLease scratch;
+	auto &tileList = scratch->tiles;
 
 	const std::shared_ptr<Player> &casterPlayer = caster ? caster->getPlayer() : nullptr;
 
@@ -1224,10 +1276,14 @@ void Combat::CombatFunc(const std::shared_ptr<Creature> &caster, const Position
 
 	uint32_t maxX = 0;
 	uint32_t maxY = 0;
-	std::vector<std::shared_ptr<Creature>> affectedTargets;
+	auto &affectedTargets = scratch->targets;
+	auto &targetTiles = scratch->targetTiles;
+	auto &allowedTiles = scratch->allowedTiles;
+	allowedTiles.resize(tileList.size());
 
 	// Calculate the max viewable range and affected creatures
-	for (const auto &tile : tileList) {
+	for (size_t tileIndex = 0; tileIndex < tileList.size(); ++tileIndex) {
+		const auto &tile = tileList[tileIndex];
 		// If the caster is a player and the world is no pvp, we need to check if there are more than one player in the tile and skip the combat
 		if (casterPlayer && g_game().getWorldType() == WORLD_TYPE_NO_PVP && tile->getPosition() == origin) {
 			if (!casterPlayer->isFirstOnStack()) {
@@ -1248,14 +1304,15 @@ void Combat::CombatFunc(const std::shared_ptr<Creature> &caster, const Position
 			maxY = diff;
 		}
 
-		if (canDoCombat(caster, tile, params.aggressive) != RETURNVALUE_NOERROR) {
+		allowedTiles[tileIndex] = canDoCombat(caster, tile, params.aggressive) == RETURNVALUE_NOERROR;
+		if (!allowedTiles[tileIndex]) {
 			continue;
 		}
 
-		if (CreatureVector* creatures = tile->getCreatures()) {
+		// The targets are taken once, before any damage, so that Lua callbacks adding or removing creatures from the tiles do not affect the iteration
+		if (const CreatureVector* creatures = tile->getCreatures()) {
 			const auto &topCreature = tile->getTopCreature();
-			CreatureVector creaturesCopy = *creatures;
-			for (const auto &creature : creaturesCopy) {
+			for (const auto &creature : *creatures) {
 				if (params.targetCasterOrTopMost) {
 					if (caster && caster->getTile() == tile) {
 						if (creature != caster) {
@@ -1268,6 +1325,10 @@ void Combat::CombatFunc(const std::shared_ptr<Creature> &caster, const Position
 
 				if (!params.aggressive || (caster != creature && Combat::canDoCombat(caster, creature, params.aggressive) == RETURNVALUE_NOERROR)) {
 					affectedTargets.push_back(creature);
+					targetTiles.push_back(tileIndex);
+					if (params.targetCasterOrTopMost) {
+						break;
+					}
 				}
 			}
 		}
@@ -1291,53 +1352,40 @@ void Combat::CombatFunc(const std::shared_ptr<Creature> &caster, const Position
 	// The apply extensions can't modifify the damage value, so we need to create a copy of the damage value
 	auto extensionsDamage = tmpDamage;
 	applyExtensions(caster, affectedTargets, extensionsDamage, params);
-	for (const auto &tile : tileList) {
-		if (canDoCombat(caster, tile, params.aggressive) != RETURNVALUE_NOERROR) {
+
+	size_t targetIndex = 0;
+	for (size_t tileIndex = 0; tileIndex < tileList.size(); ++tileIndex) {
+		if (!allowedTiles[tileIndex]) {
 			continue;
 		}
 
-		if (CreatureVector* creatures = tile->getCreatures()) {
-			const auto &topCreature = tile->getTopCreature();
-			// A copy of the tile's creature list is made because modifications to this vector, such as adding or removing creatures through a Lua callback, may occur during the iteration within the for loop.
-			CreatureVector creaturesCopy = *creatures;
-			for (const auto &creature : creaturesCopy) {
-				if (params.targetCasterOrTopMost) {
-					if (caster && caster->getTile() == tile) {
-						if (creature != caster) {
-							continue;
-						}
-					} else if (creature != topCreature) {
-						continue;
-					}
-				}
-
-				if (!params.aggressive || (caster != creature && Combat::canDoCombat(caster, creature, params.aggressive) == RETURNVALUE_NOERROR)) {
-					// Wheel of destiny update beam mastery damage
-					if (casterPlayer) {
-						casterPlayer->wheel().updateBeamMasteryDamage(tmpDamage, beamAffectedTotal, beamAffectedCurrent);
-					}
+		for (; targetIndex < affectedTargets.size() && targetTiles[targetIndex] == tileIndex; ++targetIndex) {
+			const auto &creature = affectedTargets[targetIndex];
+			// An earlier target's death or a callback may have changed things since the targets were taken
+			if (creature->isRemoved() || (params.aggressive && Combat::canDoCombat(caster, creature, params.aggressive) != RETURNVALUE_NOERROR)) {
+				continue;
+			}
 
-					if (func) {
-						auto creatureDamage = creature->getCombatDamage();
-						if (!creatureDamage.isEmpty()) {
-							func(caster, creature, params, &creatureDamage);
-							// Reset the creature's combat damage
-							creature->setCombatDamage(CombatDamage());
-						} else {
-							func(caster, creature, params, &tmpDamage);
-						}
-					}
-					if (params.targetCallback) {
-						params.targetCallback->onTargetCombat(caster, creature);
-					}
+			// Wheel of destiny update beam mastery damage
+			if (casterPlayer) {
+				casterPlayer->wheel().updateBeamMasteryDamage(tmpDamage, beamAffectedTotal, beamAffectedCurrent);
+			}
 
-					if (params.targetCasterOrTopMost) {
-						break;
-					}
+			if (func) {
+				auto creatureDamage = creature->getCombatDamage();
+				if (!creatureDamage.isEmpty()) {
+					func(caster, creature, params, &creatureDamage);
+					// Reset the creature's combat damage
+					creature->setCombatDamage(CombatDamage());
+				} else {
+					func(caster, creature, params, &tmpDamage);
 				}
 			}
+			if (params.targetCallback) {
+				params.targetCallback->onTargetCombat(caster, creature);
+			}
 		}
-		combatTileEffects(spectators.data(), caster, tile, params);
+		combatTileEffects(spectators, caster, tileList[tileIndex], params);
 	}
 
 	postCombatEffects(caster, origin, toPos, params);
@@ -1496,7 +1544,7 @@ void Combat::doCombatDefault(const std::shared_ptr<Creature> &caster, const std:
 		auto spectators = Spectators().find<Player>(target->getPosition(), true);
 
 		CombatNullFunc(caster, target, params, nullptr);
-		combatTileEffects(spectators.data(), caster, target->getTile(), params);
+		combatTileEffects(spectators, caster, target->getTile(), params);
 
 		if (params.targetCallback) {
 			params.targetCallback->onTargetCombat(caster, target);
@@ -1924,6 +1972,7 @@ bool ChainPickerCallback::onChainCombat(const std::shared_ptr<Creature> &creatur
 
 void AreaCombat::clear() {
 	std::ranges::fill(areas, nullptr);
+	updateOffsets();
 }
 
 std::unique_ptr<AreaCombat> AreaCombat::clone() const {
@@ -1937,6 +1986,7 @@ AreaCombat::AreaCombat(const AreaCombat &rhs) {
 			areas[i] = area->clone();
 		}
 	}
+	offsets = rhs.offsets;
 }
 
 AreaCombat::~AreaCombat() {
@@ -1944,40 +1994,50 @@ AreaCombat::~AreaCombat() {
 }
 
 void AreaCombat::getList(const Position &centerPos, const Position &targetPos, std::vector<std::shared_ptr<Tile>> &list, const Direction dir) const {
-	auto casterPos = getNextPosition(dir, targetPos);
+	const auto casterPos = getNextPosition(dir, targetPos);
+	const auto &areaOffsets = getOffsets(centerPos, targetPos);
+	list.reserve(list.size() + areaOffsets.size());
+
+	for (const auto &offset : areaOffsets) {
+		const Position tilePos(static_cast<uint16_t>(targetPos.x + offset.x), static_cast<uint16_t>(targetPos.y + offset.y), targetPos.z);
+		auto tile = g_game().map.getTile(tilePos);
+		if (tile && tile->hasFlag(TILESTATE_FLOORCHANGE)) {
+			continue;
+		}
 
-	const std::unique_ptr<MatrixArea> &area = getArea(centerPos, targetPos);
-	if (!area) {
-		return;
+		if (g_game().isSightClear(casterPos, tilePos, true)) {
+			list.emplace_back(tile ? std::move(tile) : g_game().map.getOrCreateTile(tilePos));
+		}
 	}
+}
 
-	uint32_t centerY;
-	uint32_t centerX;
-	area->getCenter(centerY, centerX);
+const std::vector<AreaOffset> &AreaCombat::getOffsets(const Position &centerPos, const Position &targetPos) const {
+	return offsets[getAreaDirection(centerPos, targetPos)];
+}
 
-	const uint32_t rows = area->getRows();
-	const uint32_t cols = area->getCols();
+void AreaCombat::updateOffsets() {
+	for (uint_fast8_t i = 0; i <= Direction::DIRECTION_LAST; ++i) {
+		auto &areaOffsets = offsets[i];
+		areaOffsets.clear();
 
-	list.reserve(rows * cols);
-	Position tmpPos(targetPos.x - centerX, targetPos.y - centerY, targetPos.z);
+		const auto &area = areas[i];
+		if (!area) {
+			continue;
+		}
 
-	for (uint32_t y = 0; y < rows; ++y) {
-		for (uint32_t x = 0; x < cols; ++x) {
-			if (area->getValue(y, x) != 0) {
-				std::shared_ptr<Tile> tile = g_game().map.getTile(tmpPos);
-				if (tile && tile->hasFlag(TILESTATE_FLOORCHANGE)) {
-					++tmpPos.x;
-					continue;
-				}
+		uint32_t centerY;
+		uint32_t centerX;
+		area->getCenter(centerY, centerX);
 
-				if (g_game().isSightClear(casterPos, tmpPos, true)) {
-					list.emplace_back(g_game().map.getOrCreateTile(tmpPos));
+		// Row by row, the order the targets have always been hit in
+		for (uint32_t y = 0, rows = area->getRows(); y < rows; ++y) {
+			for (uint32_t x = 0, cols = area->getCols(); x < cols; ++x) {
+				if (area->getValue(y, x)) {
+					areaOffsets.push_back({ static_cast<int32_t>(x) - static_cast<int32_t>(centerX), static_cast<int32_t>(y) - static_cast<int32_t>(centerY) });
 				}
 			}
-			++tmpPos.x;
 		}
-		++tmpPos.y;
-		tmpPos.x -= cols;
+		areaOffsets.shrink_to_fit();
 	}
 }
 
@@ -2062,7 +2122,7 @@ void AreaCombat::copyArea(const std::unique_ptr<MatrixArea> &input, const std::u
 	}
 }
 
-const std::unique_ptr<MatrixArea> &AreaCombat::getArea(const Position &centerPos, const Position &targetPos) const {
+Direction AreaCombat::getAreaDirection(const Position &centerPos, const Position &targetPos) const {
 	int32_t dx = Position::getOffsetX(targetPos, centerPos);
 	int32_t dy = Position::getOffsetY(targetPos, centerPos);
 
@@ -2089,7 +2149,7 @@ const std::unique_ptr<MatrixArea> &AreaCombat::getArea(const Position &centerPos
 		}
 	}
 
-	return areas[dir];
+	return dir;
 }
 
 std::unique_ptr<MatrixArea> AreaCombat::createArea(const std::list<uint32_t> &list, uint32_t rows) {
@@ -2142,6 +2202,7 @@ void AreaCombat::setupArea(const std::list<uint32_t> &list, const uint32_t rows)
 	areas[DIRECTION_SOUTH] = std::move(southArea);
 	areas[DIRECTION_EAST] = std::move(eastArea);
 	areas[DIRECTION_WEST] = std::move(westArea);
+	updateOffsets();
 }
 
 void AreaCombat::setupArea(int32_t length, int32_t spread) {
@@ -2240,6 +2301,7 @@ void AreaCombat::setupExtArea(const std::list<uint32_t> &list, uint32_t rows) {
 	areas[DIRECTION_SOUTHWEST] = std::move(swArea);
 	areas[DIRECTION_NORTHEAST] = std::move(neArea);
 	areas[DIRECTION_SOUTHEAST] = std::move(seArea);
+	updateOffsets();
 }
 
 //**********************************************************//
@@ -2293,7 +2355,7 @@ void MagicField::onStepInField(const std::shared_ptr<Creature> &creature) {
 	}
 }
 
-void Combat::applyExtensions(const std::shared_ptr<Creature> &caster, const std::vector<std::shared_ptr<Creature>> targets, CombatDamage &damage, const CombatParams &params) {
+void Combat::applyExtensions(const std::shared_ptr<Creature> &caster, const std::vector<std::shared_ptr<Creature>> &targets, CombatDamage &damage, const CombatParams &params) {
 	metrics::method_latency measure(__METRICS_METHOD_NAME__);
 	if (damage.extension || !caster || damage.primary.type == COMBAT_HEALING) {
 		return;
@@ -19,6 +19,7 @@ class Player;
 class MatrixArea;
 class Weapon;
 class Tile;
+class Spectators;
 
 using CreatureVector = std::vector<std::shared_ptr<Creature>>;
 
@@ -145,6 +146,12 @@ private:
 	bool** data_;
 };
 
+// A cell of an area, relative to the position the area is cast on
+struct AreaOffset {
+	int32_t x;
+	int32_t y;
+};
+
 class AreaCombat {
 public:
 	AreaCombat() = default;
@@ -156,6 +163,7 @@ public:
 	AreaCombat &operator=(const AreaCombat &) = delete;
 
 	void getList(const Position &centerPos, const Position &targetPos, std::vector<std::shared_ptr<Tile>> &list, const Direction dir) const;
+	const std::vector<AreaOffset> &getOffsets(const Position &centerPos, const Position &targetPos) const;
 
 	void setupArea(const std::list<uint32_t> &list, uint32_t rows);
 	void setupArea(int32_t length, int32_t spread);
@@ -169,9 +177,12 @@ private:
 	std::unique_ptr<MatrixArea> createArea(const std::list<uint32_t> &list, uint32_t rows);
 	void copyArea(const std::unique_ptr<MatrixArea> &input, const std::unique_ptr<MatrixArea> &output, MatrixOperation_t op) const;
 
-	const std::unique_ptr<MatrixArea> &getArea(const Position &centerPos, const Position &targetPos) const;
+	Direction getAreaDirection(const Position &centerPos, const Position &targetPos) const;
+	void updateOffsets();
 
 	std::array<std::unique_ptr<MatrixArea>, Direction::DIRECTION_LAST + 1> areas {};
+	// The cells of each area, so that casting it does not scan the matrix
+	std::array<std::vector<AreaOffset>, Direction::DIRECTION_LAST + 1> offsets {};
 	bool hasExtArea = false;
 };
 
@@ -183,7 +194,7 @@ public:
 	Combat(const Combat &) = delete;
 	Combat &operator=(const Combat &) = delete;
 
-	static void applyExtensions(const std::shared_ptr<Creature> &caster, const std::vector<std::shared_ptr<Creature>> targets, CombatDamage &damage, const CombatParams &params);
+	static void applyExtensions(const std::shared_ptr<Creature> &caster, const std::vector<std::shared_ptr<Creature>> &targets, CombatDamage &damage, const CombatParams &params);
 
 	static void doCombatHealth(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &target, CombatDamage &damage, const CombatParams &params);
 	static void doCombatHealth(const std::shared_ptr<Creature> &caster, const Position &position, const std::unique_ptr<AreaCombat> &area, CombatDamage &damage, const CombatParams &params);
@@ -280,7 +291,7 @@ private:
 	static void CombatDispelFunc(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &target, const CombatParams &params, CombatDamage* data);
 	static void CombatNullFunc(const std::shared_ptr<Creature> &caster, const std::shared_ptr<Creature> &target, const CombatParams &params, CombatDamage* data);
 
-	static void combatTileEffects(const CreatureVector &spectators, const std::shared_ptr<Creature> &caster, const std::shared_ptr<Tile> &tile, const CombatParams &params);
+	static void combatTileEffects(const Spectators &spectators, const std::shared_ptr<Creature> &caster, const std::shared_ptr<Tile> &tile, const CombatParams &params);
 
 	/**
 	 * @brief Calculate the level formula for combat.
@@ -408,6 +408,27 @@ int32_t Condition::getTicks() const {
 	return ticks;
 }
 
+int64_t Condition::getNextTickTime() const {
+	if (ticks == -1) {
+		return std::numeric_limits<int64_t>::max();
+	}
+
+	if (tickSound != SoundEffect_t::SILENCE) {
+		return lastTickTime + EVENT_CREATURE_THINK_INTERVAL;
+	}
+
+	// Only the end of the condition to look for
+	return endTime == std::numeric_limits<int64_t>::max() ? endTime : endTime + 1;
+}
+
+int64_t Condition::getLastTickTime() const {
+	return lastTickTime;
+}
+
+void Condition::setLastTickTime(int64_t time) {
+	lastTickTime = time;
+}
+
 bool Condition::updateCondition(const std::shared_ptr<Condition> &addCondition) {
 	if (conditionType != addCondition->getType()) {
 		return false;
@@ -1293,6 +1314,10 @@ void ConditionRegeneration::serialize(PropWriteStream &propWriteStream) {
 	propWriteStream.write<uint32_t>(manaGain);
 }
 
+int64_t ConditionRegeneration::getNextTickTime() const {
+	return lastTickTime + EVENT_CREATURE_THINK_INTERVAL;
+}
+
 bool ConditionRegeneration::executeCondition(const std::shared_ptr<Creature> &creature, int32_t interval) {
 	internalHealthTicks += interval;
 	internalManaTicks += interval;
@@ -1525,6 +1550,10 @@ void ConditionSoul::serialize(PropWriteStream &propWriteStream) {
 	propWriteStream.write<uint32_t>(soulTicks);
 }
 
+int64_t ConditionSoul::getNextTickTime() const {
+	return lastTickTime + EVENT_CREATURE_THINK_INTERVAL;
+}
+
 bool ConditionSoul::executeCondition(const std::shared_ptr<Creature> &creature, int32_t interval) {
 	internalSoulTicks += interval;
 
@@ -1785,6 +1814,21 @@ bool ConditionDamage::executeCondition(const std::shared_ptr<Creature> &creature
 	return Condition::executeCondition(creature, interval);
 }
 
+int64_t ConditionDamage::getNextTickTime() const {
+	// Field conditions check every think whether the creature still stands on the field
+	if (field) {
+		return lastTickTime + EVENT_CREATURE_THINK_INTERVAL;
+	}
+
+	const auto nextTickTime = Condition::getNextTickTime();
+	if (periodDamage != 0) {
+		return std::min(nextTickTime, lastTickTime + tickInterval - periodDamageTick);
+	} else if (!damageList.empty()) {
+		return std::min(nextTickTime, lastTickTime + damageList.front().timeLeft);
+	}
+	return nextTickTime;
+}
+
 bool ConditionDamage::getNextDamage(int32_t &damage) {
 	if (periodDamage != 0) {
 		damage = periodDamage;
@@ -2198,6 +2242,10 @@ bool ConditionFeared::startCondition(std::shared_ptr<Creature> creature) {
 	return Condition::startCondition(creature);
 }
 
+int64_t ConditionFeared::getNextTickTime() const {
+	return lastTickTime + EVENT_CREATURE_THINK_INTERVAL;
+}
+
 bool ConditionFeared::executeCondition(const std::shared_ptr<Creature> &creature, int32_t interval) {
 	Position currentPos = creature->getPosition();
 	std::vector<Direction> listDir;
@@ -2544,6 +2592,10 @@ bool ConditionLight::startCondition(std::shared_ptr<Creature> creature) {
 	return true;
 }
 
+int64_t ConditionLight::getNextTickTime() const {
+	return std::min(Condition::getNextTickTime(), lastTickTime + static_cast<int64_t>(lightChangeInterval) - internalLightTicks);
+}
+
 bool ConditionLight::executeCondition(const std::shared_ptr<Creature> &creature, int32_t interval) {
 	internalLightTicks += interval;
 
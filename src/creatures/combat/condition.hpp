@@ -40,6 +40,11 @@ public:
 	int32_t getTicks() const;
 	void setTicks(int32_t newTicks);
 
+	// The condition is not executed again before this time, max if it never needs to be
+	virtual int64_t getNextTickTime() const;
+	int64_t getLastTickTime() const;
+	void setLastTickTime(int64_t time);
+
 	static std::shared_ptr<Condition> createCondition(ConditionId_t id, ConditionType_t type, int32_t ticks, int32_t param = 0, bool buff = false, uint32_t subId = 0, bool isPersistent = false);
 	static std::shared_ptr<Condition> createCondition(PropStream &propStream);
 
@@ -57,6 +62,7 @@ public:
 protected:
 	uint8_t drainBodyStage = 0;
 	int64_t endTime {};
+	int64_t lastTickTime {};
 	uint32_t subId {};
 	int32_t ticks {};
 	ConditionType_t conditionType {};
@@ -159,6 +165,7 @@ public:
 	void endCondition(std::shared_ptr<Creature> creature) override;
 	void addCondition(std::shared_ptr<Creature> creature, std::shared_ptr<Condition> addCondition) override;
 	bool executeCondition(const std::shared_ptr<Creature> &creature, int32_t interval) override;
+	int64_t getNextTickTime() const override;
 
 	bool setParam(ConditionParam_t param, int32_t value) override;
 
@@ -208,6 +215,7 @@ public:
 
 	void addCondition(std::shared_ptr<Creature> creature, std::shared_ptr<Condition> addCondition) override;
 	bool executeCondition(const std::shared_ptr<Creature> &creature, int32_t interval) override;
+	int64_t getNextTickTime() const override;
 
 	bool setParam(ConditionParam_t param, int32_t value) override;
 
@@ -242,6 +250,7 @@ public:
 
 	bool startCondition(std::shared_ptr<Creature> creature) override;
 	bool executeCondition(const std::shared_ptr<Creature> &creature, int32_t interval) override;
+	int64_t getNextTickTime() const override;
 	void endCondition(std::shared_ptr<Creature> creature) override;
 	void addCondition(std::shared_ptr<Creature> creature, std::shared_ptr<Condition> condition) override;
 	std::unordered_set<PlayerIcon> getIcons() const override;
@@ -288,6 +297,7 @@ public:
 
 	bool startCondition(std::shared_ptr<Creature> creature) override;
 	bool executeCondition(const std::shared_ptr<Creature> &creature, int32_t interval) override;
+	int64_t getNextTickTime() const override;
 	void endCondition(std::shared_ptr<Creature> creature) override;
 	void addCondition(std::shared_ptr<Creature> creature, std::shared_ptr<Condition> condition) override;
 	std::unordered_set<PlayerIcon> getIcons() const override;
@@ -379,6 +389,7 @@ public:
 
 	bool startCondition(std::shared_ptr<Creature> creature) override;
 	bool executeCondition(const std::shared_ptr<Creature> &creature, int32_t interval) override;
+	int64_t getNextTickTime() const override;
 	void endCondition(std::shared_ptr<Creature> creature) override;
 	void addCondition(std::shared_ptr<Creature> creature, std::shared_ptr<Condition> addCondition) override;
 
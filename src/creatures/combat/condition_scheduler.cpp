@@ -0,0 +1,92 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "creatures/combat/condition_scheduler.hpp"
+
+#include "lib/di/container.hpp"
+
+ConditionScheduler &ConditionScheduler::getInstance() {
+	return inject<ConditionScheduler>();
+}
+
+void ConditionScheduler::schedule(uint32_t creatureId, int64_t dueTime) {
+	auto [it, inserted] = scheduled.try_emplace(creatureId, dueTime);
+	if (!inserted) {
+		if (it->second == dueTime) {
+			return;
+		}
+		it->second = dueTime;
+	}
+
+	// Times already past go in the next bucket to be drained
+	auto tick = dueTime / BUCKET_INTERVAL;
+	if (cursor >= 0 && tick < cursor) {
+		tick = cursor;
+	}
+
+	auto &bucket = buckets[static_cast<size_t>(tick) % BUCKETS];
+	bucket.creatureIds.emplace_back(creatureId);
+	bucket.dueTimes.emplace_back(dueTime);
+}
+
+void ConditionScheduler::cancel(uint32_t creatureId) {
+	scheduled.erase(creatureId);
+}
+
+void ConditionScheduler::takeDue(int64_t now, std::vector<uint32_t> &due) {
+	const auto tick = now / BUCKET_INTERVAL;
+	if (cursor < 0) {
+		// Anything scheduled before the first drain sits in the bucket of its own time
+		cursor = tick - static_cast<int64_t>(BUCKETS) + 1;
+	}
+
+	// A whole turn of the wheel visits every bucket, no need to go around again after a long stall
+	cursor = std::max(cursor, tick - static_cast<int64_t>(BUCKETS) + 1);
+	for (; cursor < tick; ++cursor) {
+		drain(buckets[static_cast<size_t>(cursor) % BUCKETS], now, due);
+	}
+	// The current bucket is drained on every call until its time is over
+	drain(buckets[static_cast<size_t>(tick) % BUCKETS], now, due);
+}
+
+void ConditionScheduler::drain(Bucket &bucket, int64_t now, std::vector<uint32_t> &due) {
+	size_t kept = 0;
+	for (size_t i = 0, size = bucket.creatureIds.size(); i < size; ++i) {
+		const auto creatureId = bucket.creatureIds[i];
+		const auto dueTime = bucket.dueTimes[i];
+
+		const auto it = scheduled.find(creatureId);
+		if (it == scheduled.end() || it->second != dueTime) {
+			// Cancelled or scheduled again
+			continue;
+		}
+
+		if (dueTime > now) {
+			// Due on a later turn of the wheel
+			bucket.creatureIds[kept] = creatureId;
+			bucket.dueTimes[kept] = dueTime;
+			++kept;
+			continue;
+		}
+
+		scheduled.erase(it);
+		due.emplace_back(creatureId);
+	}
+
+	bucket.creatureIds.resize(kept);
+	bucket.dueTimes.resize(kept);
+}
+
+bool ConditionScheduler::isScheduled(uint32_t creatureId) const {
+	return scheduled.contains(creatureId);
+}
+
+size_t ConditionScheduler::size() const {
+	return scheduled.size();
+}
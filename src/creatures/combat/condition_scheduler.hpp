@@ -0,0 +1,67 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#ifndef USE_PRECOMPILED_HEADERS
+	#include <parallel_hashmap/phmap.h>
+	#include <array>
+	#include <cstdint>
+	#include <vector>
+#endif
+
+/**
+ * Tells which creatures have a condition due, so that only those run their conditions.
+ *
+ * Creatures are kept in a timing wheel of BUCKET_INTERVAL buckets by the time their earliest condition
+ * is due. A bucket keeps the creature ids and due times side by side, so that draining it only walks two
+ * arrays. Scheduling a creature again replaces its previous time, the old entry is skipped when its
+ * bucket is drained.
+ */
+class ConditionScheduler {
+public:
+	static constexpr int64_t BUCKET_INTERVAL = 100;
+	// A little over a minute and a half, later times wait in their bucket for the wheel to come around
+	static constexpr size_t BUCKETS = 1024;
+
+	ConditionScheduler() = default;
+
+	// Singleton - ensures we don't accidentally copy it.
+	ConditionScheduler(const ConditionScheduler &) = delete;
+	void operator=(const ConditionScheduler &) = delete;
+
+	static ConditionScheduler &getInstance();
+
+	void schedule(uint32_t creatureId, int64_t dueTime);
+	void cancel(uint32_t creatureId);
+
+	/**
+	 * @brief Takes the creatures due by now out of the wheel, bucket by bucket.
+	 */
+	void takeDue(int64_t now, std::vector<uint32_t> &due);
+
+	bool isScheduled(uint32_t creatureId) const;
+	size_t size() const;
+
+private:
+	struct Bucket {
+		std::vector<uint32_t> creatureIds;
+		std::vector<int64_t> dueTimes;
+	};
+
+	void drain(Bucket &bucket, int64_t now, std::vector<uint32_t> &due);
+
+	std::array<Bucket, BUCKETS> buckets;
+	// The time each creature is currently scheduled at
+	phmap::flat_hash_map<uint32_t, int64_t> scheduled;
+	// The oldest bucket not fully drained, in BUCKET_INTERVAL since the epoch
+	int64_t cursor = -1;
+};
+
+constexpr auto g_conditionScheduler = ConditionScheduler::getInstance;
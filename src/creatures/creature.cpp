@@ -11,6 +11,7 @@
 
 #include "config/configmanager.hpp"
 #include "creatures/combat/condition.hpp"
+#include "creatures/combat/condition_scheduler.hpp"
 #include "creatures/combat/combat.hpp"
 #include "creatures/monsters/monster.hpp"
 #include "creatures/players/grouping/party.hpp"
@@ -20,6 +21,7 @@
 #include "lib/metrics/metrics.hpp"
 #include "lua/creature/creatureevent.hpp"
 #include "map/spectators.hpp"
+#include "map/utils/pathfinding_service.hpp"
 #include "creatures/players/player.hpp"
 #include "server/network/protocol/protocolgame.hpp"
 
@@ -1002,7 +1004,21 @@ void Creature::goToFollowCreature() {
 		}
 	}
 
+	// Melee chasers share the flow field of their target, only falling back to the search when it has no free step
+	if (listDir.empty() && monster && !monster->getMaster() && !fpp.keepDistance && fpp.maxTargetDist <= 1 && g_configManager().getBoolean(TOGGLE_PATHFINDING_FLOW_FIELD)) {
+		if (const auto &flowField = g_game().map.getFlowField(followCreature); flowField->contains(getPosition())) {
+			hasFollowPath = flowField->getPath(getPosition(), static_cast<uint16_t>(std::max<int32_t>(fpp.maxTargetDist, 1)), listDir, [this](const Position &pos) {
+				return g_game().map.canWalkTo(getCreature(), pos) != nullptr;
+			});
+		}
+	}
+
 	if (listDir.empty()) {
+		if (monster && PathfindingService::isEnabled()) {
+			g_pathfinding().addRequest(getCreature(), followCreature, fpp, executeOnFollow);
+			return;
+		}
+
 		hasFollowPath = getPathTo(followCreature->getPosition(), listDir, fpp);
 	}
 
@@ -1013,6 +1029,15 @@ void Creature::goToFollowCreature() {
 	}
 }
 
+void Creature::applyFollowPath(const std::vector<Direction> &listDir, bool found, bool executeOnFollow) {
+	hasFollowPath = found;
+	startAutoWalk(listDir);
+
+	if (executeOnFollow) {
+		onFollowCreatureComplete(getFollowCreature());
+	}
+}
+
 bool Creature::canFollowMaster() const {
 	const auto &master = getMaster();
 	if (!master) {
@@ -1273,12 +1298,15 @@ bool Creature::addCondition(const std::shared_ptr<Condition> &condition, bool at
 	const auto &prevCond = getCondition(condition->getType(), condition->getId(), condition->getSubId());
 	if (prevCond) {
 		prevCond->addCondition(getCreature(), condition);
+		scheduleConditions();
 		return true;
 	}
 
 	if (condition->startCondition(getCreature())) {
+		condition->setLastTickTime(OTSYS_TIME());
 		conditions.emplace_back(condition);
 		onAddCondition(condition->getType());
+		scheduleConditions();
 		return true;
 	}
 
@@ -1425,11 +1453,29 @@ std::vector<std::shared_ptr<Condition>> Creature::getConditionsByType(ConditionT
 	return conditionsVec;
 }
 
-void Creature::executeConditions(uint32_t interval) {
+int64_t Creature::getNextConditionTick(const std::shared_ptr<Condition> &condition) const {
+	const auto thinkTime = condition->getLastTickTime() + EVENT_CREATURE_THINK_INTERVAL;
+	// Players save and show their condition ticks, which have to stay current
+	if (getPlayer()) {
+		return thinkTime;
+	}
+	// Conditions never ran more often than the creatures think
+	return std::max(condition->getNextTickTime(), thinkTime);
+}
+
+void Creature::executeConditions() {
 	metrics::method_latency measure(__METRICS_METHOD_NAME__);
+	const auto now = OTSYS_TIME();
 	auto it = conditions.begin(), end = conditions.end();
 	while (it != end) {
 		std::shared_ptr<Condition> condition = *it;
+		if (getNextConditionTick(condition) > now) {
+			++it;
+			continue;
+		}
+
+		const auto interval = static_cast<int32_t>(now - condition->getLastTickTime());
+		condition->setLastTickTime(now);
 		if (!condition->executeCondition(getCreature(), interval)) {
 			ConditionType_t type = condition->getType();
 
@@ -1442,6 +1488,38 @@ void Creature::executeConditions(uint32_t interval) {
 			++it;
 		}
 	}
+
+	scheduleConditions();
+}
+
+void Creature::scheduleConditions() {
+	if (g_dispatcher().context().isAsync()) {
+		g_dispatcher().addEvent([creature = getCreature()] { creature->scheduleConditions(); }, __FUNCTION__);
+		return;
+	}
+
+	if (getID() == 0 || isRemoved()) {
+		return;
+	}
+
+	auto nextTick = std::numeric_limits<int64_t>::max();
+	for (const auto &condition : conditions) {
+		nextTick = std::min(nextTick, getNextConditionTick(condition));
+	}
+
+	if (nextTick == std::numeric_limits<int64_t>::max()) {
+		g_conditionScheduler().cancel(getID());
+	} else {
+		g_conditionScheduler().schedule(getID(), nextTick);
+	}
+}
+
+void Creature::pauseConditions() {
+	const auto now = OTSYS_TIME();
+	for (const auto &condition : conditions) {
+		condition->setLastTickTime(now);
+	}
+	scheduleConditions();
 }
 
 bool Creature::hasCondition(ConditionType_t type, uint32_t subId /* = 0*/) const {
@@ -325,6 +325,8 @@ public:
 	}
 	void goToFollowCreature_async(std::function<void()> &&onComplete = nullptr);
 	virtual void goToFollowCreature();
+	// Applies a follow path solved by the PathfindingService
+	void applyFollowPath(const std::vector<Direction> &listDir, bool found, bool executeOnFollow);
 
 	// walk events
 	virtual void onWalk(Direction &dir);
@@ -424,7 +426,11 @@ public:
 	std::shared_ptr<Condition> getCondition(ConditionType_t type, ConditionId_t conditionId, uint32_t subId = 0) const;
 	std::vector<std::shared_ptr<Condition>> getCleansableConditions() const;
 	std::vector<std::shared_ptr<Condition>> getConditionsByType(ConditionType_t type) const;
-	void executeConditions(uint32_t interval);
+	// Runs the conditions whose tick is due and schedules the creature for the next one
+	void executeConditions();
+	void scheduleConditions();
+	// The conditions of a creature that is not being checked wait, as if no time went by
+	void pauseConditions();
 	bool hasCondition(ConditionType_t type, uint32_t subId = 0) const;
 
 	virtual bool isImmune([[maybe_unused]] CombatType_t type) const {
@@ -872,6 +878,7 @@ private:
 	bool isLostSummon();
 	void sendAsyncTasks();
 	void handleLostSummon(bool teleportSummons);
+	int64_t getNextConditionTick(const std::shared_ptr<Condition> &condition) const;
 
 	std::vector<std::function<void()>> asyncTasks;
 
@@ -1469,6 +1469,8 @@ struct FindPathParams {
 	int32_t maxSearchDist = 0;
 	int32_t minTargetDist = -1;
 	int32_t maxTargetDist = -1;
+	// Node budget of the search, 0 uses the configured one
+	int32_t maxNodes = 0;
 };
 
 struct RecentDeathEntry {
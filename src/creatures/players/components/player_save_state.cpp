@@ -0,0 +1,76 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "creatures/players/components/player_save_state.hpp"
+
+#include "lib/metrics/metrics.hpp"
+
+PlayerSaveState::Digest PlayerSaveState::digest(const std::vector<std::string> &rows) {
+	// FNV-1a over the rows, each one terminated so that moving bytes between rows changes the hash
+	constexpr uint64_t prime = 0x100000001b3;
+	Digest result { 0xcbf29ce484222325, rows.size(), 0 };
+	for (const auto &row : rows) {
+		for (const auto c : row) {
+			result.hash = (result.hash ^ static_cast<uint8_t>(c)) * prime;
+		}
+		result.hash = (result.hash ^ 0xff) * prime;
+		result.bytes += row.size();
+	}
+	return result;
+}
+
+void PlayerSaveState::begin() {
+	pending.fill(std::nullopt);
+	skipped.fill(false);
+	skippedRows = 0;
+	skippedBytes = 0;
+}
+
+bool PlayerSaveState::stage(PlayerSaveSection_t section, const std::vector<std::string> &rows) {
+	const auto index = static_cast<size_t>(section);
+	auto current = digest(rows);
+	const auto &last = committed[index];
+	if (last && last->digest == current && last->rows == rows) {
+		skipped[index] = true;
+		skippedRows += current.rows;
+		skippedBytes += current.bytes;
+		return false;
+	}
+
+	pending[index] = Written { current, rows };
+	return true;
+}
+
+void PlayerSaveState::commit() {
+	for (size_t index = 0; index < SECTIONS; ++index) {
+		if (pending[index]) {
+			committed[index] = std::move(pending[index]);
+			continue;
+		}
+
+		if (skipped[index]) {
+			const auto section = std::string(magic_enum::enum_name(static_cast<PlayerSaveSection_t>(index)));
+			g_metrics().addCounter("player_save_skipped_rows", static_cast<double>(committed[index]->digest.rows), { { "section", section } });
+			g_metrics().addCounter("player_save_skipped_bytes", static_cast<double>(committed[index]->digest.bytes), { { "section", section } });
+		}
+	}
+	pending.fill(std::nullopt);
+	skipped.fill(false);
+}
+
+void PlayerSaveState::discard() {
+	// A failed save may have written part of its sections, so they are written again in full by the next one
+	for (size_t index = 0; index < SECTIONS; ++index) {
+		if (pending[index]) {
+			committed[index].reset();
+		}
+	}
+	pending.fill(std::nullopt);
+	skipped.fill(false);
+}
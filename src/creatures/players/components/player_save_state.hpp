@@ -0,0 +1,105 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#ifndef USE_PRECOMPILED_HEADERS
+	#include <array>
+	#include <cstdint>
+	#include <optional>
+	#include <string>
+	#include <vector>
+#endif
+
+/**
+ * @brief Player data written by its own queries on each save.
+ */
+enum class PlayerSaveSection_t : uint8_t {
+	Stash,
+	Spells,
+	Kills,
+	Bestiary,
+	Items,
+	DepotItems,
+	RewardItems,
+	Inbox,
+	Prey,
+	TaskHunting,
+	ForgeHistory,
+	Bosstiary,
+
+	Last = Bosstiary
+};
+
+/**
+ * @brief Tracks which sections of a player changed since they were last written to the database.
+ *
+ * Each section is serialized into its rows as usual, the rows are then compared with the ones written by the
+ * last successful save, and the section is only rewritten when they differ. The digest is checked first,
+ * the rows themselves are only compared when it matches, so a hash collision never skips a change.
+ * The digests of a save are only kept once the whole save succeeded, the sections staged by a failed one are written again.
+ *
+ * Access is not thread-safe; use only while holding the player lock, as SaveManager does.
+ */
+class PlayerSaveState {
+public:
+	struct Digest {
+		uint64_t hash = 0;
+		size_t rows = 0;
+		size_t bytes = 0;
+
+		bool operator==(const Digest &other) const = default;
+	};
+
+	static constexpr size_t SECTIONS = static_cast<size_t>(PlayerSaveSection_t::Last) + 1;
+
+	static Digest digest(const std::vector<std::string> &rows);
+
+	/**
+	 * @brief Starts a new save, dropping anything staged by a previous one that was not committed.
+	 */
+	void begin();
+
+	/**
+	 * @brief Compares the rows of a section with the ones written by the last committed save.
+	 * @return true if the section changed and must be written.
+	 */
+	bool stage(PlayerSaveSection_t section, const std::vector<std::string> &rows);
+
+	/**
+	 * @brief Keeps the rows of the sections written by the current save and reports what it skipped.
+	 */
+	void commit();
+
+	/**
+	 * @brief Forgets the sections staged by the current save, they are written again by the next one.
+	 */
+	void discard();
+
+	size_t getSkippedRows() const {
+		return skippedRows;
+	}
+
+	size_t getSkippedBytes() const {
+		return skippedBytes;
+	}
+
+private:
+	struct Written {
+		Digest digest;
+		std::vector<std::string> rows;
+	};
+
+	std::array<std::optional<Written>, SECTIONS> committed;
+	std::array<std::optional<Written>, SECTIONS> pending;
+	std::array<bool, SECTIONS> skipped {};
+
+	size_t skippedRows = 0;
+	size_t skippedBytes = 0;
+};
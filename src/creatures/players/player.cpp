@@ -32,6 +32,7 @@
 #include "enums/player_icons.hpp"
 #include "enums/player_cyclopedia.hpp"
 #include "game/game.hpp"
+#include "game/highscore_ranking.hpp"
 #include "game/modal_window/modal_window.hpp"
 #include "game/scheduling/dispatcher.hpp"
 
@@ -143,7 +144,7 @@ bool Player::isPushable() {
 }
 
 std::shared_ptr<Task> Player::createPlayerTask(uint32_t delay, std::function<void(void)> f, const std::string &context) {
-	return std::make_shared<Task>(std::move(f), context, delay);
+	return Task::create(std::move(f), context, delay);
 }
 
 uint32_t Player::playerFirstID = 0x10000000;
@@ -1129,6 +1130,7 @@ void Player::addSkillAdvance(skills_t skill, uint64_t count) {
 		}
 
 		g_creatureEvents().playerAdvance(static_self_cast<Player>(), skill, (skills[skill].level - 1), skills[skill].level);
+		g_highscoreRanking().update(*this);
 
 		sendUpdateSkills = true;
 		currReqTries = nextReqTries;
@@ -3262,6 +3264,7 @@ void Player::addManaSpent(uint64_t amount) {
 
 		g_creatureEvents().playerAdvance(static_self_cast<Player>(), SKILL_MAGLEVEL, magLevel - 1, magLevel);
 		sendTakeScreenshot(SCREENSHOT_TYPE_SKILLUP);
+		g_highscoreRanking().update(*this);
 
 		sendUpdateStats = true;
 		currReqMana = nextReqMana;
@@ -3421,6 +3424,7 @@ void Player::addExperience(const std::shared_ptr<Creature> &target, uint64_t exp
 	}
 	sendStats();
 	sendExperienceTracker(rawExp, exp);
+	g_highscoreRanking().update(*this);
 }
 
 void Player::removeExperience(uint64_t exp, bool sendText /* = false*/) {
@@ -3506,6 +3510,7 @@ void Player::removeExperience(uint64_t exp, bool sendText /* = false*/) {
 	}
 	sendStats();
 	sendExperienceTracker(0, -static_cast<int64_t>(exp));
+	g_highscoreRanking().update(*this);
 }
 
 double_t Player::getPercentLevel(uint64_t count, uint64_t nextLevelCount) {
@@ -7580,6 +7585,10 @@ bool Player::addOfflineTrainingTries(skills_t skill, uint64_t tries) {
 		sendStats();
 	}
 
+	if (newSkillValue != oldSkillValue) {
+		g_highscoreRanking().update(*this);
+	}
+
 	std::string message = fmt::format(
 		"Your {} skill changed from level {} (with {:.2f}% progress towards level {}) to level {} (with {:.2f}% progress towards level {})",
 		ucwords(getSkillName(skill)),
@@ -11140,6 +11149,11 @@ const PlayerStorage &Player::storage() const {
 	return m_storage;
 }
 
+// Save state interface
+PlayerSaveState &Player::saveState() {
+	return m_saveState;
+}
+
 void Player::sendLootMessage(const std::string &message) const {
 	const auto &party = getParty();
 	if (!party) {
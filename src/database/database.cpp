@@ -14,9 +14,19 @@
 #include "lib/metrics/metrics.hpp"
 #include "utils/tools.hpp"
 
+thread_local size_t Database::threadSlot = std::numeric_limits<size_t>::max();
+thread_local Database::Connection* Database::transactionConnection = nullptr;
+thread_local size_t Database::transactionDepth = 0;
+thread_local bool Database::transactionFailed = false;
+thread_local uint64_t Database::lastInsertId = 0;
+
 Database::~Database() {
-	if (handle != nullptr) {
-		mysql_close(handle);
+	for (const auto &connection : connections) {
+		// Statements must be closed while their connection is still open
+		connection->statements.clear();
+		if (connection->handle != nullptr) {
+			mysql_close(connection->handle);
+		}
 	}
 }
 
@@ -25,15 +35,43 @@ Database &Database::getInstance() {
 }
 
 bool Database::connect() {
-	return connect(&g_configManager().getString(MYSQL_HOST), &g_configManager().getString(MYSQL_USER), &g_configManager().getString(MYSQL_PASS), &g_configManager().getString(MYSQL_DB), g_configManager().getNumber(SQL_PORT), &g_configManager().getString(MYSQL_SOCK));
+	const auto poolSize = static_cast<size_t>(std::max<int32_t>(1, g_configManager().getNumber(MYSQL_POOL_SIZE)));
+	return connect(&g_configManager().getString(MYSQL_HOST), &g_configManager().getString(MYSQL_USER), &g_configManager().getString(MYSQL_PASS), &g_configManager().getString(MYSQL_DB), g_configManager().getNumber(SQL_PORT), &g_configManager().getString(MYSQL_SOCK), poolSize);
 }
 
-bool Database::connect(const std::string* host, const std::string* user, const std::string* password, const std::string* database, uint32_t port, const std::string* sock) {
+bool Database::connect(const std::string* host, const std::string* user, const std::string* password, const std::string* database, uint32_t port, const std::string* sock, size_t poolSize) {
+	if (!connections.empty()) {
+		g_logger().error("[{}] Database already connected", __FUNCTION__);
+		return false;
+	}
+
+	poolSize = std::clamp<size_t>(poolSize, 1, MAX_POOL_SIZE);
+	for (size_t i = 0; i < poolSize; ++i) {
+		auto connection = std::make_unique<Connection>();
+		connection->handle = openConnection(host, user, password, database, port, sock);
+		if (!connection->handle) {
+			return false;
+		}
+		connections.emplace_back(std::move(connection));
+	}
+
+	DBResult_ptr result = storeQuery("SHOW VARIABLES LIKE 'max_allowed_packet'");
+	if (result) {
+		maxPacketSize = result->getNumber<uint64_t>("Value");
+	}
+
+	if (poolSize > 1) {
+		g_logger().info("Opened {} MySQL connections", poolSize);
+	}
+	return true;
+}
+
+MYSQL* Database::openConnection(const std::string* host, const std::string* user, const std::string* password, const std::string* database, uint32_t port, const std::string* sock) {
 	// connection handle initialization
-	handle = mysql_init(nullptr);
+	MYSQL* handle = mysql_init(nullptr);
 	if (!handle) {
 		g_logger().error("Failed to initialize MySQL connection handle.");
-		return false;
+		return nullptr;
 	}
 
 	if (host->empty() || user->empty() || password->empty() || database->empty() || port <= 0) {
@@ -51,14 +89,10 @@ bool Database::connect(const std::string* host, const std::string* user, const s
 	// connects to database
 	if (!mysql_real_connect(handle, host->c_str(), user->c_str(), password->c_str(), database->c_str(), port, sock->c_str(), 0)) {
 		g_logger().error("MySQL Error Message: {}", mysql_error(handle));
-		return false;
-	}
-
-	DBResult_ptr result = storeQuery("SHOW VARIABLES LIKE 'max_allowed_packet'");
-	if (result) {
-		maxPacketSize = result->getNumber<uint64_t>("Value");
+		mysql_close(handle);
+		return nullptr;
 	}
-	return true;
+	return handle;
 }
 
 void Database::createDatabaseBackup(bool compress) const {
@@ -158,53 +192,115 @@ void Database::createDatabaseBackup(bool compress) const {
 	}
 }
 
+Database::ConnectionLock Database::acquireConnection(std::string_view scope) const {
+	// Inside a transaction, its own connection is already locked by this thread
+	if (transactionConnection) {
+		return { *transactionConnection, std::unique_lock(transactionConnection->lock) };
+	}
+
+	if (threadSlot == std::numeric_limits<size_t>::max()) {
+		threadSlot = nextThreadSlot.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	metrics::database_pool_latency measure(scope);
+	auto &own = *connections[threadSlot % connections.size()];
+	std::unique_lock lock(own.lock, std::try_to_lock);
+	if (lock.owns_lock()) {
+		return { own, std::move(lock) };
+	}
+
+	// Busy with a transaction or another thread sharing it, any idle connection does the job
+	for (const auto &connection : connections) {
+		std::unique_lock borrowed(connection->lock, std::try_to_lock);
+		if (borrowed.owns_lock()) {
+			return { *connection, std::move(borrowed) };
+		}
+	}
+
+	lock.lock();
+	measure.stop();
+	g_metrics().addCounter("database_pool_waits", 1, { { "scope", std::string(scope) } });
+	return { own, std::move(lock) };
+}
+
 bool Database::beginTransaction() {
-	if (!executeQuery("BEGIN")) {
+	if (connections.empty()) {
+		g_logger().error("Database not initialized!");
+		return false;
+	}
+
+	// Nested transactions join the outer one, which is committed or rolled back as a whole
+	if (transactionDepth > 0) {
+		++transactionDepth;
+		return true;
+	}
+
+	auto [connection, lock] = acquireConnection("transaction");
+	if (!retryQuery(connection.handle, "BEGIN", 10)) {
 		return false;
 	}
-	metrics::lock_latency measureLock("database");
-	databaseLock.lock();
-	measureLock.stop();
 
+	// Kept locked until commit or rollback, pinning the connection to this thread
+	lock.release();
+	transactionConnection = &connection;
+	transactionDepth = 1;
+	transactionFailed = false;
 	return true;
 }
 
 bool Database::rollback() {
-	if (!handle) {
-		g_logger().error("Database not initialized!");
+	if (!transactionConnection) {
+		g_logger().error("[{}] No transaction started", __FUNCTION__);
 		return false;
 	}
 
-	if (mysql_rollback(handle) != 0) {
-		g_logger().error("Message: {}", mysql_error(handle));
-		databaseLock.unlock();
-		return false;
+	if (--transactionDepth > 0) {
+		transactionFailed = true;
+		return true;
 	}
 
-	databaseLock.unlock();
-	return true;
+	auto* connection = std::exchange(transactionConnection, nullptr);
+	const bool success = mysql_rollback(connection->handle) == 0;
+	if (!success) {
+		g_logger().error("Message: {}", mysql_error(connection->handle));
+	}
+	connection->lock.unlock();
+	return success;
 }
 
 bool Database::commit() {
-	if (!handle) {
-		g_logger().error("Database not initialized!");
+	if (!transactionConnection) {
+		g_logger().error("[{}] No transaction started", __FUNCTION__);
 		return false;
 	}
-	if (mysql_commit(handle) != 0) {
-		g_logger().error("Message: {}", mysql_error(handle));
-		databaseLock.unlock();
+
+	if (transactionDepth > 1) {
+		--transactionDepth;
+		return true;
+	}
+
+	// A nested transaction failed, nothing of the outer one can be kept
+	if (transactionFailed) {
+		g_logger().error("[{}] Rolling back transaction, a nested transaction failed", __FUNCTION__);
+		rollback();
 		return false;
 	}
 
-	databaseLock.unlock();
-	return true;
+	transactionDepth = 0;
+	auto* connection = std::exchange(transactionConnection, nullptr);
+	const bool success = mysql_commit(connection->handle) == 0;
+	if (!success) {
+		g_logger().error("Message: {}", mysql_error(connection->handle));
+	}
+	connection->lock.unlock();
+	return success;
 }
 
 bool Database::isRecoverableError(unsigned int error) {
 	return error == CR_SERVER_LOST || error == CR_SERVER_GONE_ERROR || error == CR_CONN_HOST_ERROR || error == 1053 /*ER_SERVER_SHUTDOWN*/ || error == CR_CONNECTION_ERROR;
 }
 
-bool Database::retryQuery(std::string_view query, int retries) {
+bool Database::retryQuery(MYSQL* handle, std::string_view query, int retries) {
 	while (retries > 0 && mysql_query(handle, query.data()) != 0) {
 		g_logger().error("Query: {}", query.substr(0, 256));
 		g_logger().error("MySQL error [{}]: {}", mysql_errno(handle), mysql_error(handle));
@@ -223,34 +319,32 @@ bool Database::retryQuery(std::string_view query, int retries) {
 }
 
 bool Database::executeQuery(std::string_view query) {
-	if (!handle) {
+	if (connections.empty()) {
 		g_logger().error("Database not initialized!");
 		return false;
 	}
 
 	g_logger().trace("Executing Query: {}", query);
 
-	metrics::lock_latency measureLock("database");
-	std::scoped_lock lock { databaseLock };
-	measureLock.stop();
+	auto [connection, lock] = acquireConnection("query");
 
 	metrics::query_latency measure(query.substr(0, 50));
-	bool success = retryQuery(query, 10);
-	mysql_free_result(mysql_store_result(handle));
+	bool success = retryQuery(connection.handle, query, 10);
+	lastInsertId = static_cast<uint64_t>(mysql_insert_id(connection.handle));
+	mysql_free_result(mysql_store_result(connection.handle));
 
 	return success;
 }
 
 DBResult_ptr Database::storeQuery(std::string_view query) {
-	if (!handle) {
+	if (connections.empty()) {
 		g_logger().error("Database not initialized!");
 		return nullptr;
 	}
 	g_logger().trace("Storing Query: {}", query);
 
-	metrics::lock_latency measureLock("database");
-	std::scoped_lock lock { databaseLock };
-	measureLock.stop();
+	auto [connection, lock] = acquireConnection("store");
+	MYSQL* handle = connection.handle;
 
 	metrics::query_latency measure(query.substr(0, 50));
 retry:
@@ -276,6 +370,291 @@ retry:
 	return nullptr;
 }
 
+Database::Statement::~Statement() {
+	if (handle != nullptr) {
+		mysql_stmt_close(handle);
+	}
+}
+
+Database::Statement* Database::prepareStatement(Connection &connection, std::string_view query, unsigned int &error) {
+	if (const auto it = connection.statements.find(query); it != connection.statements.end()) {
+		return it->second.get();
+	}
+
+	// Queries of statements are constant, so the cache only fills up with a lot of distinct ones
+	if (connection.statements.size() >= MAX_CACHED_STATEMENTS) {
+		connection.statements.clear();
+	}
+
+	auto statement = std::make_unique<Statement>();
+	statement->handle = mysql_stmt_init(connection.handle);
+	if (!statement->handle) {
+		error = mysql_errno(connection.handle);
+		g_logger().error("[{}] Failed to initialize statement, message: {}", __FUNCTION__, mysql_error(connection.handle));
+		return nullptr;
+	}
+
+	if (mysql_stmt_prepare(statement->handle, query.data(), static_cast<unsigned long>(query.size())) != 0) {
+		error = mysql_stmt_errno(statement->handle);
+		g_logger().error("Query: {}", query.substr(0, 256));
+		g_logger().error("MySQL error [{}]: {}", error, mysql_stmt_error(statement->handle));
+		return nullptr;
+	}
+
+	// Sizes the buffers of string columns when fetching the result
+	decltype(MYSQL_BIND::is_null_value) updateMaxLength = 1;
+	mysql_stmt_attr_set(statement->handle, STMT_ATTR_UPDATE_MAX_LENGTH, &updateMaxLength);
+
+	if (MYSQL_RES* metadata = mysql_stmt_result_metadata(statement->handle)) {
+		const auto count = mysql_num_fields(metadata);
+		const MYSQL_FIELD* fields = mysql_fetch_fields(metadata);
+		std::vector<std::string> names;
+		names.reserve(count);
+		for (unsigned int i = 0; i < count; ++i) {
+			names.emplace_back(fields[i].name);
+			statement->types.emplace_back(fields[i].type);
+			statement->unsignedColumns.emplace_back((fields[i].flags & UNSIGNED_FLAG) != 0);
+		}
+		mysql_free_result(metadata);
+		statement->columns = std::make_shared<const DBResult::Columns>(std::move(names));
+	}
+
+	return connection.statements.emplace(std::string(query), std::move(statement)).first->second.get();
+}
+
+Database::Statement* Database::executeStatement(Connection &connection, std::string_view query, std::initializer_list<DBParam> params) {
+	for (int retries = 10; retries > 0; --retries) {
+		unsigned int error = 0;
+		Statement* statement = prepareStatement(connection, query, error);
+		if (statement) {
+			MYSQL_STMT* handle = statement->handle;
+			if (mysql_stmt_param_count(handle) != params.size()) {
+				g_logger().error("[{}] Query expects {} parameters, {} given: {}", __FUNCTION__, mysql_stmt_param_count(handle), params.size(), query.substr(0, 256));
+				return nullptr;
+			}
+
+			// Parameters are sent straight from their values, MySQL never writes to input buffers
+			std::vector<MYSQL_BIND> binds(params.size());
+			size_t index = 0;
+			for (const auto &param : params) {
+				auto &bind = binds[index++];
+				switch (param.type) {
+					case DBParam::Type::Null:
+						bind.buffer_type = MYSQL_TYPE_NULL;
+						break;
+					case DBParam::Type::Signed:
+						bind.buffer_type = MYSQL_TYPE_LONGLONG;
+						bind.buffer = const_cast<int64_t*>(&param.signedValue);
+						break;
+					case DBParam::Type::Unsigned:
+						bind.buffer_type = MYSQL_TYPE_LONGLONG;
+						bind.buffer = const_cast<uint64_t*>(&param.unsignedValue);
+						bind.is_unsigned = 1;
+						break;
+					case DBParam::Type::Double:
+						bind.buffer_type = MYSQL_TYPE_DOUBLE;
+						bind.buffer = const_cast<double*>(&param.doubleValue);
+						break;
+					case DBParam::Type::String:
+					case DBParam::Type::Blob:
+						bind.buffer_type = param.type == DBParam::Type::Blob ? MYSQL_TYPE_BLOB : MYSQL_TYPE_STRING;
+						bind.buffer = const_cast<char*>(param.bytes);
+						bind.buffer_length = static_cast<unsigned long>(param.length);
+						break;
+				}
+			}
+
+			if ((binds.empty() || mysql_stmt_bind_param(handle, binds.data()) == 0) && mysql_stmt_execute(handle) == 0) {
+				return statement;
+			}
+
+			error = mysql_stmt_errno(handle);
+			g_logger().error("Query: {}", query.substr(0, 256));
+			g_logger().error("MySQL error [{}]: {}", error, mysql_stmt_error(handle));
+		}
+
+		// The server dropped the statements of the connection (reconnected) or asks to prepare it again
+		const bool reprepare = error == 1243 /*ER_UNKNOWN_STMT_HANDLER*/ || error == 1615 /*ER_NEED_REPREPARE*/;
+		if (!reprepare && !isRecoverableError(error)) {
+			return nullptr;
+		}
+
+		connection.statements.clear();
+		if (!reprepare) {
+			std::this_thread::sleep_for(std::chrono::seconds(1));
+		}
+	}
+
+	g_logger().error("Query {} failed after {} retries.", query.substr(0, 256), 10);
+	return nullptr;
+}
+
+DBResult_ptr Database::fetchStatement(Statement &statement) {
+	MYSQL_STMT* handle = statement.handle;
+	if (!statement.columns) {
+		return nullptr;
+	}
+
+	if (mysql_stmt_store_result(handle) != 0) {
+		g_logger().error("[{}] MySQL error [{}]: {}", __FUNCTION__, mysql_stmt_errno(handle), mysql_stmt_error(handle));
+		mysql_stmt_free_result(handle);
+		return nullptr;
+	}
+
+	const auto rowCount = static_cast<size_t>(mysql_stmt_num_rows(handle));
+	if (rowCount == 0) {
+		mysql_stmt_free_result(handle);
+		return nullptr;
+	}
+
+	// Integers and decimals are fetched as numbers, everything else as bytes
+	const size_t columnCount = statement.types.size();
+	std::vector<MYSQL_BIND> binds(columnCount);
+	std::vector<int64_t> integers(columnCount);
+	std::vector<double> doubles(columnCount);
+	std::vector<std::string> buffers(columnCount);
+	std::vector<unsigned long> lengths(columnCount);
+	std::vector<decltype(MYSQL_BIND::is_null_value)> nulls(columnCount);
+
+	MYSQL_RES* metadata = mysql_stmt_result_metadata(handle);
+	const MYSQL_FIELD* fields = metadata ? mysql_fetch_fields(metadata) : nullptr;
+	for (size_t i = 0; i < columnCount; ++i) {
+		auto &bind = binds[i];
+		bind.length = &lengths[i];
+		bind.is_null = &nulls[i];
+		switch (statement.types[i]) {
+			case MYSQL_TYPE_TINY:
+			case MYSQL_TYPE_SHORT:
+			case MYSQL_TYPE_INT24:
+			case MYSQL_TYPE_LONG:
+			case MYSQL_TYPE_LONGLONG:
+			case MYSQL_TYPE_YEAR:
+				bind.buffer_type = MYSQL_TYPE_LONGLONG;
+				bind.buffer = &integers[i];
+				bind.is_unsigned = statement.unsignedColumns[i];
+				break;
+			case MYSQL_TYPE_FLOAT:
+			case MYSQL_TYPE_DOUBLE:
+				bind.buffer_type = MYSQL_TYPE_DOUBLE;
+				bind.buffer = &doubles[i];
+				break;
+			default:
+				buffers[i].resize(std::max<size_t>(fields ? fields[i].max_length : 0, 16));
+				bind.buffer_type = MYSQL_TYPE_STRING;
+				bind.buffer = buffers[i].data();
+				bind.buffer_length = static_cast<unsigned long>(buffers[i].size());
+				break;
+		}
+	}
+	mysql_free_result(metadata);
+
+	if (mysql_stmt_bind_result(handle, binds.data()) != 0) {
+		g_logger().error("[{}] MySQL error [{}]: {}", __FUNCTION__, mysql_stmt_errno(handle), mysql_stmt_error(handle));
+		mysql_stmt_free_result(handle);
+		return nullptr;
+	}
+
+	std::vector<DBResult::Value> values;
+	values.reserve(rowCount * columnCount);
+	std::string data;
+
+	int status;
+	while ((status = mysql_stmt_fetch(handle)) == 0 || status == MYSQL_DATA_TRUNCATED) {
+		bool rebind = false;
+		for (size_t i = 0; i < columnCount; ++i) {
+			auto &value = values.emplace_back();
+			if (nulls[i]) {
+				continue;
+			}
+
+			auto &bind = binds[i];
+			if (bind.buffer_type == MYSQL_TYPE_LONGLONG) {
+				if (bind.is_unsigned) {
+					value.type = DBResult::Value::Type::Unsigned;
+					value.unsignedValue = static_cast<uint64_t>(integers[i]);
+				} else {
+					value.type = DBResult::Value::Type::Signed;
+					value.signedValue = integers[i];
+				}
+				continue;
+			}
+
+			if (bind.buffer_type == MYSQL_TYPE_DOUBLE) {
+				value.type = DBResult::Value::Type::Double;
+				value.doubleValue = doubles[i];
+				continue;
+			}
+
+			const auto length = lengths[i];
+			if (length > buffers[i].size()) {
+				// Longer than the max length reported for the column, fetch it again into a larger buffer
+				buffers[i].resize(length);
+				bind.buffer = buffers[i].data();
+				bind.buffer_length = length;
+				mysql_stmt_fetch_column(handle, &bind, static_cast<unsigned int>(i), 0);
+				rebind = true;
+			}
+
+			value.type = DBResult::Value::Type::Bytes;
+			value.offset = data.size();
+			value.length = length;
+			data.append(buffers[i].data(), length);
+			data.push_back('\0');
+		}
+
+		if (rebind) {
+			mysql_stmt_bind_result(handle, binds.data());
+		}
+	}
+
+	if (status != MYSQL_NO_DATA) {
+		g_logger().error("[{}] MySQL error [{}]: {}", __FUNCTION__, mysql_stmt_errno(handle), mysql_stmt_error(handle));
+	}
+	mysql_stmt_free_result(handle);
+
+	return std::make_shared<DBResult>(statement.columns, std::move(values), std::move(data));
+}
+
+bool Database::executeQuery(std::string_view query, std::initializer_list<DBParam> params) {
+	if (connections.empty()) {
+		g_logger().error("Database not initialized!");
+		return false;
+	}
+
+	g_logger().trace("Executing Statement: {}", query);
+
+	auto [connection, lock] = acquireConnection("query");
+
+	metrics::query_latency measure(query.substr(0, 50));
+	Statement* statement = executeStatement(connection, query, params);
+	if (!statement) {
+		return false;
+	}
+
+	lastInsertId = static_cast<uint64_t>(mysql_stmt_insert_id(statement->handle));
+	mysql_stmt_free_result(statement->handle);
+	return true;
+}
+
+DBResult_ptr Database::storeQuery(std::string_view query, std::initializer_list<DBParam> params) {
+	if (connections.empty()) {
+		g_logger().error("Database not initialized!");
+		return nullptr;
+	}
+
+	g_logger().trace("Storing Statement: {}", query);
+
+	auto [connection, lock] = acquireConnection("store");
+
+	metrics::query_latency measure(query.substr(0, 50));
+	Statement* statement = executeStatement(connection, query, params);
+	if (!statement) {
+		return nullptr;
+	}
+
+	return fetchStatement(*statement);
+}
+
 std::string Database::escapeString(const std::string &s) const {
 	std::string::size_type len = s.length();
 	auto length = static_cast<uint32_t>(len);
@@ -294,8 +673,15 @@ std::string Database::escapeBlob(const char* s, uint32_t length) const {
 	escaped.push_back('\'');
 
 	if (length != 0) {
+		if (connections.empty()) {
+			g_logger().error("Database not initialized!");
+			return {};
+		}
+
 		std::string output(maxLength, '\0');
-		size_t escapedLength = mysql_real_escape_string(handle, &output[0], s, length);
+		// Escapes on the connection of the calling thread, other threads may be running queries on the rest of the pool
+		auto [connection, lock] = acquireConnection("escape");
+		size_t escapedLength = mysql_real_escape_string(connection.handle, &output[0], s, length);
 		output.resize(escapedLength);
 		escaped.append(output);
 	}
@@ -304,49 +690,101 @@ std::string Database::escapeBlob(const char* s, uint32_t length) const {
 	return escaped;
 }
 
+DBResult::Columns::Columns(std::vector<std::string> columnNames) :
+	names(std::move(columnNames)) {
+	indexes.reserve(names.size());
+	for (size_t i = 0; i < names.size(); ++i) {
+		indexes.try_emplace(names[i], i);
+	}
+}
+
 DBResult::DBResult(MYSQL_RES* res) {
 	handle = res;
 
 	int num_fields = mysql_num_fields(handle);
 
 	const MYSQL_FIELD* fields = mysql_fetch_fields(handle);
+	std::vector<std::string> names;
+	names.reserve(num_fields);
 	for (size_t i = 0; i < num_fields; i++) {
-		listNames[fields[i].name] = i;
+		names.emplace_back(fields[i].name);
 	}
+	columns = std::make_shared<const Columns>(std::move(names));
 	row = mysql_fetch_row(handle);
 }
 
+DBResult::DBResult(std::shared_ptr<const Columns> resultColumns, std::vector<Value> resultValues, std::string resultData) :
+	columns(std::move(resultColumns)), values(std::move(resultValues)), data(std::move(resultData)) {
+	rowCount = columns->names.empty() ? 0 : values.size() / columns->names.size();
+}
+
 DBResult::~DBResult() {
-	mysql_free_result(handle);
+	if (handle) {
+		mysql_free_result(handle);
+	}
 }
 
 std::string DBResult::getString(const std::string &s) const {
-	auto it = listNames.find(s);
-	if (it == listNames.end()) {
+	const auto column = columns->getIndex(s);
+	if (column == Columns::npos) {
 		g_logger().error("Column '{}' does not exist in result set", s);
 		return {};
 	}
-	if (row[it->second] == nullptr) {
-		return {};
+	return getString(column);
+}
+
+std::string DBResult::getString(size_t column) const {
+	if (handle) {
+		if (row[column] == nullptr) {
+			return {};
+		}
+		return std::string(row[column]);
+	}
+
+	const auto &value = getValue(column);
+	switch (value.type) {
+		case Value::Type::Signed:
+			return std::to_string(value.signedValue);
+		case Value::Type::Unsigned:
+			return std::to_string(value.unsignedValue);
+		case Value::Type::Double:
+			return fmt::format("{}", value.doubleValue);
+		case Value::Type::Bytes:
+			return data.substr(value.offset, value.length);
+		default:
+			return {};
 	}
-	return std::string(row[it->second]);
 }
 
 const char* DBResult::getStream(const std::string &s, unsigned long &size) const {
-	auto it = listNames.find(s);
-	if (it == listNames.end()) {
+	const auto column = columns->getIndex(s);
+	if (column == Columns::npos) {
 		g_logger().error("Column '{}' doesn't exist in the result set", s);
 		size = 0;
 		return nullptr;
 	}
+	return getStream(column, size);
+}
+
+const char* DBResult::getStream(size_t column, unsigned long &size) const {
+	if (handle) {
+		if (row[column] == nullptr) {
+			size = 0;
+			return nullptr;
+		}
+
+		size = mysql_fetch_lengths(handle)[column];
+		return row[column];
+	}
 
-	if (row[it->second] == nullptr) {
+	const auto &value = getValue(column);
+	if (value.type != Value::Type::Bytes) {
 		size = 0;
 		return nullptr;
 	}
 
-	size = mysql_fetch_lengths(handle)[it->second];
-	return row[it->second];
+	size = static_cast<unsigned long>(value.length);
+	return data.c_str() + value.offset;
 }
 
 uint8_t DBResult::getU8FromString(const std::string &string, const std::string &function) {
@@ -370,20 +808,29 @@ int8_t DBResult::getInt8FromString(const std::string &string, const std::string
 }
 
 size_t DBResult::countResults() const {
-	return static_cast<size_t>(mysql_num_rows(handle));
+	if (handle) {
+		return static_cast<size_t>(mysql_num_rows(handle));
+	}
+	return rowCount;
 }
 
 bool DBResult::hasNext() const {
-	return row != nullptr;
+	if (handle) {
+		return row != nullptr;
+	}
+	return current < rowCount;
 }
 
 bool DBResult::next() {
-	if (!handle) {
-		g_logger().error("Database not initialized!");
-		return false;
+	if (handle) {
+		row = mysql_fetch_row(handle);
+		return row != nullptr;
 	}
-	row = mysql_fetch_row(handle);
-	return row != nullptr;
+
+	if (current < rowCount) {
+		++current;
+	}
+	return current < rowCount;
 }
 
 DBInsert::DBInsert(std::string insertQuery) :
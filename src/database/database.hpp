@@ -13,105 +13,205 @@
 
 #ifndef USE_PRECOMPILED_HEADERS
 	#include <mysql/mysql.h>
+	#include <parallel_hashmap/phmap.h>
+	#include <atomic>
+	#include <initializer_list>
 	#include <mutex>
 	#include <utility>
+	#include <vector>
 #endif
 
 class DBResult;
 using DBResult_ptr = std::shared_ptr<DBResult>;
 
-class Database {
+/**
+ * Parameter of a prepared statement, bound by value through the binary protocol without escaping.
+ * Strings and blobs are not copied, they must outlive the query they are passed to.
+ */
+class DBParam {
 public:
-	static const size_t MAX_QUERY_SIZE = 8 * 1024 * 1024; // 8 Mb -- half the default MySQL max_allowed_packet size
-
-	Database() = default;
-	~Database();
+	enum class Type : uint8_t {
+		Null,
+		Signed,
+		Unsigned,
+		Double,
+		String,
+		Blob,
+	};
 
-	// Singleton - ensures we don't accidentally copy it.
-	Database(const Database &) = delete;
-	Database &operator=(const Database &) = delete;
-
-	static Database &getInstance();
-
-	bool connect();
-
-	bool connect(const std::string* host, const std::string* user, const std::string* password, const std::string* database, uint32_t port, const std::string* sock);
-
-	/**
-	 * @brief Creates a backup of the database.
-	 *
-	 * This function generates a backup of the database, with options for compression.
-	 * The backup can be triggered periodically or during specific events like server loading.
-	 *
-	 * The backup operation will only execute if the configuration option `MYSQL_DB_BACKUP`
-	 * is set to true in the `config.lua` file. If this configuration is disabled, the function
-	 * will return without performing any action.
-	 *
-	 * @param compress Indicates whether the backup should be compressed.
-	 * - If `compress` is true, the backup is created during an interval-based save, which occurs every 2 hours.
-	 *   This helps prevent excessive growth in the number of backup files.
-	 * - If `compress` is false, the backup is created during the global save, which is triggered once a day when the server loads.
-	 */
-	void createDatabaseBackup(bool compress) const;
-
-	bool retryQuery(std::string_view query, int retries);
-	bool executeQuery(std::string_view query);
-
-	DBResult_ptr storeQuery(std::string_view query);
-
-	std::string escapeString(const std::string &s) const;
-
-	std::string escapeBlob(const char* s, uint32_t length) const;
-
-	uint64_t getLastInsertId() const {
-		return static_cast<uint64_t>(mysql_insert_id(handle));
+	template <typename T>
+		requires std::is_integral_v<T> || std::is_enum_v<T>
+	DBParam(T value) {
+		if constexpr (std::is_enum_v<T>) {
+			setInteger(static_cast<std::underlying_type_t<T>>(value));
+		} else {
+			setInteger(value);
+		}
 	}
 
-	static const char* getClientVersion() {
-		return mysql_get_client_info();
+	DBParam(double value) :
+		type(Type::Double), doubleValue(value) { }
+	DBParam(std::string_view value) :
+		type(Type::String), bytes(value.data()), length(value.size()) { }
+	DBParam(const std::string &value) :
+		DBParam(std::string_view(value)) { }
+	DBParam(const char* value) :
+		DBParam(std::string_view(value)) { }
+	DBParam(std::nullptr_t) { }
+
+	static DBParam blob(const char* data, size_t size) {
+		DBParam param(std::string_view(data, size));
+		param.type = Type::Blob;
+		return param;
 	}
 
-	uint64_t getMaxPacketSize() const {
-		return maxPacketSize;
+	Type getType() const {
+		return type;
 	}
 
 private:
-	bool beginTransaction();
-	bool rollback();
-	bool commit();
-
-	static bool isRecoverableError(unsigned int error);
+	template <typename T>
+	void setInteger(T value) {
+		if constexpr (std::is_same_v<T, bool> || std::is_unsigned_v<T>) {
+			type = Type::Unsigned;
+			unsignedValue = static_cast<uint64_t>(value);
+		} else {
+			type = Type::Signed;
+			signedValue = static_cast<int64_t>(value);
+		}
+	}
 
-	MYSQL* handle = nullptr;
-	std::recursive_mutex databaseLock;
-	uint64_t maxPacketSize = 1048576;
+	Type type = Type::Null;
+	union {
+		int64_t signedValue = 0;
+		uint64_t unsignedValue;
+		double doubleValue;
+	};
+	const char* bytes = nullptr;
+	size_t length = 0;
 
-	friend class DBTransaction;
+	friend class Database;
 };
 
-constexpr auto g_database = Database::getInstance;
-
+/**
+ * Result set of a query, read one row at a time.
+ *
+ * Results of plain queries hold the text rows of MySQL and parse each value on access.
+ * Results of prepared statements are fetched whole through the binary protocol: numbers are
+ * already typed and the column names are shared by every result of the same statement.
+ * Values can be read by column name or, on hot paths, by the index from getColumnIndex.
+ */
 class DBResult {
 public:
+	struct Columns {
+		static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+		explicit Columns(std::vector<std::string> columnNames);
+
+		// The indexes point into names
+		Columns(const Columns &) = delete;
+		Columns &operator=(const Columns &) = delete;
+
+		size_t getIndex(std::string_view name) const {
+			const auto it = indexes.find(name);
+			return it != indexes.end() ? it->second : npos;
+		}
+
+		std::vector<std::string> names;
+		phmap::flat_hash_map<std::string_view, size_t> indexes;
+	};
+
+	struct Value {
+		enum class Type : uint8_t {
+			Null,
+			Signed,
+			Unsigned,
+			Double,
+			Bytes,
+		};
+
+		Type type = Type::Null;
+		union {
+			int64_t signedValue = 0;
+			uint64_t unsignedValue;
+			double doubleValue;
+		};
+		// Bytes are kept NUL terminated in the data of the result
+		size_t offset = 0;
+		size_t length = 0;
+	};
+
 	explicit DBResult(MYSQL_RES* res);
+	DBResult(std::shared_ptr<const Columns> columns, std::vector<Value> values, std::string data);
 	~DBResult();
 
 	// Non copyable
 	DBResult(const DBResult &) = delete;
 	DBResult &operator=(const DBResult &) = delete;
 
+	size_t getColumnIndex(const std::string &s) const {
+		return columns->getIndex(s);
+	}
+
 	template <typename T>
 	T getNumber(const std::string &s) const {
-		auto it = listNames.find(s);
-		if (it == listNames.end()) {
+		const auto column = columns->getIndex(s);
+		if (column == Columns::npos) {
 			g_logger().error("[DBResult::getNumber] - Column '{}' doesn't exist in the result set", s);
 			return T();
 		}
+		return getNumber<T>(column);
+	}
 
-		if (row[it->second] == nullptr) {
-			return T();
+	template <typename T>
+	T getNumber(size_t column) const {
+		if (handle) {
+			if (row[column] == nullptr) {
+				return T();
+			}
+			return parseNumber<T>(row[column], columns->names[column]);
 		}
 
+		const auto &value = getValue(column);
+		switch (value.type) {
+			case Value::Type::Signed:
+				return castNumber<T>(value.signedValue);
+			case Value::Type::Unsigned:
+				return castNumber<T>(value.unsignedValue);
+			case Value::Type::Double:
+				return castNumber<T>(value.doubleValue);
+			case Value::Type::Bytes:
+				return parseNumber<T>(data.c_str() + value.offset, columns->names[column]);
+			default:
+				return T();
+		}
+	}
+
+	std::string getString(const std::string &s) const;
+	std::string getString(size_t column) const;
+	const char* getStream(const std::string &s, unsigned long &size) const;
+	const char* getStream(size_t column, unsigned long &size) const;
+	static uint8_t getU8FromString(const std::string &string, const std::string &function);
+	static int8_t getInt8FromString(const std::string &string, const std::string &function);
+
+	size_t countResults() const;
+	bool hasNext() const;
+	bool next();
+
+private:
+	template <typename T, typename V>
+	static T castNumber(V value) {
+		if constexpr (std::is_enum_v<T>) {
+			return static_cast<T>(static_cast<std::underlying_type_t<T>>(value));
+		} else if constexpr (std::is_same_v<T, bool>) {
+			return value != 0;
+		} else {
+			return static_cast<T>(value);
+		}
+	}
+
+	template <typename T>
+	static T parseNumber(const char* text, const std::string &name) {
 		T data {};
 		try {
 			// Check if the type T is a enum
@@ -119,9 +219,9 @@ public:
 				using underlying_type = std::underlying_type_t<T>;
 				underlying_type value = 0;
 				if constexpr (std::is_signed_v<underlying_type>) {
-					value = static_cast<underlying_type>(std::stoll(row[it->second]));
+					value = static_cast<underlying_type>(std::stoll(text));
 				} else {
-					value = static_cast<underlying_type>(std::stoull(row[it->second]));
+					value = static_cast<underlying_type>(std::stoull(text));
 				}
 				return static_cast<T>(value);
 			}
@@ -130,74 +230,213 @@ public:
 				// Check if the type T is int8_t or int16_t
 				if constexpr (std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t>) {
 					// Use std::stoi to convert string to int8_t
-					data = static_cast<T>(std::stoi(row[it->second]));
+					data = static_cast<T>(std::stoi(text));
 				}
 				// Check if the type T is int32_t
 				else if constexpr (std::is_same_v<T, int32_t>) {
 					// Use std::stol to convert string to int32_t
-					data = static_cast<T>(std::stol(row[it->second]));
+					data = static_cast<T>(std::stol(text));
 				}
 				// Check if the type T is int64_t
 				else if constexpr (std::is_same_v<T, int64_t>) {
 					// Use std::stoll to convert string to int64_t
-					data = static_cast<T>(std::stoll(row[it->second]));
+					data = static_cast<T>(std::stoll(text));
 				}
 				// Check if the type T is time_t
 				else if constexpr (std::is_same_v<T, time_t>) {
 					// Use std::stoll to convert string to time_t (usually long long)
-					data = static_cast<T>(std::stoll(row[it->second]));
+					data = static_cast<T>(std::stoll(text));
 				} else {
 					// Throws exception indicating that type T is invalid
 					g_logger().error("Invalid signed type T");
 				}
 			} else if (std::is_same<T, bool>::value) {
-				data = static_cast<T>(std::stoi(row[it->second]));
+				data = static_cast<T>(std::stoi(text));
 			} else {
 				// Check if the type T is uint8_t or uint16_t or uint32_t
 				if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, uint16_t> || std::is_same_v<T, uint32_t>) {
 					// Use std::stoul to convert string to uint8_t
-					data = static_cast<T>(std::stoul(row[it->second]));
+					data = static_cast<T>(std::stoul(text));
 				}
 				// Check if the type T is uint64_t
 				else if constexpr (std::is_same_v<T, uint64_t>) {
 					// Use std::stoull to convert string to uint64_t
-					data = static_cast<T>(std::stoull(row[it->second]));
+					data = static_cast<T>(std::stoull(text));
 				} else {
 					// Send log indicating that type T is invalid
-					g_logger().error("Column '{}' has an invalid unsigned T is invalid", s);
+					g_logger().error("Column '{}' has an invalid unsigned T is invalid", name);
 				}
 			}
 		} catch (std::invalid_argument &e) {
 			// Value of string is invalid
-			g_logger().error("Column '{}' has an invalid value set, error code: {}", s, e.what());
+			g_logger().error("Column '{}' has an invalid value set, error code: {}", name, e.what());
 			data = T();
 		} catch (std::out_of_range &e) {
 			// Value of string is too large to fit the range allowed by type T
-			g_logger().error("Column '{}' has a value out of range, error code: {}", s, e.what());
+			g_logger().error("Column '{}' has a value out of range, error code: {}", name, e.what());
 			data = T();
 		}
 
 		return data;
 	}
 
-	std::string getString(const std::string &s) const;
-	const char* getStream(const std::string &s, unsigned long &size) const;
-	static uint8_t getU8FromString(const std::string &string, const std::string &function);
-	static int8_t getInt8FromString(const std::string &string, const std::string &function);
+	const Value &getValue(size_t column) const {
+		return values[current * columns->names.size() + column];
+	}
 
-	size_t countResults() const;
-	bool hasNext() const;
-	bool next();
+	MYSQL_RES* handle = nullptr;
+	MYSQL_ROW row = nullptr;
 
-private:
-	MYSQL_RES* handle;
-	MYSQL_ROW row;
+	std::shared_ptr<const Columns> columns;
 
-	std::map<std::string_view, size_t> listNames;
+	// Binary result, every row is already fetched
+	std::vector<Value> values;
+	std::string data;
+	size_t rowCount = 0;
+	size_t current = 0;
 
 	friend class Database;
 };
 
+/**
+ * MySQL access through a pool of connections.
+ *
+ * Each thread has affinity to one connection of the pool, assigned the first time it runs a query,
+ * so the thread pool workers spread over the pool and queries from different threads run concurrently.
+ * When the connection of a thread is busy, the query borrows any idle one before waiting for it.
+ * A transaction pins its connection to the thread that started it, until it is committed or rolled back.
+ */
+class Database {
+public:
+	static const size_t MAX_QUERY_SIZE = 8 * 1024 * 1024; // 8 Mb -- half the default MySQL max_allowed_packet size
+	static constexpr size_t MAX_POOL_SIZE = 64;
+
+	Database() = default;
+	~Database();
+
+	// Singleton - ensures we don't accidentally copy it.
+	Database(const Database &) = delete;
+	Database &operator=(const Database &) = delete;
+
+	static Database &getInstance();
+
+	bool connect();
+
+	bool connect(const std::string* host, const std::string* user, const std::string* password, const std::string* database, uint32_t port, const std::string* sock, size_t poolSize = 1);
+
+	/**
+	 * @brief Creates a backup of the database.
+	 *
+	 * This function generates a backup of the database, with options for compression.
+	 * The backup can be triggered periodically or during specific events like server loading.
+	 *
+	 * The backup operation will only execute if the configuration option `MYSQL_DB_BACKUP`
+	 * is set to true in the `config.lua` file. If this configuration is disabled, the function
+	 * will return without performing any action.
+	 *
+	 * @param compress Indicates whether the backup should be compressed.
+	 * - If `compress` is true, the backup is created during an interval-based save, which occurs every 2 hours.
+	 *   This helps prevent excessive growth in the number of backup files.
+	 * - If `compress` is false, the backup is created during the global save, which is triggered once a day when the server loads.
+	 */
+	void createDatabaseBackup(bool compress) const;
+
+	bool executeQuery(std::string_view query);
+
+	DBResult_ptr storeQuery(std::string_view query);
+
+	/**
+	 * @brief Runs a prepared statement, with a ? placeholder in the query for each parameter.
+	 * Statements are prepared once per connection and cached by their query text,
+	 * so the query must be constant and the values always passed as parameters.
+	 */
+	bool executeQuery(std::string_view query, std::initializer_list<DBParam> params);
+
+	/**
+	 * @brief Runs a prepared statement and fetches its whole result through the binary protocol.
+	 * @return nullptr if the statement failed or returned no rows, as storeQuery.
+	 */
+	DBResult_ptr storeQuery(std::string_view query, std::initializer_list<DBParam> params);
+
+	std::string escapeString(const std::string &s) const;
+
+	std::string escapeBlob(const char* s, uint32_t length) const;
+
+	// Id generated by the last query executed by the calling thread, whichever connection ran it
+	uint64_t getLastInsertId() const {
+		return lastInsertId;
+	}
+
+	static const char* getClientVersion() {
+		return mysql_get_client_info();
+	}
+
+	uint64_t getMaxPacketSize() const {
+		return maxPacketSize;
+	}
+
+	size_t getPoolSize() const {
+		return connections.size();
+	}
+
+private:
+	struct Statement {
+		~Statement();
+
+		MYSQL_STMT* handle = nullptr;
+		// Empty for statements without a result set
+		std::shared_ptr<const DBResult::Columns> columns;
+		std::vector<enum_field_types> types;
+		std::vector<bool> unsignedColumns;
+	};
+
+	struct Connection {
+		MYSQL* handle = nullptr;
+		std::recursive_mutex lock;
+		phmap::flat_hash_map<std::string, std::unique_ptr<Statement>> statements;
+	};
+
+	struct ConnectionLock {
+		Connection &connection;
+		std::unique_lock<std::recursive_mutex> lock;
+	};
+
+	static MYSQL* openConnection(const std::string* host, const std::string* user, const std::string* password, const std::string* database, uint32_t port, const std::string* sock);
+
+	/**
+	 * @brief Locks the connection to run a query on, as described in the class documentation.
+	 * The wait is measured in the database_pool latency histogram, labeled by scope.
+	 */
+	ConnectionLock acquireConnection(std::string_view scope) const;
+
+	bool beginTransaction();
+	bool rollback();
+	bool commit();
+
+	static bool isRecoverableError(unsigned int error);
+	static bool retryQuery(MYSQL* handle, std::string_view query, int retries);
+
+	static constexpr size_t MAX_CACHED_STATEMENTS = 256;
+
+	static Statement* prepareStatement(Connection &connection, std::string_view query, unsigned int &error);
+	static Statement* executeStatement(Connection &connection, std::string_view query, std::initializer_list<DBParam> params);
+	static DBResult_ptr fetchStatement(Statement &statement);
+
+	std::vector<std::unique_ptr<Connection>> connections;
+	mutable std::atomic_size_t nextThreadSlot = 0;
+	uint64_t maxPacketSize = 1048576;
+
+	static thread_local size_t threadSlot;
+	static thread_local Connection* transactionConnection;
+	static thread_local size_t transactionDepth;
+	static thread_local bool transactionFailed;
+	static thread_local uint64_t lastInsertId;
+
+	friend class DBTransaction;
+};
+
+constexpr auto g_database = Database::getInstance;
+
 /**
  * INSERT statement.
  */
@@ -220,7 +459,10 @@ class DBTransaction {
 public:
 	explicit DBTransaction() = default;
 
-	~DBTransaction() = default;
+	~DBTransaction() {
+		// Never leave the connection pinned, even if an exception skipped the commit
+		rollback();
+	}
 
 	// non-copyable
 	DBTransaction(const DBTransaction &) = delete;
@@ -230,23 +472,33 @@ public:
 	DBTransaction(const DBTransaction &&) = delete;
 	DBTransaction &operator=(const DBTransaction &&) = delete;
 
+	/**
+	 * @brief Runs the function inside a transaction, all of its queries go through the same connection.
+	 * The transaction is committed if the function returns true and rolled back otherwise,
+	 * returning false from the function means that no changes were expected, so it is not reported as a failure.
+	 * Exceptions thrown by the function roll the transaction back and are rethrown.
+	 */
 	template <typename Func>
 	static bool executeWithinTransaction(const Func &toBeExecuted) {
-		bool changesExpected = toBeExecuted();
-		if (changesExpected) {
-			DBTransaction transaction;
-			try {
-				transaction.begin();
-				transaction.commit();
-				return changesExpected;
-			} catch (const std::exception &exception) {
-				transaction.rollback();
-				g_logger().error("[{}] Error occurred during transaction, error: {}", __FUNCTION__, exception.what());
-				return false;
-			}
-		} else {
+		DBTransaction transaction;
+		if (!transaction.begin()) {
+			return false;
+		}
+
+		bool changesExpected = false;
+		try {
+			changesExpected = toBeExecuted();
+		} catch (const std::exception &exception) {
+			transaction.rollback();
+			g_logger().error("[{}] Error occurred during transaction, error: {}", __FUNCTION__, exception.what());
+			throw;
+		}
+
+		if (!changesExpected) {
+			transaction.rollback();
 			return true;
 		}
+		return transaction.commit();
 	}
 
 private:
@@ -258,11 +510,13 @@ private:
 
 		try {
 			// Start the transaction
+			if (!Database::getInstance().beginTransaction()) {
+				return false;
+			}
 			state = STATE_START;
-			return Database::getInstance().beginTransaction();
+			return true;
 		} catch (const std::exception &exception) {
 			// An error occurred while starting the transaction
-			state = STATE_NO_START;
 			g_logger().error("[{}] An error occurred while starting the transaction, error: {}", __FUNCTION__, exception.what());
 			return false;
 		}
@@ -284,21 +538,22 @@ private:
 		}
 	}
 
-	void commit() {
+	bool commit() {
 		// Ensure that the transaction has been started
 		if (state != STATE_START) {
 			g_logger().error("Transaction not started");
-			return;
+			return false;
 		}
 
 		try {
 			// Commit the transaction
 			state = STATE_COMMIT;
-			Database::getInstance().commit();
+			return Database::getInstance().commit();
 		} catch (const std::exception &exception) {
 			// An error occurred while committing the transaction
 			state = STATE_NO_START;
 			g_logger().error("[{}] An error occurred while committing the transaction, error: {}", __FUNCTION__, exception.what());
+			return false;
 		}
 	}
 
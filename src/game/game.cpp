@@ -13,6 +13,7 @@
 #include "creatures/appearance/mounts/mounts.hpp"
 #include "creatures/appearance/attached_effects/attached_effects.hpp"
 #include "creatures/combat/condition.hpp"
+#include "creatures/combat/condition_scheduler.hpp"
 #include "creatures/combat/spells.hpp"
 #include "creatures/creature.hpp"
 #include "creatures/interactions/chat.hpp"
@@ -26,6 +27,7 @@
 #include "creatures/players/player.hpp"
 #include "enums/player_wheel.hpp"
 #include "database/databasetasks.hpp"
+#include "game/highscore_ranking.hpp"
 #include "game/scheduling/dispatcher.hpp"
 #include "game/scheduling/save_manager.hpp"
 #include "game/zones/zone.hpp"
@@ -707,10 +709,14 @@ void Game::loadItemsPrice() {
 	}
 }
 
-void Game::loadMainMap(const std::string &filename) {
+void Game::readMainMap(const std::string &filename) {
+	map.readMap(g_configManager().getString(DATA_DIRECTORY) + "/world/" + filename + ".otbm", true);
+}
+
+void Game::loadMainMap() {
 	Monster::despawnRange = g_configManager().getNumber(DEFAULT_DESPAWNRANGE);
 	Monster::despawnRadius = g_configManager().getNumber(DEFAULT_DESPAWNRADIUS);
-	map.loadMap(g_configManager().getString(DATA_DIRECTORY) + "/world/" + filename + ".otbm", true, true, true, true, true);
+	map.loadMapData(true, true, true, true, true);
 }
 
 void Game::loadCustomMaps(const std::filesystem::path &customMapPath) {
@@ -1252,6 +1258,7 @@ bool Game::removeCreature(const std::shared_ptr<Creature> &creature, bool isLogo
 	creature->setRemoved();
 
 	removeCreatureCheck(creature);
+	g_conditionScheduler().cancel(creature->getID());
 
 	for (const auto &summon : creature->getSummons()) {
 		summon->setSkillLoss(false);
@@ -4503,6 +4510,7 @@ void Game::playerSetShowOffSocket(uint32_t playerId, Outfit_t &outfit, const Pos
 	}
 
 	// Send to client
+	tile->clearItemEncoding();
 	for (const auto &spectator : Spectators().find<Player>(pos, true)) {
 		spectator->getPlayer()->sendUpdateTileItem(tile, pos, item);
 	}
@@ -6596,6 +6604,7 @@ void Game::addCreatureCheck(const std::shared_ptr<Creature> &creature) {
 
 	g_dispatcher().addEvent([this, index = uniform_random(0, EVENT_CREATURECOUNT - 1), creature] {
 		checkCreatureLists[index].emplace_back(creature);
+		creature->scheduleConditions();
 	},
 	                        "Game::addCreatureCheck");
 }
@@ -6621,11 +6630,9 @@ void Game::checkCreatures() {
 					g_dispatcher().addEvent([creature] {
 						if (creature->isAlive()) {
 							creature->onAttacking(EVENT_CREATURE_THINK_INTERVAL);
-							creature->executeConditions(EVENT_CREATURE_THINK_INTERVAL);
 						} }, __FUNCTION__);
 				} else {
 					creature->onAttacking(EVENT_CREATURE_THINK_INTERVAL);
-					creature->executeConditions(EVENT_CREATURE_THINK_INTERVAL);
 				}
 				return false;
 			}
@@ -6637,6 +6644,23 @@ void Game::checkCreatures() {
 	});
 
 	index = (index + 1) % EVENT_CREATURECOUNT;
+
+	// Conditions run apart from the think, only for the creatures with one due
+	static std::vector<uint32_t> dueCreatures;
+	dueCreatures.clear();
+	g_conditionScheduler().takeDue(OTSYS_TIME(), dueCreatures);
+	for (const auto creatureId : dueCreatures) {
+		const auto &creature = getCreatureByID(creatureId);
+		if (!creature) {
+			continue;
+		}
+
+		if (creature->creatureCheck && creature->isAlive()) {
+			creature->executeConditions();
+		} else {
+			creature->pauseConditions();
+		}
+	}
 }
 
 void Game::changeSpeed(const std::shared_ptr<Creature> &creature, int32_t varSpeedDelta) {
@@ -7085,7 +7109,7 @@ void Game::handleHazardSystemAttack(CombatDamage &damage, const std::shared_ptr<
 	}
 }
 
-void Game::notifySpectators(const CreatureVector &spectators, const Position &targetPos, const std::shared_ptr<Player> &attackerPlayer, const std::shared_ptr<Monster> &targetMonster) {
+void Game::notifySpectators(const Spectators &spectators, const Position &targetPos, const std::shared_ptr<Player> &attackerPlayer, const std::shared_ptr<Monster> &targetMonster) {
 	if (!spectators.empty()) {
 		for (const auto &spectator : spectators) {
 			if (!spectator) {
@@ -7437,15 +7461,15 @@ bool Game::combatChangeHealth(const std::shared_ptr<Creature> &attacker, const s
 			handleHazardSystemAttack(damage, attackerPlayer, targetMonster, true);
 
 			if ((damage.primary.value == 0 && damage.secondary.value == 0) || damage.hazardDodge) {
-				notifySpectators(spectators.data(), targetPos, attackerPlayer, targetMonster);
+				notifySpectators(spectators, targetPos, attackerPlayer, targetMonster);
 				return true;
 			}
 		}
 
 		if (damage.fatal) {
-			addMagicEffect(spectators.data(), targetPos, CONST_ME_FATAL);
+			addMagicEffect(spectators, targetPos, CONST_ME_FATAL);
 		} else if (damage.critical) {
-			addMagicEffect(spectators.data(), targetPos, CONST_ME_CRITICAL_DAMAGE);
+			addMagicEffect(spectators, targetPos, CONST_ME_CRITICAL_DAMAGE);
 		}
 
 		if (!damage.extension && attackerMonster && targetPlayer) {
@@ -7508,7 +7532,7 @@ bool Game::combatChangeHealth(const std::shared_ptr<Creature> &attacker, const s
 					target->removeCondition(CONDITION_MANASHIELD);
 				}
 
-				addMagicEffect(spectators.data(), targetPos, CONST_ME_LOSEENERGY);
+				addMagicEffect(spectators, targetPos, CONST_ME_LOSEENERGY);
 
 				std::string damageString = std::to_string(manaDamage);
 
@@ -7628,7 +7652,7 @@ bool Game::combatChangeHealth(const std::shared_ptr<Creature> &attacker, const s
 			spectators.find<Player>(targetPos, true);
 		}
 
-		addCreatureHealth(spectators.data(), target);
+		addCreatureHealth(spectators, target);
 
 		sendDamageMessageAndEffects(
 			attacker,
@@ -7638,7 +7662,7 @@ bool Game::combatChangeHealth(const std::shared_ptr<Creature> &attacker, const s
 			attackerPlayer,
 			targetPlayer,
 			message,
-			spectators.data(),
+			spectators,
 			realDamage
 		);
 
@@ -7673,7 +7697,7 @@ void Game::updatePlayerPartyHuntAnalyzer(const CombatDamage &damage, const std::
 void Game::sendDamageMessageAndEffects(
 	const std::shared_ptr<Creature> &attacker, const std::shared_ptr<Creature> &target, const CombatDamage &damage,
 	const Position &targetPos, const std::shared_ptr<Player> &attackerPlayer, const std::shared_ptr<Player> &targetPlayer,
-	TextMessage &message, const CreatureVector &spectators, int32_t realDamage
+	TextMessage &message, const Spectators &spectators, int32_t realDamage
 ) {
 	message.primary.value = damage.primary.value;
 	message.secondary.value = damage.secondary.value;
@@ -7692,7 +7716,7 @@ bool Game::shouldSendMessage(const TextMessage &message) const {
 void Game::sendMessages(
 	const std::shared_ptr<Creature> &attacker, const std::shared_ptr<Creature> &target, const CombatDamage &damage,
 	const Position &targetPos, const std::shared_ptr<Player> &attackerPlayer, const std::shared_ptr<Player> &targetPlayer,
-	TextMessage &message, const CreatureVector &spectators, int32_t realDamage
+	TextMessage &message, const Spectators &spectators, int32_t realDamage
 ) const {
 	if (attackerPlayer) {
 		attackerPlayer->updateImpactTracker(damage.primary.type, damage.primary.value);
@@ -7837,7 +7861,7 @@ void Game::buildMessageAsAttacker(
 
 void Game::sendEffects(
 	const std::shared_ptr<Creature> &target, const CombatDamage &damage, const Position &targetPos, TextMessage &message,
-	const CreatureVector &spectators
+	const Spectators &spectators
 ) {
 	uint16_t hitEffect;
 	if (message.primary.value) {
@@ -8184,10 +8208,10 @@ bool Game::combatChangeMana(const std::shared_ptr<Creature> &attacker, const std
 
 void Game::addCreatureHealth(const std::shared_ptr<Creature> &target) {
 	auto spectators = Spectators().find<Player>(target->getPosition(), true);
-	addCreatureHealth(spectators.data(), target);
+	addCreatureHealth(spectators, target);
 }
 
-void Game::addCreatureHealth(const CreatureVector &spectators, const std::shared_ptr<Creature> &target) {
+void Game::addCreatureHealth(const Spectators &spectators, const std::shared_ptr<Creature> &target) {
 	uint8_t healthPercent = std::ceil((static_cast<double>(target->getHealth()) / std::max<int32_t>(target->getMaxHealth(), 1)) * 100);
 	if (const auto &targetPlayer = target->getPlayer()) {
 		if (const auto &party = targetPlayer->getParty()) {
@@ -8226,10 +8250,10 @@ void Game::addPlayerVocation(const std::shared_ptr<Player> &target) {
 
 void Game::addMagicEffect(const Position &pos, uint16_t effect) {
 	auto spectators = Spectators().find<Player>(pos, true);
-	addMagicEffect(spectators.data(), pos, effect);
+	addMagicEffect(spectators, pos, effect);
 }
 
-void Game::addMagicEffect(const CreatureVector &spectators, const Position &pos, uint16_t effect) {
+void Game::addMagicEffect(const Spectators &spectators, const Position &pos, uint16_t effect) {
 	for (const auto &spectator : spectators) {
 		if (const auto &tmpPlayer = spectator->getPlayer()) {
 			tmpPlayer->sendMagicEffect(pos, effect);
@@ -8239,10 +8263,10 @@ void Game::addMagicEffect(const CreatureVector &spectators, const Position &pos,
 
 void Game::removeMagicEffect(const Position &pos, uint16_t effect) {
 	auto spectators = Spectators().find<Player>(pos, true);
-	removeMagicEffect(spectators.data(), pos, effect);
+	removeMagicEffect(spectators, pos, effect);
 }
 
-void Game::removeMagicEffect(const CreatureVector &spectators, const Position &pos, uint16_t effect) {
+void Game::removeMagicEffect(const Spectators &spectators, const Position &pos, uint16_t effect) {
 	for (const auto &spectator : spectators) {
 		if (const auto &tmpPlayer = spectator->getPlayer()) {
 			tmpPlayer->removeMagicEffect(pos, effect);
@@ -8252,10 +8276,10 @@ void Game::removeMagicEffect(const CreatureVector &spectators, const Position &p
 
 void Game::addDistanceEffect(const Position &fromPos, const Position &toPos, uint16_t effect) {
 	auto spectators = Spectators().find<Player>(fromPos).find<Player>(toPos);
-	addDistanceEffect(spectators.data(), fromPos, toPos, effect);
+	addDistanceEffect(spectators, fromPos, toPos, effect);
 }
 
-void Game::addDistanceEffect(const CreatureVector &spectators, const Position &fromPos, const Position &toPos, uint16_t effect) {
+void Game::addDistanceEffect(const Spectators &spectators, const Position &fromPos, const Position &toPos, uint16_t effect) {
 	for (const auto &spectator : spectators) {
 		if (const auto &tmpPlayer = spectator->getPlayer()) {
 			tmpPlayer->sendDistanceShoot(fromPos, toPos, effect);
@@ -8761,198 +8785,22 @@ void Game::playerCyclopediaCharacterInfo(const std::shared_ptr<Player> &player,
 	}
 }
 
-std::string Game::generateHighscoreQuery(
-	const std::string &categoryName,
-	uint32_t page,
-	uint8_t entriesPerPage,
-	uint32_t vocation,
-	uint32_t playerGUID /*= 0*/
-) {
-	uint32_t startPage = (page - 1) * static_cast<uint32_t>(entriesPerPage);
-	uint32_t endPage = startPage + static_cast<uint32_t>(entriesPerPage);
-	std::string entriesStr = std::to_string(entriesPerPage);
-
-	if (categoryName.empty()) {
-		g_logger().error("Category name cannot be empty.");
-		return "";
-	}
-
-	std::string query = fmt::format(
-		"SELECT `id`, `name`, `level`, `vocation`, `points`, `rank`, `rn` AS `entries`, "
-	);
-
-	if (playerGUID != 0) {
-		query += fmt::format("(@ourRow DIV {0}) + 1 AS `page` FROM (", entriesStr);
-	} else {
-		query += fmt::format("{} AS `page` FROM (", page);
-	}
-
-	query += fmt::format(
-		"SELECT `id`, `name`, `level`, `vocation`, `{}` AS `points`, "
-		"@curRank := IF(@prevRank = `{}`, @curRank, IF(@prevRank := `{}`, @curRank + 1, @curRank + 1)) AS `rank`, "
-		"(@row := @row + 1) AS `rn`",
-		categoryName, categoryName, categoryName
-	);
-
-	if (playerGUID != 0) {
-		query += fmt::format(", @ourRow := IF(`id` = {}, @row - 1, @ourRow) AS `rw`", playerGUID);
-	}
-
-	query += fmt::format(
-		" FROM (SELECT `id`, `name`, `level`, `vocation`, `{}` FROM `players` `p`, "
-		"(SELECT @curRank := 0, @prevRank := NULL, @row := 0, @ourRow := 0) `r` "
-		"WHERE `group_id` < {} ORDER BY `{}` DESC) `t`",
-		categoryName, static_cast<int>(GROUP_TYPE_GAMEMASTER), categoryName
-	);
-
-	if (vocation != 0xFFFFFFFF) {
-		query += generateVocationConditionHighscore(vocation);
-	}
-
-	query += ") `T` WHERE ";
-
-	if (playerGUID != 0) {
-		query += fmt::format(
-			"`rn` > ((@ourRow DIV {0}) * {0}) AND `rn` <= (((@ourRow DIV {0}) * {0}) + {0})",
-			entriesStr
-		);
-	} else {
-		query += fmt::format("`rn` > {} AND `rn` <= {}", startPage, endPage);
-	}
-
-	return query;
-}
-
-std::string Game::generateVocationConditionHighscore(uint32_t vocation) {
-	std::ostringstream queryPart;
-	bool firstVocation = true;
-
-	const auto vocationsMap = g_vocations().getVocations();
-	for (const auto &it : vocationsMap) {
-		const auto &voc = it.second;
-		if (voc->getFromVocation() == vocation) {
-			if (firstVocation) {
-				queryPart << " WHERE `vocation` = " << voc->getId();
-				firstVocation = false;
-			} else {
-				queryPart << " OR `vocation` = " << voc->getId();
-			}
-		}
-	}
-
-	return queryPart.str();
-}
+void Game::playerHighscores(const std::shared_ptr<Player> &player, HighscoreType_t type, uint8_t category, uint32_t vocation, const std::string &, uint16_t page, uint8_t entriesPerPage) {
+	category = HighscoreRanking::normalizeCategory(category);
 
-void Game::processHighscoreResults(const DBResult_ptr &result, uint32_t playerID, uint8_t category, uint32_t vocation, uint8_t entriesPerPage) {
-	const auto &player = g_game().getPlayerByID(playerID);
-	if (!player) {
-		return;
+	std::optional<HighscoreRanking::Page> result;
+	if (type == HIGHSCORE_GETENTRIES) {
+		result = g_highscoreRanking().getPage(category, vocation, page, entriesPerPage);
+	} else if (type == HIGHSCORE_OURRANK) {
+		result = g_highscoreRanking().getPlayerPage(category, vocation, player->getGUID(), entriesPerPage);
 	}
 
-	player->resetAsyncOngoingTask(PlayerAsyncTask_Highscore);
-
 	if (!result) {
 		player->sendHighscoresNoData();
 		return;
 	}
 
-	auto page = result->getNumber<uint16_t>("page");
-	auto pages = result->getNumber<uint32_t>("entries");
-	pages += entriesPerPage - 1;
-	pages /= entriesPerPage;
-
-	std::ostringstream cacheKeyStream;
-	cacheKeyStream << "Highscore_" << static_cast<int>(category) << "_" << static_cast<int>(vocation) << "_" << static_cast<int>(entriesPerPage) << "_" << page;
-	std::string cacheKey = cacheKeyStream.str();
-
-	auto it = highscoreCache.find(cacheKey);
-	auto now = std::chrono::system_clock::now();
-	if (it != highscoreCache.end() && (now - it->second.timestamp < HIGHSCORE_CACHE_EXPIRATION_TIME)) {
-		auto &cacheEntry = it->second;
-		auto cachedTime = it->second.timestamp;
-		auto durationSinceEpoch = cachedTime.time_since_epoch();
-		auto secondsSinceEpoch = std::chrono::duration_cast<std::chrono::seconds>(durationSinceEpoch).count();
-		auto updateTimer = static_cast<uint32_t>(secondsSinceEpoch);
-		player->sendHighscores(cacheEntry.characters, category, vocation, cacheEntry.page, static_cast<uint16_t>(cacheEntry.entriesPerPage), updateTimer);
-	} else {
-		std::vector<HighscoreCharacter> characters;
-		characters.reserve(result->countResults());
-		if (result) {
-			do {
-				const auto &voc = g_vocations().getVocation(result->getNumber<uint16_t>("vocation"));
-				uint8_t characterVocation = voc ? voc->getClientId() : 0;
-				std::string loyaltyTitle; // todo get loyalty title from player
-				characters.emplace_back(std::move(result->getString("name")), result->getNumber<uint64_t>("points"), result->getNumber<uint32_t>("id"), result->getNumber<uint32_t>("rank"), result->getNumber<uint16_t>("level"), characterVocation, loyaltyTitle);
-			} while (result->next());
-		}
-
-		player->sendHighscores(characters, category, vocation, page, static_cast<uint16_t>(pages), getTimeNow());
-		highscoreCache[cacheKey] = { characters, page, pages, now };
-	}
-}
-
-void Game::cacheQueryHighscore(const std::string &key, const std::string &query, uint32_t page, uint8_t entriesPerPage) {
-	QueryHighscoreCacheEntry queryEntry { query, page, entriesPerPage, std::chrono::steady_clock::now() };
-	queryCache[key] = queryEntry;
-}
-
-std::string Game::generateHighscoreOrGetCachedQueryForEntries(const std::string &categoryName, uint32_t page, uint8_t entriesPerPage, uint32_t vocation) {
-	std::ostringstream cacheKeyStream;
-	cacheKeyStream << "Entries_" << categoryName << "_" << page << "_" << static_cast<int>(entriesPerPage) << "_" << vocation;
-	std::string cacheKey = cacheKeyStream.str();
-
-	if (queryCache.find(cacheKey) != queryCache.end()) {
-		const QueryHighscoreCacheEntry &cachedEntry = queryCache[cacheKey];
-		if (cachedEntry.page == page) {
-			return cachedEntry.query;
-		}
-	}
-
-	std::string newQuery = generateHighscoreQuery(categoryName, page, entriesPerPage, vocation);
-	cacheQueryHighscore(cacheKey, newQuery, page, entriesPerPage);
-
-	return newQuery;
-}
-
-std::string Game::generateHighscoreOrGetCachedQueryForOurRank(const std::string &categoryName, uint8_t entriesPerPage, uint32_t playerGUID, uint32_t vocation) {
-	std::ostringstream cacheKeyStream;
-	cacheKeyStream << "OurRank_" << categoryName << "_" << static_cast<int>(entriesPerPage) << "_" << playerGUID << "_" << vocation;
-	std::string cacheKey = cacheKeyStream.str();
-
-	if (queryCache.find(cacheKey) != queryCache.end()) {
-		const QueryHighscoreCacheEntry &cachedEntry = queryCache[cacheKey];
-		if (cachedEntry.page == entriesPerPage) {
-			return cachedEntry.query;
-		}
-	}
-
-	std::string newQuery = generateHighscoreQuery(categoryName, 0, entriesPerPage, vocation, playerGUID);
-	cacheQueryHighscore(cacheKey, newQuery, entriesPerPage, entriesPerPage);
-
-	return newQuery;
-}
-
-void Game::playerHighscores(const std::shared_ptr<Player> &player, HighscoreType_t type, uint8_t category, uint32_t vocation, const std::string &, uint16_t page, uint8_t entriesPerPage) {
-	if (player->hasAsyncOngoingTask(PlayerAsyncTask_Highscore)) {
-		return;
-	}
-
-	std::string categoryName = getSkillNameById(category);
-
-	std::string query;
-	if (type == HIGHSCORE_GETENTRIES) {
-		query = generateHighscoreOrGetCachedQueryForEntries(categoryName, page, entriesPerPage, vocation);
-	} else if (type == HIGHSCORE_OURRANK) {
-		query = generateHighscoreOrGetCachedQueryForOurRank(categoryName, entriesPerPage, player->getGUID(), vocation);
-	}
-
-	uint32_t playerID = player->getID();
-	std::function<void(DBResult_ptr, bool)> callback = [this, playerID, category, vocation, entriesPerPage](const DBResult_ptr &result, bool) {
-		processHighscoreResults(result, playerID, category, vocation, entriesPerPage);
-	};
-
-	g_databaseTasks().store(query, callback);
-	player->addAsyncOngoingTask(PlayerAsyncTask_Highscore);
+	player->sendHighscores(result->characters, category, vocation, result->page, result->pages, result->updatedAt);
 }
 
 std::string Game::getSkillNameById(uint8_t &skill) {
@@ -9376,7 +9224,7 @@ void Game::playerCreateMarketOffer(uint32_t playerId, uint8_t type, uint16_t ite
 		return;
 	}
 
-	IOMarket::createOffer(player->getGUID(), static_cast<MarketAction_t>(type), it.id, amount, price, tier, anonymous);
+	IOMarket::createOffer(player->getGUID(), player->getName(), static_cast<MarketAction_t>(type), it.id, amount, price, tier, anonymous);
 
 	const MarketOfferList &buyOffers = IOMarket::getActiveOffers(MARKETACTION_BUY, it.id, tier);
 	const MarketOfferList &sellOffers = IOMarket::getActiveOffers(MARKETACTION_SELL, it.id, tier);
@@ -9950,6 +9798,7 @@ void Game::playerSetMonsterPodium(uint32_t playerId, uint32_t monsterRaceId, con
 		item->removeAttribute(ItemAttribute_t::NAME);
 	}
 
+	tile->clearItemEncoding();
 	for (const auto &spectator : Spectators().find<Player>(pos, true)) {
 		spectator->getPlayer()->sendUpdateTileItem(tile, pos, item);
 	}
@@ -11249,6 +11098,7 @@ void Game::refreshItem(const std::shared_ptr<Item> &item) {
 		return;
 	}
 	if (const auto &tile = parent->getTile()) {
+		tile->clearItemEncoding();
 		const auto spectators = Spectators().find<Player>(tile->getPosition(), true);
 		// send to client
 		for (const auto &spectator : spectators) {
@@ -69,23 +69,8 @@ static constexpr int32_t EVENT_FORGEABLEMONSTERCHECKINTERVAL = 300000;
 static constexpr int32_t EVENT_LUA_GARBAGE_COLLECTION = 60000 * 10; // 10min
 
 static constexpr std::chrono::minutes CACHE_EXPIRATION_TIME { 10 }; // 10min
-static constexpr std::chrono::minutes HIGHSCORE_CACHE_EXPIRATION_TIME { 10 }; // 10min
 static constexpr int32_t UPDATE_PLAYERS_ONLINE_DB = 60000 * 10; // 10min
 
-struct QueryHighscoreCacheEntry {
-	std::string query;
-	uint32_t page;
-	uint8_t entriesPerPage;
-	std::chrono::time_point<std::chrono::steady_clock> timestamp;
-};
-
-struct HighscoreCacheEntry {
-	std::vector<HighscoreCharacter> characters;
-	uint32_t page;
-	uint32_t entriesPerPage;
-	std::chrono::time_point<std::chrono::system_clock> timestamp;
-};
-
 class Game {
 public:
 	Game();
@@ -108,11 +93,14 @@ public:
 	void logCyclopediaStats();
 
 	/**
-	 * Load the main map
-	 * \param filename Is the map custom name (Example: "map".otbm, not is necessary add extension .otbm)
-	 * \returns true if the custom map was loaded successfully
+	 * Read the tiles of the main map, only needs the item types to be loaded
+	 * \param filename Is the map name (Example: "map".otbm, not is necessary add extension .otbm)
 	 */
-	void loadMainMap(const std::string &filename);
+	void readMainMap(const std::string &filename);
+	/**
+	 * Load the houses, spawns and zones of the main map once it is read and the scripts are loaded
+	 */
+	void loadMainMap();
 	/**
 	 * Load the custom map
 	 * \param filename Is the map custom name (Example: "map".otbm, not is necessary add extension .otbm)
@@ -456,7 +444,7 @@ public:
 
 	// Hazard combat helpers
 	void handleHazardSystemAttack(CombatDamage &damage, const std::shared_ptr<Player> &player, const std::shared_ptr<Monster> &monster, bool isPlayerAttacker);
-	void notifySpectators(const CreatureVector &spectators, const Position &targetPos, const std::shared_ptr<Player> &attackerPlayer, const std::shared_ptr<Monster> &targetMonster);
+	void notifySpectators(const Spectators &spectators, const Position &targetPos, const std::shared_ptr<Player> &attackerPlayer, const std::shared_ptr<Monster> &targetMonster);
 
 	// Custom PvP System combat helpers
 	void applyPvPDamage(CombatDamage &damage, const std::shared_ptr<Player> &attacker, const std::shared_ptr<Player> &target);
@@ -482,15 +470,15 @@ public:
 
 	// Animation help functions
 	void addCreatureHealth(const std::shared_ptr<Creature> &target);
-	static void addCreatureHealth(const CreatureVector &spectators, const std::shared_ptr<Creature> &target);
+	static void addCreatureHealth(const Spectators &spectators, const std::shared_ptr<Creature> &target);
 	void addPlayerMana(const std::shared_ptr<Player> &target);
 	void addPlayerVocation(const std::shared_ptr<Player> &target);
 	void addMagicEffect(const Position &pos, uint16_t effect);
-	static void addMagicEffect(const CreatureVector &spectators, const Position &pos, uint16_t effect);
+	static void addMagicEffect(const Spectators &spectators, const Position &pos, uint16_t effect);
 	void removeMagicEffect(const Position &pos, uint16_t effect);
-	static void removeMagicEffect(const CreatureVector &spectators, const Position &pos, uint16_t effect);
+	static void removeMagicEffect(const Spectators &spectators, const Position &pos, uint16_t effect);
 	void addDistanceEffect(const Position &fromPos, const Position &toPos, uint16_t effect);
-	static void addDistanceEffect(const CreatureVector &spectators, const Position &fromPos, const Position &toPos, uint16_t effect);
+	static void addDistanceEffect(const Spectators &spectators, const Position &fromPos, const Position &toPos, uint16_t effect);
 
 	int32_t getLightHour() const {
 		return lightHour;
@@ -795,9 +783,6 @@ private:
 	 */
 	ReturnValue collectRewardChestItems(const std::shared_ptr<Player> &player, uint32_t maxMoveItems = 0);
 
-	phmap::flat_hash_map<std::string, QueryHighscoreCacheEntry> queryCache;
-	phmap::flat_hash_map<std::string, HighscoreCacheEntry> highscoreCache;
-
 	std::unordered_map<std::string, std::weak_ptr<Player>> m_deadPlayers;
 	phmap::parallel_flat_hash_map<uint32_t, std::shared_ptr<Player>> players;
 	phmap::flat_hash_map<std::string, std::weak_ptr<Player>> mappedPlayerNames;
@@ -887,20 +872,20 @@ private:
 	void sendDamageMessageAndEffects(
 		const std::shared_ptr<Creature> &attacker, const std::shared_ptr<Creature> &target, const CombatDamage &damage, const Position &targetPos,
 		const std::shared_ptr<Player> &attackerPlayer, const std::shared_ptr<Player> &targetPlayer, TextMessage &message,
-		const CreatureVector &spectators, int32_t realDamage
+		const Spectators &spectators, int32_t realDamage
 	);
 
 	void updatePlayerPartyHuntAnalyzer(const CombatDamage &damage, const std::shared_ptr<Player> &player) const;
 
 	void sendEffects(
 		const std::shared_ptr<Creature> &target, const CombatDamage &damage, const Position &targetPos,
-		TextMessage &message, const CreatureVector &spectators
+		TextMessage &message, const Spectators &spectators
 	);
 
 	void sendMessages(
 		const std::shared_ptr<Creature> &attacker, const std::shared_ptr<Creature> &target, const CombatDamage &damage,
 		const Position &targetPos, const std::shared_ptr<Player> &attackerPlayer, const std::shared_ptr<Player> &targetPlayer,
-		TextMessage &message, const CreatureVector &spectators, int32_t realDamage
+		TextMessage &message, const Spectators &spectators, int32_t realDamage
 	) const;
 
 	bool shouldSendMessage(const TextMessage &message) const;
@@ -929,20 +914,6 @@ private:
 
 	std::unique_ptr<AttachedEffects> m_attachedEffects;
 
-	void cacheQueryHighscore(const std::string &key, const std::string &query, uint32_t page, uint8_t entriesPerPage);
-	void processHighscoreResults(const DBResult_ptr &result, uint32_t playerID, uint8_t category, uint32_t vocation, uint8_t entriesPerPage);
-
-	std::string generateVocationConditionHighscore(uint32_t vocation);
-	std::string generateHighscoreQuery(
-		const std::string &categoryName,
-		uint32_t page,
-		uint8_t entriesPerPage,
-		uint32_t vocation,
-		uint32_t playerGUID = 0
-	);
-	std::string generateHighscoreOrGetCachedQueryForEntries(const std::string &categoryName, uint32_t page, uint8_t entriesPerPage, uint32_t vocation);
-	std::string generateHighscoreOrGetCachedQueryForOurRank(const std::string &categoryName, uint8_t entriesPerPage, uint32_t playerGUID, uint32_t vocation);
-
 	void updatePlayersOnline() const;
 };
 
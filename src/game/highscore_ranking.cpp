@@ -0,0 +1,307 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "game/highscore_ranking.hpp"
+
+#include "creatures/players/grouping/groups.hpp"
+#include "creatures/players/player.hpp"
+#include "creatures/players/vocations/vocation.hpp"
+#include "database/database.hpp"
+#include "enums/account_group_type.hpp"
+#include "game/game.hpp"
+#include "lib/di/container.hpp"
+
+namespace {
+	// Categories in the order of Entry::points
+	constexpr std::array<HighscoreCategories_t, HighscoreRanking::CATEGORIES> RANKED_CATEGORIES {
+		HighscoreCategories_t::EXPERIENCE,
+		HighscoreCategories_t::FIST_FIGHTING,
+		HighscoreCategories_t::CLUB_FIGHTING,
+		HighscoreCategories_t::SWORD_FIGHTING,
+		HighscoreCategories_t::AXE_FIGHTING,
+		HighscoreCategories_t::DISTANCE_FIGHTING,
+		HighscoreCategories_t::SHIELDING,
+		HighscoreCategories_t::FISHING,
+		HighscoreCategories_t::MAGIC_LEVEL,
+		HighscoreCategories_t::BOSS_POINTS,
+	};
+}
+
+HighscoreRanking &HighscoreRanking::getInstance() {
+	return inject<HighscoreRanking>();
+}
+
+size_t HighscoreRanking::categoryIndex(uint8_t category) {
+	for (size_t index = 0; index < CATEGORIES; ++index) {
+		if (static_cast<uint8_t>(RANKED_CATEGORIES[index]) == category) {
+			return index;
+		}
+	}
+	return 0;
+}
+
+uint8_t HighscoreRanking::normalizeCategory(uint8_t category) {
+	return static_cast<uint8_t>(RANKED_CATEGORIES[categoryIndex(category)]);
+}
+
+void HighscoreRanking::load() {
+	std::string columns;
+	for (const auto category : RANKED_CATEGORIES) {
+		auto skill = static_cast<uint8_t>(category);
+		columns += fmt::format(", `{}`", Game::getSkillNameById(skill));
+	}
+
+	const auto result = g_database().storeQuery(
+		fmt::format("SELECT `id`, `name`, `level`, `vocation`{} FROM `players` WHERE `group_id` < ?", columns),
+		{ static_cast<int32_t>(GROUP_TYPE_GAMEMASTER) }
+	);
+
+	phmap::flat_hash_map<uint32_t, Entry> loaded;
+	if (result) {
+		const auto firstPoints = result->getColumnIndex("vocation") + 1;
+		do {
+			Entry entry;
+			entry.id = result->getNumber<uint32_t>("id");
+			entry.name = result->getString("name");
+			entry.level = result->getNumber<uint16_t>("level");
+			if (const auto &vocation = g_vocations().getVocation(result->getNumber<uint16_t>("vocation"))) {
+				entry.clientVocation = vocation->getClientId();
+				entry.baseVocation = vocation->getFromVocation();
+			}
+			for (size_t index = 0; index < CATEGORIES; ++index) {
+				entry.points[index] = result->getNumber<uint64_t>(firstPoints + index);
+			}
+			loaded.try_emplace(entry.id, std::move(entry));
+		} while (result->next());
+	}
+
+	std::scoped_lock lock(mutex);
+	entries = std::move(loaded);
+	pending.clear();
+	rebuildLocked();
+	g_logger().info("Loaded {} players into the highscores", entries.size());
+}
+
+void HighscoreRanking::update(Entry entry) {
+	std::scoped_lock lock(mutex);
+	const auto id = entry.id;
+	pending.insert_or_assign(id, std::move(entry));
+}
+
+void HighscoreRanking::update(const Player &player) {
+	const auto &group = player.getGroup();
+	if (group && group->id >= GROUP_TYPE_GAMEMASTER) {
+		remove(player.getGUID());
+		return;
+	}
+
+	Entry entry;
+	entry.id = player.getGUID();
+	entry.name = player.getName();
+	entry.level = static_cast<uint16_t>(player.getLevel());
+	if (const auto &vocation = player.getVocation()) {
+		entry.clientVocation = vocation->getClientId();
+		entry.baseVocation = vocation->getFromVocation();
+	}
+	entry.points[0] = player.getExperience();
+	for (uint8_t skill = SKILL_FIST; skill <= SKILL_FISHING; ++skill) {
+		entry.points[skill + 1] = player.getBaseSkill(skill);
+	}
+	entry.points[8] = player.getBaseMagicLevel();
+	entry.points[9] = player.getBossPoints();
+	update(std::move(entry));
+}
+
+void HighscoreRanking::remove(uint32_t playerId) {
+	std::scoped_lock lock(mutex);
+	pending.insert_or_assign(playerId, std::nullopt);
+}
+
+void HighscoreRanking::refresh() {
+	std::scoped_lock lock(mutex);
+	refreshLocked(true);
+}
+
+void HighscoreRanking::updateRanks(Ranks &list, size_t from) {
+	// Dense ranks, players with the same points share one and the next points take the following
+	for (size_t position = from; position < list.size(); ++position) {
+		list[position].rank = position == 0 ? 1 : list[position - 1].rank + (list[position - 1].points != list[position].points ? 1 : 0);
+	}
+}
+
+void HighscoreRanking::refreshLocked(bool force) {
+	const auto now = std::chrono::system_clock::now();
+	if (pending.empty() || (!force && now - updatedAt < REFRESH_INTERVAL)) {
+		return;
+	}
+
+	// Moving a few players is cheaper than sorting everyone again, past that the lists are rebuilt
+	if (pending.size() * 8 > entries.size()) {
+		for (auto &[id, entry] : pending) {
+			if (entry) {
+				entries.insert_or_assign(id, std::move(*entry));
+			} else {
+				entries.erase(id);
+			}
+		}
+		pending.clear();
+		rebuildLocked();
+		return;
+	}
+
+	for (const auto &[id, entry] : pending) {
+		applyLocked(id, entry);
+	}
+	pending.clear();
+
+	for (const auto &[key, from] : outdated) {
+		updateRanks(ranks[key.first][key.second], from);
+	}
+	outdated.clear();
+	updatedAt = now;
+}
+
+void HighscoreRanking::rebuildLocked() {
+	for (auto &lists : ranks) {
+		lists.clear();
+	}
+
+	for (const auto &[id, entry] : entries) {
+		for (size_t category = 0; category < CATEGORIES; ++category) {
+			const Rank rank { entry.points[category], id };
+			ranks[category][ALL_VOCATIONS].emplace_back(rank);
+			ranks[category][entry.baseVocation].emplace_back(rank);
+		}
+	}
+
+	for (auto &lists : ranks) {
+		for (auto &[vocation, list] : lists) {
+			std::sort(list.begin(), list.end(), before);
+			updateRanks(list, 0);
+		}
+	}
+
+	outdated.clear();
+	updatedAt = std::chrono::system_clock::now();
+}
+
+void HighscoreRanking::applyLocked(uint32_t id, const std::optional<Entry> &entry) {
+	const auto it = entries.find(id);
+	if (it != entries.end()) {
+		for (size_t category = 0; category < CATEGORIES; ++category) {
+			const Rank rank { it->second.points[category], id };
+			eraseLocked(category, ALL_VOCATIONS, rank);
+			eraseLocked(category, it->second.baseVocation, rank);
+		}
+	}
+
+	if (!entry) {
+		if (it != entries.end()) {
+			entries.erase(it);
+		}
+		return;
+	}
+
+	for (size_t category = 0; category < CATEGORIES; ++category) {
+		const Rank rank { entry->points[category], id };
+		insertLocked(category, ALL_VOCATIONS, rank);
+		insertLocked(category, entry->baseVocation, rank);
+	}
+	entries.insert_or_assign(id, *entry);
+}
+
+void HighscoreRanking::eraseLocked(size_t category, uint32_t vocation, const Rank &rank) {
+	auto &list = ranks[category][vocation];
+	const auto it = std::lower_bound(list.begin(), list.end(), rank, before);
+	if (it == list.end() || it->id != rank.id) {
+		return;
+	}
+
+	const auto position = static_cast<size_t>(it - list.begin());
+	list.erase(it);
+	auto [outdatedIt, inserted] = outdated.try_emplace({ category, vocation }, position);
+	outdatedIt->second = std::min(outdatedIt->second, position);
+}
+
+void HighscoreRanking::insertLocked(size_t category, uint32_t vocation, const Rank &rank) {
+	auto &list = ranks[category][vocation];
+	const auto it = list.insert(std::lower_bound(list.begin(), list.end(), rank, before), rank);
+
+	const auto position = static_cast<size_t>(it - list.begin());
+	auto [outdatedIt, inserted] = outdated.try_emplace({ category, vocation }, position);
+	outdatedIt->second = std::min(outdatedIt->second, position);
+}
+
+std::optional<HighscoreRanking::Page> HighscoreRanking::getPage(uint8_t category, uint32_t vocation, uint16_t page, uint8_t entriesPerPage) {
+	std::scoped_lock lock(mutex);
+	refreshLocked(false);
+
+	const auto &lists = ranks[categoryIndex(category)];
+	const auto it = lists.find(vocation);
+	if (it == lists.end()) {
+		return std::nullopt;
+	}
+	return makePageLocked(it->second, page, entriesPerPage);
+}
+
+std::optional<HighscoreRanking::Page> HighscoreRanking::getPlayerPage(uint8_t category, uint32_t vocation, uint32_t playerId, uint8_t entriesPerPage) {
+	std::scoped_lock lock(mutex);
+	refreshLocked(false);
+
+	const auto index = categoryIndex(category);
+	const auto &lists = ranks[index];
+	const auto it = lists.find(vocation);
+	if (it == lists.end() || entriesPerPage == 0) {
+		return std::nullopt;
+	}
+
+	uint16_t page = 1;
+	const auto entryIt = entries.find(playerId);
+	if (entryIt != entries.end()) {
+		const auto &list = it->second;
+		const Rank rank { entryIt->second.points[index], playerId };
+		const auto rankIt = std::lower_bound(list.begin(), list.end(), rank, before);
+		if (rankIt != list.end() && rankIt->id == playerId) {
+			page = static_cast<uint16_t>(static_cast<size_t>(rankIt - list.begin()) / entriesPerPage + 1);
+		}
+	}
+	return makePageLocked(it->second, page, entriesPerPage);
+}
+
+std::optional<HighscoreRanking::Page> HighscoreRanking::makePageLocked(const Ranks &list, uint16_t page, uint8_t entriesPerPage) const {
+	if (entriesPerPage == 0 || page == 0) {
+		return std::nullopt;
+	}
+
+	const size_t pages = (list.size() + entriesPerPage - 1) / entriesPerPage;
+	if (page > pages) {
+		return std::nullopt;
+	}
+
+	Page result;
+	result.page = page;
+	result.pages = static_cast<uint16_t>(std::min<size_t>(pages, std::numeric_limits<uint16_t>::max()));
+	result.updatedAt = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::seconds>(updatedAt.time_since_epoch()).count());
+
+	const size_t first = static_cast<size_t>(page - 1) * entriesPerPage;
+	const size_t last = std::min(first + entriesPerPage, list.size());
+	result.characters.reserve(last - first);
+	for (size_t position = first; position < last; ++position) {
+		const auto &rank = list[position];
+		const auto &entry = entries.at(rank.id);
+		std::string loyaltyTitle; // todo get loyalty title from player
+		result.characters.emplace_back(entry.name, rank.points, rank.id, rank.rank, entry.level, entry.clientVocation, loyaltyTitle);
+	}
+	return result;
+}
+
+size_t HighscoreRanking::size() const {
+	std::scoped_lock lock(mutex);
+	return entries.size();
+}
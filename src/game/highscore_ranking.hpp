@@ -0,0 +1,129 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "game/game_definitions.hpp"
+#include "server/server_definitions.hpp"
+
+#ifndef USE_PRECOMPILED_HEADERS
+	#include <parallel_hashmap/phmap.h>
+	#include <array>
+	#include <chrono>
+	#include <limits>
+	#include <map>
+	#include <mutex>
+	#include <optional>
+	#include <string>
+	#include <vector>
+#endif
+
+class Player;
+
+/**
+ * Highscores served from memory instead of ordering the players table for every page.
+ *
+ * Every ranked category keeps one list for all vocations and one per base vocation, sorted by points
+ * with the dense rank of each entry stored alongside, so a page is a slice and a player's rank a binary search.
+ * Players are loaded once at startup and then updated as they advance or are saved. Updates are queued
+ * and applied to the lists at most once every REFRESH_INTERVAL, when the highscores are next viewed.
+ */
+class HighscoreRanking {
+public:
+	static constexpr uint32_t ALL_VOCATIONS = std::numeric_limits<uint32_t>::max();
+	static constexpr std::chrono::seconds REFRESH_INTERVAL { 60 };
+
+	// Experience, the skills from fist fighting to magic level and boss points
+	static constexpr size_t CATEGORIES = 10;
+
+	struct Entry {
+		uint32_t id = 0;
+		std::string name;
+		uint16_t level = 0;
+		uint8_t clientVocation = 0;
+		// The vocation the client filters by, the one the player's vocation was promoted from
+		uint32_t baseVocation = 0;
+		std::array<uint64_t, CATEGORIES> points {};
+	};
+
+	struct Page {
+		std::vector<HighscoreCharacter> characters;
+		uint16_t page = 0;
+		uint16_t pages = 0;
+		uint32_t updatedAt = 0;
+	};
+
+	HighscoreRanking() = default;
+
+	// Singleton - ensures we don't accidentally copy it.
+	HighscoreRanking(const HighscoreRanking &) = delete;
+	void operator=(const HighscoreRanking &) = delete;
+
+	static HighscoreRanking &getInstance();
+
+	/**
+	 * @brief Categories without a ranking fall back to experience, as the client expects.
+	 */
+	static uint8_t normalizeCategory(uint8_t category);
+
+	/**
+	 * @brief Replaces the ranking with every player below the gamemaster group.
+	 */
+	void load();
+
+	void update(Entry entry);
+	void update(const Player &player);
+	void remove(uint32_t playerId);
+
+	/**
+	 * @brief Applies the queued updates right away.
+	 */
+	void refresh();
+
+	// Pages are numbered from 1, nothing is returned for an empty ranking or a page past its end
+	std::optional<Page> getPage(uint8_t category, uint32_t vocation, uint16_t page, uint8_t entriesPerPage);
+	// The page holding the player, or the first one if the player is not ranked
+	std::optional<Page> getPlayerPage(uint8_t category, uint32_t vocation, uint32_t playerId, uint8_t entriesPerPage);
+
+	size_t size() const;
+
+private:
+	struct Rank {
+		uint64_t points = 0;
+		uint32_t id = 0;
+		uint32_t rank = 0;
+	};
+
+	// Most points first, ties by id
+	using Ranks = std::vector<Rank>;
+
+	static size_t categoryIndex(uint8_t category);
+	static void updateRanks(Ranks &list, size_t from);
+	static bool before(const Rank &lhs, const Rank &rhs) {
+		return lhs.points != rhs.points ? lhs.points > rhs.points : lhs.id < rhs.id;
+	}
+
+	void refreshLocked(bool force);
+	void rebuildLocked();
+	void applyLocked(uint32_t id, const std::optional<Entry> &entry);
+	void eraseLocked(size_t category, uint32_t vocation, const Rank &rank);
+	void insertLocked(size_t category, uint32_t vocation, const Rank &rank);
+	std::optional<Page> makePageLocked(const Ranks &ranks, uint16_t page, uint8_t entriesPerPage) const;
+
+	mutable std::mutex mutex;
+	phmap::flat_hash_map<uint32_t, Entry> entries;
+	// Queued changes by player, nullopt removes the player
+	phmap::flat_hash_map<uint32_t, std::optional<Entry>> pending;
+	std::array<phmap::flat_hash_map<uint32_t, Ranks>, CATEGORIES> ranks;
+	// First position whose rank is outdated in each list touched by an update
+	std::map<std::pair<size_t, uint32_t>, size_t> outdated;
+	std::chrono::system_clock::time_point updatedAt;
+};
+
+constexpr auto g_highscoreRanking = HighscoreRanking::getInstance;
@@ -11,6 +11,7 @@
 
 #include "lib/thread/thread_pool.hpp"
 #include "lib/di/container.hpp"
+#include "lib/metrics/metrics.hpp"
 #include "utils/tools.hpp"
 
 thread_local DispatcherContext Dispatcher::dispacherContext;
@@ -69,12 +70,20 @@ void Dispatcher::executeSerialEvents(const uint8_t groupId) {
 }
 
 void Dispatcher::executeParallelEvents(const uint8_t groupId) {
+	if (workStealing) {
+		executeStealingEvents(groupId);
+		return;
+	}
+
 	auto &tasks = m_tasks[groupId];
 	if (tasks.empty()) {
 		return;
 	}
 
-	asyncWait(tasks.size(), [groupId, &tasks](size_t i) {
+	Benchmark bm_parallel;
+	const auto size = tasks.size();
+
+	asyncWait(size, [groupId, &tasks](size_t i) {
 		dispacherContext.type = DispatcherType::AsyncEvent;
 		dispacherContext.group = static_cast<TaskGroup>(groupId);
 		tasks[i].execute();
@@ -83,6 +92,107 @@ void Dispatcher::executeParallelEvents(const uint8_t groupId) {
 	});
 
 	tasks.clear();
+
+	logParallelThroughput(groupId, size, bm_parallel.duration(), "merge");
+}
+
+void Dispatcher::executeStealingEvents(const uint8_t groupId) {
+	auto &pending = pendingStealingTasks[groupId];
+	const auto size = pending.load(std::memory_order_acquire);
+	if (size == 0) {
+		return;
+	}
+
+	// Closes the current phase: whatever is published from now on, including by the tasks below, waits for the next cycle.
+	const auto phase = stealingPhase[groupId].fetch_add(1, std::memory_order_acq_rel);
+
+	Benchmark bm_parallel;
+	std::atomic_uint_fast32_t executed = 0;
+
+	const auto worker = [this, groupId, phase, &pending, &executed] {
+		dispacherContext.type = DispatcherType::AsyncEvent;
+		dispacherContext.group = static_cast<TaskGroup>(groupId);
+
+		const size_t ownThreadId = ThreadPool::getThreadId();
+		while (pending.load(std::memory_order_acquire) > 0) {
+			auto task = popOrStealTask(groupId, ownThreadId, phase);
+			if (!task) {
+				// The remaining tasks are being held by another worker or belong to the next phase.
+				break;
+			}
+
+			task->execute();
+			executed.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		dispacherContext.reset();
+	};
+
+	// Nested asyncWait calls made by the tasks must run inline, just like in the merge model.
+	asyncWaitDisabled = true;
+
+	const auto workers = std::min<size_t>(size, threadPool.get_thread_count());
+	BS::multi_future<void> retFuture;
+	if (workers > 1) {
+		retFuture = threadPool.submit_loop(1, workers, [&worker](const unsigned int) { worker(); });
+	}
+
+	worker();
+
+	if (workers > 1) {
+		retFuture.wait();
+	}
+
+	asyncWaitDisabled = false;
+
+	logParallelThroughput(groupId, executed.load(), bm_parallel.duration(), "work-stealing");
+}
+
+std::optional<Task> Dispatcher::popOrStealTask(const uint8_t groupId, const size_t ownThreadId, const uint_fast32_t phase) {
+	// Phases wrap around, so compare them by distance rather than by value.
+	const auto belongsToPhase = [phase](const auto &entry) {
+		return static_cast<int32_t>(static_cast<uint32_t>(entry.first - phase)) <= 0;
+	};
+
+	const auto size = threads.size();
+	for (size_t i = 0; i < size; ++i) {
+		const auto threadId = (ownThreadId + i) % size;
+		auto &queue = threads[threadId]->stealingTasks[groupId];
+
+		std::scoped_lock lock(queue.mutex);
+		if (queue.tasks.empty() || !belongsToPhase(queue.tasks.front())) {
+			// The deque is ordered by phase, so if its front is not ours to run, nothing in it is.
+			continue;
+		}
+
+		// LIFO for the owner (hot cache), FIFO for the thieves.
+		std::optional<Task> task;
+		if (i == 0 && belongsToPhase(queue.tasks.back())) {
+			task.emplace(std::move(queue.tasks.back().second));
+			queue.tasks.pop_back();
+		} else {
+			task.emplace(std::move(queue.tasks.front().second));
+			queue.tasks.pop_front();
+		}
+
+		pendingStealingTasks[groupId].fetch_sub(1, std::memory_order_release);
+		return task;
+	}
+
+	return std::nullopt;
+}
+
+void Dispatcher::logParallelThroughput(const uint8_t groupId, const size_t executed, const double durationMs, std::string_view mode) {
+	if (executed == 0) {
+		return;
+	}
+
+	const auto groupName = magic_enum::enum_name(static_cast<TaskGroup>(groupId));
+	g_metrics().addCounter("dispatcher_parallel_tasks", static_cast<double>(executed), { { "group", std::string(groupName) }, { "mode", std::string(mode) } });
+
+	if (durationMs > 0) {
+		g_logger().trace("[Dispatcher::executeParallelEvents] - {} executed {} tasks in {:.3f} ms ({:.0f} tasks/s) using {} model", groupName, executed, durationMs, executed / (durationMs / 1000), mode);
+	}
 }
 
 void Dispatcher::asyncWait(size_t requestSize, std::function<void(size_t i)> &&f) {
@@ -138,13 +248,8 @@ void Dispatcher::executeEvents(const TaskGroup startGroup) {
 void Dispatcher::executeScheduledEvents() {
 	auto &threadScheduledTasks = getThreadTask()->scheduledTasks;
 
-	auto it = scheduledTasks.begin();
-	while (it != scheduledTasks.end()) {
-		const auto &task = *it;
-		if (task->getTime() > OTSYS_TIME()) {
-			break;
-		}
-
+	scheduledTasks.advance(OTSYS_TIME());
+	while (const auto task = scheduledTasks.popReady(OTSYS_TIME())) {
 		dispacherContext.type = task->isCycle() ? DispatcherType::CycleEvent : DispatcherType::ScheduledEvent;
 		dispacherContext.group = TaskGroup::Serial;
 		dispacherContext.taskName = task->getContext();
@@ -155,12 +260,6 @@ void Dispatcher::executeScheduledEvents() {
 		} else {
 			scheduledTasksRef.erase(task->getId());
 		}
-
-		++it;
-	}
-
-	if (it != scheduledTasks.begin()) {
-		scheduledTasks.erase(scheduledTasks.begin(), it);
 	}
 
 	dispacherContext.reset();
@@ -187,7 +286,9 @@ void Dispatcher::__mergeEvents(const std::array<uint8_t, 2> &groups, const bool
 		}
 
 		if (mergeScheduledEvents && !thread->scheduledTasks.empty()) {
-			scheduledTasks.insert(make_move_iterator(thread->scheduledTasks.begin()), make_move_iterator(thread->scheduledTasks.end()));
+			for (const auto &task : thread->scheduledTasks) {
+				scheduledTasks.insert(task);
+			}
 			thread->scheduledTasks.clear();
 		}
 	}
@@ -195,6 +296,11 @@ void Dispatcher::__mergeEvents(const std::array<uint8_t, 2> &groups, const bool
 
 // Merge only async thread events with main dispatch events
 void Dispatcher::mergeAsyncEvents() {
+	// With work stealing the parallel groups are consumed straight from the thread deques.
+	if (workStealing) {
+		return;
+	}
+
 	static constexpr auto groups = std::to_array({ static_cast<uint8_t>(TaskGroup::WalkParallel), static_cast<uint8_t>(TaskGroup::GenericParallel) });
 	__mergeEvents(groups, false);
 }
@@ -207,16 +313,7 @@ void Dispatcher::mergeEvents() {
 }
 
 std::chrono::milliseconds Dispatcher::timeUntilNextScheduledTask() const {
-	constexpr auto CHRONO_0 = std::chrono::milliseconds(0);
-	constexpr auto CHRONO_MILI_MAX = std::chrono::milliseconds::max();
-
-	if (scheduledTasks.empty()) {
-		return CHRONO_MILI_MAX;
-	}
-
-	const auto &task = *scheduledTasks.begin();
-	const auto timeRemaining = std::chrono::milliseconds(task->getTime() - OTSYS_TIME());
-	return std::max<std::chrono::milliseconds>(timeRemaining, CHRONO_0);
+	return scheduledTasks.timeUntilNextTask(OTSYS_TIME());
 }
 
 void Dispatcher::addEvent(std::function<void(void)> &&f, std::string_view context, uint32_t expiresAfterMs) {
@@ -263,6 +360,20 @@ void Dispatcher::asyncEvent(std::function<void(void)> &&f, TaskGroup group) {
 	}
 
 	const auto &thread = getThreadTask();
+	if (workStealing && isParallelGroup(group)) {
+		const auto groupId = static_cast<uint8_t>(group);
+		auto &queue = thread->stealingTasks[groupId];
+
+		// Counted before it is published, so a worker that takes it can never drive the counter below zero.
+		pendingStealingTasks[groupId].fetch_add(1, std::memory_order_release);
+		{
+			std::scoped_lock lock(queue.mutex);
+			queue.tasks.emplace_back(stealingPhase[groupId].load(std::memory_order_acquire), Task(0, std::move(f), dispacherContext.taskName));
+		}
+		notify();
+		return;
+	}
+
 	std::scoped_lock lock(thread->mutex);
 	thread->tasks[static_cast<uint8_t>(group)].emplace_back(0, std::move(f), dispacherContext.taskName);
 	notify();
@@ -10,11 +10,15 @@
 #pragma once
 
 #include "task.hpp"
+#include "timer_wheel.hpp"
 #include "lib/thread/thread_pool.hpp"
+#include "server/server.hpp"
 
 static constexpr uint16_t DISPATCHER_TASK_EXPIRATION = 2000;
 static constexpr uint16_t SCHEDULER_MINTICKS = 50;
 
+static_assert(TimerWheel::TICK_MS == SCHEDULER_MINTICKS, "The timer wheel tick must match the scheduler min ticks");
+
 enum class TaskGroup : int8_t {
 	ThreadPool = -1,
 	Walk,
@@ -78,9 +82,12 @@ private:
  */
 class Dispatcher {
 public:
+	// Threads adding events besides those of the pool: the main one, which also runs the network, and the extra network I/O ones
+	static constexpr uint_fast16_t EXTERNAL_THREADS = ServiceManager::MAX_IO_THREADS + 1;
+
 	explicit Dispatcher(ThreadPool &threadPool) :
 		threadPool(threadPool) {
-		threads.reserve(threadPool.get_thread_count() + 1);
+		threads.reserve(threadPool.get_thread_count() + EXTERNAL_THREADS);
 		for (uint_fast16_t i = 0; i < threads.capacity(); ++i) {
 			threads.emplace_back(std::make_unique<ThreadTask>());
 		}
@@ -139,6 +146,23 @@ public:
 		return dispatcherCycle;
 	}
 
+	/**
+	 * @brief Switches the parallel groups (WalkParallel and GenericParallel) to the work-stealing model.
+	 *
+	 * In this mode async events are pushed into a per-thread deque instead of the thread vectors,
+	 * so the dispatcher no longer merges them into m_tasks every cycle nor partitions them statically.
+	 * Each worker drains its own deque first and then steals from the other threads.
+	 *
+	 * @note Must be set during startup, before any parallel event is dispatched.
+	 */
+	void setWorkStealing(bool enabled) {
+		workStealing = enabled;
+	}
+
+	[[nodiscard]] bool isWorkStealing() const {
+		return workStealing;
+	}
+
 	void stopEvent(uint64_t eventId);
 
 	const auto &context() const {
@@ -153,7 +177,7 @@ private:
 	}
 
 	uint64_t scheduleEvent(uint32_t delay, std::function<void(void)> &&f, std::string_view context, bool cycle, bool log = true) {
-		return scheduleEvent(std::make_shared<Task>(std::move(f), context, delay, cycle, log));
+		return scheduleEvent(Task::create(std::move(f), context, delay, cycle, log));
 	}
 
 	void init();
@@ -171,18 +195,25 @@ private:
 
 	inline void executeSerialEvents(const uint8_t groupId);
 	inline void executeParallelEvents(const uint8_t groupId);
+	inline void executeStealingEvents(const uint8_t groupId);
+	inline std::optional<Task> popOrStealTask(const uint8_t groupId, const size_t ownThreadId, const uint_fast32_t phase);
+	void logParallelThroughput(const uint8_t groupId, const size_t executed, const double durationMs, std::string_view mode);
 	inline std::chrono::milliseconds timeUntilNextScheduledTask() const;
 
 	inline void checkPendingTasks() {
 		hasPendingTasks = false;
 		for (uint_fast8_t i = 0; i < static_cast<uint8_t>(TaskGroup::Last); ++i) {
-			if (!m_tasks[i].empty()) {
+			if (!m_tasks[i].empty() || pendingStealingTasks[i] > 0) {
 				hasPendingTasks = true;
 				break;
 			}
 		}
 	}
 
+	static constexpr bool isParallelGroup(const TaskGroup group) {
+		return group == TaskGroup::WalkParallel || group == TaskGroup::GenericParallel;
+	}
+
 	void notify() {
 		if (!hasPendingTasks) {
 			hasPendingTasks = true;
@@ -225,20 +256,34 @@ private:
 		std::array<std::vector<Task>, static_cast<uint8_t>(TaskGroup::Last)> tasks;
 		std::vector<std::shared_ptr<Task>> scheduledTasks;
 		std::mutex mutex;
+
+		// Work-stealing deques, the owner thread pushes/pops at the back and thieves take from the front.
+		// Each task carries the phase it was published in, so a phase never runs what was added while it ran.
+		struct StealingQueue {
+			std::deque<std::pair<uint_fast32_t, Task>> tasks;
+			std::mutex mutex;
+		};
+
+		std::array<StealingQueue, static_cast<uint8_t>(TaskGroup::Last)> stealingTasks;
 	};
 
 	std::vector<std::unique_ptr<ThreadTask>> threads;
 
 	// Main Events
 	std::array<std::vector<Task>, static_cast<uint8_t>(TaskGroup::Last)> m_tasks;
-	phmap::btree_multiset<std::shared_ptr<Task>, Task::Compare> scheduledTasks {};
+	TimerWheel scheduledTasks;
 	phmap::parallel_flat_hash_map_m<uint64_t, std::shared_ptr<Task>> scheduledTasksRef {};
 
+	std::array<std::atomic_uint_fast32_t, static_cast<uint8_t>(TaskGroup::Last)> pendingStealingTasks {};
+	std::array<std::atomic_uint_fast32_t, static_cast<uint8_t>(TaskGroup::Last)> stealingPhase {};
+
 	bool asyncWaitDisabled = false;
+	std::atomic_bool workStealing = false;
 
 	bool shuttingDown = false;
 
 	friend class CanaryServer;
+	friend class DispatcherBenchmark;
 };
 
 constexpr auto g_dispatcher = Dispatcher::getInstance;
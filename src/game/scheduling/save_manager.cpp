@@ -152,7 +152,8 @@ bool SaveManager::doSavePlayer(std::shared_ptr<Player> player) {
 	}
 
 	auto duration = bm_savePlayer.duration();
-	logger.debug("Saving player {} took {} milliseconds.", player->getName(), duration);
+	const auto &saveState = player->saveState();
+	logger.debug("Saving player {} took {} milliseconds, skipped {} unchanged rows ({} bytes).", player->getName(), duration, saveState.getSkippedRows(), saveState.getSkippedBytes());
 	return saveSuccess;
 }
 
@@ -11,6 +11,7 @@
 
 #include "lib/metrics/metrics.hpp"
 
+#include "utils/lockfree.hpp"
 #include "utils/tools.hpp"
 
 std::atomic_uint_fast64_t Task::LAST_EVENT_ID = 0;
@@ -37,6 +38,10 @@ Task::Task(std::function<void(void)> &&f, std::string_view context, uint32_t del
 	assert(!this->context.empty() && "Context cannot be empty!");
 }
 
+std::shared_ptr<Task> Task::create(std::function<void(void)> &&f, std::string_view context, uint32_t delay, bool cycle /* = false*/, bool log /*= true*/) {
+	return std::allocate_shared<Task>(LockfreePoolingAllocator<Task, TASK_FREE_LIST_CAPACITY>(), std::move(f), context, delay, cycle, log);
+}
+
 [[nodiscard]] bool Task::hasExpired() const {
 	return expiration != 0 && expiration < OTSYS_TIME();
 }
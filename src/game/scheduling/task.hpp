@@ -11,6 +11,8 @@
 
 class Dispatcher;
 
+static constexpr size_t TASK_FREE_LIST_CAPACITY = 4096;
+
 class Task {
 public:
 	Task(uint32_t expiresAfterMs, std::function<void(void)> &&f, std::string_view context);
@@ -19,6 +21,12 @@ public:
 
 	~Task() = default;
 
+	/**
+	 * @brief Creates a scheduled task using the pooled allocator,
+	 * so scheduling an event does not need a new heap allocation for the task and its control block.
+	 */
+	static std::shared_ptr<Task> create(std::function<void(void)> &&f, std::string_view context, uint32_t delay, bool cycle = false, bool log = true);
+
 	uint64_t getId() {
 		if (id == 0) {
 			if (++LAST_EVENT_ID == 0) {
@@ -94,12 +102,6 @@ private:
 		return tasksContext.contains(context);
 	}
 
-	struct Compare {
-		bool operator()(const std::shared_ptr<Task> &a, const std::shared_ptr<Task> &b) const {
-			return a->getTime() < b->getTime();
-		}
-	};
-
 	std::function<void(void)> func;
 	std::string context;
 
@@ -0,0 +1,153 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "game/scheduling/timer_wheel.hpp"
+
+#include "utils/tools.hpp"
+
+void TimerWheel::insert(const TaskPtr &task) {
+	if (currentTick < 0) {
+		currentTick = OTSYS_TIME() / TICK_MS;
+	}
+
+	place(task);
+}
+
+void TimerWheel::place(const TaskPtr &task) {
+	const int64_t tick = task->getTime() / TICK_MS;
+	if (tick < currentTick) {
+		// Its tick has already expired
+		pushReady(task);
+		return;
+	}
+
+	++wheelSize;
+
+	const auto delta = tick - currentTick;
+	if (delta < static_cast<int64_t>(ROOT_SIZE)) {
+		const auto index = tick & ROOT_MASK;
+		root[index].emplace_back(task);
+		rootOccupied.set(index);
+		return;
+	}
+
+	// Too far away tasks are parked on the last slot and re-evaluated once cascaded
+	const auto slotTick = currentTick + std::min(delta, MAX_DELTA);
+	for (uint8_t level = 0; level < UPPER_LEVELS; ++level) {
+		if (level == UPPER_LEVELS - 1 || (slotTick - currentTick) < (int64_t(1) << levelShift(level + 1))) {
+			levels[level][(slotTick >> levelShift(level)) & LEVEL_MASK].emplace_back(task);
+			return;
+		}
+	}
+}
+
+void TimerWheel::cascade(uint8_t level) {
+	const auto index = (currentTick >> levelShift(level)) & LEVEL_MASK;
+	auto tasks = std::move(levels[level][index]);
+	levels[level][index].clear();
+
+	wheelSize -= tasks.size();
+	for (const auto &task : tasks) {
+		if (!task->isCanceled()) {
+			place(task);
+		}
+	}
+}
+
+void TimerWheel::advance(int64_t now) {
+	const int64_t targetTick = now / TICK_MS;
+	if (currentTick < 0) {
+		currentTick = targetTick;
+	}
+
+	while (currentTick <= targetTick) {
+		if (wheelSize == 0) {
+			// Nothing to expire or cascade, jump straight to the target
+			currentTick = targetTick + 1;
+			break;
+		}
+
+		const auto index = currentTick & ROOT_MASK;
+		if (index == 0) {
+			// The root wrapped, bring down the next slot of each level that also wrapped
+			for (uint8_t level = 0; level < UPPER_LEVELS; ++level) {
+				cascade(level);
+				if (((currentTick >> levelShift(level)) & LEVEL_MASK) != 0) {
+					break;
+				}
+			}
+		}
+
+		if (rootOccupied.test(index)) {
+			auto &slot = root[index];
+			wheelSize -= slot.size();
+			for (const auto &task : slot) {
+				if (!task->isCanceled()) {
+					pushReady(task);
+				}
+			}
+			slot.clear();
+			rootOccupied.reset(index);
+		}
+
+		++currentTick;
+	}
+}
+
+void TimerWheel::pushReady(const TaskPtr &task) {
+	ready.emplace_back(task);
+	std::ranges::push_heap(ready, ReadyCompare {});
+}
+
+TimerWheel::TaskPtr TimerWheel::popReady(int64_t now) {
+	while (!ready.empty()) {
+		const auto &task = ready.front();
+		if (!task->isCanceled() && task->getTime() > now) {
+			return nullptr;
+		}
+
+		std::ranges::pop_heap(ready, ReadyCompare {});
+		auto next = std::move(ready.back());
+		ready.pop_back();
+
+		if (!next->isCanceled()) {
+			return next;
+		}
+	}
+
+	return nullptr;
+}
+
+std::chrono::milliseconds TimerWheel::timeUntilNextTask(int64_t now) const {
+	constexpr auto CHRONO_0 = std::chrono::milliseconds(0);
+	constexpr auto CHRONO_MILI_MAX = std::chrono::milliseconds::max();
+
+	if (!ready.empty()) {
+		return std::max<std::chrono::milliseconds>(std::chrono::milliseconds(ready.front()->getTime() - now), CHRONO_0);
+	}
+
+	if (wheelSize == 0) {
+		return CHRONO_MILI_MAX;
+	}
+
+	// Next occupied tick before the root wraps, otherwise wake up for the cascade
+	const auto index = static_cast<size_t>(currentTick & ROOT_MASK);
+	auto nextTick = currentTick;
+	if (index != 0) {
+		nextTick = (currentTick | ROOT_MASK) + 1;
+		for (auto i = index; i < ROOT_SIZE; ++i) {
+			if (rootOccupied.test(i)) {
+				nextTick = currentTick + static_cast<int64_t>(i - index);
+				break;
+			}
+		}
+	}
+
+	return std::max<std::chrono::milliseconds>(std::chrono::milliseconds(nextTick * TICK_MS - now), CHRONO_0);
+}
@@ -0,0 +1,102 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "game/scheduling/task.hpp"
+
+/**
+ * Hierarchical timing wheel used by the Dispatcher to store scheduled and cycle events.
+ *
+ * Each tick is TICK_MS long. The first level holds the next 256 ticks (12.8s), and
+ * every upper level holds 64 slots of the level below it, reaching ~38 days on the
+ * last one; anything farther is parked on the last slot and re-evaluated when cascaded.
+ *
+ * Insertion is O(1) and cancellation is done lazily through Task::cancel, the task is
+ * simply dropped when its slot expires. When a tick expires its tasks are moved to a
+ * small min-heap ordered by execution time, so tasks inside the same tick still run
+ * in the exact order (and not before the time) they were scheduled for.
+ *
+ * This class is not thread-safe, it must only be used by the dispatcher thread.
+ */
+class TimerWheel {
+public:
+	using TaskPtr = std::shared_ptr<Task>;
+
+	static constexpr int64_t TICK_MS = 50;
+
+	TimerWheel() = default;
+
+	// Ensures that we don't accidentally copy it
+	TimerWheel(const TimerWheel &) = delete;
+	TimerWheel &operator=(const TimerWheel &) = delete;
+
+	void insert(const TaskPtr &task);
+
+	/**
+	 * @brief Expires every tick up to (and including) the one containing now.
+	 * The tasks of the expired ticks become available through popReady.
+	 */
+	void advance(int64_t now);
+
+	/**
+	 * @brief Returns the next task whose time is less than or equal to now, or nullptr.
+	 * Canceled tasks are discarded on the way.
+	 */
+	TaskPtr popReady(int64_t now);
+
+	/**
+	 * @brief Milliseconds until the wheel has something to do (a task to run or a tick to cascade).
+	 */
+	[[nodiscard]] std::chrono::milliseconds timeUntilNextTask(int64_t now) const;
+
+	[[nodiscard]] bool empty() const {
+		return wheelSize == 0 && ready.empty();
+	}
+
+	[[nodiscard]] size_t size() const {
+		return wheelSize + ready.size();
+	}
+
+private:
+	static constexpr uint8_t ROOT_BITS = 8;
+	static constexpr uint8_t LEVEL_BITS = 6;
+	static constexpr uint8_t UPPER_LEVELS = 3;
+	static constexpr size_t ROOT_SIZE = 1 << ROOT_BITS;
+	static constexpr size_t LEVEL_SIZE = 1 << LEVEL_BITS;
+	static constexpr int64_t ROOT_MASK = ROOT_SIZE - 1;
+	static constexpr int64_t LEVEL_MASK = LEVEL_SIZE - 1;
+	static constexpr int64_t MAX_DELTA = (int64_t(1) << (ROOT_BITS + UPPER_LEVELS * LEVEL_BITS)) - 1;
+
+	struct ReadyCompare {
+		bool operator()(const TaskPtr &a, const TaskPtr &b) const {
+			return a->getTime() > b->getTime();
+		}
+	};
+
+	static constexpr int64_t levelShift(uint8_t level) {
+		return ROOT_BITS + level * LEVEL_BITS;
+	}
+
+	void place(const TaskPtr &task);
+	void cascade(uint8_t level);
+	void pushReady(const TaskPtr &task);
+
+	std::array<std::vector<TaskPtr>, ROOT_SIZE> root;
+	std::array<std::array<std::vector<TaskPtr>, LEVEL_SIZE>, UPPER_LEVELS> levels;
+	std::bitset<ROOT_SIZE> rootOccupied;
+
+	// Tasks from expired ticks, ordered by time (min-heap)
+	std::vector<TaskPtr> ready;
+
+	// Next tick to be expired, -1 until the first insertion/advance
+	int64_t currentTick = -1;
+	// Tasks stored in the wheel slots (ready ones are not counted)
+	size_t wheelSize = 0;
+};
@@ -238,6 +238,11 @@ void Zone::itemRemoved(const std::shared_ptr<Item> &item) {
 }
 
 void Zone::refresh() {
+	// Zones made by the scripts while the main map is read at startup, Zone::refreshAll goes over them afterwards
+	if (g_game().map.isReading()) {
+		return;
+	}
+
 	Benchmark bm_refresh;
 	creaturesCache.clear();
 	monstersCache.clear();
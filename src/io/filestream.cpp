@@ -159,3 +159,39 @@ bool FileStream::endNode() {
 	back();
 	return false;
 }
+
+bool FileStream::skipNode(uint8_t type) {
+	if (!startNode(type)) {
+		return false;
+	}
+
+	uint32_t depth = 1;
+	for (auto pos = m_pos; pos < m_data.size(); ++pos) {
+		switch (m_data[pos]) {
+			case OTB::Node::ESCAPE:
+				++pos;
+				break;
+			case OTB::Node::START:
+				++depth;
+				break;
+			case OTB::Node::END:
+				if (--depth == 0) {
+					m_pos = pos + 1;
+					--m_nodes;
+					return true;
+				}
+				break;
+			default:
+				break;
+		}
+	}
+
+	g_logger().error("[FileStream::skipNode] - Node has no end");
+	m_pos = static_cast<uint32_t>(m_data.size());
+	return false;
+}
+
+FileStream FileStream::view(uint32_t begin, uint32_t end) const {
+	const auto first = std::min<size_t>(begin, m_data.size());
+	return FileStream(m_data.subspan(first, std::max(first, std::min<size_t>(end, m_data.size())) - first));
+}
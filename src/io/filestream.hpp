@@ -11,13 +11,17 @@
 
 class FileStream {
 public:
-	FileStream(const char* begin, const char* end) {
-		m_data.insert(m_data.end(), begin, end);
-	}
+	FileStream(const char* begin, const char* end) :
+		m_storage(begin, end), m_data(m_storage) { }
 
-	explicit FileStream(mio::mmap_source source) {
-		m_data.insert(m_data.end(), source.begin(), source.end());
-	}
+	explicit FileStream(mio::mmap_source source) :
+		m_storage(source.begin(), source.end()), m_data(m_storage) { }
+
+	// Views of it would go on reading the bytes of the original
+	FileStream(const FileStream &) = delete;
+	FileStream &operator=(const FileStream &) = delete;
+	FileStream(FileStream &&) = default;
+	FileStream &operator=(FileStream &&) = default;
 
 	void back(uint32_t pos = 1);
 	void seek(uint32_t pos);
@@ -27,8 +31,13 @@ public:
 
 	bool startNode(uint8_t type = 0);
 	bool endNode();
+	// Goes past a whole node of the type, children included, only looking for where it ends
+	bool skipNode(uint8_t type = 0);
 	bool isProp(uint8_t prop, bool toNext = true);
 
+	// The bytes from begin to end, read on their own without copying them, valid as long as this stream is
+	FileStream view(uint32_t begin, uint32_t end) const;
+
 	uint8_t getU8();
 	uint16_t getU16();
 	uint32_t getU32();
@@ -36,10 +45,15 @@ public:
 	std::string getString();
 
 private:
+	explicit FileStream(std::span<const uint8_t> data) :
+		m_data(data) { }
+
 	template <typename T>
 	bool read(T &ret, bool escape = false);
 	uint32_t m_nodes { 0 };
 	uint32_t m_pos { 0 };
 
-	std::vector<uint8_t> m_data;
+	// Empty for a view, which reads the storage of another stream
+	std::vector<uint8_t> m_storage;
+	std::span<const uint8_t> m_data;
 };
@@ -31,13 +31,19 @@
 
 void IOLoginDataLoad::loadItems(ItemsMap &itemsMap, const DBResult_ptr &result, const std::shared_ptr<Player> &player) {
 	try {
+		// Looked up once, every row of the item tables has the same columns
+		const auto sidColumn = result->getColumnIndex("sid");
+		const auto pidColumn = result->getColumnIndex("pid");
+		const auto typeColumn = result->getColumnIndex("itemtype");
+		const auto countColumn = result->getColumnIndex("count");
+		const auto attributesColumn = result->getColumnIndex("attributes");
 		do {
-			auto sid = result->getNumber<uint32_t>("sid");
-			auto pid = result->getNumber<uint32_t>("pid");
-			auto type = result->getNumber<uint16_t>("itemtype");
-			auto count = result->getNumber<uint16_t>("count");
+			auto sid = result->getNumber<uint32_t>(sidColumn);
+			auto pid = result->getNumber<uint32_t>(pidColumn);
+			auto type = result->getNumber<uint16_t>(typeColumn);
+			auto count = result->getNumber<uint16_t>(countColumn);
 			unsigned long attrSize;
-			const char* attr = result->getStream("attributes", attrSize);
+			const char* attr = result->getStream(attributesColumn, attrSize);
 			PropStream propStream;
 			propStream.init(attr, attrSize);
 
@@ -371,10 +377,7 @@ void IOLoginDataLoad::loadPlayerKills(const std::shared_ptr<Player> &player, DBR
 		return;
 	}
 
-	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `player_id`, `time`, `target`, `unavenged` FROM `player_kills` WHERE `player_id` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
+	if ((result = g_database().storeQuery("SELECT `player_id`, `time`, `target`, `unavenged` FROM `player_kills` WHERE `player_id` = ?", { player->getGUID() }))) {
 		do {
 			auto killTime = result->getNumber<time_t>("time");
 			if ((time(nullptr) - killTime) <= g_configManager().getNumber(FRAG_TIME)) {
@@ -440,10 +443,7 @@ void IOLoginDataLoad::loadPlayerStashItems(const std::shared_ptr<Player> &player
 		return;
 	}
 
-	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `item_count`, `item_id`  FROM `player_stash` WHERE `player_id` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
+	if ((result = g_database().storeQuery("SELECT `item_count`, `item_id` FROM `player_stash` WHERE `player_id` = ?", { player->getGUID() }))) {
 		do {
 			auto itemId = result->getNumber<uint16_t>("item_id");
 			const ItemType &itemType = Item::items[itemId];
@@ -523,10 +523,7 @@ void IOLoginDataLoad::loadPlayerInstantSpellList(const std::shared_ptr<Player> &
 		return;
 	}
 
-	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `player_id`, `name` FROM `player_spells` WHERE `player_id` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
+	if ((result = g_database().storeQuery("SELECT `player_id`, `name` FROM `player_spells` WHERE `player_id` = ?", { player->getGUID() }))) {
 		do {
 			player->learnedInstantSpellList.emplace_back(result->getString("name"));
 		} while (result->next());
@@ -539,13 +536,11 @@ void IOLoginDataLoad::loadPlayerInventoryItems(const std::shared_ptr<Player> &pl
 		return;
 	}
 
-	auto query = fmt::format("SELECT pid, sid, itemtype, count, attributes FROM player_items WHERE player_id = {} ORDER BY sid DESC", player->getGUID());
-
 	ItemsMap inventoryItems;
 	std::vector<std::shared_ptr<Item>> itemsToStartDecaying;
 
 	try {
-		if ((result = g_database().storeQuery(query))) {
+		if ((result = g_database().storeQuery("SELECT pid, sid, itemtype, count, attributes FROM player_items WHERE player_id = ? ORDER BY sid DESC", { player->getGUID() }))) {
 			loadItems(inventoryItems, result, player);
 
 			for (auto it = inventoryItems.rbegin(), end = inventoryItems.rend(); it != end; ++it) {
@@ -619,11 +614,7 @@ void IOLoginDataLoad::loadRewardItems(const std::shared_ptr<Player> &player) {
 	}
 
 	ItemsMap rewardItems;
-	std::ostringstream query;
-	query.str(std::string());
-	query << "SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_rewards` WHERE `player_id` = "
-		  << player->getGUID() << " ORDER BY `pid`, `sid` ASC";
-	if (auto result = Database::getInstance().storeQuery(query.str())) {
+	if (auto result = g_database().storeQuery("SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_rewards` WHERE `player_id` = ? ORDER BY `pid`, `sid` ASC", { player->getGUID() })) {
 		loadItems(rewardItems, result, player);
 		bindRewardBag(player, rewardItems);
 		insertItemsIntoRewardBag(rewardItems);
@@ -638,8 +629,7 @@ void IOLoginDataLoad::loadPlayerDepotItems(const std::shared_ptr<Player> &player
 
 	ItemsMap depotItems;
 	std::vector<std::shared_ptr<Item>> itemsToStartDecaying;
-	auto query = fmt::format("SELECT pid, sid, itemtype, count, attributes FROM player_depotitems WHERE player_id = {} ORDER BY sid DESC", player->getGUID());
-	if ((result = g_database().storeQuery(query))) {
+	if ((result = g_database().storeQuery("SELECT pid, sid, itemtype, count, attributes FROM player_depotitems WHERE player_id = ? ORDER BY sid DESC", { player->getGUID() }))) {
 		loadItems(depotItems, result, player);
 		for (auto it = depotItems.rbegin(), end = depotItems.rend(); it != end; ++it) {
 			const std::pair<std::shared_ptr<Item>, int32_t> &pair = it->second;
@@ -684,8 +674,7 @@ void IOLoginDataLoad::loadPlayerInboxItems(const std::shared_ptr<Player> &player
 	}
 
 	std::vector<std::shared_ptr<Item>> itemsToStartDecaying;
-	auto query = fmt::format("SELECT pid, sid, itemtype, count, attributes FROM player_inboxitems WHERE player_id = {} ORDER BY sid DESC", player->getGUID());
-	if ((result = g_database().storeQuery(query))) {
+	if ((result = g_database().storeQuery("SELECT pid, sid, itemtype, count, attributes FROM player_inboxitems WHERE player_id = ? ORDER BY sid DESC", { player->getGUID() }))) {
 		ItemsMap inboxItems;
 		loadItems(inboxItems, result, player);
 
@@ -782,10 +771,7 @@ void IOLoginDataLoad::loadPlayerPreyClass(const std::shared_ptr<Player> &player,
 	}
 
 	if (g_configManager().getBoolean(PREY_ENABLED)) {
-		Database &db = Database::getInstance();
-		std::ostringstream query;
-		query << "SELECT * FROM `player_prey` WHERE `player_id` = " << player->getGUID();
-		if ((result = db.storeQuery(query.str()))) {
+		if ((result = g_database().storeQuery("SELECT * FROM `player_prey` WHERE `player_id` = ?", { player->getGUID() }))) {
 			do {
 				auto slot = std::make_unique<PreySlot>(static_cast<PreySlot_t>(result->getNumber<uint16_t>("slot")));
 				auto state = static_cast<PreyDataState_t>(result->getNumber<uint16_t>("state"));
@@ -829,10 +815,7 @@ void IOLoginDataLoad::loadPlayerTaskHuntingClass(const std::shared_ptr<Player> &
 	}
 
 	if (g_configManager().getBoolean(TASK_HUNTING_ENABLED)) {
-		Database &db = Database::getInstance();
-		std::ostringstream query;
-		query << "SELECT * FROM `player_taskhunt` WHERE `player_id` = " << player->getGUID();
-		if ((result = db.storeQuery(query.str()))) {
+		if ((result = g_database().storeQuery("SELECT * FROM `player_taskhunt` WHERE `player_id` = ?", { player->getGUID() }))) {
 			do {
 				auto slot = std::make_unique<TaskHuntingSlot>(static_cast<PreySlot_t>(result->getNumber<uint16_t>("slot")));
 				auto state = static_cast<PreyTaskDataState_t>(result->getNumber<uint16_t>("state"));
@@ -880,11 +863,7 @@ void IOLoginDataLoad::loadPlayerForgeHistory(const std::shared_ptr<Player> &play
 
 	auto playerGUID = player->getGUID();
 
-	auto query = fmt::format(
-		"SELECT id, action_type, description, done_at, is_success FROM forge_history WHERE player_id = {}",
-		playerGUID
-	);
-	if ((result = Database::getInstance().storeQuery(query))) {
+	if ((result = g_database().storeQuery("SELECT id, action_type, description, done_at, is_success FROM forge_history WHERE player_id = ?", { playerGUID }))) {
 		do {
 			auto actionEnum = magic_enum::enum_value<ForgeAction_t>(result->getNumber<uint16_t>("action_type"));
 			ForgeHistory history;
@@ -908,9 +887,7 @@ void IOLoginDataLoad::loadPlayerBosstiary(const std::shared_ptr<Player> &player,
 		return;
 	}
 
-	std::ostringstream query;
-	query << "SELECT * FROM `player_bosstiary` WHERE `player_id` = " << player->getGUID();
-	if ((result = Database::getInstance().storeQuery(query.str()))) {
+	if ((result = g_database().storeQuery("SELECT * FROM `player_bosstiary` WHERE `player_id` = ?", { player->getGUID() }))) {
 		do {
 			player->setSlotBossId(1, result->getNumber<uint16_t>("bossIdSlotOne"));
 			player->setSlotBossId(2, result->getNumber<uint16_t>("bossIdSlotTwo"));
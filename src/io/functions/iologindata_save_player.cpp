@@ -22,7 +22,7 @@
 #include "creatures/players/player.hpp"
 #include "io/player_storage_repository.hpp"
 
-bool IOLoginDataSave::saveItems(const std::shared_ptr<Player> &player, const ItemBlockList &itemList, DBInsert &query_insert, PropWriteStream &propWriteStream) {
+bool IOLoginDataSave::serializeItems(const std::shared_ptr<Player> &player, const ItemBlockList &itemList, std::vector<std::string> &rows, PropWriteStream &propWriteStream) {
 	if (!player) {
 		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
 		return false;
@@ -81,12 +81,10 @@ bool IOLoginDataSave::saveItems(const std::shared_ptr<Player> &player, const Ite
 		size_t attributesSize;
 		const char* attributes = propWriteStream.getStream(attributesSize);
 
-		// Build query string and add row
+		// Build row string
 		ss << player->getGUID() << ',' << pid << ',' << runningId << ',' << item->getID() << ',' << item->getSubType() << ',' << db.escapeBlob(attributes, static_cast<uint32_t>(attributesSize));
-		if (!query_insert.addRow(ss)) {
-			g_logger().error("Error adding row to query.");
-			return false;
-		}
+		rows.emplace_back(ss.str());
+		ss.str(std::string());
 	}
 
 	// Loop through containers in queue
@@ -135,20 +133,40 @@ bool IOLoginDataSave::saveItems(const std::shared_ptr<Player> &player, const Ite
 			size_t attributesSize;
 			const char* attributes = propWriteStream.getStream(attributesSize);
 
-			// Build query string and add row
+			// Build row string
 			ss << player->getGUID() << ',' << parentId << ',' << runningId << ',' << item->getID() << ',' << item->getSubType() << ',' << db.escapeBlob(attributes, static_cast<uint32_t>(attributesSize));
-			if (!query_insert.addRow(ss)) {
-				g_logger().error("Error adding row to query for container item.");
-				return false;
-			}
+			rows.emplace_back(ss.str());
+			ss.str(std::string());
 		}
 
 		// Removes the object after processing everything, avoiding memory usage after freeing
 		queue.pop_front();
 	}
+	return true;
+}
+
+bool IOLoginDataSave::saveRows(const std::shared_ptr<Player> &player, PlayerSaveSection_t section, std::string_view table, const std::string &insertQuery, const std::vector<std::string> &rows) {
+	// Same rows as written by the last save, nothing to delete and insert again
+	if (!player->saveState().stage(section, rows)) {
+		return true;
+	}
+
+	// One prepared statement per table, the player is bound as its parameter
+	const auto deleteQuery = fmt::format("DELETE FROM `{}` WHERE `player_id` = ?", table);
+	if (!g_database().executeQuery(deleteQuery, { player->getGUID() })) {
+		g_logger().warn("[IOLoginData::savePlayer] - Error delete query '{}' from player: {}", table, player->getName());
+		return false;
+	}
+
+	DBInsert rowsQuery(insertQuery);
+	for (const auto &row : rows) {
+		if (!rowsQuery.addRow(row)) {
+			g_logger().error("Error adding row to query.");
+			return false;
+		}
+	}
 
-	// Execute query
-	if (!query_insert.execute()) {
+	if (!rowsQuery.execute()) {
 		g_logger().error("Error executing query.");
 		return false;
 	}
@@ -167,22 +185,18 @@ bool IOLoginDataSave::savePlayerFirst(const std::shared_ptr<Player> &player) {
 
 	Database &db = Database::getInstance();
 
-	std::ostringstream query;
-	query << "SELECT `save` FROM `players` WHERE `id` = " << player->getGUID();
-	DBResult_ptr result = db.storeQuery(query.str());
+	DBResult_ptr result = db.storeQuery("SELECT `save` FROM `players` WHERE `id` = ?", { player->getGUID() });
 	if (!result) {
 		g_logger().warn("[IOLoginData::savePlayer] - Error for select result query from player: {}", player->getName());
 		return false;
 	}
 
 	if (result->getNumber<uint16_t>("save") == 0) {
-		query.str("");
-		query << "UPDATE `players` SET `lastlogin` = " << player->lastLoginSaved << ", `lastip` = " << player->lastIP << " WHERE `id` = " << player->getGUID();
-		return db.executeQuery(query.str());
+		return db.executeQuery("UPDATE `players` SET `lastlogin` = ?, `lastip` = ? WHERE `id` = ?", { player->lastLoginSaved, player->lastIP, player->getGUID() });
 	}
 
 	// First, an UPDATE query to write the player itself
-	query.str("");
+	std::ostringstream query;
 	query << "UPDATE `players` SET ";
 	query << "`name` = " << db.escapeString(player->name) << ",";
 	query << "`level` = " << player->level << ",";
@@ -337,16 +351,8 @@ bool IOLoginDataSave::savePlayerStash(const std::shared_ptr<Player> &player) {
 		return false;
 	}
 
-	Database &db = Database::getInstance();
 	std::ostringstream query;
-	query << "DELETE FROM `player_stash` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		return false;
-	}
-
-	query.str("");
-
-	DBInsert stashQuery("INSERT INTO `player_stash` (`player_id`,`item_id`,`item_count`) VALUES ");
+	std::vector<std::string> rows;
 	for (const auto &[itemId, itemCount] : player->getStashItems()) {
 		const ItemType &itemType = Item::items[itemId];
 		if (itemType.decayTo >= 0 && itemType.decayTime > 0) {
@@ -360,15 +366,11 @@ bool IOLoginDataSave::savePlayerStash(const std::shared_ptr<Player> &player) {
 		}
 
 		query << player->getGUID() << ',' << itemId << ',' << itemCount;
-		if (!stashQuery.addRow(query)) {
-			return false;
-		}
+		rows.emplace_back(query.str());
+		query.str("");
 	}
 
-	if (!stashQuery.execute()) {
-		return false;
-	}
-	return true;
+	return saveRows(player, PlayerSaveSection_t::Stash, "player_stash", "INSERT INTO `player_stash` (`player_id`,`item_id`,`item_count`) VALUES ", rows);
 }
 
 bool IOLoginDataSave::savePlayerSpells(const std::shared_ptr<Player> &player) {
@@ -377,27 +379,16 @@ bool IOLoginDataSave::savePlayerSpells(const std::shared_ptr<Player> &player) {
 		return false;
 	}
 
-	Database &db = Database::getInstance();
+	const Database &db = Database::getInstance();
 	std::ostringstream query;
-	query << "DELETE FROM `player_spells` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		return false;
-	}
-
-	query.str("");
-
-	DBInsert spellsQuery("INSERT INTO `player_spells` (`player_id`, `name` ) VALUES ");
+	std::vector<std::string> rows;
 	for (const std::string &spellName : player->learnedInstantSpellList) {
 		query << player->getGUID() << ',' << db.escapeString(spellName);
-		if (!spellsQuery.addRow(query)) {
-			return false;
-		}
+		rows.emplace_back(query.str());
+		query.str("");
 	}
 
-	if (!spellsQuery.execute()) {
-		return false;
-	}
-	return true;
+	return saveRows(player, PlayerSaveSection_t::Spells, "player_spells", "INSERT INTO `player_spells` (`player_id`, `name` ) VALUES ", rows);
 }
 
 bool IOLoginDataSave::savePlayerKills(const std::shared_ptr<Player> &player) {
@@ -406,27 +397,15 @@ bool IOLoginDataSave::savePlayerKills(const std::shared_ptr<Player> &player) {
 		return false;
 	}
 
-	Database &db = Database::getInstance();
 	std::ostringstream query;
-	query << "DELETE FROM `player_kills` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		return false;
-	}
-
-	query.str("");
-
-	DBInsert killsQuery("INSERT INTO `player_kills` (`player_id`, `target`, `time`, `unavenged`) VALUES");
+	std::vector<std::string> rows;
 	for (const auto &kill : player->unjustifiedKills) {
 		query << player->getGUID() << ',' << kill.target << ',' << kill.time << ',' << kill.unavenged;
-		if (!killsQuery.addRow(query)) {
-			return false;
-		}
+		rows.emplace_back(query.str());
+		query.str("");
 	}
 
-	if (!killsQuery.execute()) {
-		return false;
-	}
-	return true;
+	return saveRows(player, PlayerSaveSection_t::Kills, "player_kills", "INSERT INTO `player_kills` (`player_id`, `target`, `time`, `unavenged`) VALUES", rows);
 }
 
 bool IOLoginDataSave::savePlayerBestiarySystem(const std::shared_ptr<Player> &player) {
@@ -467,7 +446,12 @@ bool IOLoginDataSave::savePlayerBestiarySystem(const std::shared_ptr<Player> &pl
 	query << " `tracker list` = " << db.escapeBlob(trackerList, static_cast<uint32_t>(trackerSize));
 	query << " WHERE `player_id` = " << player->getGUID();
 
-	if (!db.executeQuery(query.str())) {
+	const std::vector<std::string> rows { query.str() };
+	if (!player->saveState().stage(PlayerSaveSection_t::Bestiary, rows)) {
+		return true;
+	}
+
+	if (!db.executeQuery(rows.front())) {
 		g_logger().warn("[IOLoginData::savePlayer] - Error saving bestiary data from player: {}", player->getName());
 		return false;
 	}
@@ -480,17 +464,7 @@ bool IOLoginDataSave::savePlayerItem(const std::shared_ptr<Player> &player) {
 		return false;
 	}
 
-	Database &db = Database::getInstance();
 	PropWriteStream propWriteStream;
-	std::ostringstream query;
-	query << "DELETE FROM `player_items` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		g_logger().warn("[IOLoginData::savePlayer] - Error delete query 'player_items' from player: {}", player->getName());
-		return false;
-	}
-
-	DBInsert itemsQuery("INSERT INTO `player_items` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
-
 	ItemBlockList itemList;
 	for (int32_t slotId = CONST_SLOT_FIRST; slotId <= CONST_SLOT_LAST; ++slotId) {
 		const auto &item = player->inventory[slotId];
@@ -499,7 +473,8 @@ bool IOLoginDataSave::savePlayerItem(const std::shared_ptr<Player> &player) {
 		}
 	}
 
-	if (!saveItems(player, itemList, itemsQuery, propWriteStream)) {
+	std::vector<std::string> rows;
+	if (!serializeItems(player, itemList, rows, propWriteStream) || !saveRows(player, PlayerSaveSection_t::Items, "player_items", "INSERT INTO `player_items` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ", rows)) {
 		g_logger().warn("[IOLoginData::savePlayer] - Failed for save items from player: {}", player->getName());
 		return false;
 	}
@@ -512,33 +487,23 @@ bool IOLoginDataSave::savePlayerDepotItems(const std::shared_ptr<Player> &player
 		return false;
 	}
 
-	Database &db = Database::getInstance();
+	if (player->lastDepotId == -1) {
+		return true;
+	}
+
 	PropWriteStream propWriteStream;
 	ItemDepotList depotList;
-	if (player->lastDepotId != -1) {
-		std::ostringstream query;
-		query << "DELETE FROM `player_depotitems` WHERE `player_id` = " << player->getGUID();
-
-		if (!db.executeQuery(query.str())) {
-			return false;
-		}
-
-		query.str("");
-
-		DBInsert depotQuery("INSERT INTO `player_depotitems` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
-
-		for (const auto &[pid, depotChest] : player->depotChests) {
-			for (const std::shared_ptr<Item> &item : depotChest->getItemList()) {
-				depotList.emplace_back(pid, item);
-			}
+	for (const auto &[pid, depotChest] : player->depotChests) {
+		for (const std::shared_ptr<Item> &item : depotChest->getItemList()) {
+			depotList.emplace_back(pid, item);
 		}
+	}
 
-		if (!saveItems(player, depotList, depotQuery, propWriteStream)) {
-			return false;
-		}
-		return true;
+	std::vector<std::string> rows;
+	if (!serializeItems(player, depotList, rows, propWriteStream)) {
+		return false;
 	}
-	return true;
+	return saveRows(player, PlayerSaveSection_t::DepotItems, "player_depotitems", "INSERT INTO `player_depotitems` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ", rows);
 }
 
 bool IOLoginDataSave::saveRewardItems(const std::shared_ptr<Player> &player) {
@@ -547,32 +512,23 @@ bool IOLoginDataSave::saveRewardItems(const std::shared_ptr<Player> &player) {
 		return false;
 	}
 
-	std::ostringstream query;
-	query << "DELETE FROM `player_rewards` WHERE `player_id` = " << player->getGUID();
-
-	if (!Database::getInstance().executeQuery(query.str())) {
-		return false;
-	}
-
 	std::vector<uint64_t> rewardList;
 	player->getRewardList(rewardList);
 
 	ItemRewardList rewardListItems;
-	if (!rewardList.empty()) {
-		for (const auto &rewardId : rewardList) {
-			auto reward = player->getReward(rewardId, false);
-			if (!reward->empty() && (getTimeMsNow() - rewardId <= 1000 * 60 * 60 * 24 * 7)) {
-				rewardListItems.emplace_back(0, reward);
-			}
+	for (const auto &rewardId : rewardList) {
+		auto reward = player->getReward(rewardId, false);
+		if (!reward->empty() && (getTimeMsNow() - rewardId <= 1000 * 60 * 60 * 24 * 7)) {
+			rewardListItems.emplace_back(0, reward);
 		}
+	}
 
-		DBInsert rewardQuery("INSERT INTO `player_rewards` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
-		PropWriteStream propWriteStream;
-		if (!saveItems(player, rewardListItems, rewardQuery, propWriteStream)) {
-			return false;
-		}
+	PropWriteStream propWriteStream;
+	std::vector<std::string> rows;
+	if (!serializeItems(player, rewardListItems, rows, propWriteStream)) {
+		return false;
 	}
-	return true;
+	return saveRows(player, PlayerSaveSection_t::RewardItems, "player_rewards", "INSERT INTO `player_rewards` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ", rows);
 }
 
 bool IOLoginDataSave::savePlayerInbox(const std::shared_ptr<Player> &player) {
@@ -581,26 +537,17 @@ bool IOLoginDataSave::savePlayerInbox(const std::shared_ptr<Player> &player) {
 		return false;
 	}
 
-	Database &db = Database::getInstance();
 	PropWriteStream propWriteStream;
 	ItemInboxList inboxList;
-	std::ostringstream query;
-	query << "DELETE FROM `player_inboxitems` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		return false;
-	}
-
-	query.str("");
-	DBInsert inboxQuery("INSERT INTO `player_inboxitems` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
-
 	for (const auto &item : player->getInbox()->getItemList()) {
 		inboxList.emplace_back(0, item);
 	}
 
-	if (!saveItems(player, inboxList, inboxQuery, propWriteStream)) {
+	std::vector<std::string> rows;
+	if (!serializeItems(player, inboxList, rows, propWriteStream)) {
 		return false;
 	}
-	return true;
+	return saveRows(player, PlayerSaveSection_t::Inbox, "player_inboxitems", "INSERT INTO `player_inboxitems` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ", rows);
 }
 
 bool IOLoginDataSave::savePlayerPreyClass(const std::shared_ptr<Player> &player) {
@@ -612,6 +559,7 @@ bool IOLoginDataSave::savePlayerPreyClass(const std::shared_ptr<Player> &player)
 	Database &db = Database::getInstance();
 	if (g_configManager().getBoolean(PREY_ENABLED)) {
 		std::ostringstream query;
+		std::vector<std::string> rows;
 		for (uint8_t slotId = PreySlot_First; slotId <= PreySlot_Last; slotId++) {
 			if (const auto &slot = player->getPreySlotById(static_cast<PreySlot_t>(slotId))) {
 				query.str(std::string());
@@ -646,11 +594,18 @@ bool IOLoginDataSave::savePlayerPreyClass(const std::shared_ptr<Player> &player)
 					  << "`bonus_time` = VALUES(`bonus_time`), "
 					  << "`free_reroll` = VALUES(`free_reroll`), "
 					  << "`monster_list` = VALUES(`monster_list`)";
+				rows.emplace_back(query.str());
+			}
+		}
 
-				if (!db.executeQuery(query.str())) {
-					g_logger().warn("[IOLoginData::savePlayer] - Error saving prey slot data from player: {}", player->getName());
-					return false;
-				}
+		if (!player->saveState().stage(PlayerSaveSection_t::Prey, rows)) {
+			return true;
+		}
+
+		for (const auto &row : rows) {
+			if (!db.executeQuery(row)) {
+				g_logger().warn("[IOLoginData::savePlayer] - Error saving prey slot data from player: {}", player->getName());
+				return false;
 			}
 		}
 	}
@@ -666,6 +621,7 @@ bool IOLoginDataSave::savePlayerTaskHuntingClass(const std::shared_ptr<Player> &
 	Database &db = Database::getInstance();
 	if (g_configManager().getBoolean(TASK_HUNTING_ENABLED)) {
 		std::ostringstream query;
+		std::vector<std::string> rows;
 		for (uint8_t slotId = PreySlot_First; slotId <= PreySlot_Last; slotId++) {
 			if (const auto &slot = player->getTaskHuntingSlotById(static_cast<PreySlot_t>(slotId))) {
 				query.str("");
@@ -698,11 +654,18 @@ bool IOLoginDataSave::savePlayerTaskHuntingClass(const std::shared_ptr<Player> &
 					  << "`disabled_time` = VALUES(`disabled_time`), "
 					  << "`free_reroll` = VALUES(`free_reroll`), "
 					  << "`monster_list` = VALUES(`monster_list`)";
+				rows.emplace_back(query.str());
+			}
+		}
 
-				if (!db.executeQuery(query.str())) {
-					g_logger().warn("[IOLoginData::savePlayer] - Error saving task hunting slot data from player: {}", player->getName());
-					return false;
-				}
+		if (!player->saveState().stage(PlayerSaveSection_t::TaskHunting, rows)) {
+			return true;
+		}
+
+		for (const auto &row : rows) {
+			if (!db.executeQuery(row)) {
+				g_logger().warn("[IOLoginData::savePlayer] - Error saving task hunting slot data from player: {}", player->getName());
+				return false;
 			}
 		}
 	}
@@ -716,13 +679,7 @@ bool IOLoginDataSave::savePlayerForgeHistory(const std::shared_ptr<Player> &play
 	}
 
 	std::ostringstream query;
-	query << "DELETE FROM `forge_history` WHERE `player_id` = " << player->getGUID();
-	if (!Database::getInstance().executeQuery(query.str())) {
-		return false;
-	}
-
-	query.str("");
-	DBInsert insertQuery("INSERT INTO `forge_history` (`player_id`, `action_type`, `description`, `done_at`, `is_success`) VALUES");
+	std::vector<std::string> rows;
 	for (const auto &history : player->getForgeHistory()) {
 		const auto stringDescription = Database::getInstance().escapeString(history.description);
 		auto actionString = magic_enum::enum_integer(history.actionType);
@@ -732,15 +689,11 @@ bool IOLoginDataSave::savePlayerForgeHistory(const std::shared_ptr<Player> &play
 			  << stringDescription << ','
 			  << history.createdAt << ','
 			  << history.success;
-
-		if (!insertQuery.addRow(query)) {
-			return false;
-		}
-	}
-	if (!insertQuery.execute()) {
-		return false;
+		rows.emplace_back(query.str());
+		query.str("");
 	}
-	return true;
+
+	return saveRows(player, PlayerSaveSection_t::ForgeHistory, "forge_history", "INSERT INTO `forge_history` (`player_id`, `action_type`, `description`, `done_at`, `is_success`) VALUES", rows);
 }
 
 bool IOLoginDataSave::savePlayerBosstiary(const std::shared_ptr<Player> &player) {
@@ -750,13 +703,6 @@ bool IOLoginDataSave::savePlayerBosstiary(const std::shared_ptr<Player> &player)
 	}
 
 	std::ostringstream query;
-	query << "DELETE FROM `player_bosstiary` WHERE `player_id` = " << player->getGUID();
-	if (!Database::getInstance().executeQuery(query.str())) {
-		return false;
-	}
-
-	query.str("");
-	DBInsert insertQuery("INSERT INTO `player_bosstiary` (`player_id`, `bossIdSlotOne`, `bossIdSlotTwo`, `removeTimes`, `tracker`) VALUES");
 
 	// Bosstiary tracker
 	PropWriteStream stream;
@@ -776,15 +722,7 @@ bool IOLoginDataSave::savePlayerBosstiary(const std::shared_ptr<Player> &player)
 		  << std::to_string(player->getRemoveTimes()) << ','
 		  << Database::getInstance().escapeBlob(chars, static_cast<uint32_t>(size));
 
-	if (!insertQuery.addRow(query)) {
-		return false;
-	}
-
-	if (!insertQuery.execute()) {
-		return false;
-	}
-
-	return true;
+	return saveRows(player, PlayerSaveSection_t::Bosstiary, "player_bosstiary", "INSERT INTO `player_bosstiary` (`player_id`, `bossIdSlotOne`, `bossIdSlotTwo`, `removeTimes`, `tracker`) VALUES", { query.str() });
 }
 
 bool IOLoginDataSave::savePlayerStorage(const std::shared_ptr<Player> &player) {
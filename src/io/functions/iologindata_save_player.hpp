@@ -12,7 +12,7 @@
 #include "io/iologindata.hpp"
 
 class PropWriteStream;
-class DBInsert;
+enum class PlayerSaveSection_t : uint8_t;
 
 class IOLoginDataSave : public IOLoginData {
 public:
@@ -37,5 +37,11 @@ protected:
 	using ItemRewardList = std::list<std::pair<int32_t, std::shared_ptr<Item>>>;
 	using ItemInboxList = std::list<std::pair<int32_t, std::shared_ptr<Item>>>;
 
-	static bool saveItems(const std::shared_ptr<Player> &player, const ItemBlockList &itemList, DBInsert &query_insert, PropWriteStream &stream);
+	static bool serializeItems(const std::shared_ptr<Player> &player, const ItemBlockList &itemList, std::vector<std::string> &rows, PropWriteStream &stream);
+
+	/**
+	 * @brief Replaces the rows of a player in a table, unless they are the same as written by its last save.
+	 * @param insertQuery The INSERT statement up to the VALUES keyword, as used by DBInsert.
+	 */
+	static bool saveRows(const std::shared_ptr<Player> &player, PlayerSaveSection_t section, std::string_view table, const std::string &insertQuery, const std::vector<std::string> &rows);
 };
@@ -14,7 +14,9 @@
 #include "database/database.hpp"
 #include "io/functions/iologindata_load_player.hpp"
 #include "io/functions/iologindata_save_player.hpp"
+#include "kv/kv.hpp"
 #include "game/game.hpp"
+#include "game/highscore_ranking.hpp"
 #include "creatures/monsters/monster.hpp"
 #include "creatures/players/player.hpp"
 #include "lib/metrics/metrics.hpp"
@@ -79,17 +81,11 @@ uint8_t IOLoginData::getAccountType(uint32_t accountId) {
 
 // The boolean "disableIrrelevantInfo" will deactivate the loading of information that is not relevant to the preload, for example, forge, bosstiary, etc. None of this we need to access if the player is offline
 bool IOLoginData::loadPlayerById(const std::shared_ptr<Player> &player, uint32_t id, bool disableIrrelevantInfo /* = true*/) {
-	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT * FROM `players` WHERE `id` = " << id;
-	return loadPlayer(player, db.storeQuery(query.str()), disableIrrelevantInfo);
+	return loadPlayer(player, g_database().storeQuery("SELECT * FROM `players` WHERE `id` = ?", { id }), disableIrrelevantInfo);
 }
 
 bool IOLoginData::loadPlayerByName(const std::shared_ptr<Player> &player, const std::string &name, bool disableIrrelevantInfo /* = true*/) {
-	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT * FROM `players` WHERE `name` = " << db.escapeString(name);
-	return loadPlayer(player, db.storeQuery(query.str()), disableIrrelevantInfo);
+	return loadPlayer(player, g_database().storeQuery("SELECT * FROM `players` WHERE `name` = ?", { name }), disableIrrelevantInfo);
 }
 
 bool IOLoginData::loadPlayer(const std::shared_ptr<Player> &player, const DBResult_ptr &result, bool disableIrrelevantInfo /* = false*/) {
@@ -185,6 +181,8 @@ bool IOLoginData::loadPlayer(const std::shared_ptr<Player> &player, const DBResu
 }
 
 void IOLoginData::loadOnlyDataForOnlinePlayer(const std::shared_ptr<Player> &player, const DBResult_ptr &result) {
+	// Scripts read the player's key-value store all along the login, load it in a single query
+	player->kv()->prefetch();
 	IOLoginDataLoad::loadPlayerForgeHistory(player, result);
 	IOLoginDataLoad::loadPlayerBosstiary(player, result);
 	IOLoginDataLoad::loadPlayerInitializeSystem(player);
@@ -192,6 +190,11 @@ void IOLoginData::loadOnlyDataForOnlinePlayer(const std::shared_ptr<Player> &pla
 }
 
 bool IOLoginData::savePlayer(const std::shared_ptr<Player> &player) {
+	// Sections unchanged since the last successful save are skipped, see PlayerSaveState
+	if (player) {
+		player->saveState().begin();
+	}
+
 	try {
 		bool success = DBTransaction::executeWithinTransaction([player]() {
 			return savePlayerGuard(player);
@@ -199,6 +202,10 @@ bool IOLoginData::savePlayer(const std::shared_ptr<Player> &player) {
 
 		if (!success) {
 			g_logger().error("[{}] Error occurred saving player", __FUNCTION__);
+			player->saveState().discard();
+		} else {
+			player->saveState().commit();
+			g_highscoreRanking().update(*player);
 		}
 
 		return success;
@@ -206,6 +213,9 @@ bool IOLoginData::savePlayer(const std::shared_ptr<Player> &player) {
 		g_logger().error("[{}] Exception occurred: {}", __FUNCTION__, e.what());
 	}
 
+	if (player) {
+		player->saveState().discard();
+	}
 	return false;
 }
 
@@ -12,6 +12,8 @@
 #include "game/movement/teleport.hpp"
 #include "game/game.hpp"
 #include "io/filestream.hpp"
+#include "io/iomapsnapshot.hpp"
+#include "lib/thread/thread_pool.hpp"
 
 /*
     OTBM_ROOTV1
@@ -37,9 +39,15 @@
     |--- OTBM_ITEM_DEF (not implemented)
 */
 
-void IOMap::loadMap(Map* map, const Position &pos) {
+void IOMap::loadMap(Map* map, const Position &pos, bool useSnapshot) {
 	Benchmark bm_mapLoad;
 
+	if (useSnapshot && IOMapSnapshot::load(*map, map->path, pos)) {
+		map->flush();
+		g_logger().debug("Map Loaded {} ({}x{}) from its snapshot in {} milliseconds", map->path.filename().string(), map->width, map->height, bm_mapLoad.duration());
+		return;
+	}
+
 	const auto &fileByte = mio::mmap_source(map->path.string());
 
 	const auto begin = fileByte.begin() + sizeof(OTB::Identifier { { 'O', 'T', 'B', 'M' } });
@@ -66,21 +74,52 @@ void IOMap::loadMap(Map* map, const Position &pos) {
 		throw IOMapException("This map need to be upgraded by using the latest map editor version to be able to load correctly.");
 	}
 
+	std::unique_ptr<IOMapSnapshot> snapshot;
+	if (useSnapshot) {
+		snapshot = std::make_unique<IOMapSnapshot>(pos);
+		snapshot->setSize(map->width, map->height);
+	}
+
 	if (stream.startNode(OTBM_MAP_DATA)) {
-		parseMapDataAttributes(stream, map);
-		parseTileArea(stream, *map, pos);
+		parseMapDataAttributes(stream, map, snapshot.get());
+		parseTileArea(stream, *map, pos, snapshot.get());
 		stream.endNode();
 	}
 
-	parseTowns(stream, *map);
-	parseWaypoints(stream, *map);
+	parseTowns(stream, *map, snapshot.get());
+	parseWaypoints(stream, *map, snapshot.get());
 
 	map->flush();
 
 	g_logger().debug("Map Loaded {} ({}x{}) in {} milliseconds", map->path.filename().string(), map->width, map->height, bm_mapLoad.duration());
+
+	if (snapshot && snapshot->save(map->path)) {
+		g_logger().info("Compiled the snapshot of {}, loaded from the next startup", map->path.filename().string());
+	}
 }
 
-void IOMap::parseMapDataAttributes(FileStream &stream, Map* map) {
+void IOMap::setMapDataFile(Map &map, uint8_t attribute, const std::string &fileName) {
+	const auto &path = map.path.string();
+	const auto directory = path.substr(0, path.rfind('/') + 1);
+	switch (attribute) {
+		case OTBM_ATTR_EXT_SPAWN_MONSTER_FILE:
+			map.monsterfile = directory + fileName;
+			break;
+		case OTBM_ATTR_EXT_SPAWN_NPC_FILE:
+			map.npcfile = directory + fileName;
+			break;
+		case OTBM_ATTR_EXT_HOUSE_FILE:
+			map.housefile = directory + fileName;
+			break;
+		case OTBM_ATTR_EXT_ZONE_FILE:
+			map.zonesfile = directory + fileName;
+			break;
+		default:
+			break;
+	}
+}
+
+void IOMap::parseMapDataAttributes(FileStream &stream, Map* map, IOMapSnapshot* snapshot) {
 	bool end = false;
 	while (!end) {
 		const uint8_t attr = stream.getU8();
@@ -89,23 +128,15 @@ void IOMap::parseMapDataAttributes(FileStream &stream, Map* map) {
 				stream.getString();
 			} break;
 
-			case OTBM_ATTR_EXT_SPAWN_MONSTER_FILE: {
-				map->monsterfile = map->path.string().substr(0, map->path.string().rfind('/') + 1);
-				map->monsterfile += stream.getString();
-			} break;
-
-			case OTBM_ATTR_EXT_SPAWN_NPC_FILE: {
-				map->npcfile = map->path.string().substr(0, map->path.string().rfind('/') + 1);
-				map->npcfile += stream.getString();
-			} break;
-			case OTBM_ATTR_EXT_HOUSE_FILE: {
-				map->housefile = map->path.string().substr(0, map->path.string().rfind('/') + 1);
-				map->housefile += stream.getString();
-			} break;
-
+			case OTBM_ATTR_EXT_SPAWN_MONSTER_FILE:
+			case OTBM_ATTR_EXT_SPAWN_NPC_FILE:
+			case OTBM_ATTR_EXT_HOUSE_FILE:
 			case OTBM_ATTR_EXT_ZONE_FILE: {
-				map->zonesfile = map->path.string().substr(0, map->path.string().rfind('/') + 1);
-				map->zonesfile += stream.getString();
+				const auto fileName = stream.getString();
+				setMapDataFile(*map, attr, fileName);
+				if (snapshot) {
+					snapshot->addAttribute(attr, fileName);
+				}
 			} break;
 
 			default:
@@ -116,134 +147,233 @@ void IOMap::parseMapDataAttributes(FileStream &stream, Map* map) {
 	}
 }
 
-void IOMap::parseTileArea(FileStream &stream, Map &map, const Position &pos) {
-	while (stream.startNode(OTBM_TILE_AREA)) {
-		const uint16_t base_x = stream.getU16();
-		const uint16_t base_y = stream.getU16();
-		const uint8_t base_z = stream.getU8();
+void IOMap::parseTileArea(FileStream &stream, Map &map, const Position &pos, IOMapSnapshot* snapshot) {
+	// Where each tile area node is, found without decoding any of them
+	std::vector<TileArea> areas;
+	for (auto begin = stream.tell(); stream.skipNode(OTBM_TILE_AREA); begin = stream.tell()) {
+		auto &area = areas.emplace_back();
+		area.begin = begin;
+		area.end = stream.tell();
+	}
+	if (areas.empty()) {
+		return;
+	}
 
-		while (stream.startNode()) {
-			const uint8_t tileType = stream.getU8();
-			if (tileType != OTBM_HOUSETILE && tileType != OTBM_TILE) {
-				throw IOMapException("Could not read tile type node.");
+	// The areas are decoded by the thread pool with a cache each, this thread shares them into the map in file order,
+	// as they would have been read one after another, and decodes areas itself whenever the next isn't done yet
+	std::mutex mutex;
+	std::condition_variable decoded;
+	size_t nextArea = 0;
+	const auto decodeNext = [&](BasicCache &cache, std::unique_lock<std::mutex> &lock) {
+		auto &area = areas[nextArea++];
+		lock.unlock();
+		try {
+			parseTileArea(stream, area, pos, cache);
+		} catch (...) {
+			area.error = std::current_exception();
+		}
+		lock.lock();
+		area.decoded = true;
+		decoded.notify_all();
+	};
+
+	const auto workers = std::min<size_t>(areas.size(), g_threadPool().get_thread_count());
+	std::vector<BasicCache> caches(workers);
+	BS::multi_future<void> futures;
+	if (workers > 1) {
+		futures = g_threadPool().submit_loop(1, workers, [&](const size_t worker) {
+			std::unique_lock lock(mutex);
+			while (nextArea < areas.size()) {
+				decodeNext(caches[worker], lock);
 			}
+		});
+	}
 
-			const auto tile = std::make_shared<BasicTile>();
+	std::exception_ptr error;
+	std::unique_lock lock(mutex);
+	for (auto &area : areas) {
+		while (!area.decoded) {
+			if (nextArea < areas.size()) {
+				decodeNext(caches.front(), lock);
+			} else {
+				decoded.wait(lock);
+			}
+		}
 
-			const uint8_t tileCoordsX = stream.getU8();
-			const uint8_t tileCoordsY = stream.getU8();
+		lock.unlock();
+		try {
+			if (area.error) {
+				std::rethrow_exception(area.error);
+			}
+			for (const auto &[houseId, position] : area.houses) {
+				if (!map.houses.addHouse(houseId)) {
+					throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not create house id: {}", position.x, position.y, position.z, houseId));
+				}
+				if (snapshot) {
+					snapshot->addHouse(houseId, position);
+				}
+			}
+			for (const auto &[zoneId, position] : area.zones) {
+				map.zonePositions.emplace_back(zoneId, position);
+				if (snapshot) {
+					snapshot->addZone(zoneId, position);
+				}
+			}
+			for (const auto &[position, hash, tile] : area.tiles) {
+				const auto sharedTile = map.setBasicTile(position.x, position.y, position.z, tile, hash);
+				if (snapshot) {
+					snapshot->addTile(position, sharedTile);
+				}
+			}
+		} catch (...) {
+			error = std::current_exception();
+		}
+		area = {};
+		lock.lock();
 
-			const uint16_t x = base_x + tileCoordsX + pos.x;
-			const uint16_t y = base_y + tileCoordsY + pos.y;
-			const auto z = static_cast<uint8_t>(base_z + pos.z);
+		if (error) {
+			// Nothing past it goes into the map, as reading the file one area after another would have stopped there
+			nextArea = areas.size();
+			break;
+		}
+	}
+	lock.unlock();
 
-			if (tileType == OTBM_HOUSETILE) {
-				tile->houseId = stream.getU32();
-				if (!map.houses.addHouse(tile->houseId)) {
-					throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not create house id: {}", x, y, z, tile->houseId));
-				}
+	futures.wait();
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
+
+void IOMap::parseTileArea(const FileStream &mapStream, TileArea &area, const Position &pos, BasicCache &cache) {
+	auto stream = mapStream.view(area.begin, area.end);
+	if (!stream.startNode(OTBM_TILE_AREA)) {
+		throw IOMapException("Could not read tile area node.");
+	}
+
+	const uint16_t base_x = stream.getU16();
+	const uint16_t base_y = stream.getU16();
+	const uint8_t base_z = stream.getU8();
+
+	while (stream.startNode()) {
+		const uint8_t tileType = stream.getU8();
+		if (tileType != OTBM_HOUSETILE && tileType != OTBM_TILE) {
+			throw IOMapException("Could not read tile type node.");
+		}
+
+		BasicTile tile;
+
+		const uint8_t tileCoordsX = stream.getU8();
+		const uint8_t tileCoordsY = stream.getU8();
+
+		const uint16_t x = base_x + tileCoordsX + pos.x;
+		const uint16_t y = base_y + tileCoordsY + pos.y;
+		const auto z = static_cast<uint8_t>(base_z + pos.z);
+
+		if (tileType == OTBM_HOUSETILE) {
+			tile.houseId = stream.getU32();
+			area.houses.emplace_back(tile.houseId, Position(x, y, z));
+		}
+
+		if (stream.isProp(OTBM_ATTR_TILE_FLAGS)) {
+			const uint32_t flags = stream.getU32();
+			if ((flags & OTBM_TILEFLAG_PROTECTIONZONE) != 0) {
+				tile.flags |= TILESTATE_PROTECTIONZONE;
+			} else if ((flags & OTBM_TILEFLAG_NOPVPZONE) != 0) {
+				tile.flags |= TILESTATE_NOPVPZONE;
+			} else if ((flags & OTBM_TILEFLAG_PVPZONE) != 0) {
+				tile.flags |= TILESTATE_PVPZONE;
 			}
 
-			if (stream.isProp(OTBM_ATTR_TILE_FLAGS)) {
-				const uint32_t flags = stream.getU32();
-				if ((flags & OTBM_TILEFLAG_PROTECTIONZONE) != 0) {
-					tile->flags |= TILESTATE_PROTECTIONZONE;
-				} else if ((flags & OTBM_TILEFLAG_NOPVPZONE) != 0) {
-					tile->flags |= TILESTATE_NOPVPZONE;
-				} else if ((flags & OTBM_TILEFLAG_PVPZONE) != 0) {
-					tile->flags |= TILESTATE_PVPZONE;
-				}
+			if ((flags & OTBM_TILEFLAG_NOLOGOUT) != 0) {
+				tile.flags |= TILESTATE_NOLOGOUT;
+			}
+		}
 
-				if ((flags & OTBM_TILEFLAG_NOLOGOUT) != 0) {
-					tile->flags |= TILESTATE_NOLOGOUT;
+		if (stream.isProp(OTBM_ATTR_ITEM)) {
+			const uint16_t id = stream.getU16();
+			const auto &iType = Item::items[id];
+
+			if (!tile.isHouse() || !iType.isBed()) {
+				BasicItem item;
+				item.id = id;
+
+				if (tile.isHouse() && iType.movable) {
+					g_logger().warn("[IOMap::loadMap] - "
+					                "Movable item with ID: {}, in house: {}, "
+					                "at position: x {}, y {}, z {}",
+					                id, tile.houseId, x, y, z);
+				} else if (iType.isGroundTile()) {
+					tile.ground = cache.share(std::move(item));
+				} else {
+					tile.items.emplace_back(cache.share(std::move(item)));
 				}
 			}
+		}
 
-			if (stream.isProp(OTBM_ATTR_ITEM)) {
-				const uint16_t id = stream.getU16();
-				const auto &iType = Item::items[id];
-
-				if (!tile->isHouse() || !iType.isBed()) {
-					const auto item = std::make_shared<BasicItem>();
-					item->id = id;
+		while (stream.startNode()) {
+			auto type = stream.getU8();
+			switch (type) {
+				case OTBM_ITEM: {
+					const uint16_t id = stream.getU16();
+					const auto &iType = Item::items[id];
+					BasicItem item;
+					item.id = id;
+
+					if (!item.unserializeItemNode(stream, x, y, z, cache)) {
+						throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Failed to load item {}, Node Type.", x, y, z, id));
+					}
 
-					if (tile->isHouse() && iType.movable) {
+					if (tile.isHouse() && (iType.isBed() || iType.isTrashHolder())) {
+						// nothing
+					} else if (tile.isHouse() && iType.movable) {
 						g_logger().warn("[IOMap::loadMap] - "
 						                "Movable item with ID: {}, in house: {}, "
 						                "at position: x {}, y {}, z {}",
-						                id, tile->houseId, x, y, z);
+						                id, tile.houseId, x, y, z);
 					} else if (iType.isGroundTile()) {
-						tile->ground = map.tryReplaceItemFromCache(item);
+						tile.ground = cache.share(std::move(item));
 					} else {
-						tile->items.emplace_back(map.tryReplaceItemFromCache(item));
+						tile.items.emplace_back(cache.share(std::move(item)));
 					}
-				}
-			}
-
-			while (stream.startNode()) {
-				auto type = stream.getU8();
-				switch (type) {
-					case OTBM_ITEM: {
-						const uint16_t id = stream.getU16();
-						const auto &iType = Item::items[id];
-						const auto item = std::make_shared<BasicItem>();
-						item->id = id;
-
-						if (!item->unserializeItemNode(stream, x, y, z)) {
-							throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Failed to load item {}, Node Type.", x, y, z, id));
-						}
-
-						if (tile->isHouse() && (iType.isBed() || iType.isTrashHolder())) {
-							// nothing
-						} else if (tile->isHouse() && iType.movable) {
-							g_logger().warn("[IOMap::loadMap] - "
-							                "Movable item with ID: {}, in house: {}, "
-							                "at position: x {}, y {}, z {}",
-							                id, tile->houseId, x, y, z);
-						} else if (iType.isGroundTile()) {
-							tile->ground = map.tryReplaceItemFromCache(item);
-						} else {
-							tile->items.emplace_back(map.tryReplaceItemFromCache(item));
-						}
-					} break;
-					case OTBM_TILE_ZONE: {
-						const auto zoneCount = stream.getU16();
-						for (uint16_t i = 0; i < zoneCount; ++i) {
-							const auto zoneId = stream.getU16();
-							if (!zoneId) {
-								throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Invalid zone id.", x, y, z));
-							}
-							auto zone = Zone::getZone(zoneId);
-							zone->addPosition(Position(x, y, z));
+				} break;
+				case OTBM_TILE_ZONE: {
+					const auto zoneCount = stream.getU16();
+					for (uint16_t i = 0; i < zoneCount; ++i) {
+						const auto zoneId = stream.getU16();
+						if (!zoneId) {
+							throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Invalid zone id.", x, y, z));
 						}
-					} break;
-					default:
-						throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not read item/zone node.", x, y, z));
-				}
-
-				if (!stream.endNode()) {
-					throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not end node.", x, y, z));
-				}
+						area.zones.emplace_back(zoneId, Position(x, y, z));
+					}
+				} break;
+				default:
+					throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not read item/zone node.", x, y, z));
 			}
 
 			if (!stream.endNode()) {
 				throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not end node.", x, y, z));
 			}
-
-			if (tile->isEmpty(true)) {
-				continue;
-			}
-
-			map.setBasicTile(x, y, z, tile);
 		}
 
 		if (!stream.endNode()) {
-			throw IOMapException("Could not end node.");
+			throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not end node.", x, y, z));
 		}
+
+		if (tile.isEmpty(true)) {
+			continue;
+		}
+
+		const auto hash = tile.hash();
+		area.tiles.emplace_back(Position(x, y, z), hash, cache.share(std::move(tile), hash));
+	}
+
+	if (!stream.endNode()) {
+		throw IOMapException("Could not end node.");
 	}
 }
 
-void IOMap::parseTowns(FileStream &stream, Map &map) {
+void IOMap::parseTowns(FileStream &stream, Map &map, IOMapSnapshot* snapshot) {
 	if (!stream.startNode(OTBM_TOWNS)) {
 		throw IOMapException("Could not read towns node.");
 	}
@@ -258,6 +388,9 @@ void IOMap::parseTowns(FileStream &stream, Map &map) {
 		auto town = map.towns.getOrCreateTown(townId);
 		town->setName(townName);
 		town->setTemplePos(Position(x, y, z));
+		if (snapshot) {
+			snapshot->addTown(townId, townName, Position(x, y, z));
+		}
 
 		if (!stream.endNode()) {
 			throw IOMapException("Could not end node.");
@@ -269,7 +402,7 @@ void IOMap::parseTowns(FileStream &stream, Map &map) {
 	}
 }
 
-void IOMap::parseWaypoints(FileStream &stream, Map &map) {
+void IOMap::parseWaypoints(FileStream &stream, Map &map, IOMapSnapshot* snapshot) {
 	if (!stream.startNode(OTBM_WAYPOINTS)) {
 		throw IOMapException("Could not read waypoints node.");
 	}
@@ -281,6 +414,9 @@ void IOMap::parseWaypoints(FileStream &stream, Map &map) {
 		const uint8_t z = stream.getU8();
 
 		map.waypoints[name] = Position(x, y, z);
+		if (snapshot) {
+			snapshot->addWaypoint(name, Position(x, y, z));
+		}
 
 		if (!stream.endNode()) {
 			throw IOMapException("Could not end node.");
@@ -19,10 +19,20 @@
 #include "creatures/monsters/spawns/spawn_monster.hpp"
 #include "creatures/npcs/spawns/spawn_npc.hpp"
 #include "game/zones/zone.hpp"
+#include "io/filestream.hpp"
+
+class IOMapSnapshot;
 
 class IOMap {
 public:
-	static void loadMap(Map* map, const Position &pos = Position());
+	/**
+	 * Load a map file
+	 * \param useSnapshot if true, the snapshot of the map is loaded instead while up to date, else it is compiled again
+	 */
+	static void loadMap(Map* map, const Position &pos = Position(), bool useSnapshot = false);
+
+	// Sets the monster, npc, house or zone file the map data names, relative to the map
+	static void setMapDataFile(Map &map, uint8_t attribute, const std::string &fileName);
 
 	/**
 	 * Load main map monsters
@@ -150,10 +160,25 @@ public:
 	}
 
 private:
-	static void parseMapDataAttributes(FileStream &stream, Map* map);
-	static void parseWaypoints(FileStream &stream, Map &map);
-	static void parseTowns(FileStream &stream, Map &map);
-	static void parseTileArea(FileStream &stream, Map &map, const Position &pos);
+	// A tile area node of the map file, decoded apart from the others
+	struct TileArea {
+		// Where the node is in the map stream, decoded from a view of it
+		uint32_t begin = 0;
+		uint32_t end = 0;
+		bool decoded = false;
+		std::exception_ptr error;
+
+		std::vector<std::tuple<Position, size_t, std::shared_ptr<BasicTile>>> tiles;
+		std::vector<std::pair<uint32_t, Position>> houses;
+		std::vector<std::pair<uint16_t, Position>> zones;
+	};
+
+	// The snapshot, if any, records what each of them adds to the map
+	static void parseMapDataAttributes(FileStream &stream, Map* map, IOMapSnapshot* snapshot);
+	static void parseWaypoints(FileStream &stream, Map &map, IOMapSnapshot* snapshot);
+	static void parseTowns(FileStream &stream, Map &map, IOMapSnapshot* snapshot);
+	static void parseTileArea(FileStream &stream, Map &map, const Position &pos, IOMapSnapshot* snapshot);
+	static void parseTileArea(const FileStream &mapStream, TileArea &area, const Position &pos, BasicCache &cache);
 };
 
 class IOMapException : public std::exception {
@@ -0,0 +1,413 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "io/iomapsnapshot.hpp"
+
+#include "io/iomap.hpp"
+#include "items/item.hpp"
+#include "map/map.hpp"
+#include "utils/hash.hpp"
+
+static constexpr std::array<char, 4> SNAPSHOT_IDENTIFIER = { 'O', 'T', 'M', 'S' };
+
+// Records are unpadded and the file holds no pointer to them, so they are copied out rather than cast in place
+template <typename T>
+static T readRecord(const char* table, size_t index) {
+	T record;
+	std::memcpy(&record, table + index * sizeof(T), sizeof(T));
+	return record;
+}
+
+IOMapSnapshot::IOMapSnapshot(const Position &offset) :
+	offset(offset) { }
+
+std::filesystem::path IOMapSnapshot::getPath(const std::filesystem::path &mapPath) {
+	return std::filesystem::path(mapPath).replace_extension(".snapshot");
+}
+
+uint64_t IOMapSnapshot::getItemsFingerprint() {
+	// What reading a tile asks of the item types, see IOMap::parseTileArea
+	size_t fingerprint = 0;
+	for (const auto &itemType : Item::items.getItems()) {
+		stdext::hash_combine(fingerprint, itemType.id);
+		stdext::hash_combine(fingerprint, static_cast<uint32_t>(itemType.group));
+		stdext::hash_combine(fingerprint, static_cast<uint32_t>(itemType.type));
+		stdext::hash_combine(fingerprint, static_cast<uint8_t>(itemType.movable));
+	}
+	return fingerprint;
+}
+
+bool IOMapSnapshot::isCompiledFrom(const Header &header, const std::filesystem::path &mapPath) {
+	std::error_code error;
+	const auto mapSize = std::filesystem::file_size(mapPath, error);
+	if (error || header.mapSize != mapSize) {
+		return false;
+	}
+
+	const auto mapWriteTime = std::filesystem::last_write_time(mapPath, error);
+	if (error || header.mapWriteTime != static_cast<int64_t>(mapWriteTime.time_since_epoch().count())) {
+		return false;
+	}
+
+	return header.itemsFingerprint == getItemsFingerprint();
+}
+
+bool IOMapSnapshot::load(Map &map, const std::filesystem::path &mapPath, const Position &offset) {
+	const auto path = getPath(mapPath);
+	if (std::endian::native != std::endian::little || !std::filesystem::exists(path)) {
+		return false;
+	}
+
+	mio::mmap_source file;
+	try {
+		file = mio::mmap_source(path.string());
+	} catch (const std::system_error &e) {
+		g_logger().warn("[IOMapSnapshot::load] - Could not open {}: {}", path.filename().string(), e.what());
+		return false;
+	}
+
+	Header header;
+	if (file.size() < sizeof(Header)) {
+		g_logger().warn("[IOMapSnapshot::load] - {} is corrupted, reading the map instead", path.filename().string());
+		return false;
+	}
+	std::memcpy(&header, file.data(), sizeof(Header));
+
+	if (header.identifier != SNAPSHOT_IDENTIFIER || header.version != VERSION || !isCompiledFrom(header, mapPath)) {
+		g_logger().info("The snapshot of {} is out of date, reading the map instead", mapPath.filename().string());
+		return false;
+	}
+
+	const uint64_t expectedSize = sizeof(Header) + uint64_t { header.strings }
+		+ uint64_t { header.items } * sizeof(ItemRecord) + uint64_t { header.itemRefs } * sizeof(uint32_t)
+		+ uint64_t { header.tiles } * sizeof(TileRecord) + uint64_t { header.placements } * sizeof(PlacementRecord)
+		+ uint64_t { header.houses } * sizeof(HouseRecord) + uint64_t { header.zones } * sizeof(ZoneRecord)
+		+ uint64_t { header.towns } * sizeof(TownRecord) + uint64_t { header.waypoints } * sizeof(WaypointRecord)
+		+ uint64_t { header.attributes } * sizeof(AttributeRecord);
+	if (file.size() != expectedSize) {
+		g_logger().warn("[IOMapSnapshot::load] - {} is corrupted, reading the map instead", path.filename().string());
+		return false;
+	}
+
+	// Where each table starts, the file holding nothing else
+	const char* strings = file.data() + sizeof(Header);
+	const char* items = strings + header.strings;
+	const char* itemRefs = items + header.items * sizeof(ItemRecord);
+	const char* tiles = itemRefs + header.itemRefs * sizeof(uint32_t);
+	const char* placements = tiles + header.tiles * sizeof(TileRecord);
+	const char* houses = placements + header.placements * sizeof(PlacementRecord);
+	const char* zones = houses + header.houses * sizeof(HouseRecord);
+	const char* towns = zones + header.zones * sizeof(ZoneRecord);
+	const char* waypoints = towns + header.towns * sizeof(TownRecord);
+	const char* attributes = waypoints + header.waypoints * sizeof(WaypointRecord);
+
+	const auto toString = [&](const StringRef &ref) {
+		return std::string(strings + ref.offset, ref.length);
+	};
+	const auto isString = [&](const StringRef &ref) {
+		return uint64_t { ref.offset } + ref.length <= header.strings;
+	};
+	const auto isRefs = [&](uint32_t first, uint32_t count) {
+		return uint64_t { first } + count <= header.itemRefs;
+	};
+
+	// Nothing goes into the map unless the whole file is sound
+	bool valid = true;
+	for (uint32_t i = 0; valid && i < header.items; ++i) {
+		const auto record = readRecord<ItemRecord>(items, i);
+		valid = isString(record.text) && isRefs(record.firstItem, record.itemCount);
+		for (uint32_t ref = 0; valid && ref < record.itemCount; ++ref) {
+			valid = readRecord<uint32_t>(itemRefs, record.firstItem + ref) < i;
+		}
+	}
+	for (uint32_t i = 0; valid && i < header.tiles; ++i) {
+		const auto record = readRecord<TileRecord>(tiles, i);
+		valid = (record.ground == NO_ITEM || record.ground < header.items) && isRefs(record.firstItem, record.itemCount);
+		for (uint32_t ref = 0; valid && ref < record.itemCount; ++ref) {
+			valid = readRecord<uint32_t>(itemRefs, record.firstItem + ref) < header.items;
+		}
+	}
+	for (uint32_t i = 0; valid && i < header.placements; ++i) {
+		valid = readRecord<PlacementRecord>(placements, i).tile < header.tiles;
+	}
+	for (uint32_t i = 0; valid && i < header.towns; ++i) {
+		valid = isString(readRecord<TownRecord>(towns, i).name);
+	}
+	for (uint32_t i = 0; valid && i < header.waypoints; ++i) {
+		valid = isString(readRecord<WaypointRecord>(waypoints, i).name);
+	}
+	for (uint32_t i = 0; valid && i < header.attributes; ++i) {
+		valid = isString(readRecord<AttributeRecord>(attributes, i).value);
+	}
+	if (!valid) {
+		g_logger().warn("[IOMapSnapshot::load] - {} is corrupted, reading the map instead", path.filename().string());
+		return false;
+	}
+
+	// The items and tiles are distinct already, so they are built once each and shared as they are
+	std::vector<std::shared_ptr<BasicItem>> sharedItems(header.items);
+	for (uint32_t i = 0; i < header.items; ++i) {
+		const auto record = readRecord<ItemRecord>(items, i);
+		const auto &item = sharedItems[i] = std::make_shared<BasicItem>();
+		item->id = record.id;
+		item->charges = record.charges;
+		item->actionId = record.actionId;
+		item->uniqueId = record.uniqueId;
+		item->destX = record.destX;
+		item->destY = record.destY;
+		item->destZ = record.destZ;
+		item->doorOrDepotId = record.doorOrDepotId;
+		item->text = toString(record.text);
+		item->items.reserve(record.itemCount);
+		for (uint32_t ref = 0; ref < record.itemCount; ++ref) {
+			item->items.emplace_back(sharedItems[readRecord<uint32_t>(itemRefs, record.firstItem + ref)]);
+		}
+	}
+
+	std::vector<std::shared_ptr<BasicTile>> sharedTiles(header.tiles);
+	for (uint32_t i = 0; i < header.tiles; ++i) {
+		const auto record = readRecord<TileRecord>(tiles, i);
+		const auto &tile = sharedTiles[i] = std::make_shared<BasicTile>();
+		tile->flags = record.flags;
+		tile->houseId = record.houseId;
+		tile->type = record.type;
+		tile->isStatic = record.isStatic != 0;
+		if (record.ground != NO_ITEM) {
+			tile->ground = sharedItems[record.ground];
+		}
+		tile->items.reserve(record.itemCount);
+		for (uint32_t ref = 0; ref < record.itemCount; ++ref) {
+			tile->items.emplace_back(sharedItems[readRecord<uint32_t>(itemRefs, record.firstItem + ref)]);
+		}
+	}
+
+	const auto absolute = [&offset](const PositionRecord &position) {
+		return Position(static_cast<uint16_t>(position.x + offset.x), static_cast<uint16_t>(position.y + offset.y), static_cast<uint8_t>(position.z + offset.z));
+	};
+
+	map.width = header.width;
+	map.height = header.height;
+
+	for (uint32_t i = 0; i < header.attributes; ++i) {
+		const auto record = readRecord<AttributeRecord>(attributes, i);
+		IOMap::setMapDataFile(map, record.attribute, toString(record.value));
+	}
+
+	for (uint32_t i = 0; i < header.houses; ++i) {
+		const auto record = readRecord<HouseRecord>(houses, i);
+		if (!map.houses.addHouse(record.houseId)) {
+			const auto position = absolute(record.position);
+			throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not create house id: {}", position.x, position.y, position.z, record.houseId));
+		}
+	}
+
+	for (uint32_t i = 0; i < header.zones; ++i) {
+		const auto record = readRecord<ZoneRecord>(zones, i);
+		map.zonePositions.emplace_back(record.zoneId, absolute(record.position));
+	}
+
+	for (uint32_t i = 0; i < header.placements; ++i) {
+		const auto record = readRecord<PlacementRecord>(placements, i);
+		const auto position = absolute(record.position);
+		map.setSharedBasicTile(position.x, position.y, position.z, sharedTiles[record.tile]);
+	}
+
+	for (uint32_t i = 0; i < header.towns; ++i) {
+		const auto record = readRecord<TownRecord>(towns, i);
+		const auto town = map.towns.getOrCreateTown(record.townId);
+		town->setName(toString(record.name));
+		town->setTemplePos(Position(record.templePosition.x, record.templePosition.y, record.templePosition.z));
+	}
+
+	for (uint32_t i = 0; i < header.waypoints; ++i) {
+		const auto record = readRecord<WaypointRecord>(waypoints, i);
+		map.waypoints[toString(record.name)] = Position(record.position.x, record.position.y, record.position.z);
+	}
+
+	return true;
+}
+
+void IOMapSnapshot::setSize(uint16_t newWidth, uint16_t newHeight) {
+	width = newWidth;
+	height = newHeight;
+}
+
+void IOMapSnapshot::addAttribute(uint8_t attribute, const std::string &value) {
+	attributes.emplace_back(AttributeRecord { attribute, addString(value) });
+}
+
+void IOMapSnapshot::addHouse(uint32_t houseId, const Position &position) {
+	houses.emplace_back(HouseRecord { houseId, relative(position) });
+}
+
+void IOMapSnapshot::addZone(uint16_t zoneId, const Position &position) {
+	zones.emplace_back(ZoneRecord { zoneId, relative(position) });
+}
+
+void IOMapSnapshot::addTile(const Position &position, const std::shared_ptr<BasicTile> &tile) {
+	if (!tile) {
+		return;
+	}
+
+	const auto [it, inserted] = tileIndex.try_emplace(tile.get(), static_cast<uint32_t>(tiles.size()));
+	if (inserted) {
+		TileRecord record;
+		record.flags = tile->flags;
+		record.houseId = tile->houseId;
+		record.type = tile->type;
+		record.isStatic = tile->isStatic ? 1 : 0;
+		if (tile->ground) {
+			record.ground = addItem(tile->ground);
+		}
+
+		std::vector<uint32_t> refs;
+		refs.reserve(tile->items.size());
+		for (const auto &item : tile->items) {
+			refs.emplace_back(addItem(item));
+		}
+		record.firstItem = static_cast<uint32_t>(itemRefs.size());
+		record.itemCount = static_cast<uint32_t>(refs.size());
+		itemRefs.insert(itemRefs.end(), refs.begin(), refs.end());
+
+		tiles.emplace_back(record);
+	}
+
+	placements.emplace_back(PlacementRecord { relative(position), it->second });
+}
+
+void IOMapSnapshot::addTown(uint32_t townId, const std::string &name, const Position &templePosition) {
+	towns.emplace_back(TownRecord { townId, addString(name), { templePosition.x, templePosition.y, templePosition.z } });
+}
+
+void IOMapSnapshot::addWaypoint(const std::string &name, const Position &position) {
+	waypoints.emplace_back(WaypointRecord { addString(name), { position.x, position.y, position.z } });
+}
+
+uint32_t IOMapSnapshot::addItem(const std::shared_ptr<BasicItem> &item) {
+	if (const auto it = itemIndex.find(item.get()); it != itemIndex.end()) {
+		return it->second;
+	}
+
+	// The items it contains go first, so that loading only ever looks back
+	std::vector<uint32_t> refs;
+	refs.reserve(item->items.size());
+	for (const auto &child : item->items) {
+		refs.emplace_back(addItem(child));
+	}
+
+	ItemRecord record;
+	record.id = item->id;
+	record.charges = item->charges;
+	record.actionId = item->actionId;
+	record.uniqueId = item->uniqueId;
+	record.destX = item->destX;
+	record.destY = item->destY;
+	record.destZ = item->destZ;
+	record.doorOrDepotId = item->doorOrDepotId;
+	record.text = addString(item->text);
+	record.firstItem = static_cast<uint32_t>(itemRefs.size());
+	record.itemCount = static_cast<uint32_t>(refs.size());
+	itemRefs.insert(itemRefs.end(), refs.begin(), refs.end());
+
+	const auto index = static_cast<uint32_t>(items.size());
+	items.emplace_back(record);
+	itemIndex.emplace(item.get(), index);
+	return index;
+}
+
+IOMapSnapshot::StringRef IOMapSnapshot::addString(const std::string &value) {
+	if (value.empty()) {
+		return {};
+	}
+
+	const StringRef ref { static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(value.size()) };
+	strings += value;
+	return ref;
+}
+
+IOMapSnapshot::PositionRecord IOMapSnapshot::relative(const Position &position) const {
+	return {
+		static_cast<uint16_t>(position.x - offset.x),
+		static_cast<uint16_t>(position.y - offset.y),
+		static_cast<uint8_t>(position.z - offset.z),
+	};
+}
+
+bool IOMapSnapshot::save(const std::filesystem::path &mapPath) const {
+	if constexpr (std::endian::native != std::endian::little) {
+		return false;
+	}
+
+	const auto path = getPath(mapPath);
+
+	Header header;
+	header.identifier = SNAPSHOT_IDENTIFIER;
+	header.version = VERSION;
+
+	std::error_code error;
+	header.mapSize = std::filesystem::file_size(mapPath, error);
+	if (!error) {
+		header.mapWriteTime = static_cast<int64_t>(std::filesystem::last_write_time(mapPath, error).time_since_epoch().count());
+	}
+	if (error) {
+		g_logger().warn("[IOMapSnapshot::save] - Could not stat {}: {}", mapPath.filename().string(), error.message());
+		return false;
+	}
+
+	header.itemsFingerprint = getItemsFingerprint();
+	header.width = width;
+	header.height = height;
+	header.strings = static_cast<uint32_t>(strings.size());
+	header.items = static_cast<uint32_t>(items.size());
+	header.itemRefs = static_cast<uint32_t>(itemRefs.size());
+	header.tiles = static_cast<uint32_t>(tiles.size());
+	header.placements = static_cast<uint32_t>(placements.size());
+	header.houses = static_cast<uint32_t>(houses.size());
+	header.zones = static_cast<uint32_t>(zones.size());
+	header.towns = static_cast<uint32_t>(towns.size());
+	header.waypoints = static_cast<uint32_t>(waypoints.size());
+	header.attributes = static_cast<uint32_t>(attributes.size());
+
+	// Written aside then moved over the old one, so that a server stopped halfway never finds half a snapshot
+	auto temporaryPath = path;
+	temporaryPath += ".tmp";
+	{
+		std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+		const auto write = [&file](const auto &table) {
+			file.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(table.size() * sizeof(table[0])));
+		};
+		file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		write(strings);
+		write(items);
+		write(itemRefs);
+		write(tiles);
+		write(placements);
+		write(houses);
+		write(zones);
+		write(towns);
+		write(waypoints);
+		write(attributes);
+
+		if (!file) {
+			g_logger().warn("[IOMapSnapshot::save] - Could not write {}", temporaryPath.string());
+			file.close();
+			std::filesystem::remove(temporaryPath, error);
+			return false;
+		}
+	}
+
+	std::filesystem::rename(temporaryPath, path, error);
+	if (error) {
+		g_logger().warn("[IOMapSnapshot::save] - Could not write {}: {}", path.string(), error.message());
+		std::filesystem::remove(temporaryPath, error);
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,172 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "game/movement/position.hpp"
+
+class Map;
+struct BasicItem;
+struct BasicTile;
+
+/**
+ * A map file compiled into flat tables of its distinct items and tiles, with where each tile goes, the houses,
+ * zones, towns and waypoints, to be loaded by mapping the file instead of decoding the map again.
+ *
+ * It is written next to the map after reading it, and only loaded while the map file and the item types are those
+ * it was compiled from, as the item types decide which items of a tile are kept and which one is the ground.
+ */
+class IOMapSnapshot {
+public:
+	// Increase when the layout of the file changes, older snapshots are then compiled again
+	static constexpr uint32_t VERSION = 1;
+
+	// The offset the map is loaded at, for the snapshot to hold the positions of the map file
+	explicit IOMapSnapshot(const Position &offset);
+
+	static std::filesystem::path getPath(const std::filesystem::path &mapPath);
+
+	/**
+	 * Loads the snapshot of the map file into the map
+	 * \returns false if there is none or it is out of date, for the map file to be read instead
+	 */
+	static bool load(Map &map, const std::filesystem::path &mapPath, const Position &offset);
+
+	// What reading the map file added to the map, in the order it was read
+	void setSize(uint16_t width, uint16_t height);
+	void addAttribute(uint8_t attribute, const std::string &value);
+	void addHouse(uint32_t houseId, const Position &position);
+	void addZone(uint16_t zoneId, const Position &position);
+	void addTile(const Position &position, const std::shared_ptr<BasicTile> &tile);
+	void addTown(uint32_t townId, const std::string &name, const Position &templePosition);
+	void addWaypoint(const std::string &name, const Position &position);
+
+	bool save(const std::filesystem::path &mapPath) const;
+
+private:
+	// The records of the file, little endian and unpadded, each table an array of them after the header
+#pragma pack(1)
+	struct StringRef {
+		uint32_t offset = 0;
+		uint32_t length = 0;
+	};
+
+	struct PositionRecord {
+		uint16_t x = 0;
+		uint16_t y = 0;
+		uint8_t z = 0;
+	};
+
+	struct Header {
+		std::array<char, 4> identifier {};
+		uint32_t version = 0;
+		// What the map was compiled from
+		uint64_t mapSize = 0;
+		int64_t mapWriteTime = 0;
+		uint64_t itemsFingerprint = 0;
+		uint16_t width = 0;
+		uint16_t height = 0;
+		// The number of records of each table, in the order they follow
+		uint32_t strings = 0;
+		uint32_t items = 0;
+		uint32_t itemRefs = 0;
+		uint32_t tiles = 0;
+		uint32_t placements = 0;
+		uint32_t houses = 0;
+		uint32_t zones = 0;
+		uint32_t towns = 0;
+		uint32_t waypoints = 0;
+		uint32_t attributes = 0;
+	};
+
+	// Items come after the items they contain, which are listed in itemRefs
+	struct ItemRecord {
+		uint16_t id = 0;
+		uint16_t charges = 0;
+		uint16_t actionId = 0;
+		uint16_t uniqueId = 0;
+		uint16_t destX = 0;
+		uint16_t destY = 0;
+		uint8_t destZ = 0;
+		uint16_t doorOrDepotId = 0;
+		StringRef text;
+		uint32_t firstItem = 0;
+		uint32_t itemCount = 0;
+	};
+
+	struct TileRecord {
+		uint32_t flags = 0;
+		uint32_t houseId = 0;
+		uint8_t type = 0;
+		uint8_t isStatic = 0;
+		uint32_t ground = NO_ITEM;
+		uint32_t firstItem = 0;
+		uint32_t itemCount = 0;
+	};
+
+	struct PlacementRecord {
+		PositionRecord position;
+		uint32_t tile = 0;
+	};
+
+	struct HouseRecord {
+		uint32_t houseId = 0;
+		PositionRecord position;
+	};
+
+	struct ZoneRecord {
+		uint16_t zoneId = 0;
+		PositionRecord position;
+	};
+
+	struct TownRecord {
+		uint32_t townId = 0;
+		StringRef name;
+		PositionRecord templePosition;
+	};
+
+	struct WaypointRecord {
+		StringRef name;
+		PositionRecord position;
+	};
+
+	struct AttributeRecord {
+		uint8_t attribute = 0;
+		StringRef value;
+	};
+#pragma pack()
+
+	static constexpr uint32_t NO_ITEM = std::numeric_limits<uint32_t>::max();
+
+	static uint64_t getItemsFingerprint();
+	static bool isCompiledFrom(const Header &header, const std::filesystem::path &mapPath);
+
+	uint32_t addItem(const std::shared_ptr<BasicItem> &item);
+	StringRef addString(const std::string &value);
+	PositionRecord relative(const Position &position) const;
+
+	Position offset;
+	uint16_t width = 0;
+	uint16_t height = 0;
+
+	std::string strings;
+	std::vector<ItemRecord> items;
+	std::vector<uint32_t> itemRefs;
+	std::vector<TileRecord> tiles;
+	std::vector<PlacementRecord> placements;
+	std::vector<HouseRecord> houses;
+	std::vector<ZoneRecord> zones;
+	std::vector<TownRecord> towns;
+	std::vector<WaypointRecord> waypoints;
+	std::vector<AttributeRecord> attributes;
+
+	// Where each distinct item and tile went in their tables
+	phmap::flat_hash_map<const BasicItem*, uint32_t> itemIndex;
+	phmap::flat_hash_map<const BasicTile*, uint32_t> tileIndex;
+};
@@ -17,6 +17,7 @@
 #include "io/iologindata.hpp"
 #include "items/containers/inbox/inbox.hpp"
 #include "creatures/players/player.hpp"
+#include "lib/thread/thread_pool.hpp"
 
 uint8_t IOMarket::getTierFromDatabaseTable(const std::string &string) {
 	auto tier = static_cast<uint8_t>(std::atoi(string.c_str()));
@@ -28,105 +29,108 @@ uint8_t IOMarket::getTierFromDatabaseTable(const std::string &string) {
 	return tier;
 }
 
-MarketOfferList IOMarket::getActiveOffers(MarketAction_t action) {
-	MarketOfferList offerList;
+MarketOffer IOMarket::toMarketOffer(const MarketOrder &order) {
+	MarketOffer offer;
+	offer.itemId = order.itemId;
+	offer.amount = order.amount;
+	offer.price = order.price;
+	offer.timestamp = order.created + g_configManager().getNumber(MARKET_OFFER_DURATION);
+	offer.counter = order.getCounter();
+	offer.playerName = order.anonymous ? "Anonymous" : order.playerName;
+	offer.tier = order.tier;
+	return offer;
+}
 
-	std::string query = fmt::format(
-		"SELECT `id`, `itemtype`, `amount`, `price`, `tier`, `created`, `anonymous`, "
-		"(SELECT `name` FROM `players` WHERE `id` = `player_id`) AS `player_name` "
-		"FROM `market_offers` WHERE `sale` = {}",
-		action
+void IOMarket::loadOffers() {
+	orderBook.clear();
+
+	DBResult_ptr result = g_database().storeQuery(
+		"SELECT `o`.`id`, `o`.`player_id`, `o`.`sale`, `o`.`itemtype`, `o`.`amount`, `o`.`created`, `o`.`anonymous`, `o`.`price`, `o`.`tier`, `p`.`name` AS `player_name` "
+		"FROM `market_offers` AS `o` LEFT JOIN `players` AS `p` ON `p`.`id` = `o`.`player_id`",
+		{}
 	);
+	if (result) {
+		do {
+			MarketOrder order;
+			order.id = result->getNumber<uint32_t>("id");
+			order.playerId = result->getNumber<uint32_t>("player_id");
+			order.side = static_cast<MarketAction_t>(result->getNumber<uint16_t>("sale"));
+			order.itemId = result->getNumber<uint16_t>("itemtype");
+			order.amount = result->getNumber<uint16_t>("amount");
+			order.created = result->getNumber<uint32_t>("created");
+			order.anonymous = result->getNumber<bool>("anonymous");
+			order.price = result->getNumber<uint64_t>("price");
+			order.tier = getTierFromDatabaseTable(result->getString("tier"));
+			order.playerName = result->getString("player_name");
+			orderBook.add(std::move(order));
+		} while (result->next());
+	}
 
-	DBResult_ptr result = g_database().storeQuery(query);
-	if (!result) {
-		return offerList;
+	// Ids of new offers are given here, so the client counters are known before they are written
+	nextOfferId = orderBook.getMaxId() + 1;
+	g_logger().info("Loaded {} market offers", orderBook.size());
+}
+
+void IOMarket::persist(std::function<bool()> write) {
+	std::scoped_lock lock(writesMutex);
+	pendingWrites.emplace_back(std::move(write));
+	if (flushing) {
+		return;
 	}
 
-	const int32_t marketOfferDuration = g_configManager().getNumber(MARKET_OFFER_DURATION);
+	flushing = true;
+	g_threadPool().detach_task([this] { flushWrites(); });
+}
+
+void IOMarket::flushWrites() {
+	while (true) {
+		std::function<bool()> write;
+		{
+			std::scoped_lock lock(writesMutex);
+			if (pendingWrites.empty()) {
+				flushing = false;
+				return;
+			}
+			write = std::move(pendingWrites.front());
+			pendingWrites.pop_front();
+		}
 
-	do {
-		MarketOffer offer;
-		offer.itemId = result->getNumber<uint16_t>("itemtype");
-		offer.amount = result->getNumber<uint16_t>("amount");
-		offer.price = result->getNumber<uint64_t>("price");
-		offer.timestamp = result->getNumber<uint32_t>("created") + marketOfferDuration;
-		offer.counter = (result->getNumber<uint32_t>("id") ^ 0xABCDEF) & 0xFFFF;
-		if (result->getNumber<uint16_t>("anonymous") == 0) {
-			offer.playerName = result->getString("player_name");
-		} else {
-			offer.playerName = "Anonymous";
+		if (!write()) {
+			g_logger().error("[{}] Failed to write a market offer change", __FUNCTION__);
 		}
-		offer.tier = getTierFromDatabaseTable(result->getString("tier"));
-		offerList.push_back(offer);
-	} while (result->next());
+	}
+}
+
+MarketOfferList IOMarket::getActiveOffers(MarketAction_t action) {
+	MarketOfferList offerList;
+	for (const auto &order : getInstance().orderBook.getOrders(action)) {
+		offerList.push_back(toMarketOffer(order));
+	}
 	return offerList;
 }
 
 MarketOfferList IOMarket::getActiveOffers(MarketAction_t action, uint16_t itemId, uint8_t tier) {
 	MarketOfferList offerList;
-
-	std::ostringstream query;
-	query << "SELECT `id`, `amount`, `price`, `tier`, `created`, `anonymous`, (SELECT `name` FROM `players` WHERE `id` = `player_id`) AS `player_name` FROM `market_offers` WHERE `sale` = " << action << " AND `itemtype` = " << itemId << " AND `tier` = " << std::to_string(tier);
-
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
-	if (!result) {
-		return offerList;
+	for (const auto &order : getInstance().orderBook.getOrders(action, itemId, tier)) {
+		offerList.push_back(toMarketOffer(order));
 	}
-
-	const int32_t marketOfferDuration = g_configManager().getNumber(MARKET_OFFER_DURATION);
-
-	do {
-		MarketOffer offer;
-		offer.itemId = itemId;
-		offer.amount = result->getNumber<uint16_t>("amount");
-		offer.price = result->getNumber<uint64_t>("price");
-		offer.timestamp = result->getNumber<uint32_t>("created") + marketOfferDuration;
-		offer.counter = (result->getNumber<uint32_t>("id") ^ 0xABCDEF) & 0xFFFF;
-		if (result->getNumber<uint16_t>("anonymous") == 0) {
-			offer.playerName = result->getString("player_name");
-		} else {
-			offer.playerName = "Anonymous";
-		}
-		offer.tier = getTierFromDatabaseTable(result->getString("tier"));
-		offerList.push_back(offer);
-	} while (result->next());
 	return offerList;
 }
 
 MarketOfferList IOMarket::getOwnOffers(MarketAction_t action, uint32_t playerId) {
 	MarketOfferList offerList;
-
-	const int32_t marketOfferDuration = g_configManager().getNumber(MARKET_OFFER_DURATION);
-
-	std::ostringstream query;
-	query << "SELECT `id`, `amount`, `price`, `created`, `itemtype`, `tier` FROM `market_offers` WHERE `player_id` = " << playerId << " AND `sale` = " << action;
-
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
-	if (!result) {
-		return offerList;
+	for (const auto &order : getInstance().orderBook.getPlayerOrders(action, playerId)) {
+		auto offer = toMarketOffer(order);
+		offer.playerName.clear();
+		offerList.push_back(std::move(offer));
 	}
-
-	do {
-		MarketOffer offer;
-		offer.amount = result->getNumber<uint16_t>("amount");
-		offer.price = result->getNumber<uint64_t>("price");
-		offer.timestamp = result->getNumber<uint32_t>("created") + marketOfferDuration;
-		offer.counter = (result->getNumber<uint32_t>("id") ^ 0xABCDEF) & 0xFFFF;
-		offer.itemId = result->getNumber<uint16_t>("itemtype");
-		offer.tier = getTierFromDatabaseTable(result->getString("tier"));
-		offerList.push_back(offer);
-	} while (result->next());
 	return offerList;
 }
 
 HistoryMarketOfferList IOMarket::getOwnHistory(MarketAction_t action, uint32_t playerId) {
 	HistoryMarketOfferList offerList;
 
-	std::ostringstream query;
-	query << "SELECT `itemtype`, `amount`, `price`, `expires_at`, `state`, `tier` FROM `market_history` WHERE `player_id` = " << playerId << " AND `sale` = " << action;
-
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
+	DBResult_ptr result = g_database().storeQuery("SELECT `itemtype`, `amount`, `price`, `expires_at`, `state`, `tier` FROM `market_history` WHERE `player_id` = ? AND `sale` = ?", { playerId, action });
 	if (!result) {
 		return offerList;
 	}
@@ -151,21 +155,20 @@ HistoryMarketOfferList IOMarket::getOwnHistory(MarketAction_t action, uint32_t p
 	return offerList;
 }
 
-void IOMarket::processExpiredOffers(const DBResult_ptr &result, bool) {
-	if (!result) {
-		return;
-	}
-
-	do {
-		if (!IOMarket::moveOfferToHistory(result->getNumber<uint32_t>("id"), OFFERSTATE_EXPIRED)) {
-			continue;
-		}
-
-		const auto playerId = result->getNumber<uint32_t>("player_id");
-		const auto amount = result->getNumber<uint16_t>("amount");
-		auto tier = getTierFromDatabaseTable(result->getString("tier"));
-		if (result->getNumber<uint16_t>("sale") == 1) {
-			const ItemType &itemType = Item::items[result->getNumber<uint16_t>("itemtype")];
+void IOMarket::processExpiredOffers(const std::vector<MarketOrder> &offers) {
+	auto &market = getInstance();
+	for (const auto &offer : offers) {
+		const auto offerId = offer.id;
+		market.persist([offerId] {
+			return g_database().executeQuery("DELETE FROM `market_offers` WHERE `id` = ?", { offerId });
+		});
+		appendHistory(offer.playerId, offer.side, offer.itemId, offer.amount, offer.price, getTimeNow(), offer.tier, OFFERSTATE_EXPIRED);
+
+		const auto playerId = offer.playerId;
+		const auto amount = offer.amount;
+		auto tier = offer.tier;
+		if (offer.side == MARKETACTION_SELL) {
+			const ItemType &itemType = Item::items[offer.itemId];
 			if (itemType.id == 0) {
 				continue;
 			}
@@ -218,7 +221,7 @@ void IOMarket::processExpiredOffers(const DBResult_ptr &result, bool) {
 				g_saveManager().savePlayer(player);
 			}
 		} else {
-			uint64_t totalPrice = result->getNumber<uint64_t>("price") * amount;
+			uint64_t totalPrice = offer.price * amount;
 
 			const auto &player = g_game().getPlayerByGUID(playerId);
 			if (player) {
@@ -227,15 +230,17 @@ void IOMarket::processExpiredOffers(const DBResult_ptr &result, bool) {
 				IOLoginData::increaseBankBalance(playerId, totalPrice);
 			}
 		}
-	} while (result->next());
+	}
 }
 
 void IOMarket::checkExpiredOffers() {
 	const time_t lastExpireDate = getTimeNow() - g_configManager().getNumber(MARKET_OFFER_DURATION);
-
-	std::ostringstream query;
-	query << "SELECT `id`, `amount`, `price`, `itemtype`, `player_id`, `sale`, `tier` FROM `market_offers` WHERE `created` <= " << lastExpireDate;
-	g_databaseTasks().store(query.str(), IOMarket::processExpiredOffers);
+	if (lastExpireDate > 0) {
+		auto expired = getInstance().orderBook.takeExpired(static_cast<uint32_t>(lastExpireDate));
+		if (!expired.empty()) {
+			g_dispatcher().addEvent([expired = std::move(expired)] { processExpiredOffers(expired); }, __FUNCTION__);
+		}
+	}
 
 	int32_t checkExpiredMarketOffersEachMinutes = g_configManager().getNumber(CHECK_EXPIRED_MARKET_OFFERS_EACH_MINUTES);
 	if (checkExpiredMarketOffersEachMinutes <= 0) {
@@ -246,63 +251,76 @@ void IOMarket::checkExpiredOffers() {
 }
 
 uint32_t IOMarket::getPlayerOfferCount(uint32_t playerId) {
-	std::ostringstream query;
-	query << "SELECT COUNT(*) AS `count` FROM `market_offers` WHERE `player_id` = " << playerId;
-
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
-	if (!result) {
-		return 0;
-	}
-	return result->getNumber<int32_t>("count");
+	return static_cast<uint32_t>(getInstance().orderBook.countPlayerOrders(playerId));
 }
 
 MarketOfferEx IOMarket::getOfferByCounter(uint32_t timestamp, uint16_t counter) {
 	MarketOfferEx offer;
 
 	const int32_t created = timestamp - g_configManager().getNumber(MARKET_OFFER_DURATION);
-
-	std::ostringstream query;
-	query << "SELECT `id`, `sale`, `itemtype`, `amount`, `created`, `price`, `player_id`, `anonymous`, `tier`, (SELECT `name` FROM `players` WHERE `id` = `player_id`) AS `player_name` FROM `market_offers` WHERE `created` = " << created << " AND ((`id` ^ 0xABCDEF) & 65535) = " << counter << " LIMIT 1";
-
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
-	if (!result) {
+	const auto order = getInstance().orderBook.getByCounter(static_cast<uint32_t>(created), counter);
+	if (!order) {
 		offer.id = 0;
 		return offer;
 	}
 
-	offer.id = result->getNumber<uint32_t>("id");
-	offer.type = static_cast<MarketAction_t>(result->getNumber<uint16_t>("sale"));
-	offer.amount = result->getNumber<uint16_t>("amount");
-	offer.counter = (result->getNumber<uint32_t>("id") ^ 0xABCDEF) & 0xFFFF;
-	offer.timestamp = result->getNumber<uint32_t>("created");
-	offer.price = result->getNumber<uint64_t>("price");
-	offer.itemId = result->getNumber<uint16_t>("itemtype");
-	offer.playerId = result->getNumber<uint32_t>("player_id");
-	offer.tier = getTierFromDatabaseTable(result->getString("tier"));
-	if (result->getNumber<uint16_t>("anonymous") == 0) {
-		offer.playerName = result->getString("player_name");
-	} else {
-		offer.playerName = "Anonymous";
-	}
+	offer.id = order->id;
+	offer.type = order->side;
+	offer.amount = order->amount;
+	offer.counter = order->getCounter();
+	offer.timestamp = order->created;
+	offer.price = order->price;
+	offer.itemId = order->itemId;
+	offer.playerId = order->playerId;
+	offer.tier = order->tier;
+	offer.playerName = order->anonymous ? "Anonymous" : order->playerName;
 	return offer;
 }
 
-void IOMarket::createOffer(uint32_t playerId, MarketAction_t action, uint32_t itemId, uint16_t amount, uint64_t price, uint8_t tier, bool anonymous) {
-	std::ostringstream query;
-	query << "INSERT INTO `market_offers` (`player_id`, `sale`, `itemtype`, `amount`, `created`, `anonymous`, `price`, `tier`) VALUES (" << playerId << ',' << action << ',' << itemId << ',' << amount << ',' << getTimeNow() << ',' << anonymous << ',' << price << ',' << std::to_string(tier) << ')';
-	Database::getInstance().executeQuery(query.str());
+void IOMarket::createOffer(uint32_t playerId, const std::string &playerName, MarketAction_t action, uint32_t itemId, uint16_t amount, uint64_t price, uint8_t tier, bool anonymous) {
+	auto &market = getInstance();
+
+	MarketOrder order;
+	order.id = market.nextOfferId++;
+	order.playerId = playerId;
+	order.side = action;
+	order.itemId = static_cast<uint16_t>(itemId);
+	order.amount = amount;
+	order.created = static_cast<uint32_t>(getTimeNow());
+	order.anonymous = anonymous;
+	order.price = price;
+	order.tier = tier;
+	order.playerName = playerName;
+
+	const auto id = order.id;
+	const auto created = order.created;
+	market.orderBook.add(std::move(order));
+	market.persist([=] {
+		return g_database().executeQuery("INSERT INTO `market_offers` (`id`, `player_id`, `sale`, `itemtype`, `amount`, `created`, `anonymous`, `price`, `tier`) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)", { id, playerId, action, itemId, amount, created, anonymous, price, tier });
+	});
 }
 
 void IOMarket::acceptOffer(uint32_t offerId, uint16_t amount) {
-	std::ostringstream query;
-	query << "UPDATE `market_offers` SET `amount` = `amount` - " << amount << " WHERE `id` = " << offerId;
-	Database::getInstance().executeQuery(query.str());
+	auto &market = getInstance();
+	if (!market.orderBook.reduce(offerId, amount)) {
+		g_logger().error("[{}] Offer {} does not have {} left", __FUNCTION__, offerId, amount);
+		return;
+	}
+
+	market.persist([offerId, amount] {
+		return g_database().executeQuery("UPDATE `market_offers` SET `amount` = `amount` - ? WHERE `id` = ?", { amount, offerId });
+	});
 }
 
 void IOMarket::deleteOffer(uint32_t offerId) {
-	std::ostringstream query;
-	query << "DELETE FROM `market_offers` WHERE `id` = " << offerId;
-	Database::getInstance().executeQuery(query.str());
+	auto &market = getInstance();
+	if (!market.orderBook.remove(offerId)) {
+		return;
+	}
+
+	market.persist([offerId] {
+		return g_database().executeQuery("DELETE FROM `market_offers` WHERE `id` = ?", { offerId });
+	});
 }
 
 void IOMarket::appendHistory(uint32_t playerId, MarketAction_t type, uint16_t itemId, uint16_t amount, uint64_t price, time_t timestamp, uint8_t tier, MarketOfferState_t state) {
@@ -314,31 +332,16 @@ void IOMarket::appendHistory(uint32_t playerId, MarketAction_t type, uint16_t it
 }
 
 bool IOMarket::moveOfferToHistory(uint32_t offerId, MarketOfferState_t state) {
-	Database &db = Database::getInstance();
-
-	std::ostringstream query;
-	query << "SELECT `player_id`, `sale`, `itemtype`, `amount`, `price`, `created`, `tier` FROM `market_offers` WHERE `id` = " << offerId;
-
-	DBResult_ptr result = db.storeQuery(query.str());
-	if (!result) {
-		return false;
-	}
-
-	query.str(std::string());
-	query << "DELETE FROM `market_offers` WHERE `id` = " << offerId;
-	if (!db.executeQuery(query.str())) {
+	auto &market = getInstance();
+	const auto order = market.orderBook.remove(offerId);
+	if (!order) {
 		return false;
 	}
 
-	appendHistory(
-		result->getNumber<uint32_t>("player_id"),
-		static_cast<MarketAction_t>(result->getNumber<uint16_t>("sale")),
-		result->getNumber<uint16_t>("itemtype"),
-		result->getNumber<uint16_t>("amount"),
-		result->getNumber<uint64_t>("price"),
-		getTimeNow(),
-		getTierFromDatabaseTable(result->getString("tier")), state
-	);
+	market.persist([offerId] {
+		return g_database().executeQuery("DELETE FROM `market_offers` WHERE `id` = ?", { offerId });
+	});
+	appendHistory(order->playerId, order->side, order->itemId, order->amount, order->price, getTimeNow(), order->tier, state);
 	return true;
 }
 
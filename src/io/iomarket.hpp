@@ -11,8 +11,17 @@
 
 #include "database/database.hpp"
 #include "declarations.hpp"
+#include "io/market_order_book.hpp"
 #include "lib/di/container.hpp"
 
+/**
+ * Market offers and history.
+ *
+ * Active offers are loaded once into an order book and served from memory afterwards: browsing,
+ * looking offers up and expiring them never query the database. Changes to the offers are applied
+ * to the book right away and written behind, in order, by a single task on the thread pool.
+ * The book is authoritative while the server runs, offers must not be changed in the database meanwhile.
+ */
 class IOMarket {
 public:
 	IOMarket() = default;
@@ -26,13 +35,18 @@ public:
 	static MarketOfferList getOwnOffers(MarketAction_t action, uint32_t playerId);
 	static HistoryMarketOfferList getOwnHistory(MarketAction_t action, uint32_t playerId);
 
-	static void processExpiredOffers(const DBResult_ptr &result, bool);
+	/**
+	 * @brief Loads the active offers into the order book, once at startup.
+	 */
+	void loadOffers();
+
+	static void processExpiredOffers(const std::vector<MarketOrder> &offers);
 	static void checkExpiredOffers();
 
 	static uint32_t getPlayerOfferCount(uint32_t playerId);
 	static MarketOfferEx getOfferByCounter(uint32_t timestamp, uint16_t counter);
 
-	static void createOffer(uint32_t playerId, MarketAction_t action, uint32_t itemId, uint16_t amount, uint64_t price, uint8_t tier, bool anonymous);
+	static void createOffer(uint32_t playerId, const std::string &playerName, MarketAction_t action, uint32_t itemId, uint16_t amount, uint64_t price, uint8_t tier, bool anonymous);
 	static void acceptOffer(uint32_t offerId, uint16_t amount);
 	static void deleteOffer(uint32_t offerId);
 
@@ -51,7 +65,24 @@ public:
 
 	static uint8_t getTierFromDatabaseTable(const std::string &string);
 
+	const MarketOrderBook &getOrderBook() const {
+		return orderBook;
+	}
+
 private:
+	static MarketOffer toMarketOffer(const MarketOrder &order);
+
+	// Queues a write of the offers table, run after all the writes queued before it
+	void persist(std::function<bool()> write);
+	void flushWrites();
+
+	MarketOrderBook orderBook;
+	std::atomic<uint32_t> nextOfferId = 1;
+
+	std::mutex writesMutex;
+	std::deque<std::function<bool()>> pendingWrites;
+	bool flushing = false;
+
 	// [uint16_t = item id, [uint8_t = item tier, MarketStatistics = structure of the statistics]]
 	StatisticsMap purchaseStatistics;
 	StatisticsMap saleStatistics;
@@ -0,0 +1,180 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "io/market_order_book.hpp"
+
+void MarketOrderBook::clear() {
+	std::scoped_lock lock(mutex);
+	orders.clear();
+	sides.clear();
+	playerOrders.clear();
+	counters.clear();
+	expiry.clear();
+}
+
+void MarketOrderBook::add(MarketOrder order) {
+	std::scoped_lock lock(mutex);
+	const auto id = order.id;
+	removeLocked(id);
+
+	sides[sideKey(order.side, order.itemId, order.tier)].emplace(sortPrice(order), id);
+	playerOrders[order.playerId].emplace(id);
+	// Counters repeat every 65536 ids, the first offer keeps it within the same second
+	counters.try_emplace(counterKey(order.created, order.getCounter()), id);
+	expiry.emplace(order.created, id);
+	orders.emplace(id, std::move(order));
+}
+
+std::optional<MarketOrder> MarketOrderBook::remove(uint32_t id) {
+	std::scoped_lock lock(mutex);
+	return removeLocked(id);
+}
+
+std::optional<MarketOrder> MarketOrderBook::removeLocked(uint32_t id) {
+	const auto it = orders.find(id);
+	if (it == orders.end()) {
+		return std::nullopt;
+	}
+
+	auto order = std::move(it->second);
+	orders.erase(it);
+
+	const auto sideIt = sides.find(sideKey(order.side, order.itemId, order.tier));
+	if (sideIt != sides.end()) {
+		sideIt->second.erase({ sortPrice(order), id });
+		if (sideIt->second.empty()) {
+			sides.erase(sideIt);
+		}
+	}
+
+	const auto playerIt = playerOrders.find(order.playerId);
+	if (playerIt != playerOrders.end()) {
+		playerIt->second.erase(id);
+		if (playerIt->second.empty()) {
+			playerOrders.erase(playerIt);
+		}
+	}
+
+	const auto counterIt = counters.find(counterKey(order.created, order.getCounter()));
+	if (counterIt != counters.end() && counterIt->second == id) {
+		counters.erase(counterIt);
+	}
+
+	expiry.erase({ order.created, id });
+	return order;
+}
+
+bool MarketOrderBook::reduce(uint32_t id, uint16_t amount) {
+	std::scoped_lock lock(mutex);
+	const auto it = orders.find(id);
+	if (it == orders.end() || it->second.amount < amount) {
+		return false;
+	}
+
+	it->second.amount -= amount;
+	return true;
+}
+
+std::optional<MarketOrder> MarketOrderBook::get(uint32_t id) const {
+	std::scoped_lock lock(mutex);
+	const auto it = orders.find(id);
+	if (it == orders.end()) {
+		return std::nullopt;
+	}
+	return it->second;
+}
+
+std::optional<MarketOrder> MarketOrderBook::getByCounter(uint32_t created, uint16_t counter) const {
+	std::scoped_lock lock(mutex);
+	const auto counterIt = counters.find(counterKey(created, counter));
+	if (counterIt == counters.end()) {
+		return std::nullopt;
+	}
+	return orders.at(counterIt->second);
+}
+
+std::vector<MarketOrder> MarketOrderBook::getOrders(MarketAction_t side, uint16_t itemId, uint8_t tier) const {
+	std::scoped_lock lock(mutex);
+	std::vector<MarketOrder> result;
+	const auto sideIt = sides.find(sideKey(side, itemId, tier));
+	if (sideIt == sides.end()) {
+		return result;
+	}
+
+	result.reserve(sideIt->second.size());
+	for (const auto &[price, id] : sideIt->second) {
+		result.emplace_back(orders.at(id));
+	}
+	return result;
+}
+
+std::vector<MarketOrder> MarketOrderBook::getOrders(MarketAction_t side) const {
+	std::scoped_lock lock(mutex);
+	std::vector<MarketOrder> result;
+	for (const auto &[key, entries] : sides) {
+		if ((key & 0xFF) != static_cast<uint32_t>(side)) {
+			continue;
+		}
+
+		for (const auto &[price, id] : entries) {
+			result.emplace_back(orders.at(id));
+		}
+	}
+	return result;
+}
+
+std::vector<MarketOrder> MarketOrderBook::getPlayerOrders(MarketAction_t side, uint32_t playerId) const {
+	std::scoped_lock lock(mutex);
+	std::vector<MarketOrder> result;
+	const auto playerIt = playerOrders.find(playerId);
+	if (playerIt == playerOrders.end()) {
+		return result;
+	}
+
+	for (const auto id : playerIt->second) {
+		const auto &order = orders.at(id);
+		if (order.side == side) {
+			result.emplace_back(order);
+		}
+	}
+	return result;
+}
+
+size_t MarketOrderBook::countPlayerOrders(uint32_t playerId) const {
+	std::scoped_lock lock(mutex);
+	const auto playerIt = playerOrders.find(playerId);
+	return playerIt != playerOrders.end() ? playerIt->second.size() : 0;
+}
+
+std::vector<MarketOrder> MarketOrderBook::takeExpired(uint32_t createdUntil) {
+	std::scoped_lock lock(mutex);
+	std::vector<MarketOrder> result;
+	while (!expiry.empty() && expiry.begin()->first <= createdUntil) {
+		if (auto order = removeLocked(expiry.begin()->second)) {
+			result.emplace_back(std::move(*order));
+		} else {
+			expiry.erase(expiry.begin());
+		}
+	}
+	return result;
+}
+
+uint32_t MarketOrderBook::getMaxId() const {
+	std::scoped_lock lock(mutex);
+	uint32_t maxId = 0;
+	for (const auto &[id, order] : orders) {
+		maxId = std::max(maxId, id);
+	}
+	return maxId;
+}
+
+size_t MarketOrderBook::size() const {
+	std::scoped_lock lock(mutex);
+	return orders.size();
+}
@@ -0,0 +1,103 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "creatures/creatures_definitions.hpp"
+
+#ifndef USE_PRECOMPILED_HEADERS
+	#include <parallel_hashmap/phmap.h>
+	#include <mutex>
+	#include <optional>
+	#include <set>
+	#include <string>
+	#include <vector>
+#endif
+
+struct MarketOrder {
+	uint32_t id = 0;
+	uint32_t playerId = 0;
+	uint64_t price = 0;
+	uint32_t created = 0;
+	uint16_t amount = 0;
+	uint16_t itemId = 0;
+	MarketAction_t side = MARKETACTION_BUY;
+	uint8_t tier = 0;
+	bool anonymous = false;
+	std::string playerName;
+
+	// Identifies the offer to the client, along with its timestamp
+	uint16_t getCounter() const {
+		return (id ^ 0xABCDEF) & 0xFFFF;
+	}
+};
+
+/**
+ * Active market offers, kept in memory so that browsing the market never reaches the database.
+ *
+ * Each side of an item and tier is an ordered set with the best price first (highest buy, lowest sale),
+ * ties broken by age. Offers are also indexed by player, by creation time for expiry and
+ * by the timestamp and counter the client refers to them with.
+ * Persisting the changes is left to the caller, see IOMarket.
+ */
+class MarketOrderBook {
+public:
+	void clear();
+
+	void add(MarketOrder order);
+	std::optional<MarketOrder> remove(uint32_t id);
+
+	/**
+	 * @brief Takes an amount from an offer, the offer is kept even if nothing is left of it.
+	 * @return false if the offer does not exist or has less than the amount.
+	 */
+	bool reduce(uint32_t id, uint16_t amount);
+
+	std::optional<MarketOrder> get(uint32_t id) const;
+	std::optional<MarketOrder> getByCounter(uint32_t created, uint16_t counter) const;
+
+	// Best price first
+	std::vector<MarketOrder> getOrders(MarketAction_t side, uint16_t itemId, uint8_t tier) const;
+	std::vector<MarketOrder> getOrders(MarketAction_t side) const;
+	std::vector<MarketOrder> getPlayerOrders(MarketAction_t side, uint32_t playerId) const;
+	size_t countPlayerOrders(uint32_t playerId) const;
+
+	/**
+	 * @brief Removes the offers created up to a time, oldest first.
+	 */
+	std::vector<MarketOrder> takeExpired(uint32_t createdUntil);
+
+	uint32_t getMaxId() const;
+	size_t size() const;
+
+private:
+	// Price sorted so that iterating from the start gives the best offers, then the id
+	using Side = std::set<std::pair<uint64_t, uint32_t>>;
+
+	static uint32_t sideKey(MarketAction_t side, uint16_t itemId, uint8_t tier) {
+		return (static_cast<uint32_t>(itemId) << 16) | (static_cast<uint32_t>(tier) << 8) | static_cast<uint32_t>(side);
+	}
+
+	static uint64_t counterKey(uint32_t created, uint16_t counter) {
+		return (static_cast<uint64_t>(created) << 16) | counter;
+	}
+
+	static uint64_t sortPrice(const MarketOrder &order) {
+		return order.side == MARKETACTION_BUY ? ~order.price : order.price;
+	}
+
+	std::optional<MarketOrder> removeLocked(uint32_t id);
+
+	mutable std::mutex mutex;
+	phmap::flat_hash_map<uint32_t, MarketOrder> orders;
+	phmap::flat_hash_map<uint32_t, Side> sides;
+	phmap::flat_hash_map<uint32_t, std::set<uint32_t>> playerOrders;
+	phmap::flat_hash_map<uint64_t, uint32_t> counters;
+	std::set<std::pair<uint32_t, uint32_t>> expiry;
+};
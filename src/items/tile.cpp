@@ -22,6 +22,7 @@
 #include "items/trashholder.hpp"
 #include "lua/creature/movement.hpp"
 #include "map/spectators.hpp"
+#include "map/utils/flowfield.hpp"
 #include "utils/tools.hpp"
 #include "game/scheduling/dispatcher.hpp"
 
@@ -493,7 +494,7 @@ void Tile::onUpdateTileItem(const std::shared_ptr<Item> &oldItem, const ItemType
 	}
 }
 
-void Tile::onRemoveTileItem(const CreatureVector &spectators, const std::vector<int32_t> &oldStackPosVector, const std::shared_ptr<Item> &item) {
+void Tile::onRemoveTileItem(const Spectators &spectators, const std::vector<int32_t> &oldStackPosVector, const std::shared_ptr<Item> &item) {
 	if (!item) {
 		g_logger().error("Tile::onRemoveTileItem: item is nullptr");
 		return;
@@ -581,7 +582,8 @@ void Tile::onRemoveTileItem(const CreatureVector &spectators, const std::vector<
 	}
 }
 
-void Tile::onUpdateTile(const CreatureVector &spectators) {
+void Tile::onUpdateTile(const Spectators &spectators) {
+	clearItemEncoding();
 	const Position &cylinderMapPos = getPosition();
 
 	// send to clients
@@ -1025,7 +1027,6 @@ void Tile::addThing(int32_t, const std::shared_ptr<Thing> &thing) {
 
 	const auto &creature = thing->getCreature();
 	if (creature) {
-		Spectators::clearCache();
 		creature->setParent(static_self_cast<Tile>());
 
 		CreatureVector* creatures = makeCreatures();
@@ -1041,6 +1042,7 @@ void Tile::addThing(int32_t, const std::shared_ptr<Thing> &thing) {
 			return /*RETURNVALUE_NOTPOSSIBLE*/;
 		}
 
+		clearItemEncoding();
 		item->setParent(static_self_cast<Tile>());
 
 		const ItemType &itemType = Item::items[item->getID()];
@@ -1148,6 +1150,7 @@ void Tile::updateThing(const std::shared_ptr<Thing> &thing, uint16_t itemId, uin
 
 	const ItemType &oldType = Item::items[item->getID()];
 	const ItemType &newType = Item::items[itemId];
+	clearItemEncoding();
 	resetTileFlags(item);
 	item->setID(itemId);
 	item->setSubType(count);
@@ -1167,6 +1170,7 @@ void Tile::replaceThing(uint32_t index, const std::shared_ptr<Thing> &thing) {
 		return /*RETURNVALUE_NOTPOSSIBLE*/;
 	}
 
+	clearItemEncoding();
 	std::shared_ptr<Item> oldItem = nullptr;
 	bool isInserted = false;
 
@@ -1241,7 +1245,6 @@ void Tile::removeThing(const std::shared_ptr<Thing> &thing, uint32_t count) {
 		if (creatures) {
 			const auto it = std::ranges::find(*creatures, thing);
 			if (it != creatures->end()) {
-				Spectators::clearCache();
 				creatures->erase(it);
 			}
 		}
@@ -1258,12 +1261,13 @@ void Tile::removeThing(const std::shared_ptr<Thing> &thing, uint32_t count) {
 		return;
 	}
 
+	clearItemEncoding();
 	if (item == ground) {
 		ground->resetParent();
 		ground = nullptr;
 
 		const auto spectators = Spectators().find<Creature>(getPosition(), true);
-		onRemoveTileItem(spectators.data(), std::vector<int32_t>(spectators.size(), 0), item);
+		onRemoveTileItem(spectators, std::vector<int32_t>(spectators.size(), 0), item);
 		return;
 	}
 
@@ -1288,7 +1292,7 @@ void Tile::removeThing(const std::shared_ptr<Thing> &thing, uint32_t count) {
 		}
 
 		items->erase(it);
-		onRemoveTileItem(spectators.data(), oldStackPosVector, item);
+		onRemoveTileItem(spectators, oldStackPosVector, item);
 		item->resetParent();
 	} else {
 		const auto it = std::find(items->getBeginDownItem(), items->getEndDownItem(), item);
@@ -1314,7 +1318,7 @@ void Tile::removeThing(const std::shared_ptr<Thing> &thing, uint32_t count) {
 			item->resetParent();
 			items->erase(it);
 			items->decreaseDownItemCount();
-			onRemoveTileItem(spectators.data(), oldStackPosVector, item);
+			onRemoveTileItem(spectators, oldStackPosVector, item);
 		}
 	}
 }
@@ -1326,6 +1330,9 @@ void Tile::removeCreature(const std::shared_ptr<Creature> &creature) {
 
 	g_game().map.getMapSector(tilePos.x, tilePos.y)->removeCreature(creature);
 	removeThing(creature, 0);
+
+	// Spectators found earlier in this task may still hold a handle to it
+	Spectators::keepAlive(creature);
 }
 
 int32_t Tile::getThingIndex(const std::shared_ptr<Thing> &thing) const {
@@ -1596,7 +1603,7 @@ void Tile::postRemoveNotification(const std::shared_ptr<Thing> &thing, const std
 	auto spectators = Spectators().find<Player>(getPosition(), true);
 
 	if (getThingCount() > 8) {
-		onUpdateTile(spectators.data());
+		onUpdateTile(spectators);
 	}
 
 	for (const auto &spectator : spectators) {
@@ -1647,8 +1654,6 @@ void Tile::internalAddThing(uint32_t, const std::shared_ptr<Thing> &thing) {
 
 	const auto &creature = thing->getCreature();
 	if (creature) {
-		Spectators::clearCache();
-
 		CreatureVector* creatures = makeCreatures();
 		creatures->insert(creatures->begin(), creature);
 	} else {
@@ -1657,6 +1662,7 @@ void Tile::internalAddThing(uint32_t, const std::shared_ptr<Thing> &thing) {
 			return;
 		}
 
+		clearItemEncoding();
 		const ItemType &itemType = Item::items[item->getID()];
 		if (itemType.isGroundTile()) {
 			if (ground == nullptr) {
@@ -1699,6 +1705,8 @@ void Tile::updateTileFlags(const std::shared_ptr<Item> &item) {
 }
 
 void Tile::setTileFlags(const std::shared_ptr<Item> &item) {
+	const bool wasBlocking = hasFlag(FlowField::BLOCKING_FLAGS);
+
 	if (!hasFlag(TILESTATE_FLOORCHANGE)) {
 		const auto &it = Item::items[item->getID()];
 		if (it.floorChange != 0) {
@@ -1783,9 +1791,13 @@ void Tile::setTileFlags(const std::shared_ptr<Item> &item) {
 	if (item->hasProperty(CONST_PROP_SUPPORTHANGABLE)) {
 		setFlag(TILESTATE_SUPPORTS_HANGABLE);
 	}
+
+	onWalkabilityChange(item, wasBlocking);
 }
 
 void Tile::resetTileFlags(const std::shared_ptr<Item> &item) {
+	const bool wasBlocking = hasFlag(FlowField::BLOCKING_FLAGS);
+
 	const ItemType &it = Item::items[item->getID()];
 	if (it.floorChange != 0) {
 		resetFlag(TILESTATE_FLOORCHANGE);
@@ -1864,6 +1876,15 @@ void Tile::resetTileFlags(const std::shared_ptr<Item> &item) {
 	if (item->hasProperty(CONST_PROP_SUPPORTHANGABLE)) {
 		resetFlag(TILESTATE_SUPPORTS_HANGABLE);
 	}
+
+	onWalkabilityChange(item, wasBlocking);
+}
+
+void Tile::onWalkabilityChange(const std::shared_ptr<Item> &item, bool wasBlocking) {
+	// Drops the flow fields that were built with the previous state of this tile
+	if (wasBlocking != hasFlag(FlowField::BLOCKING_FLAGS) || item->isGroundTile()) {
+		g_game().map.flowFields.invalidate(getPosition());
+	}
 }
 
 bool Tile::isMovableBlocking() const {
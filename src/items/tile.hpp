@@ -19,6 +19,7 @@ class MagicField;
 class BedItem;
 class House;
 class Zone;
+class Spectators;
 class Cylinder;
 class Item;
 class ItemType;
@@ -99,6 +100,18 @@ private:
 	uint32_t downItemCount = 0;
 };
 
+/**
+ * The items of a tile as the clients of one protocol variant read them, so that describing
+ * the tile again is a copy. Each item is stored as its length followed by its bytes.
+ */
+struct TileItemEncoding {
+	uint8_t variant = 0;
+	// Ground and top items, the down items follow them
+	uint8_t topItems = 0;
+	uint8_t itemCount = 0;
+	std::vector<uint8_t> bytes;
+};
+
 class Tile : public Cylinder, public SharedObject {
 public:
 	static const std::shared_ptr<Tile> &nullptr_tile;
@@ -250,6 +263,7 @@ public:
 		return ground;
 	}
 	void setGround(const std::shared_ptr<Item> &item) {
+		clearItemEncoding();
 		if (ground) {
 			resetTileFlags(ground);
 		}
@@ -262,14 +276,26 @@ public:
 	// This method maintains safety in asynchronous calls, avoiding competition between threads.
 	void safeCall(std::function<void(void)> &&action) const;
 
+	const TileItemEncoding* getItemEncoding() const {
+		return itemEncoding.get();
+	}
+	void setItemEncoding(std::unique_ptr<TileItemEncoding> encoding) {
+		itemEncoding = std::move(encoding);
+	}
+	// Called whenever an item of the tile changes
+	void clearItemEncoding() {
+		itemEncoding.reset();
+	}
+
 private:
 	void onAddTileItem(const std::shared_ptr<Item> &item);
 	void onUpdateTileItem(const std::shared_ptr<Item> &oldItem, const ItemType &oldType, const std::shared_ptr<Item> &newItem, const ItemType &newType);
-	void onRemoveTileItem(const CreatureVector &spectators, const std::vector<int32_t> &oldStackPosVector, const std::shared_ptr<Item> &item);
-	void onUpdateTile(const CreatureVector &spectators);
+	void onRemoveTileItem(const Spectators &spectators, const std::vector<int32_t> &oldStackPosVector, const std::shared_ptr<Item> &item);
+	void onUpdateTile(const Spectators &spectators);
 
 	void setTileFlags(const std::shared_ptr<Item> &item);
 	void resetTileFlags(const std::shared_ptr<Item> &item);
+	void onWalkabilityChange(const std::shared_ptr<Item> &item, bool wasBlocking);
 	bool hasHarmfulField() const;
 	ReturnValue checkNpcCanWalkIntoTile() const;
 
@@ -278,6 +304,7 @@ protected:
 	Position tilePos;
 	uint32_t flags = 0;
 	std::unordered_set<std::shared_ptr<Zone>> zones {};
+	std::unique_ptr<TileItemEncoding> itemEncoding;
 };
 
 // Used for walkable tiles, where there is high likeliness of
@@ -31,82 +31,186 @@ void KVStore::set(const std::string &key, const std::initializer_list<std::pair<
 }
 
 void KVStore::set(const std::string &key, const ValueWrapper &value) {
+	auto &shard = shardOf(key);
+	bool writeBehindDue;
 	{
-		std::scoped_lock lock(mutex_);
-		setLocked(key, value);
+		std::scoped_lock lock(shard.mutex);
+		writeBehindDue = setLocked(shard, key, value, true);
 	}
-	processEvictions();
+	if (writeBehindDue) {
+		requestWriteBehind();
+	}
+}
+
+KVStore::Shard &KVStore::shardOf(const std::string &key) {
+	return shards_[std::hash<std::string> {}(key) % SHARDS];
 }
 
-void KVStore::setLocked(const std::string &key, const ValueWrapper &value) {
-	auto it = store_.find(key);
-	if (it != store_.end()) {
-		it->second.first = value;
-		lruQueue_.splice(lruQueue_.begin(), lruQueue_, it->second.second);
+bool KVStore::setLocked(Shard &shard, const std::string &key, const ValueWrapper &value, bool dirty) {
+	auto it = shard.store.find(key);
+	if (it == shard.store.end()) {
+		it = shard.store.try_emplace(key, Entry { value, dirty }).first;
+		it->second.key = &it->first;
 	} else {
-		std::string evictKey;
-		ValueWrapper evictValue;
-		bool needsEviction = false;
-
-		if (store_.size() >= MAX_SIZE && !lruQueue_.empty()) {
-			logger.debug("KVStore::set() - MAX_SIZE reached, removing last element");
-			auto last = std::prev(lruQueue_.end());
-			evictKey = *last;
-			evictValue = store_[*last].first;
-			needsEviction = true;
-			store_.erase(*last);
-			lruQueue_.pop_back();
-		}
+		it->second.value = value;
+		it->second.dirty = it->second.dirty || dirty;
+		unlink(shard, it->second);
+	}
+	linkNewest(shard, it->second);
 
-		lruQueue_.push_front(key);
-		store_.try_emplace(key, std::make_pair(value, lruQueue_.begin()));
+	if (shard.store.size() <= MAX_SIZE / SHARDS) {
+		return false;
+	}
 
-		if (needsEviction) {
-			pendingEvictions_.emplace_back(evictKey, evictValue);
-		}
+	logger.debug("KVStore::set() - MAX_SIZE reached, removing last element");
+	auto &oldest = *shard.oldest;
+	unlink(shard, oldest);
+	auto evictKey = *oldest.key;
+	auto evictValue = std::move(oldest.value);
+	const auto evictDirty = oldest.dirty;
+	shard.store.erase(evictKey);
+	if (!evictDirty) {
+		return false;
 	}
+
+	std::scoped_lock lock(writeBehindMutex_);
+	queued_.insert_or_assign(std::move(evictKey), std::move(evictValue));
+	return queued_.size() >= WRITE_BEHIND_BATCH;
+}
+
+void KVStore::linkNewest(Shard &shard, Entry &entry) {
+	entry.newer = nullptr;
+	entry.older = shard.newest;
+	if (shard.newest) {
+		shard.newest->newer = &entry;
+	} else {
+		shard.oldest = &entry;
+	}
+	shard.newest = &entry;
+}
+
+void KVStore::linkOldest(Shard &shard, Entry &entry) {
+	entry.older = nullptr;
+	entry.newer = shard.oldest;
+	if (shard.oldest) {
+		shard.oldest->older = &entry;
+	} else {
+		shard.newest = &entry;
+	}
+	shard.oldest = &entry;
+}
+
+void KVStore::unlink(Shard &shard, Entry &entry) {
+	if (entry.newer) {
+		entry.newer->older = entry.older;
+	} else {
+		shard.newest = entry.older;
+	}
+	if (entry.older) {
+		entry.older->newer = entry.newer;
+	} else {
+		shard.oldest = entry.newer;
+	}
+	entry.newer = entry.older = nullptr;
 }
 
 std::optional<ValueWrapper> KVStore::get(const std::string &key, bool forceLoad /*= false*/) {
 	logger.trace("KVStore::get({})", key);
 
-	{
-		std::scoped_lock lock(mutex_);
-		if (!forceLoad) {
-			auto it = store_.find(key);
-			if (it != store_.end()) {
-				auto &[value, lruIt] = it->second;
-				if (value.isDeleted()) {
-					lruQueue_.splice(lruQueue_.end(), lruQueue_, lruIt);
-					return std::nullopt;
-				}
-				lruQueue_.splice(lruQueue_.begin(), lruQueue_, lruIt);
-				return value;
+	auto &shard = shardOf(key);
+	if (!forceLoad) {
+		std::scoped_lock lock(shard.mutex);
+		if (const auto it = shard.store.find(key); it != shard.store.end()) {
+			auto &entry = it->second;
+			unlink(shard, entry);
+			if (entry.value.isDeleted()) {
+				linkOldest(shard, entry);
+				return std::nullopt;
 			}
+			linkNewest(shard, entry);
+			return entry.value;
 		}
 	}
 
-	auto value = load(key);
-	if (value) {
-		{
-			std::scoped_lock lock(mutex_);
-			setLocked(key, *value);
+	auto value = findQueued(key);
+	if (!value || forceLoad) {
+		value = load(key);
+	}
+	if (!value) {
+		return std::nullopt;
+	}
+
+	bool writeBehindDue = false;
+	{
+		std::scoped_lock lock(shard.mutex);
+		// Set by someone else while loading
+		const auto it = shard.store.find(key);
+		if (!forceLoad && it != shard.store.end()) {
+			value = it->second.value;
+		} else {
+			writeBehindDue = setLocked(shard, key, *value, false);
 		}
-		processEvictions();
+	}
+	if (writeBehindDue) {
+		requestWriteBehind();
+	}
+	if (value->isDeleted()) {
+		return std::nullopt;
 	}
 	return value;
 }
 
+std::optional<ValueWrapper> KVStore::findQueued(const std::string &key) {
+	std::scoped_lock lock(writeBehindMutex_);
+	if (const auto it = queued_.find(key); it != queued_.end()) {
+		return it->second;
+	}
+	if (const auto it = writing_.find(key); it != writing_.end()) {
+		return it->second;
+	}
+	return std::nullopt;
+}
+
+void KVStore::prefetch(const std::string &prefix /*= ""*/) {
+	logger.trace("KVStore::prefetch({})", prefix);
+
+	bool writeBehindDue = false;
+	for (const auto &[key, value] : loadPrefixValues(prefix)) {
+		auto &shard = shardOf(key);
+		std::scoped_lock lock(shard.mutex);
+		// Cached values and those waiting to be written are newer than the stored ones
+		if (shard.store.contains(key) || findQueued(key)) {
+			continue;
+		}
+		writeBehindDue = setLocked(shard, key, value, false) || writeBehindDue;
+	}
+	if (writeBehindDue) {
+		requestWriteBehind();
+	}
+}
+
 std::unordered_set<std::string> KVStore::keys(const std::string &prefix /*= ""*/) {
 	std::unordered_set<std::string> keys;
+	const auto addKey = [&keys, &prefix](const std::string &key, const ValueWrapper &value) {
+		if (key.find(prefix) == 0 && !value.isDeleted()) {
+			keys.insert(key.substr(prefix.size()));
+		}
+	};
+
+	for (auto &shard : shards_) {
+		std::scoped_lock lock(shard.mutex);
+		for (const auto &[key, entry] : shard.store) {
+			addKey(key, entry.value);
+		}
+	}
 
 	{
-		std::scoped_lock lock(mutex_);
-		for (const auto &[key, value] : store_) {
-			if (key.find(prefix) == 0 && !value.first.isDeleted()) {
-				std::string suffix = key.substr(prefix.size());
-				keys.insert(suffix);
-			}
+		std::scoped_lock lock(writeBehindMutex_);
+		for (const auto &[key, value] : queued_) {
+			addKey(key, value);
+		}
+		for (const auto &[key, value] : writing_) {
+			addKey(key, value);
 		}
 	}
 
@@ -126,17 +230,95 @@ std::shared_ptr<KV> KVStore::scoped(const std::string &scope) {
 	return std::make_shared<ScopedKV>(logger, *this, scope);
 }
 
-void KVStore::processEvictions() {
-	std::vector<std::pair<std::string, ValueWrapper>> evictions;
+bool KVStore::saveAll() {
+	std::vector<std::pair<std::string, ValueWrapper>> dirty;
+	for (auto &shard : shards_) {
+		std::scoped_lock lock(shard.mutex);
+		for (auto &[key, entry] : shard.store) {
+			if (entry.dirty) {
+				dirty.emplace_back(key, entry.value);
+				entry.dirty = false;
+			}
+		}
+	}
+
 	{
-		std::scoped_lock lock(mutex_);
-		if (!pendingEvictions_.empty()) {
-			evictions = std::move(pendingEvictions_);
-			pendingEvictions_.clear();
+		std::scoped_lock lock(writeBehindMutex_);
+		for (auto &[key, value] : dirty) {
+			queued_.insert_or_assign(std::move(key), std::move(value));
 		}
 	}
+	return writeBehind();
+}
+
+void KVStore::flush() {
+	// Waits for a write in progress, so that this one goes out after it
+	std::scoped_lock writing(writeMutex_);
+
+	phmap::flat_hash_map<std::string, ValueWrapper> values;
+	{
+		std::scoped_lock lock(writeBehindMutex_);
+		values = std::move(queued_);
+		queued_.clear();
+	}
+	for (auto &shard : shards_) {
+		std::scoped_lock lock(shard.mutex);
+		for (auto &[key, entry] : shard.store) {
+			if (entry.dirty) {
+				values.insert_or_assign(key, std::move(entry.value));
+			}
+		}
+		shard.store.clear();
+		shard.newest = shard.oldest = nullptr;
+	}
+
+	if (values.empty()) {
+		return;
+	}
+	if (!saveBatch({ values.begin(), values.end() })) {
+		logger.error("KVStore::flush() - failed to save {} values", values.size());
+	}
+}
+
+void KVStore::requestWriteBehind() {
+	if (!writeBehindScheduled_.exchange(true)) {
+		scheduleWriteBehind();
+	}
+}
+
+bool KVStore::writeBehind() {
+	std::scoped_lock writing(writeMutex_);
+	writeBehindScheduled_ = false;
+
+	std::vector<std::pair<std::string, ValueWrapper>> values;
+	{
+		std::scoped_lock lock(writeBehindMutex_);
+		if (queued_.empty()) {
+			return true;
+		}
+		writing_ = std::move(queued_);
+		queued_.clear();
+		values.assign(writing_.begin(), writing_.end());
+	}
+
+	const auto success = saveBatch(values);
+
+	std::scoped_lock lock(writeBehindMutex_);
+	if (!success) {
+		logger.error("KVStore::writeBehind() - failed to save {} values, they will be retried", values.size());
+		// Values changed again meanwhile are queued already
+		for (auto &[key, value] : writing_) {
+			queued_.try_emplace(key, std::move(value));
+		}
+	}
+	writing_.clear();
+	return success;
+}
 
-	for (const auto &[key, value] : evictions) {
-		save(key, value);
+bool KVStore::saveBatch(const std::vector<std::pair<std::string, ValueWrapper>> &values) {
+	bool success = true;
+	for (const auto &[key, value] : values) {
+		success = save(key, value) && success;
 	}
+	return success;
 }
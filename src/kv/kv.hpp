@@ -17,8 +17,10 @@
 	#include <optional>
 	#include <unordered_set>
 	#include <iomanip>
-	#include <list>
+	#include <array>
+	#include <atomic>
 	#include <utility>
+	#include <vector>
 #endif
 
 #include "kv/value_wrapper.hpp"
@@ -40,6 +42,8 @@ public:
 
 	virtual std::unordered_set<std::string> keys(const std::string &prefix = "") = 0;
 
+	virtual void prefetch(const std::string &prefix = "") = 0;
+
 	void remove(const std::string &key);
 
 	virtual void flush() {
@@ -72,9 +76,21 @@ private:
 	static std::mutex mutex_;
 };
 
+/**
+ * Cache in front of the storage backend.
+ *
+ * Keys are spread by hash over SHARDS partitions, each with its own lock and its own LRU list, so that
+ * contexts touching different keys don't wait on each other. Changed values are only marked dirty and
+ * written in batches: on saveAll, and by the write-behind once enough values were evicted from the cache.
+ * Values waiting to be written are still served from the write-behind until they are.
+ */
 class KVStore : public KV {
 public:
 	static constexpr size_t MAX_SIZE = 1000000;
+	static constexpr size_t SHARDS = 16;
+	// Evicted values queued before the write-behind runs
+	static constexpr size_t WRITE_BEHIND_BATCH = 256;
+
 	static KVStore &getInstance();
 
 	explicit KVStore(Logger &logger) :
@@ -86,35 +102,16 @@ public:
 
 	std::optional<ValueWrapper> get(const std::string &key, bool forceLoad = false) override;
 
-	void flush() override {
-		std::vector<std::pair<std::string, ValueWrapper>> snapshot;
-		{
-			std::scoped_lock lock(mutex_);
-			snapshot.reserve(store_.size() + pendingEvictions_.size());
-			for (const auto &[k, v] : store_) {
-				snapshot.emplace_back(k, v.first);
-			}
-			snapshot.insert(snapshot.end(), pendingEvictions_.begin(), pendingEvictions_.end());
-			store_.clear();
-			pendingEvictions_.clear();
-		}
-		for (const auto &[k, v] : snapshot) {
-			save(k, v);
-		}
-	}
+	bool saveAll() override;
+	void flush() override;
 
 	std::shared_ptr<KV> scoped(const std::string &scope) final;
 	std::unordered_set<std::string> keys(const std::string &prefix = "") override;
 
-protected:
-	phmap::parallel_flat_hash_map<std::string, std::pair<ValueWrapper, std::list<std::string>::iterator>> getStore() {
-		std::scoped_lock lock(mutex_);
-		phmap::parallel_flat_hash_map<std::string, std::pair<ValueWrapper, std::list<std::string>::iterator>> copy;
-		for (const auto &[key, value] : store_) {
-			copy.try_emplace(key, value);
-		}
-		return copy;
-	}
+	/**
+	 * @brief Loads every value under the prefix in one go, keeping those already cached.
+	 */
+	void prefetch(const std::string &prefix = "") override;
 
 protected:
 	Logger &logger;
@@ -122,16 +119,65 @@ protected:
 	virtual std::optional<ValueWrapper> load(const std::string &key) = 0;
 	virtual bool save(const std::string &key, const ValueWrapper &value) = 0;
 	virtual std::vector<std::string> loadPrefix(const std::string &prefix = "") = 0;
+	virtual std::vector<std::pair<std::string, ValueWrapper>> loadPrefixValues(const std::string &prefix) = 0;
+
+	/**
+	 * @brief Writes many values at once, one by one unless the backend knows better.
+	 */
+	virtual bool saveBatch(const std::vector<std::pair<std::string, ValueWrapper>> &values);
+
+	// Runs the write-behind, right away unless the backend has somewhere else to run it
+	virtual void scheduleWriteBehind() {
+		writeBehind();
+	}
+
+	/**
+	 * @brief Writes the queued values in one batch, queueing them again if that fails.
+	 */
+	bool writeBehind();
 
 private:
-	void setLocked(const std::string &key, const ValueWrapper &value);
-	void processEvictions();
-
-	phmap::parallel_flat_hash_map<std::string, std::pair<ValueWrapper, std::list<std::string>::iterator>> store_;
-	std::list<std::string> lruQueue_;
-	std::mutex mutex_;
-	// Evicted entries pending persistence; accessed under mutex_
-	std::vector<std::pair<std::string, ValueWrapper>> pendingEvictions_;
+	struct Entry {
+		ValueWrapper value;
+		bool dirty = false;
+		// Key of the node holding the entry, and the LRU links
+		const std::string* key = nullptr;
+		Entry* newer = nullptr;
+		Entry* older = nullptr;
+	};
+
+	// Apart from each other's cache lines, as threads lock them at once
+	struct alignas(64) Shard {
+		std::mutex mutex;
+		// Nodes, so that entries stay put for the LRU links
+		phmap::node_hash_map<std::string, Entry> store;
+		Entry* newest = nullptr;
+		Entry* oldest = nullptr;
+	};
+
+	Shard &shardOf(const std::string &key);
+
+	/**
+	 * @brief Caches the value under the shard lock, evicting the least recently used one past the size.
+	 * @return true if the eviction filled a write-behind batch.
+	 */
+	bool setLocked(Shard &shard, const std::string &key, const ValueWrapper &value, bool dirty);
+	void linkNewest(Shard &shard, Entry &entry);
+	void linkOldest(Shard &shard, Entry &entry);
+	void unlink(Shard &shard, Entry &entry);
+
+	std::optional<ValueWrapper> findQueued(const std::string &key);
+	void requestWriteBehind();
+
+	std::array<Shard, SHARDS> shards_;
+
+	std::mutex writeBehindMutex_;
+	// Values waiting for the write-behind and those it is writing, accessed under writeBehindMutex_
+	phmap::flat_hash_map<std::string, ValueWrapper> queued_;
+	phmap::flat_hash_map<std::string, ValueWrapper> writing_;
+	// Held for a whole write, so that batches go out in order
+	std::mutex writeMutex_;
+	std::atomic_bool writeBehindScheduled_ { false };
 };
 
 class ScopedKV final : public KV {
@@ -175,6 +221,10 @@ public:
 		return rootKV_.keys(buildKey(prefix));
 	}
 
+	void prefetch(const std::string &prefix = "") override {
+		rootKV_.prefetch(buildKey(prefix));
+	}
+
 private:
 	std::string buildKey(const std::string &key) const {
 		return fmt::format("{}.{}", prefix_, key);
@@ -11,6 +11,7 @@
 
 #include "database/database.hpp"
 #include "kv/value_wrapper_proto.hpp"
+#include "lib/thread/thread_pool.hpp"
 #include "utils/tools.hpp"
 
 #include <kv.pb.h>
@@ -25,18 +26,20 @@ std::optional<ValueWrapper> KVSQL::load(const std::string &key) {
 		return std::nullopt;
 	}
 
+	return readValue(key, result);
+}
+
+std::optional<ValueWrapper> KVSQL::readValue(const std::string &key, const DBResult_ptr &result) const {
 	unsigned long size;
 	const auto data = result->getStream("value", size);
 	if (data == nullptr) {
 		return std::nullopt;
 	}
 
-	ValueWrapper valueWrapper;
 	const auto timestamp = result->getNumber<uint64_t>("timestamp");
 	Canary::protobuf::kv::ValueWrapper protoValue;
 	if (protoValue.ParseFromArray(data, static_cast<int>(size))) {
-		valueWrapper = ProtoSerializable::fromProto(protoValue, timestamp);
-		return valueWrapper;
+		return ProtoSerializable::fromProto(protoValue, timestamp);
 	}
 	logger.error("Failed to deserialize value for key {}", key);
 	return std::nullopt;
@@ -60,45 +63,86 @@ std::vector<std::string> KVSQL::loadPrefix(const std::string &prefix /* = ""*/)
 	return keys;
 }
 
+std::vector<std::pair<std::string, ValueWrapper>> KVSQL::loadPrefixValues(const std::string &prefix) {
+	std::vector<std::pair<std::string, ValueWrapper>> values;
+	const auto query = fmt::format("SELECT `key_name`, `timestamp`, `value` FROM `kv_store` WHERE `key_name` LIKE {}", db.escapeString(prefix + "%"));
+	const auto result = db.storeQuery(query);
+	if (result == nullptr) {
+		return values;
+	}
+
+	do {
+		auto key = result->getString("key_name");
+		// An underscore in the prefix matches any character
+		if (!key.starts_with(prefix)) {
+			continue;
+		}
+		if (auto value = readValue(key, result)) {
+			values.emplace_back(std::move(key), std::move(*value));
+		}
+	} while (result->next());
+
+	return values;
+}
+
 bool KVSQL::save(const std::string &key, const ValueWrapper &value) {
-	auto update = dbUpdate();
-	prepareSave(key, value, update);
-	return update.execute();
+	return saveBatch({ { key, value } });
 }
 
-bool KVSQL::prepareSave(const std::string &key, const ValueWrapper &value, DBInsert &update) const {
-	const auto protoValue = ProtoSerializable::toProto(value);
-	std::string data;
-	if (!protoValue.SerializeToString(&data)) {
+bool KVSQL::saveBatch(const std::vector<std::pair<std::string, ValueWrapper>> &values) {
+	bool success = true;
+	const bool committed = DBTransaction::executeWithinTransaction([this, &values, &success]() {
+		auto update = dbUpdate();
+		std::vector<std::string> deletedKeys;
+		for (const auto &[key, value] : values) {
+			if (value.isDeleted()) {
+				deletedKeys.emplace_back(key);
+				continue;
+			}
+
+			std::string data;
+			if (!ProtoSerializable::toProto(value).SerializeToString(&data)) {
+				logger.error("Failed to serialize value for key {}", key);
+				success = false;
+				return false;
+			}
+			if (!update.addRow(fmt::format("{}, {}, {}", db.escapeString(key), value.getTimestamp(), db.escapeString(data)))) {
+				success = false;
+				return false;
+			}
+		}
+
+		success = update.execute() && deleteKeys(deletedKeys);
+		return success;
+	});
+
+	if (!committed || !success) {
+		logger.error("[{}] Error occurred saving {} key-value entries", __FUNCTION__, values.size());
 		return false;
 	}
-	if (value.isDeleted()) {
-		const auto query = fmt::format("DELETE FROM `kv_store` WHERE `key_name` = {}", db.escapeString(key));
-		return db.executeQuery(query);
-	}
-
-	update.addRow(fmt::format("{}, {}, {}", db.escapeString(key), value.getTimestamp(), db.escapeString(data)));
 	return true;
 }
 
-bool KVSQL::saveAll() {
-	auto store = getStore();
-	const bool success = DBTransaction::executeWithinTransaction([this, &store]() {
-		auto update = dbUpdate();
-		if (!std::ranges::all_of(store, [this, &update](const auto &kv) {
-				const auto &[key, value] = kv;
-				return prepareSave(key, value.first, update);
-			})) {
+bool KVSQL::deleteKeys(const std::vector<std::string> &keys) const {
+	for (size_t first = 0; first < keys.size(); first += DELETE_BATCH) {
+		std::string escapedKeys;
+		for (size_t i = first, last = std::min(keys.size(), first + DELETE_BATCH); i < last; ++i) {
+			if (!escapedKeys.empty()) {
+				escapedKeys.push_back(',');
+			}
+			escapedKeys.append(db.escapeString(keys[i]));
+		}
+		if (!db.executeQuery(fmt::format("DELETE FROM `kv_store` WHERE `key_name` IN ({})", escapedKeys))) {
 			return false;
 		}
-		return update.execute();
-	});
-
-	if (!success) {
-		g_logger().error("[{}] Error occurred saving player", __FUNCTION__);
 	}
+	return true;
+}
 
-	return success;
+void KVSQL::scheduleWriteBehind() {
+	g_threadPool().detach_task([this] {
+		writeBehind();
+	});
 }
 
 DBInsert KVSQL::dbUpdate() {
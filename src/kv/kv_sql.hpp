@@ -14,19 +14,28 @@
 class Database;
 class Logger;
 class DBInsert;
+class DBResult;
 class ValueWrapper;
 
+using DBResult_ptr = std::shared_ptr<DBResult>;
+
 class KVSQL final : public KVStore {
 public:
 	explicit KVSQL(Database &db, Logger &logger);
 
-	bool saveAll() override;
-
 private:
+	// Keys deleted by a single statement
+	static constexpr size_t DELETE_BATCH = 500;
+
 	std::vector<std::string> loadPrefix(const std::string &prefix = "") override;
+	std::vector<std::pair<std::string, ValueWrapper>> loadPrefixValues(const std::string &prefix) override;
 	std::optional<ValueWrapper> load(const std::string &key) override;
 	bool save(const std::string &key, const ValueWrapper &value) override;
-	bool prepareSave(const std::string &key, const ValueWrapper &value, DBInsert &update) const;
+	bool saveBatch(const std::vector<std::pair<std::string, ValueWrapper>> &values) override;
+	void scheduleWriteBehind() override;
+
+	std::optional<ValueWrapper> readValue(const std::string &key, const DBResult_ptr &result) const;
+	bool deleteKeys(const std::vector<std::string> &keys) const;
 
 	DBInsert dbUpdate();
 
@@ -83,6 +83,8 @@ namespace metrics {
 	DEFINE_LATENCY_CLASS(query, "query", "truncated_query");
 	DEFINE_LATENCY_CLASS(task, "task", "task");
 	DEFINE_LATENCY_CLASS(lock, "lock", "scope");
+	DEFINE_LATENCY_CLASS(pathfinding, "pathfinding", "scope");
+	DEFINE_LATENCY_CLASS(database_pool, "database_pool", "scope");
 
 	const std::vector<std::string> latencyNames {
 		"method_latency",
@@ -90,6 +92,8 @@ namespace metrics {
 		"query_latency",
 		"task_latency",
 		"lock_latency",
+		"pathfinding_latency",
+		"database_pool_latency",
 	};
 
 	class Metrics final {
@@ -189,6 +193,8 @@ namespace metrics {
 	DEFINE_LATENCY_CLASS(query, "query", "truncated_query");
 	DEFINE_LATENCY_CLASS(task, "task", "task");
 	DEFINE_LATENCY_CLASS(lock, "lock", "scope");
+	DEFINE_LATENCY_CLASS(pathfinding, "pathfinding", "scope");
+	DEFINE_LATENCY_CLASS(database_pool, "database_pool", "scope");
 
 	const std::vector<std::string> latencyNames {
 		"method_latency",
@@ -196,6 +202,8 @@ namespace metrics {
 		"query_latency",
 		"task_latency",
 		"lock_latency",
+		"pathfinding_latency",
+		"database_pool_latency",
 	};
 
 	class Metrics final {
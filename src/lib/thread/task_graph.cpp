@@ -0,0 +1,123 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "lib/thread/task_graph.hpp"
+
+#include "lib/thread/thread_pool.hpp"
+
+TaskGraph::TaskGraph(ThreadPool &threadPool) :
+	threadPool(threadPool) { }
+
+void TaskGraph::add(const std::string &name, std::function<void()> task, const std::vector<std::string> &dependencies) {
+	addNode(name, std::move(task), dependencies, false);
+}
+
+void TaskGraph::addOnCaller(const std::string &name, std::function<void()> task, const std::vector<std::string> &dependencies) {
+	addNode(name, std::move(task), dependencies, true);
+}
+
+void TaskGraph::addNode(const std::string &name, std::function<void()> task, const std::vector<std::string> &dependencies, bool onCaller) {
+	Node node { name, std::move(task), onCaller };
+	for (const auto &dependency : dependencies) {
+		const auto it = std::ranges::find(nodes, dependency, &Node::name);
+		if (it == nodes.end()) {
+			throw std::invalid_argument(fmt::format("Task '{}' depends on '{}', which was not added before it", name, dependency));
+		}
+		it->dependents.emplace_back(nodes.size());
+		++node.pendingDependencies;
+	}
+	nodes.emplace_back(std::move(node));
+}
+
+void TaskGraph::run() {
+	std::unique_lock lock(mutex);
+	startTime = std::chrono::steady_clock::now();
+	for (size_t index = 0; index < nodes.size(); ++index) {
+		if (nodes[index].pendingDependencies == 0) {
+			launch(index);
+		}
+	}
+
+	while (true) {
+		signal.wait(lock, [this] { return running == 0 || !callerQueue.empty(); });
+		if (callerQueue.empty()) {
+			break;
+		}
+
+		const auto index = callerQueue.front();
+		callerQueue.pop_front();
+		if (error) {
+			--running;
+			continue;
+		}
+
+		lock.unlock();
+		execute(index);
+		lock.lock();
+	}
+
+	duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
+
+void TaskGraph::launch(size_t index) {
+	++running;
+	if (nodes[index].onCaller) {
+		callerQueue.emplace_back(index);
+		signal.notify_all();
+		return;
+	}
+
+	threadPool.detach_task([this, index] { execute(index); });
+}
+
+void TaskGraph::execute(size_t index) {
+	const auto begin = std::chrono::steady_clock::now();
+	std::exception_ptr taskError;
+	try {
+		nodes[index].task();
+	} catch (...) {
+		taskError = std::current_exception();
+	}
+	const auto end = std::chrono::steady_clock::now();
+
+	std::scoped_lock lock(mutex);
+	const auto &node = nodes[index];
+	timings.emplace_back(Timing {
+		node.name,
+		std::chrono::duration<double, std::milli>(begin - startTime).count(),
+		std::chrono::duration<double, std::milli>(end - begin).count(),
+		node.onCaller,
+	});
+
+	if (taskError && !error) {
+		error = taskError;
+	}
+	if (!error) {
+		for (const auto dependent : node.dependents) {
+			if (--nodes[dependent].pendingDependencies == 0) {
+				launch(dependent);
+			}
+		}
+	}
+
+	--running;
+	// Notified with the mutex held, run() may return and the graph go away as soon as it is released
+	signal.notify_all();
+}
+
+const std::vector<TaskGraph::Timing> &TaskGraph::getTimings() const {
+	return timings;
+}
+
+double TaskGraph::getDuration() const {
+	return duration;
+}
@@ -0,0 +1,72 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+class ThreadPool;
+
+/**
+ * Runs a set of tasks once each, every one of them after the tasks it depends on.
+ *
+ * A task goes to the thread pool as soon as its dependencies are done, so that independent ones overlap. Those
+ * bound to the thread running the graph, such as anything using the Lua state, are run by it in between.
+ * Once a task throws no other one is started, and run() rethrows the exception when those running are done.
+ */
+class TaskGraph {
+public:
+	struct Timing {
+		std::string name;
+		// Milliseconds since the graph started running
+		double start = 0;
+		double duration = 0;
+		bool onCaller = false;
+	};
+
+	explicit TaskGraph(ThreadPool &threadPool);
+
+	// Dependencies are the names of tasks added before, so that there can't be a cycle
+	void add(const std::string &name, std::function<void()> task, const std::vector<std::string> &dependencies = {});
+	// Adds a task run by the thread calling run()
+	void addOnCaller(const std::string &name, std::function<void()> task, const std::vector<std::string> &dependencies = {});
+
+	void run();
+
+	// The tasks that ran, in the order they finished
+	const std::vector<Timing> &getTimings() const;
+	// Milliseconds the whole graph took
+	double getDuration() const;
+
+private:
+	struct Node {
+		std::string name;
+		std::function<void()> task;
+		bool onCaller = false;
+		size_t pendingDependencies = 0;
+		std::vector<size_t> dependents;
+	};
+
+	void addNode(const std::string &name, std::function<void()> task, const std::vector<std::string> &dependencies, bool onCaller);
+	// With the mutex held
+	void launch(size_t index);
+	void execute(size_t index);
+
+	ThreadPool &threadPool;
+
+	std::vector<Node> nodes;
+	std::vector<Timing> timings;
+	std::chrono::steady_clock::time_point startTime;
+	double duration = 0;
+
+	std::mutex mutex;
+	std::condition_variable signal;
+	std::deque<size_t> callerQueue;
+	// Tasks launched and not done yet
+	size_t running = 0;
+	std::exception_ptr error;
+};
@@ -15,6 +15,7 @@
 #include "game/game.hpp"
 #include "game/movement/position.hpp"
 #include "lua/functions/lua_functions_loader.hpp"
+#include "map/spectators.hpp"
 
 void PositionFunctions::init(lua_State* L) {
 	Lua::registerSharedClass(L, "Position", "", PositionFunctions::luaPositionCreate);
@@ -173,7 +174,7 @@ int PositionFunctions::luaPositionGetZones(lua_State* L) {
 
 int PositionFunctions::luaPositionSendMagicEffect(lua_State* L) {
 	// position:sendMagicEffect(magicEffect[, player = nullptr])
-	CreatureVector spectators;
+	Spectators spectators;
 	if (lua_gettop(L) >= 3) {
 		const auto &player = Lua::getPlayer(L, 3);
 		if (!player) {
@@ -181,7 +182,7 @@ int PositionFunctions::luaPositionSendMagicEffect(lua_State* L) {
 			return 1;
 		}
 
-		spectators.emplace_back(player);
+		spectators.insert(player);
 	}
 
 	MagicEffectClasses magicEffect = Lua::getNumber<MagicEffectClasses>(L, 2);
@@ -204,7 +205,7 @@ int PositionFunctions::luaPositionSendMagicEffect(lua_State* L) {
 
 int PositionFunctions::luaPositionRemoveMagicEffect(lua_State* L) {
 	// position:removeMagicEffect(magicEffect[, player = nullptr])
-	CreatureVector spectators;
+	Spectators spectators;
 	if (lua_gettop(L) >= 3) {
 		const auto &player = Lua::getPlayer(L, 3);
 		if (!player) {
@@ -212,7 +213,7 @@ int PositionFunctions::luaPositionRemoveMagicEffect(lua_State* L) {
 			return 1;
 		}
 
-		spectators.emplace_back(player);
+		spectators.insert(player);
 	}
 
 	MagicEffectClasses magicEffect = Lua::getNumber<MagicEffectClasses>(L, 2);
@@ -235,7 +236,7 @@ int PositionFunctions::luaPositionRemoveMagicEffect(lua_State* L) {
 
 int PositionFunctions::luaPositionSendDistanceEffect(lua_State* L) {
 	// position:sendDistanceEffect(positionEx, distanceEffect[, player = nullptr])
-	CreatureVector spectators;
+	Spectators spectators;
 	if (lua_gettop(L) >= 4) {
 		const auto &player = Lua::getPlayer(L, 4);
 		if (!player) {
@@ -243,7 +244,7 @@ int PositionFunctions::luaPositionSendDistanceEffect(lua_State* L) {
 			return 1;
 		}
 
-		spectators.emplace_back(player);
+		spectators.insert(player);
 	}
 
 	const ShootType_t distanceEffect = Lua::getNumber<ShootType_t>(L, 3);
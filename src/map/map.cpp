@@ -18,19 +18,25 @@
 #include "io/iomapserialize.hpp"
 #include "lua/callbacks/event_callback.hpp"
 #include "lua/callbacks/events_callbacks.hpp"
+#include "config/configmanager.hpp"
 #include "map/spectators.hpp"
 #include "utils/astarnodes.hpp"
 
-void Map::load(const std::string &identifier, const Position &pos) {
+void Map::load(const std::string &identifier, const Position &pos, bool useSnapshot) {
 	try {
 		path = identifier;
-		IOMap::loadMap(this, pos);
+		IOMap::loadMap(this, pos, useSnapshot);
 	} catch (const std::exception &e) {
 		g_logger().warn("[Map::load] - The map in folder {} is missing or corrupted", identifier);
 	}
 }
 
 void Map::loadMap(const std::string &identifier, bool mainMap /*= false*/, bool loadHouses /*= false*/, bool loadMonsters /*= false*/, bool loadNpcs /*= false*/, bool loadZones /*= false*/, const Position &pos /*= Position()*/) {
+	readMap(identifier, mainMap, pos);
+	loadMapData(mainMap, loadHouses, loadMonsters, loadNpcs, loadZones);
+}
+
+void Map::readMap(const std::string &identifier, bool mainMap /*= false*/, const Position &pos /*= Position()*/) {
 	// Only download map if is loading the main map and it is not already downloaded
 	if (mainMap && g_configManager().getBoolean(TOGGLE_DOWNLOAD_MAP) && !std::filesystem::exists(identifier)) {
 		const auto mapDownloadUrl = g_configManager().getString(MAP_DOWNLOAD_URL);
@@ -52,7 +58,13 @@ void Map::loadMap(const std::string &identifier, bool mainMap /*= false*/, bool
 	}
 
 	// Load the map
-	load(identifier, pos);
+	reading = true;
+	load(identifier, pos, mainMap && g_configManager().getBoolean(TOGGLE_MAP_SNAPSHOT));
+	reading = false;
+}
+
+void Map::loadMapData(bool mainMap /*= false*/, bool loadHouses /*= false*/, bool loadMonsters /*= false*/, bool loadNpcs /*= false*/, bool loadZones /*= false*/) {
+	registerZonePositions();
 
 	// Only create items from lua functions if is loading main map
 	// It needs to be after the load map to ensure the map already exists before creating the items
@@ -103,6 +115,7 @@ void Map::loadMap(const std::string &identifier, bool mainMap /*= false*/, bool
 void Map::loadMapCustom(const std::string &mapName, bool loadHouses, bool loadMonsters, bool loadNpcs, bool loadZones, int customMapIndex) {
 	// Load the map
 	load(g_configManager().getString(DATA_DIRECTORY) + "/world/custom/" + mapName + ".otbm");
+	registerZonePositions();
 
 	if (loadMonsters && !IOMap::loadMonstersCustom(this, mapName, customMapIndex)) {
 		g_logger().warn("Failed to load monster custom data");
@@ -126,6 +139,14 @@ void Map::loadMapCustom(const std::string &mapName, bool loadHouses, bool loadMo
 	npcfile.clear();
 }
 
+void Map::registerZonePositions() {
+	for (const auto &[zoneId, position] : zonePositions) {
+		Zone::getZone(zoneId)->addPosition(position);
+	}
+	zonePositions.clear();
+	zonePositions.shrink_to_fit();
+}
+
 void Map::loadHouseInfo() {
 	IOMapSerialize::loadHouseInfo();
 	IOMapSerialize::loadHouseItems(this);
@@ -164,21 +185,26 @@ std::shared_ptr<Tile> Map::getLoadedTile(uint16_t x, uint16_t y, uint8_t z) {
 		return nullptr;
 	}
 
-	const auto &leaf = getMapSector(x, y);
+	const auto leaf = getMapSector(x, y);
 	if (!leaf) {
 		return nullptr;
 	}
 
-	const auto &floor = leaf->getFloor(z);
+	const auto floor = leaf->getFloor(z);
 	if (!floor) {
 		return nullptr;
 	}
 
-	const auto &tile = floor->getTile(x, y);
-	return tile;
+	const auto tile = floor->getTileRaw(x, y);
+	return tile ? tile->static_self_cast<Tile>() : nullptr;
 }
 
 std::shared_ptr<Tile> Map::getTile(uint16_t x, uint16_t y, uint8_t z) {
+	const auto tile = getTileRaw(x, y, z);
+	return tile ? tile->static_self_cast<Tile>() : nullptr;
+}
+
+Tile* Map::getTileRaw(uint16_t x, uint16_t y, uint8_t z) {
 	// Check if the coordinates are valid
 	if (x == 0 && y == 0 && z == 0) {
 		return nullptr;
@@ -188,17 +214,22 @@ std::shared_ptr<Tile> Map::getTile(uint16_t x, uint16_t y, uint8_t z) {
 		return nullptr;
 	}
 
-	const auto &sector = getMapSector(x, y);
+	const auto sector = getMapSector(x, y);
 	if (!sector) {
 		return nullptr;
 	}
 
-	const auto &floor = sector->getFloor(z);
+	const auto floor = sector->getFloor(z);
 	if (!floor) {
 		return nullptr;
 	}
 
-	return getOrCreateTileFromCache(floor, x, y);
+	// Only tiles still waiting to be built from the map cache go through the locking path
+	if (!floor->hasTileCache(x, y)) {
+		return floor->getTileRaw(x, y);
+	}
+
+	return getOrCreateTileFromCache(floor, x, y).get();
 }
 
 void Map::refreshZones(uint16_t x, uint16_t y, uint8_t z) {
@@ -220,11 +251,11 @@ void Map::setTile(uint16_t x, uint16_t y, uint8_t z, const std::shared_ptr<Tile>
 		return;
 	}
 
-	if (const auto &sector = getMapSector(x, y)) {
-		sector->createFloor(z)->setTile(x, y, newTile);
-	} else {
-		getBestMapSector(x, y)->createFloor(z)->setTile(x, y, newTile);
-	}
+	const auto sector = getMapSector(x, y);
+	const auto floor = (sector ? sector : getBestMapSector(x, y))->createFloor(z);
+
+	std::unique_lock l(floor->getMutex());
+	floor->setTile(x, y, newTile);
 }
 
 bool Map::placeCreature(const Position &centerPos, const std::shared_ptr<Creature> &creature, bool extendedPos /* = false*/, bool forceLogin /* = false*/) {
@@ -321,7 +352,7 @@ bool Map::placeCreature(const Position &centerPos, const std::shared_ptr<Creatur
 		toCylinder->internalAddThing(creature);
 
 		const Position &dest = toCylinder->getPosition();
-		getMapSector(dest.x, dest.y)->addCreature(creature);
+		getMapSector(dest.x, dest.y)->addCreature(creature, dest);
 	}
 	return true;
 }
@@ -372,10 +403,10 @@ void Map::moveCreature(const std::shared_ptr<Creature> &creature, const std::sha
 			++minRangeX;
 		}
 
-		spectators.find<Creature>(oldPos, true, minRangeX, maxRangeX, minRangeY, maxRangeY, false);
+		spectators.find<Creature>(oldPos, true, minRangeX, maxRangeX, minRangeY, maxRangeY);
 	} else {
-		spectators.find<Creature>(oldPos, true, 0, 0, 0, 0, false);
-		spectators.find<Creature>(newPos, true, 0, 0, 0, 0, false);
+		spectators.find<Creature>(oldPos, true);
+		spectators.find<Creature>(newPos, true);
 	}
 
 	const auto playersSpectators = spectators.filter<Player>();
@@ -399,7 +430,9 @@ void Map::moveCreature(const std::shared_ptr<Creature> &creature, const std::sha
 	// Switch the node ownership
 	if (old_sector != new_sector) {
 		old_sector->removeCreature(creature);
-		new_sector->addCreature(creature);
+		new_sector->addCreature(creature, newPos);
+	} else {
+		old_sector->moveCreature(creature, newPos);
 	}
 
 	// add the creature
@@ -499,7 +532,7 @@ bool Map::checkSightLine(Position start, Position destination) {
 		while (--distanceX > 0) {
 			start.x += delta;
 
-			const auto &tile = getTile(start.x, start.y, start.z);
+			const auto tile = getTileRaw(start.x, start.y, start.z);
 			if (tile && tile->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
 				return false;
 			}
@@ -510,7 +543,7 @@ bool Map::checkSightLine(Position start, Position destination) {
 		while (--distanceY > 0) {
 			start.y += delta;
 
-			const auto &tile = getTile(start.x, start.y, start.z);
+			const auto tile = getTileRaw(start.x, start.y, start.z);
 			if (tile && tile->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
 				return false;
 			}
@@ -543,7 +576,7 @@ bool Map::checkSightLine(Position start, Position destination) {
 					xIncrease = deltaX;
 				}
 
-				const auto &tile = getTile(start.x + xIncrease, start.y + deltaY, start.z);
+				const auto tile = getTileRaw(start.x + xIncrease, start.y + deltaY, start.z);
 				if (tile && tile->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
 					if (Position::areInRange<1, 1>(start, destination)) {
 						return true;
@@ -574,7 +607,7 @@ bool Map::checkSightLine(Position start, Position destination) {
 					yIncrease = deltaY;
 				}
 
-				const auto &tile = getTile(start.x + deltaX, start.y + yIncrease, start.z);
+				const auto tile = getTileRaw(start.x + deltaX, start.y + yIncrease, start.z);
 				if (tile && tile->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
 					if (Position::areInRange<1, 1>(start, destination)) {
 						return true;
@@ -617,7 +650,7 @@ bool Map::isSightClear(const Position &fromPos, const Position &toPos, bool floo
 		startZ = fromPos.z;
 	} else {
 		// Check if we can throw above obstacle
-		const auto &tile = getTile(fromPos.x, fromPos.y, fromPos.z - 1);
+		const auto tile = getTileRaw(fromPos.x, fromPos.y, fromPos.z - 1);
 		if ((tile && (tile->getGround() || tile->hasProperty(CONST_PROP_BLOCKPROJECTILE))) || !checkSightLine(Position(fromPos.x, fromPos.y, fromPos.z - 1), Position(toPos.x, toPos.y, toPos.z - 1))) {
 			return false;
 		}
@@ -632,7 +665,7 @@ bool Map::isSightClear(const Position &fromPos, const Position &toPos, bool floo
 
 	// now we need to perform a jump between floors to see if everything is clear (literally)
 	for (; startZ != toPos.z; ++startZ) {
-		const auto &tile = getTile(toPos.x, toPos.y, startZ);
+		const auto tile = getTileRaw(toPos.x, toPos.y, startZ);
 		if (tile && (tile->getGround() || tile->hasProperty(CONST_PROP_BLOCKPROJECTILE))) {
 			return false;
 		}
@@ -655,6 +688,17 @@ std::shared_ptr<Tile> Map::canWalkTo(const std::shared_ptr<Creature> &creature,
 	return tile;
 }
 
+int32_t Map::getPathMaxNodes(const FindPathParams &fpp) {
+	return fpp.maxNodes > 0 ? fpp.maxNodes : g_configManager().getNumber(PATHFINDING_MAX_NODES);
+}
+
+std::shared_ptr<const FlowField> Map::getFlowField(const std::shared_ptr<Creature> &target) {
+	return flowFields.get(target->getID(), target->getPosition(), [this](const Position &pos) {
+		const auto tile = getTileRaw(pos);
+		return tile && tile->getGround() && !tile->hasFlag(FlowField::BLOCKING_FLAGS);
+	});
+}
+
 bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, const Position &_targetPos, std::vector<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp) {
 	static int_fast32_t allNeighbors[8][2] = {
 		{ -1, 0 }, { 0, 1 }, { 1, 0 }, { 0, -1 }, { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 }
@@ -676,7 +720,7 @@ bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, const Posit
 	Position pos = withoutCreature ? _targetPos : creature->getPosition();
 	Position endPos;
 
-	AStarNodes nodes(pos.x, pos.y, AStarNodes::getTileWalkCost(creature, getTile(pos.x, pos.y, pos.z)));
+	AStarNodes nodes(pos.x, pos.y, AStarNodes::getTileWalkCost(creature, getTile(pos.x, pos.y, pos.z)), getPathMaxNodes(fpp));
 
 	int32_t bestMatch = 0;
 
@@ -787,7 +831,7 @@ bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, const Posit
 			}
 		}
 		nodes.closeNode(n);
-	} while (nodes.getClosedNodes() < 100);
+	} while (nodes.getClosedNodes() < nodes.getMaxClosedNodes());
 	if (!found) {
 		return false;
 	}
@@ -842,7 +886,7 @@ bool Map::getPathMatchingCond(const std::shared_ptr<Creature> &creature, const P
 	Position pos = creature->getPosition();
 	Position endPos;
 
-	AStarNodes nodes(pos.x, pos.y, AStarNodes::getTileWalkCost(creature, getTile(pos.x, pos.y, pos.z)));
+	AStarNodes nodes(pos.x, pos.y, AStarNodes::getTileWalkCost(creature, getTile(pos.x, pos.y, pos.z)), getPathMaxNodes(fpp));
 
 	int32_t bestMatch = 0;
 
@@ -974,7 +1018,7 @@ bool Map::getPathMatchingCond(const std::shared_ptr<Creature> &creature, const P
 			}
 		}
 		nodes.closeNode(n);
-	} while (fpp.maxSearchDist != 0 || nodes.getClosedNodes() < 100);
+	} while (fpp.maxSearchDist != 0 || nodes.getClosedNodes() < nodes.getMaxClosedNodes());
 
 	if (!found) {
 		return false;
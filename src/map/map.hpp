@@ -10,6 +10,7 @@
 #pragma once
 
 #include "mapcache.hpp"
+#include "map/utils/flowfield.hpp"
 #include "map/town.hpp"
 #include "map/house/house.hpp"
 #include "creatures/monsters/spawns/spawn_monster.hpp"
@@ -39,9 +40,10 @@ public:
 
 	/**
 	 * Load a map.
+	 * \param useSnapshot if true, the map is loaded from its snapshot while up to date, else it is compiled again
 	 * \returns true if the map was loaded successfully
 	 */
-	void load(const std::string &identifier, const Position &pos = Position());
+	void load(const std::string &identifier, const Position &pos = Position(), bool useSnapshot = false);
 	/**
 	 * Load the main map
 	 * \param identifier Is the main map name (name of file .otbm)
@@ -51,6 +53,28 @@ public:
 	 * \returns true if the main map was loaded successfully
 	 */
 	void loadMap(const std::string &identifier, bool mainMap = false, bool loadHouses = false, bool loadMonsters = false, bool loadNpcs = false, bool loadZones = false, const Position &pos = Position());
+	/**
+	 * Reads the tiles, towns and waypoints of a map, the first half of loadMap
+	 * Only needs the item types, so the main map is read at startup while the scripts load
+	 * \param identifier Is the map file (.otbm)
+	 * \param mainMap if true, the main map is downloaded first if missing
+	 */
+	void readMap(const std::string &identifier, bool mainMap = false, const Position &pos = Position());
+	/**
+	 * Loads the houses, spawns and zones of the map read last, which need the scripts, the second half of loadMap
+	 * \param loadHouses if true, the map houses are loaded
+	 * \param loadMonsters if true, the map monsters are loaded
+	 * \param loadNpcs if true, the map npcs are loaded
+	 */
+	void loadMapData(bool mainMap = false, bool loadHouses = false, bool loadMonsters = false, bool loadNpcs = false, bool loadZones = false);
+	// Whether a map is being read, when nothing but the reader should touch the tiles
+	bool isReading() const {
+		return reading;
+	}
+	// Marks the map as being read ahead of a readMap run on another thread, which clears it once done
+	void startReading() {
+		reading = true;
+	}
 	/**
 	 * Load the custom map
 	 * \param identifier Is the map custom folder
@@ -78,6 +102,15 @@ public:
 		return getTile(pos.x, pos.y, pos.z);
 	}
 
+	/**
+	 * Get a single tile without locking nor touching its reference count.
+	 * \returns A raw pointer to that tile, valid until the end of the current dispatcher cycle.
+	 */
+	Tile* getTileRaw(uint16_t x, uint16_t y, uint8_t z);
+	Tile* getTileRaw(const Position &pos) {
+		return getTileRaw(pos.x, pos.y, pos.z);
+	}
+
 	void refreshZones(uint16_t x, uint16_t y, uint8_t z);
 	void refreshZones(const Position &pos) {
 		refreshZones(pos.x, pos.y, pos.z);
@@ -130,6 +163,17 @@ public:
 		return getPathMatching(nullptr, startPos, dirList, pathCondition, fpp);
 	}
 
+	// Node budget of a path search, the one in the params or else the configured one
+	static int32_t getPathMaxNodes(const FindPathParams &fpp);
+
+	/**
+	 * Gets the flow field towards a creature, shared by everyone chasing it
+	 *	\param target The creature being chased
+	 *	\returns The field, built on demand if missing or outdated
+	 */
+	std::shared_ptr<const FlowField> getFlowField(const std::shared_ptr<Creature> &target);
+	FlowFieldCache flowFields;
+
 	std::map<std::string, Position> waypoints;
 
 	// Storage made by "loadFromXML" of houses, monsters and npcs for main map
@@ -152,6 +196,8 @@ private:
 		setTile(pos.x, pos.y, pos.z, newTile);
 	}
 	std::shared_ptr<Tile> getLoadedTile(uint16_t x, uint16_t y, uint8_t z);
+	// Adds the positions of the map read last to their zones, on the thread the scripts register zones on
+	void registerZonePositions();
 
 	std::filesystem::path path;
 	std::string monsterfile;
@@ -162,7 +208,12 @@ private:
 	uint32_t width = 0;
 	uint32_t height = 0;
 
+	std::atomic<bool> reading = false;
+	// Zone positions of the map read last, the zones themselves are shared with the scripts
+	std::vector<std::pair<uint16_t, Position>> zonePositions;
+
 	friend class Game;
 	friend class IOMap;
+	friend class IOMapSnapshot;
 	friend class MapCache;
 };
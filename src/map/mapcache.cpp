@@ -19,22 +19,62 @@
 #include "map/map.hpp"
 #include "utils/hash.hpp"
 
-static phmap::flat_hash_map<size_t, std::shared_ptr<BasicItem>> items;
-static phmap::flat_hash_map<size_t, std::shared_ptr<BasicTile>> tiles;
+static BasicCache sharedCache;
 
-std::shared_ptr<BasicItem> static_tryGetItemFromCache(const std::shared_ptr<BasicItem> &ref) {
-	return ref ? items.try_emplace(ref->hash(), ref).first->second : nullptr;
+std::shared_ptr<BasicItem> BasicCache::share(BasicItem &&item) {
+	const auto [it, inserted] = items.try_emplace(item.hash());
+	if (inserted) {
+		it->second = std::make_shared<BasicItem>(std::move(item));
+	}
+	return it->second;
 }
 
-std::shared_ptr<BasicTile> static_tryGetTileFromCache(const std::shared_ptr<BasicTile> &ref) {
-	return ref ? tiles.try_emplace(ref->hash(), ref).first->second : nullptr;
+std::shared_ptr<BasicItem> BasicCache::share(const std::shared_ptr<BasicItem> &item) {
+	if (!item) {
+		return nullptr;
+	}
+
+	const auto [it, inserted] = items.try_emplace(item->hash(), item);
+	if (inserted) {
+		for (auto &child : item->items) {
+			child = share(child);
+		}
+	}
+	return it->second;
 }
 
-void MapCache::flush() const {
+std::shared_ptr<BasicTile> BasicCache::share(BasicTile &&tile, size_t hash) {
+	const auto [it, inserted] = tiles.try_emplace(hash);
+	if (inserted) {
+		it->second = std::make_shared<BasicTile>(std::move(tile));
+	}
+	return it->second;
+}
+
+std::shared_ptr<BasicTile> BasicCache::share(const std::shared_ptr<BasicTile> &tile, size_t hash) {
+	if (!tile) {
+		return nullptr;
+	}
+
+	const auto [it, inserted] = tiles.try_emplace(hash, tile);
+	if (inserted) {
+		tile->ground = share(tile->ground);
+		for (auto &item : tile->items) {
+			item = share(item);
+		}
+	}
+	return it->second;
+}
+
+void BasicCache::clear() {
 	items.clear();
 	tiles.clear();
 }
 
+void MapCache::flush() const {
+	sharedCache.clear();
+}
+
 void MapCache::parseItemAttr(const std::shared_ptr<BasicItem> &BasicItem, const std::shared_ptr<Item> &item) const {
 	if (BasicItem->charges > 0) {
 		item->setSubType(BasicItem->charges);
@@ -99,15 +139,22 @@ std::shared_ptr<Item> MapCache::createItem(const std::shared_ptr<BasicItem> &Bas
 	return item;
 }
 
-std::shared_ptr<Tile> MapCache::getOrCreateTileFromCache(const std::shared_ptr<Floor> &floor, uint16_t x, uint16_t y) {
+std::shared_ptr<Tile> MapCache::getOrCreateTileFromCache(Floor* floor, uint16_t x, uint16_t y) {
 	const auto &cachedTile = floor->getTileCache(x, y);
-	const auto oldTile = floor->getTile(x, y);
 	if (!cachedTile) {
-		return oldTile;
+		return floor->getTile(x, y);
 	}
 
 	std::unique_lock l(floor->getMutex());
 
+	// Another thread may have built it while we were waiting for the lock
+	if (!floor->hasTileCache(x, y)) {
+		l.unlock();
+		return floor->getTile(x, y);
+	}
+
+	const auto oldTile = floor->getTileRaw(x, y);
+
 	const uint8_t z = floor->getZ();
 	const auto map = static_cast<Map*>(this);
 
@@ -168,12 +215,26 @@ std::shared_ptr<Tile> MapCache::getOrCreateTileFromCache(const std::shared_ptr<F
 }
 
 void MapCache::setBasicTile(uint16_t x, uint16_t y, uint8_t z, const std::shared_ptr<BasicTile> &newTile) {
+	setBasicTile(x, y, z, newTile, newTile ? newTile->hash() : 0);
+}
+
+std::shared_ptr<BasicTile> MapCache::setBasicTile(uint16_t x, uint16_t y, uint8_t z, const std::shared_ptr<BasicTile> &newTile, size_t hash) {
+	if (z >= MAP_MAX_LAYERS) {
+		g_logger().error("Attempt to set tile on invalid coordinate: {}", Position(x, y, z).toString());
+		return nullptr;
+	}
+
+	auto tile = sharedCache.share(newTile, hash);
+	setSharedBasicTile(x, y, z, tile);
+	return tile;
+}
+
+void MapCache::setSharedBasicTile(uint16_t x, uint16_t y, uint8_t z, const std::shared_ptr<BasicTile> &tile) {
 	if (z >= MAP_MAX_LAYERS) {
 		g_logger().error("Attempt to set tile on invalid coordinate: {}", Position(x, y, z).toString());
 		return;
 	}
 
-	const auto &tile = static_tryGetTileFromCache(newTile);
 	if (const auto sector = getMapSector(x, y)) {
 		sector->createFloor(z)->setTileCache(x, y, tile);
 	} else {
@@ -181,10 +242,6 @@ void MapCache::setBasicTile(uint16_t x, uint16_t y, uint8_t z, const std::shared
 	}
 }
 
-std::shared_ptr<BasicItem> MapCache::tryReplaceItemFromCache(const std::shared_ptr<BasicItem> &ref) const {
-	return static_tryGetItemFromCache(ref);
-}
-
 MapSector* MapCache::createMapSector(const uint32_t x, const uint32_t y) {
 	const uint32_t index = x / SECTOR_SIZE | y / SECTOR_SIZE << 16;
 	const auto it = mapSectors.find(index);
@@ -265,7 +322,7 @@ void BasicItem::hash(size_t &h) const {
 	}
 }
 
-bool BasicItem::unserializeItemNode(FileStream &stream, uint16_t x, uint16_t y, uint8_t z) {
+bool BasicItem::unserializeItemNode(FileStream &stream, uint16_t x, uint16_t y, uint8_t z, BasicCache &cache) {
 	if (stream.isProp(OTB::Node::END)) {
 		stream.back();
 		return true;
@@ -280,14 +337,14 @@ bool BasicItem::unserializeItemNode(FileStream &stream, uint16_t x, uint16_t y,
 
 		const uint16_t streamId = stream.getU16();
 
-		const auto item = std::make_shared<BasicItem>();
-		item->id = streamId;
+		BasicItem item;
+		item.id = streamId;
 
-		if (!item->unserializeItemNode(stream, x, y, z)) {
+		if (!item.unserializeItemNode(stream, x, y, z, cache)) {
 			throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Failed to load item.", x, y, z));
 		}
 
-		items.emplace_back(static_tryGetItemFromCache(item));
+		items.emplace_back(cache.share(std::move(item)));
 
 		if (!stream.endNode()) {
 			throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not end node.", x, y, z));
@@ -17,6 +17,7 @@ class Tile;
 class Item;
 struct Position;
 class FileStream;
+struct BasicCache;
 
 #pragma pack(1)
 struct BasicItem {
@@ -35,7 +36,7 @@ struct BasicItem {
 
 	std::vector<std::shared_ptr<BasicItem>> items;
 
-	bool unserializeItemNode(FileStream &propStream, uint16_t x, uint16_t y, uint8_t z);
+	bool unserializeItemNode(FileStream &propStream, uint16_t x, uint16_t y, uint8_t z, BasicCache &cache);
 	void readAttr(FileStream &propStream);
 
 	size_t hash() const {
@@ -79,13 +80,34 @@ private:
 
 #pragma pack()
 
+/**
+ * One of each distinct basic item and tile, told apart by hash, for equal ones to be shared.
+ * The map cache keeps one, each thread reading a map keeps its own, shared into the one of the map afterwards.
+ */
+struct BasicCache {
+	// Only allocates the item if it isn't in the cache yet
+	std::shared_ptr<BasicItem> share(BasicItem &&item);
+	// Those added to the cache have their items shared too
+	std::shared_ptr<BasicItem> share(const std::shared_ptr<BasicItem> &item);
+
+	std::shared_ptr<BasicTile> share(BasicTile &&tile, size_t hash);
+	std::shared_ptr<BasicTile> share(const std::shared_ptr<BasicTile> &tile, size_t hash);
+
+	void clear();
+
+	phmap::flat_hash_map<size_t, std::shared_ptr<BasicItem>> items;
+	phmap::flat_hash_map<size_t, std::shared_ptr<BasicTile>> tiles;
+};
+
 class MapCache {
 public:
 	virtual ~MapCache() = default;
 
 	void setBasicTile(uint16_t x, uint16_t y, uint8_t z, const std::shared_ptr<BasicTile> &BasicTile);
-
-	std::shared_ptr<BasicItem> tryReplaceItemFromCache(const std::shared_ptr<BasicItem> &ref) const;
+	// For a tile whose hash is already known, as those read into the cache of another thread
+	std::shared_ptr<BasicTile> setBasicTile(uint16_t x, uint16_t y, uint8_t z, const std::shared_ptr<BasicTile> &BasicTile, size_t hash);
+	// For a tile that is distinct already, as those of a map snapshot, set without looking it up in the cache
+	void setSharedBasicTile(uint16_t x, uint16_t y, uint8_t z, const std::shared_ptr<BasicTile> &BasicTile);
 
 	void flush() const;
 
@@ -111,7 +133,7 @@ public:
 	}
 
 protected:
-	std::shared_ptr<Tile> getOrCreateTileFromCache(const std::shared_ptr<Floor> &floor, uint16_t x, uint16_t y);
+	std::shared_ptr<Tile> getOrCreateTileFromCache(Floor* floor, uint16_t x, uint16_t y);
 
 	std::unordered_map<uint32_t, MapSector> mapSectors;
 
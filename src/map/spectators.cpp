@@ -11,74 +11,64 @@
 
 #include "creatures/creature.hpp"
 #include "game/game.hpp"
+#include "game/scheduling/dispatcher.hpp"
 
-phmap::flat_hash_map<Position, SpectatorsCache> Spectators::spectatorsCache;
+std::vector<std::shared_ptr<Creature>> Spectators::removedCreatures;
 
-void Spectators::clearCache() {
-	spectatorsCache.clear();
+void Spectators::keepAlive(const std::shared_ptr<Creature> &creature) {
+	if (removedCreatures.empty()) {
+		g_dispatcher().addEvent([] { removedCreatures.clear(); }, __FUNCTION__);
+	}
+	removedCreatures.emplace_back(creature);
+}
+
+std::shared_ptr<Creature> Spectators::lock(Creature* creature) {
+	return creature->static_self_cast<Creature>();
 }
 
-Spectators Spectators::insert(const std::shared_ptr<Creature> &creature) {
+Spectators &Spectators::insert(const std::shared_ptr<Creature> &creature) & {
 	if (creature) {
-		creatures.emplace_back(creature);
+		creatures.emplace_back(Entry { creature.get(), MapSector::getSpectatorType(creature) });
 	}
 	return *this;
 }
 
-Spectators Spectators::insertAll(const CreatureVector &list) {
-	if (!list.empty()) {
-		const bool hasValue = !creatures.empty();
-
-		creatures.insert(creatures.end(), list.begin(), list.end());
-
-		// Remove duplicate
-		if (hasValue) {
-			std::unordered_set uset(creatures.begin(), creatures.end());
-			creatures.clear();
-			creatures.insert(creatures.end(), uset.begin(), uset.end());
-		}
+Spectators &Spectators::join(const Spectators &anotherSpectators) & {
+	if (!anotherSpectators.empty()) {
+		const auto previousSize = creatures.size();
+		creatures.insert(creatures.end(), anotherSpectators.creatures.begin(), anotherSpectators.creatures.end());
+		removeDuplicates(previousSize);
 	}
 	return *this;
 }
 
-bool Spectators::checkCache(const SpectatorsCache::FloorData &specData, bool onlyPlayers, bool onlyMonsters, bool onlyNpcs, const Position &centerPos, bool checkDistance, bool multifloor, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY) {
-	const auto &list = multifloor || !specData.floor ? specData.multiFloor : specData.floor;
-
-	if (!list) {
-		return false;
+void Spectators::removeDuplicates(size_t previousSize) {
+	if (previousSize == 0 || creatures.size() == previousSize) {
+		return;
 	}
 
-	if (!multifloor && !specData.floor) {
-		// Force check the distance of creatures as we only need to pick up creatures from the Floor(centerPos.z)
-		checkDistance = true;
+	// The handles are only sorted on the side, so the result keeps the order in which the creatures were found
+	absl::InlinedVector<Creature*, INLINE_CAPACITY> known;
+	known.reserve(creatures.size());
+	for (size_t i = 0; i < previousSize; ++i) {
+		known.emplace_back(creatures[i].creature);
 	}
+	std::ranges::sort(known);
 
-	if (checkDistance) {
-		CreatureVector spectators;
-		spectators.reserve(creatures.size());
-		for (const auto &creature : *list) {
-			const auto &specPos = creature->getPosition();
-			if ((centerPos.x - specPos.x >= minRangeX
-			     && centerPos.y - specPos.y >= minRangeY
-			     && centerPos.x - specPos.x <= maxRangeX
-			     && centerPos.y - specPos.y <= maxRangeY
-			     && (multifloor || specPos.z == centerPos.z)
-			     && ((onlyPlayers && creature->getPlayer())
-			         || (onlyMonsters && creature->getMonster())
-			         || (onlyNpcs && creature->getNpc())))
-			    || (!onlyPlayers && !onlyMonsters && !onlyNpcs)) {
-				spectators.emplace_back(creature);
-			}
+	auto last = creatures.begin() + previousSize;
+	for (auto it = last; it != creatures.end(); ++it) {
+		const auto position = std::ranges::lower_bound(known, it->creature);
+		if (position != known.end() && *position == it->creature) {
+			continue;
 		}
-		insertAll(spectators);
-	} else {
-		insertAll(*list);
-	}
 
-	return true;
+		known.insert(position, it->creature);
+		*last++ = *it;
+	}
+	creatures.erase(last, creatures.end());
 }
 
-CreatureVector Spectators::getSpectators(const Position &centerPos, bool multifloor, bool onlyPlayers, bool onlyMonsters, bool onlyNpcs, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY) {
+void Spectators::getSpectators(const Position &centerPos, bool multifloor, uint8_t typeMask, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY) {
 	uint8_t minRangeZ = centerPos.z;
 	uint8_t maxRangeZ = centerPos.z;
 
@@ -120,27 +110,22 @@ CreatureVector Spectators::getSpectators(const Position &centerPos, bool multifl
 	const int32_t endx2 = x2 - (x2 & SECTOR_MASK);
 	const int32_t endy2 = y2 - (y2 & SECTOR_MASK);
 
-	CreatureVector spectators;
-	spectators.reserve(std::max<uint8_t>(MAP_MAX_VIEW_PORT_X, MAP_MAX_VIEW_PORT_Y) * 2);
-
 	const MapSector* startSector = g_game().map.getMapSector(startx1, starty1);
 	const MapSector* sectorS = startSector;
 	for (int32_t ny = starty1; ny <= endy2; ny += SECTOR_SIZE) {
 		const MapSector* sectorE = sectorS;
 		for (int32_t nx = startx1; nx <= endx2; nx += SECTOR_SIZE) {
 			if (sectorE) {
-				const auto &nodeList = onlyPlayers ? sectorE->player_list
-					: onlyMonsters                 ? sectorE->monster_list
-					: onlyNpcs                     ? sectorE->npc_list
-												   : sectorE->creature_list;
-
-				for (const auto &creature : nodeList) {
-					const auto &cpos = creature->getPosition();
-					if (static_cast<uint32_t>(static_cast<int32_t>(cpos.z) - minRangeZ) <= depth) {
-						const int_fast16_t offsetZ = Position::getOffsetZ(centerPos, cpos);
-						if (static_cast<uint32_t>(cpos.x - offsetZ - min_x) <= width && static_cast<uint32_t>(cpos.y - offsetZ - min_y) <= height) {
-							spectators.emplace_back(creature);
-						}
+				// Scans the packed coordinates only, the creature itself is touched once it is known to be a spectator
+				const auto &index = sectorE->creatures;
+				for (size_t i = 0, size = index.size(); i < size; ++i) {
+					if ((index.types[i] & typeMask) == 0 || static_cast<uint32_t>(static_cast<int32_t>(index.z[i]) - minRangeZ) > depth) {
+						continue;
+					}
+
+					const int32_t offsetZ = centerPos.getZ() - index.z[i];
+					if (static_cast<uint32_t>(index.x[i] - offsetZ - min_x) <= width && static_cast<uint32_t>(index.y[i] - offsetZ - min_y) <= height) {
+						creatures.emplace_back(Entry { index.handles[i], index.types[i] });
 					}
 				}
 				sectorE = sectorE->sectorE;
@@ -155,80 +140,24 @@ CreatureVector Spectators::getSpectators(const Position &centerPos, bool multifl
 			sectorS = g_game().map.getMapSector(startx1, ny + SECTOR_SIZE);
 		}
 	}
-
-	return spectators;
 }
 
-Spectators Spectators::find(const Position &centerPos, bool multifloor, bool onlyPlayers, bool onlyMonsters, bool onlyNpcs, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY, bool useCache) {
+void Spectators::find(const Position &centerPos, bool multifloor, bool onlyPlayers, bool onlyMonsters, bool onlyNpcs, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY) {
 	minRangeX = (minRangeX == 0 ? -MAP_MAX_VIEW_PORT_X : -minRangeX);
 	maxRangeX = (maxRangeX == 0 ? MAP_MAX_VIEW_PORT_X : maxRangeX);
 	minRangeY = (minRangeY == 0 ? -MAP_MAX_VIEW_PORT_Y : -minRangeY);
 	maxRangeY = (maxRangeY == 0 ? MAP_MAX_VIEW_PORT_Y : maxRangeY);
 
-	if (!useCache) {
-		insertAll(getSpectators(centerPos, multifloor, onlyPlayers, onlyMonsters, onlyNpcs, minRangeX, maxRangeX, minRangeY, maxRangeY));
-		return *this;
-	}
-
-	const auto &it = spectatorsCache.find(centerPos);
-	const bool cacheFound = it != spectatorsCache.end();
-	if (cacheFound) {
-		auto &cache = it->second;
-		if (minRangeX < cache.minRangeX || maxRangeX > cache.maxRangeX || minRangeY < cache.minRangeY || maxRangeY > cache.maxRangeY) {
-			// recache with new range
-			cache.minRangeX = minRangeX = std::min<int32_t>(minRangeX, cache.minRangeX);
-			cache.minRangeY = minRangeY = std::min<int32_t>(minRangeY, cache.minRangeY);
-			cache.maxRangeX = maxRangeX = std::max<int32_t>(maxRangeX, cache.maxRangeX);
-			cache.maxRangeY = maxRangeY = std::max<int32_t>(maxRangeY, cache.maxRangeY);
-		} else {
-			const bool checkDistance = minRangeX != cache.minRangeX || maxRangeX != cache.maxRangeX || minRangeY != cache.minRangeY || maxRangeY != cache.maxRangeY;
-
-			if (onlyPlayers || onlyMonsters || onlyNpcs) {
-				static const SpectatorsCache::FloorData EMPTY_FLOOR_DATA;
-
-				const auto &creaturesCache = onlyPlayers ? cache.players
-					: onlyMonsters                       ? cache.monsters
-					: onlyNpcs                           ? cache.npcs
-														 : EMPTY_FLOOR_DATA;
+	const uint8_t typeMask = onlyPlayers ? MapSector::SPECTATOR_TYPE_PLAYER
+		: onlyMonsters                   ? MapSector::SPECTATOR_TYPE_MONSTER
+		: onlyNpcs                       ? MapSector::SPECTATOR_TYPE_NPC
+										 : MapSector::SPECTATOR_TYPE_PLAYER | MapSector::SPECTATOR_TYPE_MONSTER | MapSector::SPECTATOR_TYPE_NPC;
 
-				// check players/monsters/npcs cache
-				if (checkCache(creaturesCache, onlyPlayers, onlyMonsters, onlyNpcs, centerPos, checkDistance, multifloor, minRangeX, maxRangeX, minRangeY, maxRangeY)) {
-					return *this;
-				}
-
-				// if there is no players/monsters/npcs cache, look for players/monsters/npcs in the creatures cache.
-				if (checkCache(cache.creatures, onlyPlayers, onlyMonsters, onlyNpcs, centerPos, true, multifloor, minRangeX, maxRangeX, minRangeY, maxRangeY)) {
-					return *this;
-				}
-				// All Creatures
-			} else if (checkCache(cache.creatures, false, false, false, centerPos, checkDistance, multifloor, minRangeX, maxRangeX, minRangeY, maxRangeY)) {
-				return *this;
-			}
-		}
-	}
-
-	const auto &spectators = getSpectators(centerPos, multifloor, onlyPlayers, onlyMonsters, onlyNpcs, minRangeX, maxRangeX, minRangeY, maxRangeY);
-
-	// It is necessary to create the cache even if no spectators is found, so that there is no future query.
-	auto &cache = cacheFound ? it->second : spectatorsCache.emplace(centerPos, SpectatorsCache { .minRangeX = minRangeX, .maxRangeX = maxRangeX, .minRangeY = minRangeY, .maxRangeY = maxRangeY, .creatures = {}, .monsters = {}, .npcs = {}, .players = {} }).first->second;
-	auto &creaturesCache = onlyPlayers ? cache.players
-		: onlyMonsters                 ? cache.monsters
-		: onlyNpcs                     ? cache.npcs
-									   : cache.creatures;
-	auto &creatureList = (multifloor ? creaturesCache.multiFloor : creaturesCache.floor);
-	if (creatureList) {
-		creatureList->clear();
-	} else {
-		creatureList.emplace();
-	}
+	const auto previousSize = creatures.size();
+	getSpectators(centerPos, multifloor, typeMask, minRangeX, maxRangeX, minRangeY, maxRangeY);
 
-	if (!spectators.empty()) {
-		insertAll(spectators);
-
-		creatureList->insert(creatureList->end(), spectators.begin(), spectators.end());
-	}
-
-	return *this;
+	// Successive finds on the same object may overlap
+	removeDuplicates(previousSize);
 }
 
 Spectators Spectators::excludeMaster() const {
@@ -237,11 +166,9 @@ Spectators Spectators::excludeMaster() const {
 		return specs;
 	}
 
-	specs.creatures.reserve(creatures.size());
-
-	for (const auto &c : creatures) {
-		if (c->getMonster() != nullptr && !c->getMaster()) {
-			specs.insert(c);
+	for (const auto &entry : creatures) {
+		if ((entry.type & MapSector::SPECTATOR_TYPE_MONSTER) != 0 && !entry.creature->getMaster()) {
+			specs.creatures.emplace_back(entry);
 		}
 	}
 
@@ -254,11 +181,10 @@ Spectators Spectators::excludePlayerMaster() const {
 		return specs;
 	}
 
-	specs.creatures.reserve(creatures.size());
-
-	for (const auto &c : creatures) {
-		if ((c->getMonster() != nullptr && !c->getMaster()) || (!c->getMaster() || !c->getMaster()->getPlayer())) {
-			specs.insert(c);
+	for (const auto &entry : creatures) {
+		const auto &master = entry.creature->getMaster();
+		if (((entry.type & MapSector::SPECTATOR_TYPE_MONSTER) != 0 && !master) || (!master || !master->getPlayer())) {
+			specs.creatures.emplace_back(entry);
 		}
 	}
 
@@ -267,15 +193,21 @@ Spectators Spectators::excludePlayerMaster() const {
 
 Spectators Spectators::filter(bool onlyPlayers, bool onlyMonsters, bool onlyNpcs) const {
 	auto specs = Spectators();
-	specs.creatures.reserve(creatures.size());
-
-	for (const auto &c : creatures) {
-		if (onlyPlayers && c->getPlayer() != nullptr) {
-			specs.insert(c);
-		} else if (onlyMonsters && c->getMonster() != nullptr) {
-			specs.insert(c);
-		} else if (onlyNpcs && c->getNpc() != nullptr) {
-			specs.insert(c);
+
+	uint8_t typeMask = 0;
+	if (onlyPlayers) {
+		typeMask |= MapSector::SPECTATOR_TYPE_PLAYER;
+	}
+	if (onlyMonsters) {
+		typeMask |= MapSector::SPECTATOR_TYPE_MONSTER;
+	}
+	if (onlyNpcs) {
+		typeMask |= MapSector::SPECTATOR_TYPE_NPC;
+	}
+
+	for (const auto &entry : creatures) {
+		if ((entry.type & typeMask) != 0) {
+			specs.creatures.emplace_back(entry);
 		}
 	}
 
@@ -18,34 +18,92 @@ struct Position;
 // Forward declaration para CreatureVector
 using CreatureVector = std::vector<std::shared_ptr<Creature>>;
 
-struct SpectatorsCache {
-	struct FloorData {
-		std::optional<CreatureVector> floor;
-		std::optional<CreatureVector> multiFloor;
+/**
+ * Spectators are looked up straight from the structure of arrays index kept by each MapSector,
+ * which is updated incrementally when creatures are added, moved or removed,
+ * so there is no position keyed cache to be invalidated.
+ *
+ * The result keeps non-owning creature handles in inline storage, so finding, copying and
+ * filtering spectators neither allocates (up to INLINE_CAPACITY entries) nor touches reference counts.
+ * Handles are valid until the end of the current dispatcher task, creatures removed from the map
+ * are kept alive until then through keepAlive. Dereferencing an iterator yields a std::shared_ptr.
+ * Entries keep the order in which they were found, duplicates coming later are dropped.
+ */
+class Spectators {
+	struct Entry {
+		Creature* creature;
+		uint8_t type;
 	};
 
-	int32_t minRangeX { 0 };
-	int32_t maxRangeX { 0 };
-	int32_t minRangeY { 0 };
-	int32_t maxRangeY { 0 };
-
-	FloorData creatures;
-	FloorData monsters;
-	FloorData npcs;
-	FloorData players;
-};
-
-class Spectators {
 public:
-	static void clearCache();
+	static constexpr size_t INLINE_CAPACITY = 32;
+	using Container = absl::InlinedVector<Entry, INLINE_CAPACITY>;
+
+	class Iterator {
+	public:
+		using iterator_concept = std::forward_iterator_tag;
+		using iterator_category = std::input_iterator_tag;
+		using value_type = std::shared_ptr<Creature>;
+		using difference_type = std::ptrdiff_t;
+		using reference = const std::shared_ptr<Creature> &;
+
+		Iterator() = default;
+		explicit Iterator(Container::const_iterator it) :
+			it(it) { }
+
+		// The handle is locked once per entry, the first time it is dereferenced
+		const std::shared_ptr<Creature> &operator*() const {
+			if (!current) {
+				current = lock(it->creature);
+			}
+			return current;
+		}
+
+		const std::shared_ptr<Creature>* operator->() const {
+			return &**this;
+		}
+
+		Iterator &operator++() {
+			++it;
+			current.reset();
+			return *this;
+		}
+
+		Iterator operator++(int) {
+			auto copy = *this;
+			++*this;
+			return copy;
+		}
+
+		bool operator==(const Iterator &other) const {
+			return it == other.it;
+		}
+
+	private:
+		Container::const_iterator it {};
+		mutable std::shared_ptr<Creature> current;
+	};
+
+	/**
+	 * @brief Holds a creature that has just been removed from the map until the current dispatcher task ends,
+	 * so the handles given by previous finds stay valid.
+	 */
+	static void keepAlive(const std::shared_ptr<Creature> &creature);
 
 	template <typename T>
 		requires std::is_base_of_v<Creature, T>
-	Spectators find(const Position &centerPos, bool multifloor = false, int32_t minRangeX = 0, int32_t maxRangeX = 0, int32_t minRangeY = 0, int32_t maxRangeY = 0, bool useCache = true) {
+	Spectators &find(const Position &centerPos, bool multifloor = false, int32_t minRangeX = 0, int32_t maxRangeX = 0, int32_t minRangeY = 0, int32_t maxRangeY = 0) & {
 		constexpr bool onlyPlayers = std::is_same_v<T, Player>;
 		constexpr bool onlyMonsters = std::is_same_v<T, Monster>;
 		constexpr bool onlyNpcs = std::is_same_v<T, Npc>;
-		return find(centerPos, multifloor, onlyPlayers, onlyMonsters, onlyNpcs, minRangeX, maxRangeX, minRangeY, maxRangeY, useCache);
+		find(centerPos, multifloor, onlyPlayers, onlyMonsters, onlyNpcs, minRangeX, maxRangeX, minRangeY, maxRangeY);
+		return *this;
+	}
+
+	template <typename T>
+		requires std::is_base_of_v<Creature, T>
+	Spectators find(const Position &centerPos, bool multifloor = false, int32_t minRangeX = 0, int32_t maxRangeX = 0, int32_t minRangeY = 0, int32_t maxRangeY = 0) && {
+		return std::move(find<T>(centerPos, multifloor, minRangeX, maxRangeX, minRangeY, maxRangeY));
 	}
 
 	template <typename T>
@@ -60,18 +118,27 @@ public:
 	Spectators excludeMaster() const;
 	Spectators excludePlayerMaster() const;
 
-	Spectators insert(const std::shared_ptr<Creature> &creature);
-	Spectators insertAll(const CreatureVector &list);
-	Spectators join(const Spectators &anotherSpectators) {
-		return insertAll(anotherSpectators.creatures);
+	Spectators &insert(const std::shared_ptr<Creature> &creature) &;
+	Spectators insert(const std::shared_ptr<Creature> &creature) && {
+		return std::move(insert(creature));
+	}
+
+	Spectators &join(const Spectators &anotherSpectators) &;
+	Spectators join(const Spectators &anotherSpectators) && {
+		return std::move(join(anotherSpectators));
 	}
 
 	bool contains(const std::shared_ptr<Creature> &creature) const {
-		return std::ranges::find(creatures, creature) != creatures.end();
+		return std::ranges::any_of(creatures, [&creature](const Entry &entry) { return entry.creature == creature.get(); });
 	}
 
 	bool erase(const std::shared_ptr<Creature> &creature) {
-		return std::erase(creatures, creature) > 0;
+		const auto it = std::remove_if(creatures.begin(), creatures.end(), [&creature](const Entry &entry) { return entry.creature == creature.get(); });
+		if (it == creatures.end()) {
+			return false;
+		}
+		creatures.erase(it, creatures.end());
+		return true;
 	}
 
 	bool empty() const noexcept {
@@ -82,27 +149,26 @@ public:
 		return creatures.size();
 	}
 
-	auto begin() const noexcept {
-		return creatures.begin();
-	}
-
-	auto end() const noexcept {
-		return creatures.end();
+	Iterator begin() const noexcept {
+		return Iterator(creatures.begin());
 	}
 
-	const auto &data() const noexcept {
-		return creatures;
+	Iterator end() const noexcept {
+		return Iterator(creatures.end());
 	}
 
 private:
-	static phmap::flat_hash_map<Position, SpectatorsCache> spectatorsCache;
+	static std::shared_ptr<Creature> lock(Creature* creature);
+
+	void find(const Position &centerPos, bool multifloor, bool onlyPlayers, bool onlyMonsters, bool onlyNpcs, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY);
+	void getSpectators(const Position &centerPos, bool multifloor, uint8_t typeMask, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY);
 
-	Spectators find(const Position &centerPos, bool multifloor = false, bool onlyPlayers = false, bool onlyMonsters = false, bool onlyNpcs = false, int32_t minRangeX = 0, int32_t maxRangeX = 0, int32_t minRangeY = 0, int32_t maxRangeY = 0, bool useCache = true);
-	CreatureVector getSpectators(const Position &centerPos, bool multifloor = false, bool onlyPlayers = false, bool onlyMonsters = false, bool onlyNpcs = false, int32_t minRangeX = 0, int32_t maxRangeX = 0, int32_t minRangeY = 0, int32_t maxRangeY = 0);
+	// Drops the appended entries that are already in the result, only needed when appending to a non empty result
+	void removeDuplicates(size_t previousSize);
 
 	Spectators filter(bool onlyPlayers, bool onlyMonsters, bool onlyNpcs) const;
 
-	bool checkCache(const SpectatorsCache::FloorData &specData, bool onlyPlayers, bool onlyMonsters, bool onlyNpcs, const Position &centerPos, bool checkDistance, bool multifloor, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY);
+	static std::vector<std::shared_ptr<Creature>> removedCreatures;
 
-	CreatureVector creatures;
+	Container creatures;
 };
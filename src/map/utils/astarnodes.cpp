@@ -13,44 +13,40 @@
 #include "creatures/monsters/monster.hpp"
 #include "items/tile.hpp"
 
-AStarNodes::AStarNodes(uint32_t x, uint32_t y, int_fast32_t extraCost) :
-#if defined(__AVX2__) || defined(__SSE2__)
-	nodesTable(), // 1. nodesTable
-	calculatedNodes(), // 2. calculatedNodes
-	nodes(), // 3. nodes
-	closedNodes(0), // 4. closedNodes
-	curNode(0), // 5. curNode
-	openNodes() // 6. openNodes
-#else
-	nodes(), // 1. nodes
-	nodesTable(), // 2. nodesTable
-	closedNodes(0), // 3. closedNodes
-	curNode(0), // 4. curNode
-	openNodes() // 5. openNodes
-#endif
-{
-#if defined(__AVX2__)
-	__m256i defaultCost = _mm256_set1_epi32(std::numeric_limits<int32_t>::max());
-	for (int32_t i = 0; i < MAX_NODES; i += 32) {
-		_mm256_stream_si256(reinterpret_cast<__m256i*>(&calculatedNodes[i + 0]), defaultCost);
-		_mm256_stream_si256(reinterpret_cast<__m256i*>(&calculatedNodes[i + 8]), defaultCost);
-		_mm256_stream_si256(reinterpret_cast<__m256i*>(&calculatedNodes[i + 16]), defaultCost);
-		_mm256_stream_si256(reinterpret_cast<__m256i*>(&calculatedNodes[i + 24]), defaultCost);
+void AStarNodes::Storage::reserve(int32_t maxNodes) {
+	const auto lanes = static_cast<size_t>((maxNodes + LANE_SIZE - 1) / LANE_SIZE);
+	if (calculatedNodes.size() >= lanes) {
+		return;
 	}
-	_mm_sfence();
-#elif defined(__SSE2__)
-	__m128i defaultCost = _mm_set1_epi32(std::numeric_limits<int32_t>::max());
-	for (int32_t i = 0; i < MAX_NODES; i += 16) {
-		_mm_stream_si128(reinterpret_cast<__m128i*>(&calculatedNodes[i + 0]), defaultCost);
-		_mm_stream_si128(reinterpret_cast<__m128i*>(&calculatedNodes[i + 4]), defaultCost);
-		_mm_stream_si128(reinterpret_cast<__m128i*>(&calculatedNodes[i + 8]), defaultCost);
-		_mm_stream_si128(reinterpret_cast<__m128i*>(&calculatedNodes[i + 12]), defaultCost);
+
+	nodes.resize(lanes * LANE_SIZE);
+	openNodes.resize(lanes * LANE_SIZE);
+	nodesTable.resize(lanes);
+	calculatedNodes.resize(lanes);
+}
+
+AStarNodes::AStarNodes(uint32_t x, uint32_t y, int_fast32_t extraCost, int32_t newMaxNodes /* = DEFAULT_MAX_NODES*/) :
+	maxNodes(std::max<int32_t>(newMaxNodes, LANE_SIZE)),
+	closedNodes(0),
+	curNode(1),
+	useHeap(maxNodes > MAX_SCAN_NODES) {
+	// Searches don't nest, but if one ever does it gets its own buffers
+	thread_local Storage threadStorage;
+	if (threadStorage.inUse) {
+		ownStorage = std::make_unique<Storage>();
+		storage = ownStorage.get();
+	} else {
+		storage = &threadStorage;
 	}
-	_mm_sfence();
-#endif
+	storage->inUse = true;
+	storage->reserve(maxNodes);
 
-	curNode = 1;
-	closedNodes = 0;
+	nodes = storage->nodes.data();
+	nodesTable = storage->nodesTable.data()->values;
+	calculatedNodes = storage->calculatedNodes.data()->values;
+	openNodes = storage->openNodes.data();
+
+	std::fill_n(calculatedNodes, LANE_SIZE, std::numeric_limits<int32_t>::max());
 	openNodes[0] = true;
 
 	AStarNode &startNode = nodes[0];
@@ -61,17 +57,30 @@ AStarNodes::AStarNodes(uint32_t x, uint32_t y, int_fast32_t extraCost) :
 	startNode.g = 0;
 	startNode.c = extraCost;
 	nodesTable[0] = (x << 16) | y;
-#if defined(__SSE2__) || defined(__AVX2__)
 	calculatedNodes[0] = 0;
-#endif
+
+	if (useHeap) {
+		storage->openHeap.clear();
+		storage->positions.clear();
+		storage->positions.emplace(nodesTable[0], 0);
+		pushOpenNode(0);
+	}
+}
+
+AStarNodes::~AStarNodes() {
+	storage->inUse = false;
 }
 
 bool AStarNodes::createOpenNode(AStarNode* parent, uint32_t x, uint32_t y, int_fast32_t f, int_fast32_t heuristic, int_fast32_t extraCost) {
-	if (curNode >= MAX_NODES) {
+	if (curNode >= maxNodes) {
 		return false;
 	}
 
 	const int32_t retNode = curNode++;
+	if (retNode % LANE_SIZE == 0) {
+		// First node of a lane, the scans must not see the costs left by a previous search
+		std::fill_n(&calculatedNodes[retNode], LANE_SIZE, std::numeric_limits<int32_t>::max());
+	}
 	openNodes[retNode] = true;
 
 	AStarNode &node = nodes[retNode];
@@ -82,13 +91,41 @@ bool AStarNodes::createOpenNode(AStarNode* parent, uint32_t x, uint32_t y, int_f
 	node.g = heuristic;
 	node.c = extraCost;
 	nodesTable[retNode] = (x << 16) | y;
-#if defined(__SSE2__)
 	calculatedNodes[retNode] = f + heuristic;
-#endif
+
+	if (useHeap) {
+		storage->positions.emplace(nodesTable[retNode], retNode);
+		pushOpenNode(retNode);
+	}
 	return true;
 }
 
+void AStarNodes::pushOpenNode(int32_t index) {
+	auto &openHeap = storage->openHeap;
+	openHeap.emplace_back(calculatedNodes[index], index);
+	std::ranges::push_heap(openHeap, std::greater<>());
+}
+
+AStarNode* AStarNodes::getBestNodeFromHeap() {
+	auto &openHeap = storage->openHeap;
+	while (!openHeap.empty()) {
+		const auto [cost, index] = openHeap.front();
+		if (openNodes[index] && calculatedNodes[index] == cost) {
+			return &nodes[index];
+		}
+
+		// Closed or reopened with another cost since it was pushed
+		std::ranges::pop_heap(openHeap, std::greater<>());
+		openHeap.pop_back();
+	}
+	return nullptr;
+}
+
 AStarNode* AStarNodes::getBestNode() {
+	if (useHeap) {
+		return getBestNodeFromHeap();
+	}
+
 // Branchless best node search
 #if defined(__AVX512F__)
 	const __m512i increment = _mm512_set1_epi32(16);
@@ -187,51 +224,49 @@ AStarNode* AStarNodes::getBestNode() {
 	int32_t best_node = indices_array[(mm_ctz(_mm_movemask_epi8(_mm_cmpeq_epi32(minvalues, res))) >> 2)];
 	return (openNodes[best_node] ? &nodes[best_node] : nullptr);
 #else
-	int32_t best_node_f = std::numeric_limits<int32_t>::max();
-	int32_t best_node = -1;
-	for (int32_t pos = 0; pos < curNode; ++pos) {
-		if (!openNodes[pos]) {
-			continue;
-		}
-
-		int32_t total_cost = nodes[pos].f + nodes[pos].g;
-		best_node = (total_cost < best_node_f ? pos : best_node);
-		best_node_f = (total_cost < best_node_f ? total_cost : best_node_f);
-	}
-	return (best_node != -1 ? &nodes[best_node] : nullptr);
+	return getBestNodeFromHeap();
 #endif
 }
 
 void AStarNodes::closeNode(const AStarNode* node) {
-	const size_t index = node - nodes;
-	assert(index < MAX_NODES);
-#if defined(__SSE2__)
+	const auto index = static_cast<int32_t>(node - nodes);
+	assert(index < maxNodes);
 	calculatedNodes[index] = std::numeric_limits<int32_t>::max();
-#endif
 	openNodes[index] = false;
 	++closedNodes;
 }
 
 void AStarNodes::openNode(const AStarNode* node) {
-	const size_t index = node - nodes;
-	assert(index < MAX_NODES);
-#if defined(__SSE2__)
+	const auto index = static_cast<int32_t>(node - nodes);
+	assert(index < maxNodes);
 	calculatedNodes[index] = nodes[index].f + nodes[index].g;
-#endif
 	closedNodes -= (openNodes[index] ? 0 : 1);
 	openNodes[index] = true;
+
+	if (useHeap) {
+		pushOpenNode(index);
+	}
 }
 
 int32_t AStarNodes::getClosedNodes() const {
 	return closedNodes;
 }
 
+int32_t AStarNodes::getMaxClosedNodes() const {
+	return static_cast<int32_t>(static_cast<int64_t>(maxNodes) * DEFAULT_MAX_CLOSED_NODES / DEFAULT_MAX_NODES);
+}
+
 AStarNode* AStarNodes::getNodeByPosition(uint32_t x, uint32_t y) {
 	uint32_t xy = (x << 16) | y;
+	if (useHeap) {
+		const auto it = storage->positions.find(xy);
+		return it != storage->positions.end() ? &nodes[it->second] : nullptr;
+	}
+
+	int32_t pos = 0;
 #if defined(__SSE2__)
 	const __m128i key = _mm_set1_epi32(xy);
 
-	int32_t pos = 0;
 	int32_t curRound = curNode - 16;
 	for (; pos <= curRound; pos += 16) {
 		__m128i v[4];
@@ -255,20 +290,13 @@ AStarNode* AStarNodes::getNodeByPosition(uint32_t x, uint32_t y) {
 		}
 		pos += 8;
 	}
+#endif
 	for (; pos < curNode; ++pos) {
 		if (nodesTable[pos] == xy) {
 			return &nodes[pos];
 		}
 	}
 	return nullptr;
-#else
-	for (int32_t i = 1; i < curNode; ++i) {
-		if (nodesTable[i] == xy) {
-			return &nodes[i];
-		}
-	}
-	return (nodesTable[0] == xy ? &nodes[0] : nullptr); // The first node is very unlikely to be the "neighbor" so leave it for end
-#endif
 }
 
 int_fast32_t AStarNodes::getMapWalkCost(const AStarNode* node, const Position &neighborPos) {
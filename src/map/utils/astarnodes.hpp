@@ -19,35 +19,81 @@ struct AStarNode {
 	uint16_t x, y;
 };
 
+/**
+ * Node store of a single A* search, sized at runtime by the node budget.
+ *
+ * The buffers are kept per thread and reused between searches, so a search only allocates when it
+ * needs a larger budget than the previous ones. Up to MAX_SCAN_NODES the best open node is found
+ * with a vectorized scan, larger budgets (or builds without SSE2) use a binary heap instead,
+ * so long searches don't pay for every node created on each step.
+ */
 class AStarNodes {
 public:
-	AStarNodes(uint32_t x, uint32_t y, int_fast32_t extraCost);
+	static constexpr int32_t DEFAULT_MAX_NODES = 512;
+	static constexpr int32_t DEFAULT_MAX_CLOSED_NODES = 100;
+#if defined(__SSE2__)
+	static constexpr int32_t MAX_SCAN_NODES = DEFAULT_MAX_NODES;
+#else
+	static constexpr int32_t MAX_SCAN_NODES = 0;
+#endif
+
+	AStarNodes(uint32_t x, uint32_t y, int_fast32_t extraCost, int32_t maxNodes = DEFAULT_MAX_NODES);
+	~AStarNodes();
+
+	// Ensures that we don't accidentally copy it
+	AStarNodes(const AStarNodes &) = delete;
+	AStarNodes &operator=(const AStarNodes &) = delete;
 
 	bool createOpenNode(AStarNode* parent, uint32_t x, uint32_t y, int_fast32_t f, int_fast32_t heuristic, int_fast32_t extraCost);
 	AStarNode* getBestNode();
 	void closeNode(const AStarNode* node);
 	void openNode(const AStarNode* node);
 	int32_t getClosedNodes() const;
+	// The closed nodes limit grows along with the node budget
+	int32_t getMaxClosedNodes() const;
 	AStarNode* getNodeByPosition(uint32_t x, uint32_t y);
 
 	static int_fast32_t getMapWalkCost(const AStarNode* node, const Position &neighborPos);
 	static int_fast32_t getTileWalkCost(const std::shared_ptr<Creature> &creature, const std::shared_ptr<Tile> &tile);
 
 private:
-	static constexpr int32_t MAX_NODES = 512;
 	static constexpr int32_t MAP_NORMALWALKCOST = 10;
 	static constexpr int32_t MAP_PREFERDIAGONALWALKCOST = 14;
 	static constexpr int32_t MAP_DIAGONALWALKCOST = 25;
 
-#if defined(__SSE2__)
-	alignas(16) uint32_t nodesTable[MAX_NODES] {};
-	alignas(64) int32_t calculatedNodes[MAX_NODES] {};
-	AStarNode nodes[MAX_NODES];
-#else
-	AStarNode nodes[MAX_NODES];
-	uint32_t nodesTable[MAX_NODES];
-#endif
+	// The vectorized scans read whole lanes, so the tables are allocated and initialized a lane at a time
+	static constexpr int32_t LANE_SIZE = 16;
+	template <typename T>
+	struct alignas(64) Lane {
+		T values[LANE_SIZE];
+	};
+
+	struct Storage {
+		std::vector<AStarNode> nodes;
+		std::vector<Lane<uint32_t>> nodesTable;
+		std::vector<Lane<int32_t>> calculatedNodes;
+		std::vector<uint8_t> openNodes;
+		// Min-heap of (f + heuristic, index), outdated entries are skipped when they reach the top
+		std::vector<std::pair<int32_t, int32_t>> openHeap;
+		phmap::flat_hash_map<uint32_t, int32_t> positions;
+		bool inUse = false;
+
+		void reserve(int32_t maxNodes);
+	};
+
+	void pushOpenNode(int32_t index);
+	AStarNode* getBestNodeFromHeap();
+
+	std::unique_ptr<Storage> ownStorage;
+	Storage* storage;
+
+	AStarNode* nodes;
+	uint32_t* nodesTable;
+	int32_t* calculatedNodes;
+	uint8_t* openNodes;
+
+	int32_t maxNodes;
 	int32_t closedNodes;
 	int32_t curNode;
-	bool openNodes[MAX_NODES];
+	bool useHeap;
 };
@@ -0,0 +1,198 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "map/utils/flowfield.hpp"
+
+#include "utils/tools.hpp"
+
+namespace {
+	struct Neighbor {
+		int32_t x;
+		int32_t y;
+		Direction direction;
+	};
+
+	// Orthogonal neighbors first, so they win ties against diagonal ones
+	constexpr std::array<Neighbor, 8> neighbors { {
+		{ 0, -1, DIRECTION_NORTH },
+		{ 1, 0, DIRECTION_EAST },
+		{ 0, 1, DIRECTION_SOUTH },
+		{ -1, 0, DIRECTION_WEST },
+		{ -1, -1, DIRECTION_NORTHWEST },
+		{ 1, -1, DIRECTION_NORTHEAST },
+		{ 1, 1, DIRECTION_SOUTHEAST },
+		{ -1, 1, DIRECTION_SOUTHWEST },
+	} };
+}
+
+FlowField::FlowField(const Position &target, const WalkableFunction &isWalkable) :
+	target(target) {
+	distances.fill(UNREACHABLE);
+
+	std::array<uint16_t, SIDE * SIDE> queue;
+	size_t head = 0;
+	size_t tail = 0;
+
+	// The target tile is always the origin, even if its creature is the only thing that can stand there
+	const auto origin = index(target);
+	distances[origin] = 0;
+	queue[tail++] = static_cast<uint16_t>(origin);
+
+	while (head != tail) {
+		const auto current = queue[head++];
+		const auto cx = static_cast<int32_t>(current % SIDE);
+		const auto cy = static_cast<int32_t>(current / SIDE);
+		const uint16_t distance = distances[current] + 1;
+
+		for (const auto &neighbor : neighbors) {
+			const auto nx = cx + neighbor.x;
+			const auto ny = cy + neighbor.y;
+			if (nx < 0 || ny < 0 || nx >= SIDE || ny >= SIDE) {
+				continue;
+			}
+
+			const auto next = static_cast<size_t>(ny) * SIDE + static_cast<size_t>(nx);
+			if (distances[next] != UNREACHABLE) {
+				continue;
+			}
+
+			const Position pos(static_cast<uint16_t>(target.x + nx - RADIUS), static_cast<uint16_t>(target.y + ny - RADIUS), target.z);
+			if (!isWalkable(pos)) {
+				// Checked once, a blocked tile never gets a distance
+				distances[next] = UNREACHABLE - 1;
+				continue;
+			}
+
+			distances[next] = distance;
+			queue[tail++] = static_cast<uint16_t>(next);
+		}
+	}
+
+	std::ranges::replace(distances, static_cast<uint16_t>(UNREACHABLE - 1), UNREACHABLE);
+}
+
+void FlowField::getBestSteps(const Position &from, std::vector<std::pair<Direction, Position>> &steps) const {
+	const auto distance = getDistance(from);
+	uint16_t best = distance;
+	for (const auto &neighbor : neighbors) {
+		const Position pos(static_cast<uint16_t>(from.x + neighbor.x), static_cast<uint16_t>(from.y + neighbor.y), from.z);
+		const auto neighborDistance = getDistance(pos);
+		if (neighborDistance >= distance) {
+			continue;
+		}
+
+		if (neighborDistance < best) {
+			best = neighborDistance;
+			steps.clear();
+		}
+		if (neighborDistance == best) {
+			steps.emplace_back(neighbor.direction, pos);
+		}
+	}
+}
+
+bool FlowField::getPath(const Position &from, uint16_t targetDistance, std::vector<Direction> &dirList, const WalkableFunction &canWalk) const {
+	const auto distance = getDistance(from);
+	if (distance == UNREACHABLE || distance <= targetDistance) {
+		return false;
+	}
+
+	std::vector<std::pair<Direction, Position>> steps;
+	steps.reserve(neighbors.size());
+	getBestSteps(from, steps);
+
+	// Every chaser reads the same field, the first free step spreads them around taken tiles
+	const auto it = std::ranges::find_if(steps, [&canWalk](const auto &step) { return canWalk(step.second); });
+	if (it == steps.end()) {
+		return false;
+	}
+
+	const auto first = dirList.size();
+	dirList.reserve(first + distance - targetDistance);
+	dirList.emplace_back(it->first);
+
+	Position pos = it->second;
+	while (getDistance(pos) > targetDistance) {
+		steps.clear();
+		getBestSteps(pos, steps);
+		if (steps.empty()) {
+			break;
+		}
+
+		dirList.emplace_back(steps.front().first);
+		pos = steps.front().second;
+	}
+
+	// Walked from the back, as the paths from Map::getPathMatching
+	std::reverse(dirList.begin() + static_cast<std::ptrdiff_t>(first), dirList.end());
+	return true;
+}
+
+std::shared_ptr<const FlowField> FlowFieldCache::get(uint32_t targetId, const Position &targetPos, const FlowField::WalkableFunction &isWalkable) {
+	const auto now = OTSYS_TIME();
+	{
+		std::shared_lock lock(mutex);
+		const auto it = fields.find(targetId);
+		if (it != fields.end() && it->second->getTarget() == targetPos) {
+			it->second->setLastUsed(now);
+			return it->second;
+		}
+	}
+
+	// Built with the lock released, reading the tiles may create them and invalidate the cache from this same thread
+	const auto generation = invalidations.load(std::memory_order_acquire);
+	auto built = std::make_shared<const FlowField>(targetPos, isWalkable);
+	built->setLastUsed(now);
+
+	std::unique_lock lock(mutex);
+	// A tile changed while it was being built, it is used this once but not kept
+	if (invalidations.load(std::memory_order_acquire) != generation) {
+		return built;
+	}
+
+	auto &field = fields[targetId];
+	if (!field || field->getTarget() != targetPos) {
+		field = std::move(built);
+	}
+	field->setLastUsed(now);
+
+	auto result = field;
+	if (fields.size() > MAX_FIELDS) {
+		evictOldest();
+	}
+	count.store(fields.size(), std::memory_order_relaxed);
+	return result;
+}
+
+void FlowFieldCache::invalidate(const Position &pos) {
+	// Called for every tile flag change, including the map loading
+	invalidations.fetch_add(1, std::memory_order_acq_rel);
+	if (count.load(std::memory_order_relaxed) == 0) {
+		return;
+	}
+
+	std::unique_lock lock(mutex);
+	for (auto it = fields.begin(); it != fields.end();) {
+		if (!it->second || it->second->contains(pos)) {
+			fields.erase(it++);
+		} else {
+			++it;
+		}
+	}
+	count.store(fields.size(), std::memory_order_relaxed);
+}
+
+void FlowFieldCache::evictOldest() {
+	const auto oldest = std::ranges::min_element(fields, [](const auto &a, const auto &b) {
+		return a.second->getLastUsed() < b.second->getLastUsed();
+	});
+	if (oldest != fields.end()) {
+		fields.erase(oldest);
+	}
+}
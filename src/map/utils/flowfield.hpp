@@ -0,0 +1,100 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "game/movement/position.hpp"
+#include "items/items_definitions.hpp"
+
+/**
+ * Distance map towards a single target position, built with a breadth-first search over a bounded square around it.
+ *
+ * Every monster chasing the same creature can read its next step straight from the field,
+ * instead of running its own A* search towards the same position.
+ * Only static walkability is considered (ground and blocking tile flags), creatures and
+ * harmful fields are left to the caller, which validates the step it is about to take.
+ */
+class FlowField {
+public:
+	static constexpr int32_t RADIUS = 12;
+	static constexpr int32_t SIDE = RADIUS * 2 + 1;
+	static constexpr uint16_t UNREACHABLE = std::numeric_limits<uint16_t>::max();
+
+	// Tile flags that block every monster, regardless of who is walking
+	static constexpr uint32_t BLOCKING_FLAGS = TILESTATE_PROTECTIONZONE | TILESTATE_FLOORCHANGE | TILESTATE_TELEPORT | TILESTATE_BLOCKSOLID | TILESTATE_IMMOVABLEBLOCKSOLID | TILESTATE_NOFIELDBLOCKPATH | TILESTATE_IMMOVABLENOFIELDBLOCKPATH;
+
+	using WalkableFunction = std::function<bool(const Position &)>;
+
+	FlowField(const Position &target, const WalkableFunction &isWalkable);
+
+	const Position &getTarget() const {
+		return target;
+	}
+
+	bool contains(const Position &pos) const {
+		return pos.z == target.z && Position::getDistanceX(pos, target) <= RADIUS && Position::getDistanceY(pos, target) <= RADIUS;
+	}
+
+	uint16_t getDistance(const Position &pos) const {
+		return contains(pos) ? distances[index(pos)] : UNREACHABLE;
+	}
+
+	/**
+	 * @brief Walks down the field from a position until reaching the target distance.
+	 * Only the first step is checked against canWalk, the following ones are recalculated after each step anyway.
+	 * As the paths from Map::getPathMatching, the first step is the last direction of the list.
+	 * @return false if the position is out of the field, unreachable, already in range or has no free step.
+	 */
+	bool getPath(const Position &from, uint16_t targetDistance, std::vector<Direction> &dirList, const WalkableFunction &canWalk) const;
+
+	int64_t getLastUsed() const {
+		return lastUsed.load(std::memory_order_relaxed);
+	}
+	void setLastUsed(int64_t time) const {
+		lastUsed.store(time, std::memory_order_relaxed);
+	}
+
+private:
+	size_t index(const Position &pos) const {
+		return static_cast<size_t>(pos.y - target.y + RADIUS) * SIDE + static_cast<size_t>(pos.x - target.x + RADIUS);
+	}
+
+	// Neighbors to step into, cheapest first and orthogonal before diagonal
+	void getBestSteps(const Position &from, std::vector<std::pair<Direction, Position>> &steps) const;
+
+	Position target;
+	std::array<uint16_t, SIDE * SIDE> distances;
+	mutable std::atomic<int64_t> lastUsed = 0;
+};
+
+/**
+ * Flow fields of the creatures being chased, built on demand and shared between all their chasers.
+ * A field is rebuilt when its target moves and dropped when the walkability of a tile inside it changes.
+ */
+class FlowFieldCache {
+public:
+	static constexpr size_t MAX_FIELDS = 512;
+
+	std::shared_ptr<const FlowField> get(uint32_t targetId, const Position &targetPos, const FlowField::WalkableFunction &isWalkable);
+
+	void invalidate(const Position &pos);
+
+	size_t size() const {
+		return count.load(std::memory_order_relaxed);
+	}
+
+private:
+	void evictOldest();
+
+	mutable std::shared_mutex mutex;
+	phmap::flat_hash_map<uint32_t, std::shared_ptr<const FlowField>> fields;
+	std::atomic_size_t count = 0;
+	// Bumped by every invalidation that may concern a field, so one built meanwhile is not kept
+	std::atomic_uint64_t invalidations = 0;
+};
@@ -10,60 +10,104 @@
 #include "map/utils/mapsector.hpp"
 
 #include "creatures/creature.hpp"
+#include "game/scheduling/dispatcher.hpp"
+#include "items/tile.hpp"
 
 bool MapSector::newSector = false;
 
-void MapSector::addCreature(const std::shared_ptr<Creature> &c) {
-	creature_list.emplace_back(c);
+namespace {
+	std::mutex retiredTilesMutex;
+	std::vector<std::shared_ptr<Tile>> retiredTiles;
+}
+
+void Floor::setTile(uint16_t x, uint16_t y, std::shared_ptr<Tile> tile) {
+	const auto index = getIndex(x, y);
+	tilePtrs[index].store(tile.get(), std::memory_order_release);
+
+	auto &current = tiles[index].first;
+	if (current && current != tile) {
+		retireTile(std::move(current));
+	}
+	current = std::move(tile);
+}
+
+void Floor::setTileCache(uint16_t x, uint16_t y, const std::shared_ptr<BasicTile> &newTile) {
+	const auto index = getIndex(x, y);
+	tiles[index].second = newTile;
+
+	const auto bit = uint64_t(1) << (index % 64);
+	if (newTile) {
+		cachedTiles[index / 64].fetch_or(bit, std::memory_order_release);
+	} else {
+		cachedTiles[index / 64].fetch_and(~bit, std::memory_order_release);
+	}
+}
+
+void Floor::retireTile(std::shared_ptr<Tile> tile) {
+	std::scoped_lock lock(retiredTilesMutex);
+	if (retiredTiles.empty()) {
+		// Runs after the current dispatcher cycle, once nobody can hold a raw pointer to them anymore
+		g_dispatcher().addEvent([] {
+			std::vector<std::shared_ptr<Tile>> released;
+			{
+				std::scoped_lock lock(retiredTilesMutex);
+				released.swap(retiredTiles);
+			}
+		},
+		                        __FUNCTION__);
+	}
+	retiredTiles.emplace_back(std::move(tile));
+}
+
+uint8_t MapSector::getSpectatorType(const std::shared_ptr<Creature> &c) {
 	if (c->getPlayer()) {
-		player_list.emplace_back(c);
+		return SPECTATOR_TYPE_PLAYER;
 	} else if (c->getMonster()) {
-		monster_list.emplace_back(c);
+		return SPECTATOR_TYPE_MONSTER;
 	} else if (c->getNpc()) {
-		npc_list.emplace_back(c);
+		return SPECTATOR_TYPE_NPC;
 	}
+	return 0;
+}
+
+void MapSector::addCreature(const std::shared_ptr<Creature> &c, const Position &pos) {
+	creatures.handles.emplace_back(c.get());
+	creatures.x.emplace_back(pos.x);
+	creatures.y.emplace_back(pos.y);
+	creatures.z.emplace_back(pos.z);
+	creatures.types.emplace_back(getSpectatorType(c));
+	creatures.creatures.emplace_back(c);
 }
 
 void MapSector::removeCreature(const std::shared_ptr<Creature> &c) {
-	auto iter = std::ranges::find(creature_list, c);
-	if (iter == creature_list.end()) {
-		g_logger().error("[{}]: Creature not found in creature_list!", __FUNCTION__);
+	const auto index = creatures.find(c.get());
+	if (index == creatures.size()) {
+		g_logger().error("[{}]: Creature not found in sector!", __FUNCTION__);
 		return;
 	}
 
-	assert(iter != creature_list.end());
-	*iter = creature_list.back();
-	creature_list.pop_back();
+	// Swap and pop on every array to keep them aligned
+	const auto swapAndPop = [index](auto &vector) {
+		vector[index] = std::move(vector.back());
+		vector.pop_back();
+	};
 
-	if (c->getPlayer()) {
-		iter = std::ranges::find(player_list, c);
-		if (iter == player_list.end()) {
-			g_logger().error("[{}]: Player not found in player_list!", __FUNCTION__);
-			return;
-		}
-
-		assert(iter != player_list.end());
-		*iter = player_list.back();
-		player_list.pop_back();
-	} else if (c->getMonster()) {
-		iter = std::ranges::find(monster_list, c);
-		if (iter == monster_list.end()) {
-			g_logger().error("[{}]: Monster not found in player_list!", __FUNCTION__);
-			return;
-		}
-
-		assert(iter != monster_list.end());
-		*iter = monster_list.back();
-		monster_list.pop_back();
-	} else if (c->getNpc()) {
-		iter = std::ranges::find(npc_list, c);
-		if (iter == npc_list.end()) {
-			g_logger().error("[{}]: NPC not found in player_list!", __FUNCTION__);
-			return;
-		}
-
-		assert(iter != npc_list.end());
-		*iter = npc_list.back();
-		npc_list.pop_back();
+	swapAndPop(creatures.handles);
+	swapAndPop(creatures.x);
+	swapAndPop(creatures.y);
+	swapAndPop(creatures.z);
+	swapAndPop(creatures.types);
+	swapAndPop(creatures.creatures);
+}
+
+void MapSector::moveCreature(const std::shared_ptr<Creature> &c, const Position &pos) {
+	const auto index = creatures.find(c.get());
+	if (index == creatures.size()) {
+		g_logger().error("[{}]: Creature not found in sector!", __FUNCTION__);
+		return;
 	}
+
+	creatures.x[index] = pos.x;
+	creatures.y[index] = pos.y;
+	creatures.z[index] = pos.z;
 }
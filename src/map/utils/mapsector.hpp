@@ -14,33 +14,43 @@
 class Creature;
 class Tile;
 struct BasicTile;
+struct Position;
 
+/**
+ * Tiles of one floor of a sector, stored in a flat array.
+ *
+ * Besides the owning pointers, every position publishes a raw tile pointer that can be read without
+ * locking nor touching reference counts (getTileRaw). Replaced tiles are retired instead of released,
+ * RCU style, and only dropped by the dispatcher after the current cycle, so a raw pointer read in a task
+ * stays valid until that task ends. Writers still serialize through the floor mutex.
+ */
 struct Floor {
 	explicit Floor(uint8_t z) :
 		z(z) { }
 
+	Tile* getTileRaw(uint16_t x, uint16_t y) const {
+		return tilePtrs[getIndex(x, y)].load(std::memory_order_acquire);
+	}
+
 	std::shared_ptr<Tile> getTile(uint16_t x, uint16_t y) const {
 		std::shared_lock<std::shared_mutex> sl(mutex);
-		return tiles[x & SECTOR_MASK][y & SECTOR_MASK].first;
+		return tiles[getIndex(x, y)].first;
 	}
 
-	void setTile(uint16_t x, uint16_t y, std::shared_ptr<Tile> tile) {
-		tiles[x & SECTOR_MASK][y & SECTOR_MASK].first = std::move(tile);
+	// The caller must hold the floor mutex
+	void setTile(uint16_t x, uint16_t y, std::shared_ptr<Tile> tile);
+
+	bool hasTileCache(uint16_t x, uint16_t y) const {
+		const auto index = getIndex(x, y);
+		return (cachedTiles[index / 64].load(std::memory_order_acquire) & (uint64_t(1) << (index % 64))) != 0;
 	}
 
 	std::shared_ptr<BasicTile> getTileCache(uint16_t x, uint16_t y) const {
 		std::shared_lock<std::shared_mutex> sl(mutex);
-		return tiles[x & SECTOR_MASK][y & SECTOR_MASK].second;
+		return tiles[getIndex(x, y)].second;
 	}
 
-	void setTileCache(uint16_t x, uint16_t y, const std::shared_ptr<BasicTile> &newTile) {
-		tiles[x & SECTOR_MASK][y & SECTOR_MASK].second = newTile;
-	}
-
-	const auto &getTiles() const {
-		std::shared_lock<std::shared_mutex> sl(mutex);
-		return tiles;
-	}
+	void setTileCache(uint16_t x, uint16_t y, const std::shared_ptr<BasicTile> &newTile);
 
 	uint8_t getZ() const {
 		return z;
@@ -51,7 +61,18 @@ struct Floor {
 	}
 
 private:
-	std::pair<std::shared_ptr<Tile>, std::shared_ptr<BasicTile>> tiles[SECTOR_SIZE][SECTOR_SIZE] = {};
+	static constexpr size_t TILES_SIZE = SECTOR_SIZE * SECTOR_SIZE;
+
+	static size_t getIndex(uint16_t x, uint16_t y) {
+		return ((y & SECTOR_MASK) * SECTOR_SIZE) + (x & SECTOR_MASK);
+	}
+
+	static void retireTile(std::shared_ptr<Tile> tile);
+
+	std::pair<std::shared_ptr<Tile>, std::shared_ptr<BasicTile>> tiles[TILES_SIZE] = {};
+	std::atomic<Tile*> tilePtrs[TILES_SIZE] = {};
+	// One bit per position that still has a tile to be built from the map cache
+	std::atomic<uint64_t> cachedTiles[(TILES_SIZE + 63) / 64] = {};
 
 	mutable std::shared_mutex mutex;
 
@@ -67,45 +88,82 @@ public:
 	MapSector(const MapSector &&) = delete;
 	MapSector &operator=(const MapSector &&) = delete;
 
-	std::shared_ptr<Floor> createFloor(uint32_t z) {
+	Floor* createFloor(uint32_t z) {
 		if (z >= MAP_MAX_LAYERS) {
 			g_logger().error("Attempt to create floor on invalid coordinate: {}", z);
 			return nullptr;
 		}
 		std::scoped_lock lock(floors_mutex);
 		if (!floors[z]) {
-			floors[z] = std::make_shared<Floor>(static_cast<uint8_t>(z));
+			floors[z] = std::make_unique<Floor>(static_cast<uint8_t>(z));
+			floorPtrs[z].store(floors[z].get(), std::memory_order_release);
 		}
-		return floors[z];
+		return floors[z].get();
 	}
 
-	std::shared_ptr<Floor> getFloor(uint8_t z) {
+	// Lock-free, floors are never destroyed while the sector exists
+	Floor* getFloor(uint8_t z) const {
 		if (z >= MAP_MAX_LAYERS) {
 			g_logger().error("Attempt to get floor on invalid coordinate: {}", z);
 			return nullptr;
 		}
-		std::scoped_lock lock(floors_mutex);
-		return floors[z];
+		return floorPtrs[z].load(std::memory_order_acquire);
 	}
 
-	void addCreature(const std::shared_ptr<Creature> &c);
+	void addCreature(const std::shared_ptr<Creature> &c, const Position &pos);
 
 	void removeCreature(const std::shared_ptr<Creature> &c);
 
+	// Keeps the indexed position in sync when a creature moves without leaving the sector
+	void moveCreature(const std::shared_ptr<Creature> &c, const Position &pos);
+
 private:
+	enum SpectatorType : uint8_t {
+		SPECTATOR_TYPE_PLAYER = 1 << 0,
+		SPECTATOR_TYPE_MONSTER = 1 << 1,
+		SPECTATOR_TYPE_NPC = 1 << 2,
+	};
+
+	/**
+	 * Creatures of the sector in structure of arrays layout.
+	 * Range and type queries scan the packed coordinates/types and only
+	 * touch the creature handle of the ones that match.
+	 * Lookups use the raw pointer, as the creature id is only assigned after it is placed.
+	 */
+	struct CreatureIndex {
+		std::vector<Creature*> handles;
+		std::vector<uint16_t> x;
+		std::vector<uint16_t> y;
+		std::vector<uint8_t> z;
+		std::vector<uint8_t> types;
+		std::vector<std::shared_ptr<Creature>> creatures;
+
+		size_t size() const {
+			return handles.size();
+		}
+
+		bool empty() const {
+			return handles.empty();
+		}
+
+		size_t find(const Creature* creature) const {
+			return static_cast<size_t>(std::ranges::find(handles, creature) - handles.begin());
+		}
+	};
+
+	static uint8_t getSpectatorType(const std::shared_ptr<Creature> &c);
+
 	static bool newSector;
 
 	MapSector* sectorS = nullptr;
 	MapSector* sectorE = nullptr;
 
-	std::vector<std::shared_ptr<Creature>> creature_list;
-	std::vector<std::shared_ptr<Creature>> player_list;
-	std::vector<std::shared_ptr<Creature>> monster_list;
-	std::vector<std::shared_ptr<Creature>> npc_list;
+	CreatureIndex creatures;
 
 	mutable std::mutex floors_mutex;
 
-	std::shared_ptr<Floor> floors[MAP_MAX_LAYERS] = {};
+	std::unique_ptr<Floor> floors[MAP_MAX_LAYERS] = {};
+	std::atomic<Floor*> floorPtrs[MAP_MAX_LAYERS] = {};
 
 	uint32_t floorBits = 0;
 
@@ -0,0 +1,192 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "map/utils/pathfinding_service.hpp"
+
+#include "config/configmanager.hpp"
+#include "creatures/monsters/monster.hpp"
+#include "game/game.hpp"
+#include "game/scheduling/dispatcher.hpp"
+#include "lib/di/container.hpp"
+#include "lib/metrics/metrics.hpp"
+#include "utils/hash.hpp"
+#include "utils/tools.hpp"
+
+PathfindingService &PathfindingService::getInstance() {
+	return inject<PathfindingService>();
+}
+
+bool PathfindingService::isEnabled() {
+	return g_configManager().getBoolean(TOGGLE_PATHFINDING_BATCH);
+}
+
+void PathfindingService::addRequest(const std::shared_ptr<Creature> &creature, const std::shared_ptr<Creature> &target, const FindPathParams &fpp, bool executeOnFollow) {
+	Request request;
+	request.creature = creature;
+	request.target = target;
+	request.startPos = creature->getPosition();
+	request.targetPos = target->getPosition();
+	request.fpp = fpp;
+	request.executeOnFollow = executeOnFollow;
+
+	// Only monsters of the same type walk through the same tiles
+	const auto &monster = creature->getMonster();
+	request.group = Group {
+		.walker = monster ? reinterpret_cast<uintptr_t>(monster->getMonsterType().get()) : reinterpret_cast<uintptr_t>(creature.get()),
+		.targetPos = request.targetPos,
+		.flags = static_cast<uint8_t>(fpp.fullPathSearch | fpp.clearSight << 1 | fpp.allowDiagonal << 2 | fpp.keepDistance << 3),
+		.maxSearchDist = fpp.maxSearchDist,
+		.minTargetDist = fpp.minTargetDist,
+		.maxTargetDist = fpp.maxTargetDist,
+		.maxNodes = fpp.maxNodes,
+	};
+
+	std::scoped_lock lock(mutex);
+	if (requests.empty()) {
+		g_dispatcher().addEvent([this] { processBatch(); }, __FUNCTION__);
+	}
+	requests.emplace_back(std::move(request));
+}
+
+size_t PathfindingService::GroupHash::operator()(const Group &group) const {
+	size_t hash = 0;
+	stdext::hash_combine(hash, group.walker);
+	stdext::hash_combine(hash, group.targetPos.x);
+	stdext::hash_combine(hash, group.targetPos.y);
+	stdext::hash_combine(hash, group.targetPos.z);
+	stdext::hash_combine(hash, group.flags);
+	stdext::hash_combine(hash, static_cast<uint32_t>(group.maxSearchDist));
+	stdext::hash_combine(hash, static_cast<uint32_t>(group.minTargetDist));
+	stdext::hash_combine(hash, static_cast<uint32_t>(group.maxTargetDist));
+	stdext::hash_combine(hash, static_cast<uint32_t>(group.maxNodes));
+	return hash;
+}
+
+void PathfindingService::solve(Request &request) {
+	if (const auto &creature = request.creature.lock()) {
+		request.found = creature->getPathTo(request.targetPos, request.path, request.fpp);
+	}
+	request.solved = true;
+}
+
+bool PathfindingService::reusePath(Request &request, const Request &leader) {
+	if (!leader.found || leader.path.empty() || request.startPos.z != leader.startPos.z) {
+		return false;
+	}
+
+	// Already in range, its own search is as cheap as it gets
+	if (Position::getDiagonalDistance(request.startPos, request.targetPos) <= request.fpp.maxTargetDist) {
+		return false;
+	}
+
+	const auto &creature = request.creature.lock();
+	if (!creature) {
+		return false;
+	}
+
+	// Joins the leader path on the step closest to the target that is next to it, paths are walked from their back
+	const auto steps = leader.path.size();
+	Position position = leader.startPos;
+	size_t joinIndex = steps;
+	Position joinPos;
+	for (size_t i = 0; i < steps; ++i) {
+		position = getNextPosition(leader.path[steps - 1 - i], position);
+		const auto dx = Position::getDistanceX(position, request.startPos);
+		const auto dy = Position::getDistanceY(position, request.startPos);
+		if (dx <= 1 && dy <= 1 && (dx + dy == 1 || (request.fpp.allowDiagonal && dx + dy == 2))) {
+			joinIndex = i;
+			joinPos = position;
+		}
+	}
+
+	if (joinIndex == steps || !g_game().map.canWalkTo(creature, joinPos)) {
+		return false;
+	}
+
+	request.path.assign(leader.path.begin(), leader.path.begin() + static_cast<std::ptrdiff_t>(steps - 1 - joinIndex));
+	request.path.emplace_back(getDirectionTo(request.startPos, joinPos));
+	request.found = true;
+	request.solved = true;
+	return true;
+}
+
+void PathfindingService::processBatch() {
+	metrics::pathfinding_latency measure("batch");
+	Benchmark bm;
+
+	std::vector<Request> batch;
+	{
+		std::scoped_lock lock(mutex);
+		batch.swap(requests);
+	}
+
+	if (batch.empty()) {
+		return;
+	}
+
+	// The farthest request of each group is solved first, the others may reuse its path
+	phmap::flat_hash_map<Group, size_t, GroupHash> leaders;
+	for (size_t i = 0; i < batch.size(); ++i) {
+		const auto &request = batch[i];
+		const auto [it, inserted] = leaders.try_emplace(request.group, i);
+		if (!inserted) {
+			const auto &leader = batch[it->second];
+			if (Position::getDiagonalDistance(request.startPos, request.targetPos) > Position::getDiagonalDistance(leader.startPos, leader.targetPos)) {
+				it->second = i;
+			}
+		}
+	}
+
+	std::vector<size_t> leaderIndexes;
+	leaderIndexes.reserve(leaders.size());
+	for (const auto &[group, index] : leaders) {
+		leaderIndexes.emplace_back(index);
+	}
+
+	// The dispatcher thread is blocked until both phases are done, nothing changes the map in the meantime
+	g_dispatcher().asyncWait(leaderIndexes.size(), [&batch, &leaderIndexes](size_t i) {
+		solve(batch[leaderIndexes[i]]);
+	});
+
+	std::atomic_size_t reused = 0;
+	g_dispatcher().asyncWait(batch.size(), [&batch, &leaders, &reused](size_t i) {
+		auto &request = batch[i];
+		if (request.solved) {
+			return;
+		}
+
+		if (reusePath(request, batch[leaders.at(request.group)])) {
+			reused.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		solve(request);
+	});
+
+	for (auto &request : batch) {
+		const auto &creature = request.creature.lock();
+		if (!creature || creature->isRemoved()) {
+			continue;
+		}
+
+		// It moved or changed its target while the batch was being solved, the next think will ask again
+		const auto &followCreature = creature->getFollowCreature();
+		if (!followCreature || followCreature != request.target.lock() || creature->getPosition() != request.startPos) {
+			continue;
+		}
+
+		creature->applyFollowPath(request.path, request.found, request.executeOnFollow);
+	}
+
+	const auto duration = bm.duration();
+	g_metrics().addCounter("pathfinding_batches", 1);
+	g_metrics().addCounter("pathfinding_requests", batch.size());
+	g_metrics().addCounter("pathfinding_reused_paths", reused.load());
+	g_logger().trace("[{}] solved {} paths ({} groups, {} reused) in {:.2f} ms", __FUNCTION__, batch.size(), leaderIndexes.size(), reused.load(), duration);
+}
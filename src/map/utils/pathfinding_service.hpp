@@ -0,0 +1,91 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "creatures/creatures_definitions.hpp"
+#include "game/movement/position.hpp"
+
+class Creature;
+
+/**
+ * Batched pathfinding for monsters following a creature.
+ *
+ * Requests are queued during the cycle and solved together by a single dispatcher event: the searches run
+ * in parallel on the thread pool through Dispatcher::asyncWait, while the dispatcher thread is blocked,
+ * so no task can change the map and every search of the batch sees the same walkability snapshot.
+ *
+ * Requests of the same monster type, towards the same position and with the same search parameters
+ * are grouped: the farthest monster of each group is solved first and the others reuse its path
+ * when they are standing next to it, only falling back to their own A* search otherwise.
+ *
+ * The results are applied back on the dispatcher thread, unless the monster moved or changed its target meanwhile.
+ */
+class PathfindingService {
+public:
+	PathfindingService() = default;
+
+	// Ensures that we don't accidentally copy it
+	PathfindingService(const PathfindingService &) = delete;
+	PathfindingService &operator=(const PathfindingService &) = delete;
+
+	static PathfindingService &getInstance();
+
+	static bool isEnabled();
+
+	void addRequest(const std::shared_ptr<Creature> &creature, const std::shared_ptr<Creature> &target, const FindPathParams &fpp, bool executeOnFollow);
+
+	size_t getPendingRequests() const {
+		std::scoped_lock lock(mutex);
+		return requests.size();
+	}
+
+private:
+	// Requests sharing the same group may reuse each other's paths
+	struct Group {
+		// The monster type, or the creature itself when it is not a monster
+		uintptr_t walker = 0;
+		Position targetPos;
+		uint8_t flags = 0;
+		int32_t maxSearchDist = 0;
+		int32_t minTargetDist = 0;
+		int32_t maxTargetDist = 0;
+		int32_t maxNodes = 0;
+
+		bool operator==(const Group &other) const = default;
+	};
+
+	struct GroupHash {
+		size_t operator()(const Group &group) const;
+	};
+
+	struct Request {
+		std::weak_ptr<Creature> creature;
+		std::weak_ptr<Creature> target;
+		Position startPos;
+		Position targetPos;
+		FindPathParams fpp;
+		Group group;
+		bool executeOnFollow = true;
+
+		std::vector<Direction> path;
+		bool found = false;
+		bool solved = false;
+	};
+
+	void processBatch();
+
+	static void solve(Request &request);
+	static bool reusePath(Request &request, const Request &leader);
+
+	mutable std::mutex mutex;
+	std::vector<Request> requests;
+};
+
+constexpr auto g_pathfinding = PathfindingService::getInstance;
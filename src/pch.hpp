@@ -70,6 +70,7 @@
 // --------------------
 
 // ABSL
+#include <absl/container/inlined_vector.h>
 #include <absl/numeric/int128.h>
 
 // ASIO
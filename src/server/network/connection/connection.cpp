@@ -14,11 +14,14 @@
 #include "server/network/message/outputmessage.hpp"
 #include "server/network/protocol/protocol.hpp"
 #include "game/scheduling/dispatcher.hpp"
+#include "lib/metrics/metrics.hpp"
 #include "server/network/message/networkmessage.hpp"
 #include "server/network/protocol/protocolgame.hpp"
 #include "server/server.hpp"
 #include "utils/tools.hpp"
 
+static_assert(CONNECTION_RECEIVE_BUFFER_SIZE >= INPUTMESSAGE_MAXSIZE + HEADER_LENGTH, "A whole packet must fit the receive buffer");
+
 ConnectionManager &ConnectionManager::getInstance() {
 	return inject<ConnectionManager>();
 }
@@ -73,7 +76,7 @@ void Connection::close(bool force) {
 		g_dispatcher().addEvent([protocol = protocol] { protocol->release(); }, __FUNCTION__, std::chrono::milliseconds(CONNECTION_WRITE_TIMEOUT * 1000).count());
 	}
 
-	if (messageQueue.empty() || force) {
+	if ((messageQueue.empty() && writeBatch.empty()) || force) {
 		closeSocket();
 	}
 }
@@ -112,16 +115,18 @@ void Connection::accept(Protocol_ptr protocolPtr) {
 }
 
 void Connection::acceptInternal(bool toggleParseHeader) {
+	if (toggleParseHeader) {
+		std::scoped_lock lock(connectionLock);
+		receive();
+		return;
+	}
+
 	readTimer.expires_from_now(std::chrono::seconds(CONNECTION_READ_TIMEOUT));
 	readTimer.async_wait([self = std::weak_ptr<Connection>(shared_from_this())](const std::error_code &error) { Connection::handleTimeout(self, error); });
 
 	try {
-		asio::async_read(socket, asio::buffer(m_msg.getBuffer(), HEADER_LENGTH), [self = shared_from_this(), toggleParseHeader](const std::error_code &error, std::size_t N) {
-			if (toggleParseHeader) {
-				self->parseHeader(error);
-			} else {
-				self->parseProxyIdentification(error);
-			}
+		asio::async_read(socket, asio::buffer(m_msg.getBuffer(), HEADER_LENGTH), [self = shared_from_this()](const std::error_code &error, std::size_t N) {
+			self->parseProxyIdentification(error);
 		});
 	} catch (const std::system_error &e) {
 		g_logger().error("[Connection::acceptInternal] - Exception in async_read: {}", e.what());
@@ -146,9 +151,12 @@ void Connection::parseProxyIdentification(const std::error_code &error) {
 	std::string serverName = g_configManager().getString(SERVER_NAME) + "\n";
 	if (connectionState == CONNECTION_STATE_IDENTIFYING) {
 		if (msgBuffer[1] == 0x00 || strncasecmp(charData, &serverName[0], 2) != 0) {
-			// Probably not proxy identification so let's try standard parsing method
+			// Probably not proxy identification so let's try standard parsing method, those were the header
 			connectionState = CONNECTION_STATE_OPEN;
-			parseHeader(error);
+			std::copy_n(msgBuffer, HEADER_LENGTH, receiveBuffer.begin());
+			receiveStart = 0;
+			receiveEnd = HEADER_LENGTH;
+			framePackets();
 			return;
 		} else {
 			size_t remainder = serverName.length() - 2;
@@ -183,13 +191,32 @@ void Connection::parseProxyIdentification(const std::error_code &error) {
 	acceptInternal(true);
 }
 
-void Connection::parseHeader(const std::error_code &error) {
+void Connection::receive() {
+	// What is left of a packet goes back to the start, making room for the rest
+	if (receiveStart > 0) {
+		std::copy(receiveBuffer.begin() + receiveStart, receiveBuffer.begin() + receiveEnd, receiveBuffer.begin());
+		receiveEnd -= receiveStart;
+		receiveStart = 0;
+	}
+
+	try {
+		readTimer.expires_from_now(std::chrono::seconds(CONNECTION_READ_TIMEOUT));
+		readTimer.async_wait([self = std::weak_ptr<Connection>(shared_from_this())](const std::error_code &error) { Connection::handleTimeout(self, error); });
+
+		socket.async_read_some(asio::buffer(receiveBuffer.data() + receiveEnd, receiveBuffer.size() - receiveEnd), [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->onReceive(error, N); });
+	} catch (const std::system_error &e) {
+		g_logger().error("[Connection::receive] - error: {}", e.what());
+		close(FORCE_CLOSE);
+	}
+}
+
+void Connection::onReceive(const std::error_code &error, std::size_t bytesReceived) {
 	std::scoped_lock lock(connectionLock);
 	readTimer.cancel();
 
 	if (error) {
 		if (error != asio::error::operation_aborted && error != asio::error::eof && error != asio::error::connection_reset) {
-			g_logger().debug("[Connection::parseHeader] - Read error: {}", error.message());
+			g_logger().debug("[Connection::onReceive] - Read error: {}", error.message());
 		}
 		close(FORCE_CLOSE);
 		return;
@@ -197,55 +224,84 @@ void Connection::parseHeader(const std::error_code &error) {
 		return;
 	}
 
-	uint32_t timePassed = std::max<uint32_t>(1, (time(nullptr) - timeConnected) + 1);
-	if ((++packetsSent / timePassed) > static_cast<uint32_t>(g_configManager().getNumber(MAX_PACKETS_PER_SECOND))) {
-		g_logger().warn("[Connection::parseHeader] - {} disconnected for exceeding packet per second limit.", convertIPToString(getIP()));
-		close();
-		return;
-	}
+	g_metrics().addCounter("network_reads", 1);
+	receiveEnd += bytesReceived;
+	framePackets();
+}
 
-	if (timePassed > 2) {
-		timeConnected = time(nullptr);
-		packetsSent = 0;
-	}
+void Connection::framePackets() {
+	while (receiveEnd - receiveStart >= HEADER_LENGTH) {
+		const auto* data = receiveBuffer.data() + receiveStart;
+		uint16_t size = static_cast<uint16_t>(data[0] | data[1] << 8);
+		if (protocol) {
+			size = (size * 8) + 4;
+		}
 
-	uint16_t size = m_msg.getLengthHeader();
-	if (protocol) {
-		size = (size * 8) + 4;
+		if (size == 0 || size > INPUTMESSAGE_MAXSIZE) {
+			close(FORCE_CLOSE);
+			return;
+		}
+
+		if (receiveEnd - receiveStart < HEADER_LENGTH + size) {
+			break;
+		}
+
+		uint32_t timePassed = std::max<uint32_t>(1, (time(nullptr) - timeConnected) + 1);
+		if ((++packetsSent / timePassed) > static_cast<uint32_t>(g_configManager().getNumber(MAX_PACKETS_PER_SECOND))) {
+			g_logger().warn("[Connection::framePackets] - {} disconnected for exceeding packet per second limit.", convertIPToString(getIP()));
+			close();
+			return;
+		}
+
+		if (timePassed > 2) {
+			timeConnected = time(nullptr);
+			packetsSent = 0;
+		}
+
+		std::copy_n(data, HEADER_LENGTH + size, m_msg.getBuffer());
+		m_msg.setLength(size + HEADER_LENGTH);
+		m_msg.setBufferPosition(HEADER_LENGTH);
+		receiveStart += HEADER_LENGTH + size;
+		g_metrics().addCounter("network_read_packets", 1);
+
+		if (!parsePacket()) {
+			return;
+		}
 	}
 
-	if (size == 0 || size > INPUTMESSAGE_MAXSIZE) {
-		close(FORCE_CLOSE);
+	if (receivedPackets.empty()) {
+		receive();
 		return;
 	}
 
+	// The packets of the read go to the dispatcher as a single task, the receive buffer is its until it calls resumeWork
+	g_metrics().addCounter("network_dispatched_reads", 1);
 	try {
 		readTimer.expires_from_now(std::chrono::seconds(CONNECTION_READ_TIMEOUT));
 		readTimer.async_wait([self = std::weak_ptr<Connection>(shared_from_this())](const std::error_code &error) { Connection::handleTimeout(self, error); });
-
-		// Read packet content
-		m_msg.setLength(size + HEADER_LENGTH);
-		// Read the remainder of proxy identification
-		asio::async_read(socket, asio::buffer(m_msg.getBodyBuffer(), size), [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->parsePacket(error); });
 	} catch (const std::system_error &e) {
-		g_logger().error("[Connection::parseHeader] - error: {}", e.what());
+		g_logger().error("[Connection::framePackets] - error: {}", e.what());
 		close(FORCE_CLOSE);
+		return;
 	}
+	protocol->sendRecvMessageCallback();
 }
 
-void Connection::parsePacket(const std::error_code &error) {
-	std::scoped_lock lock(connectionLock);
-	readTimer.cancel();
+bool Connection::hasBufferedPacket() const {
+	if (receiveEnd - receiveStart < HEADER_LENGTH) {
+		return false;
+	}
 
-	if (error || connectionState == CONNECTION_STATE_CLOSED) {
-		if (error) {
-			g_logger().debug("[Connection::parsePacket] - Read error: {}", error.message());
-		}
-		close(FORCE_CLOSE);
-		return;
+	const auto* data = receiveBuffer.data() + receiveStart;
+	uint16_t size = static_cast<uint16_t>(data[0] | data[1] << 8);
+	if (protocol) {
+		size = (size * 8) + 4;
 	}
+	// Invalid sizes count as a packet, framing closes the connection on them
+	return size == 0 || size > INPUTMESSAGE_MAXSIZE || receiveEnd - receiveStart >= HEADER_LENGTH + size;
+}
 
-	bool skipReadingNextPacket = false;
+bool Connection::parsePacket() {
 	if (!receivedFirst) {
 		// First message received
 		receivedFirst = true;
@@ -270,7 +326,7 @@ void Connection::parsePacket(const std::error_code &error) {
 			protocol = service_port->make_protocol(recvChecksum == checksum, m_msg, shared_from_this());
 			if (!protocol) {
 				close(FORCE_CLOSE);
-				return;
+				return false;
 			}
 		} else {
 			// It is rather hard to detect if we have checksum or sequence method here so let's skip checksum check
@@ -281,33 +337,55 @@ void Connection::parsePacket(const std::error_code &error) {
 		}
 
 		protocol->onRecvFirstMessage(m_msg);
-	} else {
-		// Send the packet to the current protocol
-		skipReadingNextPacket = protocol->onRecvMessage(m_msg);
+	} else if (const auto packetSize = m_msg.getLength(); protocol->onRecvMessage(m_msg)) {
+		// Decrypted back where it was received, for the dispatcher to parse along with the rest of the read
+		const auto offset = receiveStart - packetSize;
+		std::copy_n(m_msg.getBuffer(), packetSize, receiveBuffer.data() + offset);
+		receivedPackets.emplace_back(ReceivedPacket { offset, packetSize, m_msg.getLength(), m_msg.getBufferPosition() });
 	}
 
-	try {
-		readTimer.expires_from_now(std::chrono::seconds(CONNECTION_READ_TIMEOUT));
-		readTimer.async_wait([self = std::weak_ptr<Connection>(shared_from_this())](const std::error_code &error) { Connection::handleTimeout(self, error); });
+	return connectionState != CONNECTION_STATE_CLOSED;
+}
 
-		if (!skipReadingNextPacket) {
-			// Wait to the next packet
-			asio::async_read(socket, asio::buffer(m_msg.getBuffer(), HEADER_LENGTH), [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->parseHeader(error); });
+void Connection::parseReceivedPackets() {
+	for (const auto &packet : receivedPackets) {
+		{
+			std::scoped_lock lock(connectionLock);
+			if (connectionState == CONNECTION_STATE_CLOSED) {
+				break;
+			}
 		}
-	} catch (const std::system_error &e) {
-		g_logger().error("[Connection::parsePacket] - error: {}", e.what());
-		close(FORCE_CLOSE);
+
+		std::copy_n(receiveBuffer.data() + packet.offset, packet.size, m_msg.getBuffer());
+		m_msg.setLength(packet.length);
+		m_msg.setBufferPosition(packet.position);
+		protocol->parsePacket(m_msg);
 	}
+	receivedPackets.clear();
 }
 
 void Connection::resumeWork() {
-	readTimer.expires_from_now(std::chrono::seconds(CONNECTION_READ_TIMEOUT));
-	readTimer.async_wait([self = std::weak_ptr<Connection>(shared_from_this())](const std::error_code &error) { Connection::handleTimeout(self, error); });
+	std::scoped_lock lock(connectionLock);
+	if (connectionState == CONNECTION_STATE_CLOSED) {
+		return;
+	}
 
+	if (!hasBufferedPacket()) {
+		receive();
+		return;
+	}
+
+	// Already received, framed on the I/O thread without reading the socket again
 	try {
-		asio::async_read(socket, asio::buffer(m_msg.getBuffer(), HEADER_LENGTH), [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->parseHeader(error); });
+		asio::post(socket.get_executor(), [self = shared_from_this()] {
+			std::scoped_lock lock(self->connectionLock);
+			if (self->connectionState != CONNECTION_STATE_CLOSED) {
+				self->readTimer.cancel();
+				self->framePackets();
+			}
+		});
 	} catch (const std::system_error &e) {
-		g_logger().error("[Connection::resumeWork] - Exception in async_read: {}", e.what());
+		g_logger().error("[Connection::resumeWork] - Exception in posting packet framing: {}", e.what());
 		close(FORCE_CLOSE);
 	}
 }
@@ -318,7 +396,7 @@ void Connection::send(const OutputMessage_ptr &outputMessage) {
 		return;
 	}
 
-	bool noPendingWrite = messageQueue.empty();
+	bool noPendingWrite = messageQueue.empty() && writeBatch.empty();
 	messageQueue.emplace_back(outputMessage);
 
 	if (noPendingWrite) {
@@ -345,12 +423,24 @@ void Connection::internalWorker() {
 		return;
 	}
 
-	const auto &outputMessage = messageQueue.front();
+	sendQueuedMessages(lock);
+}
+
+void Connection::sendQueuedMessages(std::unique_lock<std::recursive_mutex> &lock) {
+	// Everything queued so far goes out in a single gathered write
+	while (!messageQueue.empty() && writeBatch.size() < CONNECTION_MAX_WRITE_BATCH) {
+		writeBatch.emplace_back(std::move(messageQueue.front()));
+		messageQueue.pop_front();
+	}
+
+	// Compression and encryption run here, on the I/O thread, in the order the messages were queued
 	lock.unlock();
-	protocol->onSendMessage(outputMessage);
+	for (const auto &outputMessage : writeBatch) {
+		protocol->onSendMessage(outputMessage);
+	}
 	lock.lock();
 
-	internalSend(outputMessage);
+	internalSend();
 }
 
 uint32_t Connection::getIP() {
@@ -369,37 +459,43 @@ uint32_t Connection::getIP() {
 	return ip;
 }
 
-void Connection::internalSend(const OutputMessage_ptr &outputMessage) {
+void Connection::internalSend() {
 	writeTimer.expires_from_now(std::chrono::seconds(CONNECTION_WRITE_TIMEOUT));
 	writeTimer.async_wait([self = std::weak_ptr<Connection>(shared_from_this())](const std::error_code &error) { Connection::handleTimeout(self, error); });
 
+	writeBuffers.clear();
+	for (const auto &outputMessage : writeBatch) {
+		writeBuffers.emplace_back(outputMessage->getOutputBuffer(), outputMessage->getLength());
+	}
+
+	g_metrics().addCounter("network_writes", 1);
+	g_metrics().addCounter("network_written_messages", writeBatch.size());
+
 	try {
-		asio::async_write(socket, asio::buffer(outputMessage->getOutputBuffer(), outputMessage->getLength()), [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->onWriteOperation(error); });
+		asio::async_write(socket, writeBuffers, [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->onWriteOperation(error, N); });
 	} catch (const std::system_error &e) {
 		g_logger().error("[Connection::internalSend] - Exception in async_write: {}", e.what());
 		close(FORCE_CLOSE);
 	}
 }
 
-void Connection::onWriteOperation(const std::error_code &error) {
+void Connection::onWriteOperation(const std::error_code &error, std::size_t bytesTransferred) {
 	std::unique_lock lock(connectionLock);
 	writeTimer.cancel();
 
 	if (error) {
 		g_logger().error("[Connection::onWriteOperation] - Write error: {}", error.message());
 		messageQueue.clear();
+		writeBatch.clear();
 		close(FORCE_CLOSE);
 		return;
 	}
 
-	messageQueue.pop_front();
+	g_metrics().addCounter("network_written_bytes", bytesTransferred);
+	writeBatch.clear();
 
 	if (!messageQueue.empty()) {
-		const auto &outputMessage = messageQueue.front();
-		lock.unlock();
-		protocol->onSendMessage(outputMessage);
-		lock.lock();
-		internalSend(outputMessage);
+		sendQueuedMessages(lock);
 	} else if (connectionState == CONNECTION_STATE_CLOSED) {
 		closeSocket();
 	}
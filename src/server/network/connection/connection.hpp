@@ -15,6 +15,10 @@
 
 static constexpr int32_t CONNECTION_WRITE_TIMEOUT = 30;
 static constexpr int32_t CONNECTION_READ_TIMEOUT = 30;
+// Most messages gathered into a single socket write
+static constexpr size_t CONNECTION_MAX_WRITE_BATCH = 64;
+// Bytes taken from the socket by a single read, always room for a whole packet of the largest size
+static constexpr size_t CONNECTION_RECEIVE_BUFFER_SIZE = 8192;
 
 class Protocol;
 using Protocol_ptr = std::shared_ptr<Protocol>;
@@ -64,6 +68,8 @@ public:
 	void accept(Protocol_ptr protocolPtr);
 	void acceptInternal(bool toggleParseHeader = true);
 
+	// Parses the packets framed by the last read, on the dispatcher before it calls resumeWork
+	void parseReceivedPackets();
 	void resumeWork();
 
 	void send(const OutputMessage_ptr &outputMessage);
@@ -72,16 +78,30 @@ public:
 
 private:
 	void parseProxyIdentification(const std::error_code &error);
-	void parseHeader(const std::error_code &error);
-	void parsePacket(const std::error_code &error);
 
-	void onWriteOperation(const std::error_code &error);
+	// Reads whatever the socket has, up to the free room of the receive buffer
+	void receive();
+	void onReceive(const std::error_code &error, std::size_t bytesReceived);
+	/**
+	 * @brief Frames the packets received so far one after another, then reads more once it runs out.
+	 * Those for the dispatcher are handed to it all at once, resumeWork goes on reading once it is done with them.
+	 */
+	void framePackets();
+	bool hasBufferedPacket() const;
+	/**
+	 * @brief Handles the first message, or checks and decrypts a packet for the dispatcher.
+	 * @return false if the connection was closed.
+	 */
+	bool parsePacket();
+
+	void onWriteOperation(const std::error_code &error, std::size_t bytesTransferred);
 
 	static void handleTimeout(ConnectionWeak_ptr connectionWeak, const std::error_code &error);
 
 	void closeSocket();
 	void internalWorker();
-	void internalSend(const OutputMessage_ptr &outputMessage);
+	void sendQueuedMessages(std::unique_lock<std::recursive_mutex> &lock);
+	void internalSend();
 
 	asio::ip::tcp::socket &getSocket() {
 		return socket;
@@ -93,6 +113,9 @@ private:
 	std::recursive_mutex connectionLock;
 
 	std::list<OutputMessage_ptr> messageQueue;
+	// Messages of the write in progress, along with their buffers
+	std::vector<OutputMessage_ptr> writeBatch;
+	std::vector<asio::const_buffer> writeBuffers;
 
 	ConstServicePort_ptr service_port;
 	Protocol_ptr protocol;
@@ -101,6 +124,20 @@ private:
 
 	NetworkMessage m_msg;
 
+	// Received bytes not framed yet, from receiveStart to receiveEnd
+	std::array<uint8_t, CONNECTION_RECEIVE_BUFFER_SIZE> receiveBuffer {};
+	size_t receiveStart = 0;
+	size_t receiveEnd = 0;
+
+	// Decrypted packets of the receive buffer waiting for the dispatcher, along with the state of the message
+	struct ReceivedPacket {
+		size_t offset;
+		NetworkMessage::MsgSize_t size;
+		NetworkMessage::MsgSize_t length;
+		NetworkMessage::MsgSize_t position;
+	};
+	std::vector<ReceivedPacket> receivedPackets;
+
 	std::time_t timeConnected = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
 	uint32_t packetsSent = 0;
 	uint32_t ip = 1;
@@ -12,6 +12,7 @@
 #include "lib/di/container.hpp"
 #include "server/network/protocol/protocol.hpp"
 #include "game/scheduling/dispatcher.hpp"
+#include "lib/metrics/metrics.hpp"
 #include "utils/lockfree.hpp"
 
 constexpr uint16_t OUTPUTMESSAGE_FREE_LIST_CAPACITY = 2048;
@@ -29,6 +30,7 @@ void OutputMessagePool::scheduleSendAll() {
 
 void OutputMessagePool::sendAll() {
 	// dispatcher thread
+	metrics::method_latency measure(__METRICS_METHOD_NAME__);
 	for (const auto &protocol : bufferedProtocols) {
 		auto &msg = protocol->getCurrentBuffer();
 		if (msg) {
@@ -0,0 +1,63 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "server/network/protocol/known_creatures.hpp"
+
+bool KnownCreatures::contains(uint32_t creatureId) const {
+	return slots.contains(creatureId);
+}
+
+bool KnownCreatures::touch(uint32_t creatureId) {
+	const auto it = slots.find(creatureId);
+	if (it == slots.end()) {
+		return false;
+	}
+
+	moveToFront(it->second);
+	return true;
+}
+
+size_t KnownCreatures::size() const {
+	return used;
+}
+
+void KnownCreatures::linkFront(uint16_t slot) {
+	auto &entry = entries[slot];
+	entry.previous = NONE;
+	entry.next = head;
+	if (head != NONE) {
+		entries[head].previous = slot;
+	} else {
+		tail = slot;
+	}
+	head = slot;
+}
+
+void KnownCreatures::unlink(uint16_t slot) {
+	auto &entry = entries[slot];
+	if (entry.previous != NONE) {
+		entries[entry.previous].next = entry.next;
+	} else {
+		head = entry.next;
+	}
+	if (entry.next != NONE) {
+		entries[entry.next].previous = entry.previous;
+	} else {
+		tail = entry.previous;
+	}
+}
+
+void KnownCreatures::moveToFront(uint16_t slot) {
+	if (slot == head) {
+		return;
+	}
+
+	unlink(slot);
+	linkFront(slot);
+}
@@ -0,0 +1,112 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#ifndef USE_PRECOMPILED_HEADERS
+	#include <parallel_hashmap/phmap.h>
+	#include <array>
+	#include <cstdint>
+	#include <limits>
+#endif
+
+/**
+ * The creatures a client has been sent and keeps in its own creature list.
+ *
+ * The client holds at most CAPACITY of them, past that the server picks one to be forgotten. Entries sit in a
+ * fixed array linked from the most to the least recently seen, so that the one to forget is looked for from the
+ * least recently seen end, where it is almost always found among the first few candidates. Only when none of
+ * them can be forgotten is the rest of the table scanned, before giving up and forgetting the oldest.
+ */
+class KnownCreatures {
+public:
+	// As before, one is forgotten as soon as the client would know more than 1300
+	static constexpr size_t CAPACITY = 1300;
+	// Least recently seen creatures checked first, those that can't be forgotten are moved to the front
+	static constexpr size_t EVICTION_CANDIDATES = 16;
+
+	bool contains(uint32_t creatureId) const;
+
+	/**
+	 * @brief Marks a known creature as just seen.
+	 * @return false if the creature is not known.
+	 */
+	bool touch(uint32_t creatureId);
+
+	/**
+	 * @brief Adds a creature not known yet, forgetting another one when full.
+	 * @param canForget Tells whether a known creature can be forgotten, those that can't count as just seen.
+	 * @return The id of the creature forgotten, 0 if none was.
+	 */
+	template <typename CanForget>
+	uint32_t insert(uint32_t creatureId, CanForget &&canForget) {
+		if (used < CAPACITY) {
+			const auto slot = used++;
+			entries[slot].creatureId = creatureId;
+			slots.emplace(creatureId, slot);
+			linkFront(slot);
+			return 0;
+		}
+
+		auto slot = tail;
+		bool forgettable = false;
+		for (size_t candidate = 0; candidate < EVICTION_CANDIDATES; ++candidate) {
+			if (canForget(entries[slot].creatureId)) {
+				forgettable = true;
+				break;
+			}
+			moveToFront(slot);
+			slot = tail;
+		}
+
+		// The rest is scanned before forgetting a creature the client may still be showing
+		auto scan = tail;
+		for (size_t left = used - EVICTION_CANDIDATES; !forgettable && left > 0; --left) {
+			if (canForget(entries[scan].creatureId)) {
+				slot = scan;
+				forgettable = true;
+			}
+			scan = entries[scan].previous;
+		}
+
+		// Bad situation if none could be forgotten, the least recently seen goes anyway
+		if (!forgettable) {
+			slot = tail;
+		}
+
+		const auto removedId = entries[slot].creatureId;
+		slots.erase(removedId);
+		entries[slot].creatureId = creatureId;
+		slots.emplace(creatureId, slot);
+		moveToFront(slot);
+		return removedId;
+	}
+
+	size_t size() const;
+
+private:
+	static constexpr uint16_t NONE = std::numeric_limits<uint16_t>::max();
+
+	struct Entry {
+		uint32_t creatureId = 0;
+		uint16_t previous = NONE;
+		uint16_t next = NONE;
+	};
+
+	void linkFront(uint16_t slot);
+	void unlink(uint16_t slot);
+	void moveToFront(uint16_t slot);
+
+	std::array<Entry, CAPACITY> entries;
+	phmap::flat_hash_map<uint32_t, uint16_t> slots;
+	// Most and least recently seen
+	uint16_t head = NONE;
+	uint16_t tail = NONE;
+	uint16_t used = 0;
+};
@@ -44,25 +44,18 @@ void Protocol::onSendMessage(const OutputMessage_ptr &msg) {
 	}
 }
 
-bool Protocol::sendRecvMessageCallback(NetworkMessage &msg) {
-	if (encryptionEnabled && !XTEA_decrypt(msg)) {
-		g_logger().error("[Protocol::onRecvMessage] - XTEA_decrypt Failed");
-		return false;
-	}
-
+void Protocol::sendRecvMessageCallback() {
 	g_dispatcher().addEvent(
-		[&msg, protocolWeak = std::weak_ptr<Protocol>(shared_from_this())]() {
+		[protocolWeak = std::weak_ptr<Protocol>(shared_from_this())]() {
 			if (const auto &protocol = protocolWeak.lock()) {
 				if (const auto &protocolConnection = protocol->getConnection()) {
-					protocol->parsePacket(msg);
+					protocolConnection->parseReceivedPackets();
 					protocolConnection->resumeWork();
 				}
 			}
 		},
 		__FUNCTION__
 	);
-
-	return true;
 }
 
 bool Protocol::onRecvMessage(NetworkMessage &msg) {
@@ -100,7 +93,12 @@ bool Protocol::onRecvMessage(NetworkMessage &msg) {
 		}
 	}
 
-	return sendRecvMessageCallback(msg);
+	if (encryptionEnabled && !XTEA_decrypt(msg)) {
+		g_logger().error("[Protocol::onRecvMessage] - XTEA_decrypt Failed");
+		return false;
+	}
+
+	return true;
 }
 
 OutputMessage_ptr Protocol::getOutputBuffer(int32_t size) {
@@ -32,8 +32,13 @@ public:
 	virtual void parsePacket(NetworkMessage &) { }
 
 	virtual void onSendMessage(const OutputMessage_ptr &msg);
+	/**
+	 * @brief Checks and decrypts a message read from the client, on the I/O thread.
+	 * @return false if the message is to be dropped.
+	 */
 	bool onRecvMessage(NetworkMessage &msg);
-	bool sendRecvMessageCallback(NetworkMessage &msg);
+	// Parses the messages of the last read on the dispatcher, then lets the connection read on
+	void sendRecvMessageCallback();
 	virtual void onRecvFirstMessage(NetworkMessage &msg) = 0;
 	virtual void sendLoginChallenge() { }
 
@@ -846,22 +846,6 @@ void ProtocolGame::onRecvFirstMessage(NetworkMessage &msg) {
 
 	std::string characterName = msg.getString();
 
-	const auto &onlinePlayer = g_game().getPlayerByName(characterName);
-	const auto &foundPlayer = !onlinePlayer ? g_game().getDeadPlayer(characterName) : onlinePlayer;
-	if (foundPlayer && foundPlayer->client) {
-		if (foundPlayer->isDead()) {
-			disconnectClient("You are already logged in.");
-			return;
-		}
-
-		auto message = fmt::format("You are already connected through another client. Please use only one client at a time!");
-		if (foundPlayer->getProtocolVersion() != getVersion() && foundPlayer->isOldProtocol() != oldProtocol) {
-			message = fmt::format("You are already logged in using protocol '{}'. Please log out from the other session to connect here.", foundPlayer->getProtocolVersion());
-		}
-
-		foundPlayer->client->disconnectClient(message);
-	}
-
 	auto timeStamp = msg.get<uint32_t>();
 	uint8_t randNumber = msg.getByte();
 	if (challengeTimestamp != timeStamp || challengeRandom != randNumber) {
@@ -928,7 +912,29 @@ void ProtocolGame::onRecvFirstMessage(NetworkMessage &msg) {
 		return;
 	}
 
-	g_dispatcher().addEvent([self = getThis(), characterName, accountId, operatingSystem] { self->login(characterName, accountId, operatingSystem); }, __FUNCTION__);
+	// The players are only looked up on the dispatcher, the network threads would race with it adding and removing them
+	g_dispatcher().addEvent(
+		[self = getThis(), characterName, accountId, operatingSystem] {
+			const auto &onlinePlayer = g_game().getPlayerByName(characterName);
+			const auto &foundPlayer = !onlinePlayer ? g_game().getDeadPlayer(characterName) : onlinePlayer;
+			if (foundPlayer && foundPlayer->client) {
+				if (foundPlayer->isDead()) {
+					self->disconnectClient("You are already logged in.");
+					return;
+				}
+
+				auto message = fmt::format("You are already connected through another client. Please use only one client at a time!");
+				if (foundPlayer->getProtocolVersion() != self->getVersion() && foundPlayer->isOldProtocol() != self->oldProtocol) {
+					message = fmt::format("You are already logged in using protocol '{}'. Please log out from the other session to connect here.", foundPlayer->getProtocolVersion());
+				}
+
+				foundPlayer->client->disconnectClient(message);
+			}
+
+			self->login(characterName, accountId, operatingSystem);
+		},
+		__FUNCTION__
+	);
 }
 
 void ProtocolGame::sendLoginChallenge() {
@@ -974,10 +980,99 @@ void ProtocolGame::writeToOutputBuffer(NetworkMessage &msg) {
 		},
 		                        __FUNCTION__);
 	} else {
+		// What was batched so far goes first, e.g. the damage text before the removal of the creature that died from it
+		if (combatBatched) {
+			writeCombatBatch();
+		}
 		getOutputBuffer(msg.getLength())->append(msg);
 	}
 }
 
+ProtocolGame::CombatBatch::CombatBatch() {
+	++combatBatchDepth;
+}
+
+ProtocolGame::CombatBatch::~CombatBatch() {
+	if (--combatBatchDepth != 0) {
+		return;
+	}
+
+	for (const auto &client : combatBatchClients) {
+		client->combatBatched = false;
+		client->writeCombatBatch();
+	}
+	combatBatchClients.clear();
+}
+
+bool ProtocolGame::addToCombatBatch(size_t size) {
+	if (combatBatchDepth == 0 || g_dispatcher().context().isAsync()) {
+		return false;
+	}
+
+	if (!combatBatched) {
+		combatBatched = true;
+		combatBatchClients.emplace_back(getThis());
+	} else if (combatBatchSize + size > MAX_COMBAT_BATCH_SIZE) {
+		writeCombatBatch();
+	}
+	combatBatchSize += size;
+	return true;
+}
+
+void ProtocolGame::writeCombatBatch() {
+	if (combatBatchSize == 0) {
+		return;
+	}
+
+	NetworkMessage msg;
+	for (const auto &creature : batchedHealth) {
+		// Dead or forgotten since it was hit, its removal was already sent
+		if (creature->isRemoved() || creature->isHealthHidden() || !knownCreatures.contains(creature->getID())) {
+			continue;
+		}
+
+		msg.addByte(0x8C);
+		msg.add<uint32_t>(creature->getID());
+		msg.addByte(static_cast<uint8_t>(std::min<double>(100, std::ceil((static_cast<double>(creature->getHealth()) / std::max<int32_t>(creature->getMaxHealth(), 1)) * 100))));
+	}
+
+	// The effects of a position go in one packet, in the order they were sent
+	std::ranges::stable_sort(batchedEffects, [](const auto &lhs, const auto &rhs) {
+		return std::tie(lhs.first.z, lhs.first.y, lhs.first.x) < std::tie(rhs.first.z, rhs.first.y, rhs.first.x);
+	});
+	for (size_t i = 0; i < batchedEffects.size();) {
+		const auto &pos = batchedEffects[i].first;
+		if (oldProtocol) {
+			msg.addByte(0x83);
+			msg.addPosition(pos);
+			msg.addByte(static_cast<uint8_t>(batchedEffects[i++].second));
+			continue;
+		}
+
+		msg.addByte(0x83);
+		msg.addPosition(pos);
+		for (; i < batchedEffects.size() && batchedEffects[i].first == pos; ++i) {
+			msg.addByte(MAGIC_EFFECTS_CREATE_EFFECT);
+			msg.add<uint16_t>(batchedEffects[i].second);
+		}
+		msg.addByte(MAGIC_EFFECTS_END_LOOP);
+	}
+
+	if (!batchedTexts.empty()) {
+		msg.addBytes(reinterpret_cast<const char*>(batchedTexts.data()), batchedTexts.size());
+	}
+
+	batchedHealth.clear();
+	batchedHealthIds.clear();
+	batchedEffects.clear();
+	batchedTexts.clear();
+	combatBatchSize = 0;
+
+	if (msg.getLength() > 0) {
+		writeToOutputBuffer(msg);
+	}
+}
+
 void ProtocolGame::parsePacket(NetworkMessage &msg) {
 	if (!acceptPackets || g_game().getGameState() == GAME_STATE_SHUTDOWN || msg.getLength() <= 0) {
 		return;
@@ -1469,35 +1564,93 @@ void ProtocolGame::parseHotkeyEquip(NetworkMessage &msg) {
 	g_game().playerEquipItem(player->getID(), itemId, hasTier, tier);
 }
 
-void ProtocolGame::GetTileDescription(const std::shared_ptr<Tile> &tile, NetworkMessage &msg) {
-	if (oldProtocol) {
-		msg.add<uint16_t>(0x00); // Env effects
+const TileItemEncoding &ProtocolGame::getTileItemEncoding(Tile &tile) {
+	const auto variant = static_cast<uint8_t>((oldProtocol ? 1 : 0) | (isOTCR ? 2 : 0));
+	if (const auto* encoding = tile.getItemEncoding(); encoding && encoding->variant == variant) {
+		return *encoding;
 	}
 
-	int32_t count;
-	std::shared_ptr<Item> ground = tile->getGround();
-	if (ground) {
-		AddItem(msg, ground);
-		count = 1;
+	static thread_local NetworkMessage itemMessage;
+	static thread_local std::unique_ptr<TileItemEncoding> uncached;
+
+	auto encoding = std::make_unique<TileItemEncoding>();
+	encoding->variant = variant;
+	bool cacheable = true;
+	const auto addItem = [&](const std::shared_ptr<Item> &item) {
+		const ItemType &it = Item::items[item->getID()];
+		// The remaining duration is sent, which changes as time goes by
+		cacheable = cacheable && !it.expire && !it.expireStop && !it.clockExpire;
+
+		itemMessage.reset();
+		AddItem(itemMessage, item);
+		const auto length = itemMessage.getLength();
+		const auto* data = itemMessage.getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION;
+		encoding->bytes.emplace_back(static_cast<uint8_t>(length));
+		encoding->bytes.emplace_back(static_cast<uint8_t>(length >> 8));
+		encoding->bytes.insert(encoding->bytes.end(), data, data + length);
+		++encoding->itemCount;
+	};
+
+	// No more than 10 things of a tile are ever sent
+	if (const auto &ground = tile.getGround()) {
+		addItem(ground);
+	}
+	if (const TileItemVector* items = tile.getItemList()) {
+		for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end && encoding->itemCount < 10; ++it) {
+			addItem(*it);
+		}
+		encoding->topItems = encoding->itemCount;
+		for (auto it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end && encoding->itemCount < encoding->topItems + 10; ++it) {
+			addItem(*it);
+		}
 	} else {
-		count = 0;
+		encoding->topItems = encoding->itemCount;
 	}
 
-	const TileItemVector* items = tile->getItemList();
-	if (items) {
-		for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end; ++it) {
-			AddItem(msg, *it);
+	if (!cacheable) {
+		uncached = std::move(encoding);
+		return *uncached;
+	}
 
-			count++;
-			if (count == 9 && tile->getPosition() == player->getPosition()) {
-				break;
-			} else if (count == 10) {
-				return;
-			}
+	tile.setItemEncoding(std::move(encoding));
+	return *tile.getItemEncoding();
+}
+
+void ProtocolGame::GetTileDescription(Tile &tile, NetworkMessage &msg) {
+	if (oldProtocol) {
+		msg.add<uint16_t>(0x00); // Env effects
+	}
+
+	const auto &encoding = getTileItemEncoding(tile);
+	size_t offset = 0;
+	const auto nextItemLength = [&encoding, &offset] {
+		return static_cast<size_t>(encoding.bytes[offset] | (encoding.bytes[offset + 1] << 8));
+	};
+	const auto addNextItem = [&] {
+		const auto length = nextItemLength();
+		msg.addBytes(reinterpret_cast<const char*>(encoding.bytes.data() + offset + 2), length);
+		offset += length + 2;
+	};
+
+	int32_t count = 0;
+	uint8_t item = 0;
+	// The ground counts as the first top item, it never reaches the limits on its own
+	for (; item < encoding.topItems; ++item) {
+		addNextItem();
+
+		count++;
+		if (count == 9 && tile.getPosition() == player->getPosition()) {
+			++item;
+			break;
+		} else if (count == 10) {
+			return;
 		}
 	}
+	for (; item < encoding.topItems; ++item) {
+		offset += nextItemLength() + 2;
+	}
 
-	const CreatureVector* creatures = tile->getCreatures();
+	const CreatureVector* creatures = tile.getCreatures();
 	if (creatures) {
 		bool playerAdded = false;
 		for (auto creature : std::ranges::reverse_view(*creatures)) {
@@ -1505,7 +1658,7 @@ void ProtocolGame::GetTileDescription(const std::shared_ptr<Tile> &tile, Network
 				continue;
 			}
 
-			if (tile->getPosition() == player->getPosition() && count == 9 && !playerAdded) {
+			if (tile.getPosition() == player->getPosition() && count == 9 && !playerAdded) {
 				creature = player;
 			}
 
@@ -1524,13 +1677,11 @@ void ProtocolGame::GetTileDescription(const std::shared_ptr<Tile> &tile, Network
 		}
 	}
 
-	if (items) {
-		for (auto it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end; ++it) {
-			AddItem(msg, *it);
+	for (; item < encoding.itemCount; ++item) {
+		addNextItem();
 
-			if (++count == 10) {
-				return;
-			}
+		if (++count == 10) {
+			return;
 		}
 	}
 }
@@ -1562,7 +1713,7 @@ void ProtocolGame::GetMapDescription(int32_t x, int32_t y, int32_t z, int32_t wi
 void ProtocolGame::GetFloorDescription(NetworkMessage &msg, int32_t x, int32_t y, int32_t z, int32_t width, int32_t height, int32_t offset, int32_t &skip) {
 	for (int32_t nx = 0; nx < width; nx++) {
 		for (int32_t ny = 0; ny < height; ny++) {
-			const auto &tile = g_game().map.getTile(static_cast<uint16_t>(x + nx + offset), static_cast<uint16_t>(y + ny + offset), static_cast<uint8_t>(z));
+			const auto tile = g_game().map.getTileRaw(static_cast<uint16_t>(x + nx + offset), static_cast<uint16_t>(y + ny + offset), static_cast<uint8_t>(z));
 			if (tile) {
 				if (skip >= 0) {
 					msg.addByte(skip);
@@ -1570,7 +1721,7 @@ void ProtocolGame::GetFloorDescription(NetworkMessage &msg, int32_t x, int32_t y
 				}
 
 				skip = 0;
-				GetTileDescription(tile, msg);
+				GetTileDescription(*tile, msg);
 			} else if (skip == 0xFE) {
 				msg.addByte(0xFF);
 				msg.addByte(0xFF);
@@ -1583,45 +1734,20 @@ void ProtocolGame::GetFloorDescription(NetworkMessage &msg, int32_t x, int32_t y
 }
 
 void ProtocolGame::checkCreatureAsKnown(uint32_t id, bool &known, uint32_t &removedKnown) {
-	if (auto [creatureKnown, creatureInserted] = knownCreatureSet.insert(id);
-	    !creatureInserted) {
+	if (knownCreatures.touch(id)) {
 		known = true;
 		return;
 	}
 	known = false;
-	if (knownCreatureSet.size() > 1300) {
-		// Look for a creature to remove
-		for (auto it = knownCreatureSet.begin(), end = knownCreatureSet.end(); it != end; ++it) {
-			if (*it == id) {
-				continue;
-			}
-			// We need to protect party players from removing
-			const auto &creature = g_game().getCreatureByID(*it);
-			const auto &checkPlayer = creature ? creature->getPlayer() : nullptr;
-			if (checkPlayer) {
-				if (player->getParty() != checkPlayer->getParty() && !canSee(creature)) {
-					removedKnown = *it;
-					knownCreatureSet.erase(it);
-					return;
-				}
-			} else if (!canSee(creature)) {
-				removedKnown = *it;
-				knownCreatureSet.erase(it);
-				return;
-			}
-		}
-
-		// Bad situation. Let's just remove anyone.
-		auto it = knownCreatureSet.begin();
-		if (*it == id) {
-			++it;
+	removedKnown = knownCreatures.insert(id, [this](uint32_t knownId) {
+		// We need to protect party players from removing
+		const auto &creature = g_game().getCreatureByID(knownId);
+		const auto &checkPlayer = creature ? creature->getPlayer() : nullptr;
+		if (checkPlayer && player->getParty() && player->getParty() == checkPlayer->getParty()) {
+			return false;
 		}
-
-		removedKnown = *it;
-		knownCreatureSet.erase(it);
-	} else {
-		removedKnown = 0;
-	}
+		return !canSee(creature);
+	});
 }
 
 bool ProtocolGame::canSee(const std::shared_ptr<Creature> &c) const {
@@ -4769,6 +4895,7 @@ void ProtocolGame::sendTextMessage(const TextMessage &message) {
 	NetworkMessage msg;
 	msg.addByte(0xB4);
 	msg.addByte(internalType);
+	bool combatText = false;
 	switch (internalType) {
 		case MESSAGE_DAMAGE_DEALT:
 		case MESSAGE_DAMAGE_RECEIVED:
@@ -4778,6 +4905,7 @@ void ProtocolGame::sendTextMessage(const TextMessage &message) {
 			msg.addByte(message.primary.color);
 			msg.add<uint32_t>(message.secondary.value);
 			msg.addByte(message.secondary.color);
+			combatText = true;
 			break;
 		}
 		case MESSAGE_HEALED:
@@ -4785,6 +4913,7 @@ void ProtocolGame::sendTextMessage(const TextMessage &message) {
 			msg.addPosition(message.position);
 			msg.add<uint32_t>(message.primary.value);
 			msg.addByte(message.primary.color);
+			combatText = true;
 			break;
 		}
 		case MESSAGE_EXPERIENCE:
@@ -4807,6 +4936,12 @@ void ProtocolGame::sendTextMessage(const TextMessage &message) {
 			break;
 	}
 	msg.addString(message.text);
+
+	if (combatText && addToCombatBatch(msg.getLength())) {
+		const auto* data = msg.getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION;
+		batchedTexts.insert(batchedTexts.end(), data, data + msg.getLength());
+		return;
+	}
 	writeToOutputBuffer(msg);
 }
 
@@ -6736,6 +6871,11 @@ void ProtocolGame::sendMagicEffect(const Position &pos, uint16_t type) {
 		return;
 	}
 
+	if (addToCombatBatch(oldProtocol ? 7 : 10)) {
+		batchedEffects.emplace_back(pos, type);
+		return;
+	}
+
 	NetworkMessage msg;
 	if (oldProtocol) {
 		msg.addByte(0x83);
@@ -6771,6 +6911,16 @@ void ProtocolGame::sendCreatureHealth(const std::shared_ptr<Creature> &creature)
 		return;
 	}
 
+	// The health is read when the batch is written, so one update per creature is enough
+	if (combatBatched && batchedHealthIds.contains(creature->getID())) {
+		return;
+	}
+	if (addToCombatBatch(6)) {
+		batchedHealthIds.emplace(creature->getID());
+		batchedHealth.emplace_back(creature);
+		return;
+	}
+
 	NetworkMessage msg;
 	msg.addByte(0x8C);
 	msg.add<uint32_t>(creature->getID());
@@ -6803,7 +6953,7 @@ void ProtocolGame::sendPartyCreatureUpdate(const std::shared_ptr<Creature> &targ
 
 void ProtocolGame::sendPartyCreatureShield(const std::shared_ptr<Creature> &target) {
 	uint32_t cid = target->getID();
-	if (!knownCreatureSet.contains(cid)) {
+	if (!knownCreatures.contains(cid)) {
 		sendPartyCreatureUpdate(target);
 		return;
 	}
@@ -6821,7 +6971,7 @@ void ProtocolGame::sendPartyCreatureSkull(const std::shared_ptr<Creature> &targe
 	}
 
 	uint32_t cid = target->getID();
-	if (!knownCreatureSet.contains(cid)) {
+	if (!knownCreatures.contains(cid)) {
 		sendPartyCreatureUpdate(target);
 		return;
 	}
@@ -6835,7 +6985,7 @@ void ProtocolGame::sendPartyCreatureSkull(const std::shared_ptr<Creature> &targe
 
 void ProtocolGame::sendPartyCreatureHealth(const std::shared_ptr<Creature> &target, uint8_t healthPercent) {
 	uint32_t cid = target->getID();
-	if (!knownCreatureSet.contains(cid)) {
+	if (!knownCreatures.contains(cid)) {
 		sendPartyCreatureUpdate(target);
 		return;
 	}
@@ -6849,7 +6999,7 @@ void ProtocolGame::sendPartyCreatureHealth(const std::shared_ptr<Creature> &targ
 
 void ProtocolGame::sendPartyPlayerMana(const std::shared_ptr<Player> &target, uint8_t manaPercent) {
 	uint32_t cid = target->getID();
-	if (!knownCreatureSet.contains(cid)) {
+	if (!knownCreatures.contains(cid)) {
 		sendPartyCreatureUpdate(target);
 	}
 
@@ -6867,7 +7017,7 @@ void ProtocolGame::sendPartyPlayerMana(const std::shared_ptr<Player> &target, ui
 
 void ProtocolGame::sendPartyCreatureShowStatus(const std::shared_ptr<Creature> &target, bool showStatus) {
 	uint32_t cid = target->getID();
-	if (!knownCreatureSet.contains(cid)) {
+	if (!knownCreatures.contains(cid)) {
 		sendPartyCreatureUpdate(target);
 	}
 
@@ -6889,7 +7039,7 @@ void ProtocolGame::sendPartyPlayerVocation(const std::shared_ptr<Player> &target
 	}
 
 	uint32_t cid = target->getID();
-	if (!knownCreatureSet.contains(cid)) {
+	if (!knownCreatures.contains(cid)) {
 		sendPartyCreatureUpdate(target);
 		return;
 	}
@@ -6998,7 +7148,7 @@ void ProtocolGame::sendUpdateTile(const std::shared_ptr<Tile> &tile, const Posit
 	msg.addPosition(pos);
 
 	if (tile) {
-		GetTileDescription(tile, msg);
+		GetTileDescription(*tile, msg);
 		msg.addByte(0x00);
 		msg.addByte(0xFF);
 	} else {
@@ -8994,7 +9144,7 @@ void ProtocolGame::reloadCreature(const std::shared_ptr<Creature> &creature) {
 
 	NetworkMessage msg;
 
-	if (knownCreatureSet.contains(creature->getID())) {
+	if (knownCreatures.contains(creature->getID())) {
 		msg.addByte(0x6B);
 		msg.addPosition(creature->getPosition());
 		msg.addByte(static_cast<uint8_t>(stackpos));
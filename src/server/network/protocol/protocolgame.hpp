@@ -10,6 +10,7 @@
 #pragma once
 
 #include "server/network/protocol/protocol.hpp"
+#include "server/network/protocol/known_creatures.hpp"
 #include "game/movement/position.hpp"
 #include "utils/utils_definitions.hpp"
 
@@ -60,6 +61,7 @@ struct MarketOffer;
 struct ShopBlock;
 struct MarketOfferEx;
 struct HistoryMarketOffer;
+struct TileItemEncoding;
 struct LightInfo;
 
 using ProtocolGame_ptr = std::shared_ptr<ProtocolGame>;
@@ -112,6 +114,25 @@ public:
 		return version;
 	}
 
+	/**
+	 * @brief Collects the health updates, magic effects and damage texts sent to the clients while it lives.
+	 *
+	 * Each client gets its share written as one message when the outermost batch ends, with the health
+	 * updates of a creature coalesced into the last one. Any other packet written to a client meanwhile
+	 * writes its share first, so the client sees them in the order they were sent. Only batches on the dispatcher thread.
+	 */
+	class CombatBatch {
+	public:
+		CombatBatch();
+		~CombatBatch();
+
+		CombatBatch(const CombatBatch &) = delete;
+		CombatBatch &operator=(const CombatBatch &) = delete;
+	};
+
+	// Marks the creature as known to the client, known is false if it has to be sent in full
+	void checkCreatureAsKnown(uint32_t id, bool &known, uint32_t &removedKnown);
+
 private:
 	ProtocolGame_ptr getThis() {
 		return std::static_pointer_cast<ProtocolGame>(shared_from_this());
@@ -120,9 +141,12 @@ private:
 	void disconnectClient(const std::string &message) const;
 	void writeToOutputBuffer(NetworkMessage &msg);
 
+	// Joins the open combat batch, false if there is none
+	bool addToCombatBatch(size_t size);
+	void writeCombatBatch();
+
 	void release() override;
 
-	void checkCreatureAsKnown(uint32_t id, bool &known, uint32_t &removedKnown);
 
 	bool canSee(int32_t x, int32_t y, int32_t z) const;
 	bool canSee(const std::shared_ptr<Creature> &) const;
@@ -467,7 +491,9 @@ private:
 
 	// Help functions
 	// translate a tile to clientreadable format
-	void GetTileDescription(const std::shared_ptr<Tile> &tile, NetworkMessage &msg);
+	// The items of the tile as this client reads them, encoded once for every client of the same variant
+	const TileItemEncoding &getTileItemEncoding(Tile &tile);
+	void GetTileDescription(Tile &tile, NetworkMessage &msg);
 
 	// translate a floor to clientreadable format
 	void GetFloorDescription(NetworkMessage &msg, int32_t x, int32_t y, int32_t z, int32_t width, int32_t height, int32_t offset, int32_t &skip);
@@ -535,7 +561,21 @@ private:
 	friend class PlayerVIP;
 	friend class PlayerAttachedEffects;
 
-	std::unordered_set<uint32_t> knownCreatureSet;
+	KnownCreatures knownCreatures;
+
+	// Written early past this size, so that a batch always fits one message
+	static constexpr size_t MAX_COMBAT_BATCH_SIZE = 32768;
+	inline static thread_local uint32_t combatBatchDepth = 0;
+	inline static thread_local std::vector<ProtocolGame_ptr> combatBatchClients;
+
+	std::vector<std::shared_ptr<Creature>> batchedHealth;
+	std::unordered_set<uint32_t> batchedHealthIds;
+	std::vector<std::pair<Position, uint16_t>> batchedEffects;
+	// Encoded text messages
+	std::vector<uint8_t> batchedTexts;
+	size_t combatBatchSize = 0;
+	bool combatBatched = false;
+
 	std::shared_ptr<Player> player = nullptr;
 
 	uint32_t eventConnect = 0;
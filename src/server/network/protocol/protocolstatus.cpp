@@ -20,23 +20,27 @@ std::string ProtocolStatus::SERVER_NAME = "Canary";
 std::string ProtocolStatus::SERVER_VERSION = "3.0";
 std::string ProtocolStatus::SERVER_DEVELOPERS = "OpenTibiaBR Organization";
 
+std::mutex ProtocolStatus::ipConnectMutex;
 std::map<uint32_t, int64_t> ProtocolStatus::ipConnectMap;
 const uint64_t ProtocolStatus::start = OTSYS_TIME(true);
 
 void ProtocolStatus::onRecvFirstMessage(NetworkMessage &msg) {
 	const uint32_t ip = getIP();
-	if (ip != 0x0100007F) {
-		const std::string ipStr = convertIPToString(ip);
-		if (ipStr != g_configManager().getString(IP)) {
-			const auto it = ipConnectMap.find(ip);
-			if (it != ipConnectMap.end() && (OTSYS_TIME() < (it->second + g_configManager().getNumber(STATUSQUERY_TIMEOUT)))) {
-				disconnect();
-				return;
-			}
+	const bool checkTimeout = ip != 0x0100007F && convertIPToString(ip) != g_configManager().getString(IP);
+	bool tooSoon = false;
+	{
+		std::scoped_lock lock(ipConnectMutex);
+		const auto it = ipConnectMap.find(ip);
+		tooSoon = checkTimeout && it != ipConnectMap.end() && (OTSYS_TIME() < (it->second + g_configManager().getNumber(STATUSQUERY_TIMEOUT)));
+		if (!tooSoon) {
+			ipConnectMap[ip] = OTSYS_TIME();
 		}
 	}
 
-	ipConnectMap[ip] = OTSYS_TIME();
+	if (tooSoon) {
+		disconnect();
+		return;
+	}
 
 	switch (msg.getByte()) {
 		// XML info protocol
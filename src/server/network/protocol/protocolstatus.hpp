@@ -37,5 +37,7 @@ public:
 	static std::string SERVER_DEVELOPERS;
 
 private:
+	// First messages are read on every network thread
+	static std::mutex ipConnectMutex;
 	static std::map<uint32_t, int64_t> ipConnectMap;
 };
@@ -13,6 +13,7 @@
 #include "config/configmanager.hpp"
 #include "game/scheduling/dispatcher.hpp"
 #include "creatures/players/management/ban.hpp"
+#include "utils/tools.hpp"
 
 ServiceManager::~ServiceManager() {
 	try {
@@ -27,6 +28,14 @@ void ServiceManager::die() {
 }
 
 void ServiceManager::run() {
+	auto threads = g_configManager().getNumber(NETWORK_IO_THREADS);
+	if (threads <= 0) {
+		threads = std::max<int32_t>(1, getNumberOfCores() / 2);
+	}
+	run(static_cast<size_t>(threads) - 1);
+}
+
+void ServiceManager::run(size_t extraThreads) {
 	if (running) {
 		g_logger().error("ServiceManager is already running!", __FUNCTION__);
 		return;
@@ -34,7 +43,31 @@ void ServiceManager::run() {
 
 	assert(!running);
 	running = true;
+
+	extraThreads = std::min(extraThreads, MAX_IO_THREADS);
+	for (size_t i = 0; i < extraThreads; ++i) {
+		auto &context = *ioContexts.emplace_back(std::make_unique<asio::io_context>(1));
+		ioWork.emplace_back(asio::make_work_guard(context));
+		ioThreads.emplace_back([&context] { context.run(); });
+	}
+	g_logger().info("Network running on {} threads.", extraThreads + 1);
+
 	io_service.run();
+
+	ioWork.clear();
+	for (const auto &context : ioContexts) {
+		context->stop();
+	}
+	for (auto &thread : ioThreads) {
+		thread.join();
+	}
+	ioThreads.clear();
+}
+
+asio::io_context &ServiceManager::nextIoContext() {
+	// The main context takes its turn along with the others
+	const auto index = nextContext++ % (ioContexts.size() + 1);
+	return index == 0 ? io_service : *ioContexts[index - 1];
 }
 
 void ServiceManager::stop() {
@@ -87,7 +120,7 @@ void ServicePort::accept() {
 		return;
 	}
 
-	auto connection = ConnectionManager::getInstance().createConnection(io_service, shared_from_this());
+	auto connection = ConnectionManager::getInstance().createConnection(manager.nextIoContext(), shared_from_this());
 	acceptor->async_accept(connection->getSocket(), [self = shared_from_this(), connection](const std::error_code &error) { self->onAccept(connection, error); });
 }
 
@@ -14,6 +14,7 @@
 #include "server/signals.hpp"
 
 class Protocol;
+class ServiceManager;
 
 class ServiceBase {
 public:
@@ -49,8 +50,8 @@ public:
 
 class ServicePort : public std::enable_shared_from_this<ServicePort> {
 public:
-	explicit ServicePort(asio::io_service &init_io_service) :
-		io_service(init_io_service) { }
+	ServicePort(asio::io_service &init_io_service, ServiceManager &init_manager) :
+		io_service(init_io_service), manager(init_manager) { }
 	~ServicePort();
 
 	// non-copyable
@@ -73,6 +74,7 @@ private:
 	void accept();
 
 	asio::io_service &io_service;
+	ServiceManager &manager;
 	std::unique_ptr<asio::ip::tcp::acceptor> acceptor;
 	std::vector<Service_ptr> services;
 
@@ -80,8 +82,18 @@ private:
 	bool pendingStart = false;
 };
 
+/**
+ * Runs the network on the main thread and on extra I/O threads, each with its own context.
+ *
+ * The acceptors live on the main context, and every accepted connection is handed to the next context in
+ * turn and stays on it. All of a connection's reads, writes and timers then complete on a single thread,
+ * in order, and the events it adds go through that thread's own queue of the dispatcher.
+ */
 class ServiceManager {
 public:
+	// Extra I/O threads at most, the dispatcher keeps an event queue for each of them
+	static constexpr size_t MAX_IO_THREADS = 8;
+
 	ServiceManager() = default;
 	~ServiceManager();
 
@@ -89,7 +101,10 @@ public:
 	ServiceManager(const ServiceManager &) = delete;
 	ServiceManager &operator=(const ServiceManager &) = delete;
 
+	// Runs the network until stopped, on the configured number of threads
 	void run();
+	// Runs the network until stopped, on the main thread and that many extra I/O threads, up to MAX_IO_THREADS
+	void run(size_t extraThreads);
 	void stop();
 
 	template <typename ProtocolType>
@@ -99,12 +114,20 @@ public:
 		return acceptors.empty() == false;
 	}
 
+	asio::io_context &nextIoContext();
+
 private:
 	void die();
 
 	phmap::flat_hash_map<uint16_t, ServicePort_ptr> acceptors;
 
 	asio::io_service io_service;
+	// Those of the extra I/O threads, kept until exit as connections may still refer to them
+	std::vector<std::unique_ptr<asio::io_context>> ioContexts;
+	std::vector<asio::executor_work_guard<asio::io_context::executor_type>> ioWork;
+	std::vector<std::thread> ioThreads;
+	size_t nextContext = 0;
+
 	Signals signals { io_service };
 	asio::high_resolution_timer death_timer { io_service };
 	bool running = false;
@@ -124,7 +147,7 @@ bool ServiceManager::add(uint16_t port) {
 	const auto foundServicePort = acceptors.find(port);
 
 	if (foundServicePort == acceptors.end()) {
-		service_port = std::make_shared<ServicePort>(io_service);
+		service_port = std::make_shared<ServicePort>(io_service, *this);
 		service_port->open(port);
 		acceptors[port] = service_port;
 	} else {
@@ -0,0 +1,95 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "creatures/combat/combat.hpp"
+#include "creatures/players/player.hpp"
+
+class AreaCombatBenchmark : public ::testing::Test {
+protected:
+	const Position center { 100, 100, 7 };
+};
+
+// Old-vs-new target collection of a radius 4 area cast into a hunt of 100 creatures: the old pipeline scanned the
+// area matrix into a new tile vector and copied every tile's creatures once to count the targets and once more
+// to hit them, the new one walks the precomputed offsets into reused buffers and takes each creature once.
+TEST_F(AreaCombatBenchmark, MassAreaCasts) {
+	constexpr size_t casts = 20000;
+	constexpr int32_t gridSize = 16;
+
+	AreaCombat area;
+	area.setupArea(4);
+	const auto &offsets = area.getOffsets(center, center);
+
+	MatrixArea matrix(gridSize, gridSize);
+	for (const auto &offset : offsets) {
+		matrix.setValue(offset.y + gridSize / 2, offset.x + gridSize / 2, true);
+	}
+	matrix.setCenter(gridSize / 2, gridSize / 2);
+
+	std::vector<std::shared_ptr<CreatureVector>> grid(gridSize * gridSize);
+	for (auto &tile : grid) {
+		tile = std::make_shared<CreatureVector>();
+	}
+	for (size_t i = 0; i < 100; ++i) {
+		const auto &offset = offsets[i % offsets.size()];
+		grid[(offset.y + gridSize / 2) * gridSize + offset.x + gridSize / 2]->emplace_back(std::make_shared<Player>());
+	}
+
+	size_t oldHits = 0;
+	Benchmark bmOld;
+	for (size_t cast = 0; cast < casts; ++cast) {
+		std::vector<std::shared_ptr<CreatureVector>> tiles;
+		tiles.reserve(matrix.getRows() * matrix.getCols());
+		for (uint32_t y = 0; y < matrix.getRows(); ++y) {
+			for (uint32_t x = 0; x < matrix.getCols(); ++x) {
+				if (matrix.getValue(y, x)) {
+					tiles.emplace_back(grid[y * gridSize + x]);
+				}
+			}
+		}
+
+		std::vector<std::shared_ptr<Creature>> affected;
+		for (const auto &tile : tiles) {
+			CreatureVector creaturesCopy = *tile;
+			for (const auto &creature : creaturesCopy) {
+				affected.push_back(creature);
+			}
+		}
+		for (const auto &tile : tiles) {
+			CreatureVector creaturesCopy = *tile;
+			for (const auto &creature : creaturesCopy) {
+				oldHits += creature ? 1 : 0;
+			}
+		}
+	}
+	const auto oldDuration = bmOld.duration();
+
+	size_t newHits = 0;
+	std::vector<std::shared_ptr<CreatureVector>> tiles;
+	std::vector<std::shared_ptr<Creature>> targets;
+	std::vector<size_t> targetTiles;
+	Benchmark bmNew;
+	for (size_t cast = 0; cast < casts; ++cast) {
+		for (const auto &offset : offsets) {
+			tiles.emplace_back(grid[(offset.y + gridSize / 2) * gridSize + offset.x + gridSize / 2]);
+		}
+		for (size_t tileIndex = 0; tileIndex < tiles.size(); ++tileIndex) {
+			for (const auto &creature : *tiles[tileIndex]) {
+				targets.push_back(creature);
+				targetTiles.push_back(tileIndex);
+			}
+		}
+		for (const auto &creature : targets) {
+			newHits += creature ? 1 : 0;
+		}
+		tiles.clear();
+		targets.clear();
+		targetTiles.clear();
+	}
+	const auto newDuration = bmNew.duration();
+
+	EXPECT_EQ(casts * 100, oldHits);
+	EXPECT_EQ(oldHits, newHits);
+	fmt::print("[ BENCHMARK] {} area casts on 100 creatures: matrix and copies {:.2f}ms, offsets and scratch {:.2f}ms\n", casts, oldDuration, newDuration);
+}
@@ -0,0 +1,93 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "creatures/combat/condition_scheduler.hpp"
+#include "creatures/creature.hpp"
+
+class ConditionSchedulerBenchmark : public ::testing::Test {
+protected:
+	ConditionScheduler scheduler;
+};
+
+// Old-vs-new condition ticks of 10k monsters carrying poison, fire and energy for a minute of checks: the old
+// loop executed every condition of a tenth of the monsters on each check, the new one only the conditions
+// due of the monsters the scheduler hands out.
+TEST_F(ConditionSchedulerBenchmark, PeriodicDamageConditions) {
+	constexpr uint32_t monsters = 10000;
+	constexpr int64_t duration = 60'000;
+	constexpr std::array<int32_t, 3> intervals { 4000, 9000, 10000 };
+
+	// Counts its time down as ConditionDamage does, reading the clock for the end time on every execution
+	class PeriodicDamage {
+	public:
+		explicit PeriodicDamage(int32_t initInterval) :
+			interval(initInterval), timeLeft(initInterval) { }
+		virtual ~PeriodicDamage() = default;
+
+		virtual bool execute(int32_t elapsed, size_t &hits) {
+			timeLeft -= elapsed;
+			if (timeLeft <= 0) {
+				timeLeft = interval;
+				++hits;
+			}
+			return std::chrono::steady_clock::now().time_since_epoch().count() != 0;
+		}
+
+		int32_t interval;
+		int32_t timeLeft;
+		int64_t lastTickTime = 0;
+	};
+
+	std::vector<std::list<std::shared_ptr<PeriodicDamage>>> conditions(monsters);
+	const auto reset = [&] {
+		for (auto &list : conditions) {
+			list.clear();
+			for (const auto interval : intervals) {
+				list.emplace_back(std::make_shared<PeriodicDamage>(interval));
+			}
+		}
+	};
+
+	reset();
+	size_t oldHits = 0;
+	Benchmark bmOld;
+	for (int64_t now = EVENT_CHECK_CREATURE_INTERVAL; now <= duration; now += EVENT_CHECK_CREATURE_INTERVAL) {
+		const auto index = static_cast<uint32_t>(now / EVENT_CHECK_CREATURE_INTERVAL % EVENT_CREATURECOUNT);
+		for (uint32_t monster = index; monster < monsters; monster += EVENT_CREATURECOUNT) {
+			for (const auto &condition : conditions[monster]) {
+				condition->execute(EVENT_CREATURE_THINK_INTERVAL, oldHits);
+			}
+		}
+	}
+	const auto oldDuration = bmOld.duration();
+
+	reset();
+	for (uint32_t monster = 0; monster < monsters; ++monster) {
+		scheduler.schedule(monster, intervals[0]);
+	}
+
+	size_t newHits = 0;
+	std::vector<uint32_t> due;
+	Benchmark bmNew;
+	for (int64_t now = EVENT_CHECK_CREATURE_INTERVAL; now <= duration; now += EVENT_CHECK_CREATURE_INTERVAL) {
+		due.clear();
+		scheduler.takeDue(now, due);
+		for (const auto monster : due) {
+			auto nextTick = std::numeric_limits<int64_t>::max();
+			for (const auto &condition : conditions[monster]) {
+				if (condition->lastTickTime + condition->timeLeft <= now) {
+					condition->execute(static_cast<int32_t>(now - condition->lastTickTime), newHits);
+					condition->lastTickTime = now;
+				}
+				nextTick = std::min(nextTick, condition->lastTickTime + condition->timeLeft);
+			}
+			scheduler.schedule(monster, nextTick);
+		}
+	}
+	const auto newDuration = bmNew.duration();
+
+	EXPECT_EQ(monsters * (15 + 6 + 6), oldHits);
+	EXPECT_EQ(oldHits, newHits);
+	fmt::print("[ BENCHMARK] {} monsters with 3 conditions for {}s: every think {:.2f}ms, when due {:.2f}ms\n", monsters, duration / 1000, oldDuration, newDuration);
+}
@@ -0,0 +1,116 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "test_database.hpp"
+#include "test_env.hpp"
+
+namespace {
+	constexpr uint32_t ACCOUNT_ID = 600000100;
+	constexpr uint32_t PLAYER_ID = 600000101;
+	constexpr uint32_t ITEM_ROWS = 2000;
+
+	bool createPlayer(Database &db) {
+		const auto accountInserted = db.executeQuery(
+			fmt::format("INSERT INTO `accounts` (`id`,`name`,`password`) VALUES ({}, 'stmt', '')", ACCOUNT_ID)
+		);
+		const auto playerInserted = db.executeQuery(fmt::format(
+			"INSERT INTO `players` (`id`,`name`,`account_id`,`conditions`) VALUES ({}, 'stmt player', {}, '')",
+			PLAYER_ID,
+			ACCOUNT_ID
+		));
+		return accountInserted && playerInserted;
+	}
+
+	// Attributes with bytes that need escaping in text queries, of growing length
+	std::string attributes(uint32_t sid) {
+		std::string bytes(sid % 64, '\0');
+		for (size_t i = 0; i < bytes.size(); ++i) {
+			bytes[i] = static_cast<char>((sid + i) * 31);
+		}
+		return bytes;
+	}
+
+	bool insertItems(Database &db) {
+		DBInsert insert("INSERT INTO `player_items` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
+		for (uint32_t sid = 101; sid < 101 + ITEM_ROWS; ++sid) {
+			const auto bytes = attributes(sid);
+			if (!insert.addRow(fmt::format("{},{},{},{},{},{}", PLAYER_ID, sid % 10, sid, 2854 + sid % 100, sid % 100, db.escapeBlob(bytes.data(), static_cast<uint32_t>(bytes.size()))))) {
+				return false;
+			}
+		}
+		return insert.execute();
+	}
+}
+
+// Needs the database of the integration tests, it is skipped when there is none to connect to
+class DatabaseStatementBenchmark : public ::testing::Test {
+protected:
+	static void SetUpTestSuite() {
+		try {
+			TestDatabase::init();
+			connected = g_database().storeQuery("SELECT 1") != nullptr;
+		} catch (const std::exception &e) {
+			fmt::print("[ BENCHMARK] no test database: {}\n", e.what());
+		}
+	}
+
+	void SetUp() override {
+		if (!connected) {
+			GTEST_SKIP() << "No test database to connect to";
+		}
+	}
+
+	static inline bool connected = false;
+};
+
+// Rows per second of the player item load, by name through text results and by index through prepared statements.
+TEST_F(DatabaseStatementBenchmark, ItemLoad) {
+	auto &db = g_database();
+	databaseTest(db, [&db] {
+		ASSERT_TRUE(createPlayer(db));
+		ASSERT_TRUE(insertItems(db));
+
+		constexpr size_t rounds = 20;
+		const auto readItems = [](const DBResult_ptr &result, bool byIndex) {
+			uint64_t checksum = 0;
+			const auto sid = result->getColumnIndex("sid");
+			const auto itemtype = result->getColumnIndex("itemtype");
+			const auto attributes = result->getColumnIndex("attributes");
+			do {
+				unsigned long size;
+				if (byIndex) {
+					checksum += result->getNumber<uint32_t>(sid) + result->getNumber<uint16_t>(itemtype);
+					result->getStream(attributes, size);
+				} else {
+					checksum += result->getNumber<uint32_t>("sid") + result->getNumber<uint16_t>("itemtype");
+					result->getStream("attributes", size);
+				}
+				checksum += size;
+			} while (result->next());
+			return checksum;
+		};
+
+		uint64_t textChecksum = 0;
+		Benchmark bm;
+		for (size_t round = 0; round < rounds; ++round) {
+			const auto result = db.storeQuery(fmt::format("SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_items` WHERE `player_id` = {} ORDER BY `sid` DESC", PLAYER_ID));
+			ASSERT_NE(nullptr, result);
+			textChecksum += readItems(result, false);
+		}
+		const auto textDuration = bm.duration();
+
+		uint64_t binaryChecksum = 0;
+		bm.start();
+		for (size_t round = 0; round < rounds; ++round) {
+			const auto result = db.storeQuery("SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_items` WHERE `player_id` = ? ORDER BY `sid` DESC", { PLAYER_ID });
+			ASSERT_NE(nullptr, result);
+			binaryChecksum += readItems(result, true);
+		}
+		const auto binaryDuration = bm.duration();
+
+		EXPECT_EQ(textChecksum, binaryChecksum);
+		const auto rows = static_cast<double>(ITEM_ROWS * rounds);
+		fmt::print("[ BENCHMARK] {} item rows: text {:.3f} ms ({:.0f} rows/s), prepared {:.3f} ms ({:.0f} rows/s)\n", ITEM_ROWS * rounds, textDuration, rows * 1000 / textDuration, binaryDuration, rows * 1000 / binaryDuration);
+	})();
+}
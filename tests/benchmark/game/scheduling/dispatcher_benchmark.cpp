@@ -0,0 +1,57 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "game/scheduling/dispatcher.hpp"
+#include "lib/logging/in_memory_logger.hpp"
+#include "lib/thread/thread_pool.hpp"
+#include "utils/tools.hpp"
+
+class DispatcherBenchmark : public ::testing::Test {
+protected:
+	// One dispatcher cycle of the GenericParallel group, as the dispatcher loop runs it.
+	static void runParallelGroup(Dispatcher &dispatcher) {
+		dispatcher.mergeAsyncEvents();
+		dispatcher.executeParallelEvents(static_cast<uint8_t>(TaskGroup::GenericParallel));
+	}
+
+	InMemoryLogger logger;
+	ThreadPool threadPool { logger, 4 };
+};
+
+// Parallel tasks per second with the static partitions of the merge model and with the work-stealing deques.
+TEST_F(DispatcherBenchmark, WorkStealingAgainstMerge) {
+	constexpr size_t cycles = 200;
+	constexpr size_t tasksPerCycle = 2000;
+
+	const auto run = [this](bool workStealing) {
+		Dispatcher dispatcher(threadPool);
+		dispatcher.setWorkStealing(workStealing);
+
+		std::atomic_size_t executed = 0;
+		Benchmark bm;
+		for (size_t cycle = 0; cycle < cycles; ++cycle) {
+			for (size_t i = 0; i < tasksPerCycle; ++i) {
+				// The heavy tasks come first, as when a crowded area is handled at the start of the cycle
+				const size_t rounds = i < tasksPerCycle / 8 ? 4000 : 200;
+				dispatcher.asyncEvent([rounds, &executed] {
+					volatile uint64_t hash = 14695981039346656037ull;
+					for (size_t j = 0; j < rounds; ++j) {
+						hash = (hash ^ j) * 1099511628211ull;
+					}
+					executed.fetch_add(1, std::memory_order_relaxed);
+				});
+			}
+			runParallelGroup(dispatcher);
+		}
+		const auto duration = bm.duration();
+
+		EXPECT_EQ(cycles * tasksPerCycle, executed.load());
+		return executed.load() / (duration / 1000);
+	};
+
+	const auto mergeRate = run(false);
+	const auto stealingRate = run(true);
+
+	fmt::print("[ BENCHMARK] {} tasks on {} threads: merge {:.0f} tasks/s, work-stealing {:.0f} tasks/s\n", cycles * tasksPerCycle, threadPool.get_thread_count(), mergeRate, stealingRate);
+}
@@ -0,0 +1,93 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "game/scheduling/timer_wheel.hpp"
+#include "utils/tools.hpp"
+
+namespace {
+	std::shared_ptr<Task> makeTask(uint32_t delay) {
+		return Task::create([] { }, "TimerWheelBenchmark", delay);
+	}
+
+	std::vector<std::shared_ptr<Task>> drain(TimerWheel &wheel, int64_t now) {
+		std::vector<std::shared_ptr<Task>> fired;
+		wheel.advance(now);
+		while (auto task = wheel.popReady(now)) {
+			fired.emplace_back(std::move(task));
+		}
+		return fired;
+	}
+}
+
+class TimerWheelBenchmark : public ::testing::Test {
+protected:
+	void SetUp() override {
+		now = OTSYS_TIME();
+		wheel.advance(now);
+	}
+
+	TimerWheel wheel;
+	int64_t now = 0;
+};
+
+// Schedule/cancel/fire throughput against the btree scheduler the dispatcher used before the wheel.
+TEST_F(TimerWheelBenchmark, AgainstBtree) {
+	constexpr size_t amount = 100000;
+	constexpr int64_t horizon = 60 * 1000;
+
+	std::mt19937 rng(42);
+	std::uniform_int_distribution<uint32_t> delays(0, horizon);
+	std::vector<std::shared_ptr<Task>> tasks;
+	tasks.reserve(amount);
+	for (size_t i = 0; i < amount; ++i) {
+		tasks.emplace_back(makeTask(delays(rng)));
+	}
+
+	const auto run = [&](auto &&schedule, auto &&fire) {
+		Benchmark bm;
+		for (const auto &task : tasks) {
+			schedule(task);
+		}
+		// Creature think/decay events are usually replaced before firing
+		for (size_t i = 0; i < amount; i += 3) {
+			tasks[i]->cancel();
+		}
+		size_t fired = 0;
+		for (int64_t time = now; time <= now + horizon; time += TimerWheel::TICK_MS) {
+			fired += fire(time);
+		}
+		const auto duration = bm.duration();
+		for (size_t i = 0; i < amount; i += 3) {
+			tasks[i] = makeTask(static_cast<uint32_t>(tasks[i]->getTime() - now));
+		}
+		return std::make_pair(fired, duration);
+	};
+
+	const auto [wheelFired, wheelDuration] = run(
+		[this](const auto &task) { wheel.insert(task); },
+		[this](int64_t time) { return drain(wheel, time).size(); }
+	);
+
+	struct Compare {
+		bool operator()(const std::shared_ptr<Task> &a, const std::shared_ptr<Task> &b) const {
+			return a->getTime() < b->getTime();
+		}
+	};
+	phmap::btree_multiset<std::shared_ptr<Task>, Compare> btree;
+	const auto [btreeFired, btreeDuration] = run(
+		[&btree](const auto &task) { btree.emplace(task); },
+		[&btree](int64_t time) {
+			size_t fired = 0;
+			auto it = btree.begin();
+			for (; it != btree.end() && (*it)->getTime() <= time; ++it) {
+				fired += (*it)->isCanceled() ? 0 : 1;
+			}
+			btree.erase(btree.begin(), it);
+			return fired;
+		}
+	);
+
+	EXPECT_EQ(btreeFired, wheelFired);
+	std::cout << fmt::format("[ BENCHMARK] {} tasks: timer wheel {:.3f} ms, btree {:.3f} ms", amount, wheelDuration, btreeDuration) << std::endl;
+}
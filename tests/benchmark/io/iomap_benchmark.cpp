@@ -0,0 +1,221 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "io/filestream.hpp"
+#include "io/io_definitions.hpp"
+#include "io/iomap.hpp"
+#include "io/iomapsnapshot.hpp"
+#include "items/item.hpp"
+#include "map/map.hpp"
+
+// Writes an OTBM file of square tile areas, each tile with a ground and a few items
+class IOMapBenchmark : public ::testing::Test {
+protected:
+	static constexpr uint16_t FIRST_GROUND = 100;
+	static constexpr uint16_t GROUNDS = 8;
+	static constexpr uint16_t FIRST_ITEM = 200;
+	static constexpr uint16_t ITEMS = 40;
+	static constexpr uint8_t Z = 7;
+
+	static void SetUpTestSuite() {
+		auto &itemTypes = Item::items.getItems();
+		if (itemTypes.size() < FIRST_ITEM + ITEMS) {
+			itemTypes.resize(FIRST_ITEM + ITEMS);
+		}
+		for (uint16_t id = FIRST_GROUND; id < FIRST_GROUND + GROUNDS; ++id) {
+			itemTypes[id].id = id;
+			itemTypes[id].group = ITEM_GROUP_GROUND;
+		}
+		for (uint16_t id = FIRST_ITEM; id < FIRST_ITEM + ITEMS; ++id) {
+			itemTypes[id].id = id;
+		}
+	}
+
+	class Writer {
+	public:
+		void u8(uint8_t value) {
+			if (value == OTB::Node::ESCAPE || value == OTB::Node::START || value == OTB::Node::END) {
+				bytes.emplace_back(OTB::Node::ESCAPE);
+			}
+			bytes.emplace_back(value);
+		}
+		void u16(uint16_t value) {
+			u8(value & 0xFF);
+			u8(value >> 8);
+		}
+		void u32(uint32_t value) {
+			u16(value & 0xFFFF);
+			u16(value >> 16);
+		}
+		void start(uint8_t type) {
+			bytes.emplace_back(OTB::Node::START);
+			u8(type);
+		}
+		void end() {
+			bytes.emplace_back(OTB::Node::END);
+		}
+
+		std::vector<uint8_t> bytes { 'O', 'T', 'B', 'M' };
+	};
+
+	// Which items a tile has, the same at the same place of every area for the tiles to be shared
+	static std::pair<uint16_t, std::vector<uint16_t>> tileOf(uint16_t x, uint16_t y) {
+		x &= SECTOR_MASK;
+		y &= SECTOR_MASK;
+		const uint16_t ground = FIRST_GROUND + (x * 7 + y) % GROUNDS;
+		std::vector<uint16_t> items;
+		for (uint16_t i = 0; i < (x + y) % 3; ++i) {
+			items.emplace_back(FIRST_ITEM + (x * 13 + y * 5 + i) % ITEMS);
+		}
+		return { ground, items };
+	}
+
+	static std::string writeMap(uint16_t areasPerSide) {
+		Writer writer;
+		writer.start(0);
+		writer.u32(2);
+		writer.u16(areasPerSide * 256);
+		writer.u16(areasPerSide * 256);
+		writer.u32(3);
+		writer.u32(0);
+
+		writer.start(OTBM_MAP_DATA);
+		for (uint16_t areaX = 0; areaX < areasPerSide; ++areaX) {
+			for (uint16_t areaY = 0; areaY < areasPerSide; ++areaY) {
+				writer.start(OTBM_TILE_AREA);
+				writer.u16(areaX * 256);
+				writer.u16(areaY * 256);
+				writer.u8(Z);
+				for (uint16_t x = 0; x < 16; ++x) {
+					for (uint16_t y = 0; y < 16; ++y) {
+						const auto &[ground, items] = tileOf(areaX * 256 + x, areaY * 256 + y);
+						writer.start(OTBM_TILE);
+						writer.u8(x);
+						writer.u8(y);
+						writer.u8(OTBM_ATTR_ITEM);
+						writer.u16(ground);
+						for (const auto item : items) {
+							writer.start(OTBM_ITEM);
+							writer.u16(item);
+							writer.u8(OTBM_ATTR_COUNT);
+							writer.u8(1);
+							writer.end();
+						}
+						writer.end();
+					}
+				}
+				writer.end();
+			}
+		}
+		writer.end();
+
+		writer.start(OTBM_TOWNS);
+		writer.end();
+		writer.start(OTBM_WAYPOINTS);
+		writer.end();
+		writer.end();
+
+		const auto path = (std::filesystem::temp_directory_path() / fmt::format("iomap_benchmark_{}.otbm", areasPerSide)).string();
+		std::ofstream file(path, std::ios::binary);
+		file.write(reinterpret_cast<const char*>(writer.bytes.data()), static_cast<std::streamsize>(writer.bytes.size()));
+		return path;
+	}
+
+	static std::shared_ptr<BasicTile> cachedTile(const Map &map, uint16_t x, uint16_t y) {
+		const auto sector = map.getMapSector(x, y);
+		if (!sector || !sector->getFloor(Z)) {
+			return nullptr;
+		}
+		return sector->getFloor(Z)->getTileCache(x, y);
+	}
+};
+
+// Old-vs-new reading of a map shaped like the global one: the old parser went through the tile areas one after
+// another, allocating every item and tile before looking them up in the cache, the new one finds the areas first
+// and decodes them on the thread pool, each thread only allocating the items and tiles its cache is missing.
+TEST_F(IOMapBenchmark, ReadingTileAreas) {
+	constexpr uint16_t areasPerSide = 48;
+	const auto path = writeMap(areasPerSide);
+
+	size_t oldTiles = 0;
+	Benchmark bmOld;
+	{
+		const auto fileByte = mio::mmap_source(path);
+		FileStream stream { fileByte.begin() + 4, fileByte.end() };
+		stream.startNode();
+		stream.skip(1 + 4 + 2 + 2 + 4 + 4);
+		stream.startNode(OTBM_MAP_DATA);
+
+		BasicCache cache;
+		while (stream.startNode(OTBM_TILE_AREA)) {
+			stream.getU16();
+			stream.getU16();
+			stream.getU8();
+			while (stream.startNode()) {
+				stream.getU8();
+				const auto tile = std::make_shared<BasicTile>();
+				const uint16_t x = stream.getU8();
+				const uint16_t y = stream.getU8();
+				if (stream.isProp(OTBM_ATTR_ITEM)) {
+					const auto item = std::make_shared<BasicItem>();
+					item->id = stream.getU16();
+					tile->ground = cache.share(item);
+				}
+				while (stream.startNode()) {
+					stream.getU8();
+					const auto item = std::make_shared<BasicItem>();
+					item->id = stream.getU16();
+					item->unserializeItemNode(stream, x, y, Z, cache);
+					tile->items.emplace_back(cache.share(item));
+					stream.endNode();
+				}
+				stream.endNode();
+				cache.share(tile, tile->hash());
+				++oldTiles;
+			}
+			stream.endNode();
+		}
+	}
+	const auto oldDuration = bmOld.duration();
+
+	const auto map = std::make_unique<Map>();
+	Benchmark bmNew;
+	map->load(path);
+	const auto newDuration = bmNew.duration();
+
+	EXPECT_EQ(size_t { areasPerSide } * areasPerSide * 256, oldTiles);
+	EXPECT_NE(nullptr, cachedTile(*map, (areasPerSide - 1) * 256 + 15, (areasPerSide - 1) * 256 + 15));
+	fmt::print("[ BENCHMARK] {} tile areas of 256 tiles: one after another {:.2f}ms, decoded on the thread pool {:.2f}ms\n", size_t { areasPerSide } * areasPerSide, oldDuration, newDuration);
+
+	std::filesystem::remove(path);
+}
+
+// Old-vs-new startup of a map shaped like the global one: reading the map file, as every startup did, against
+// loading the snapshot compiled from it, which only builds each distinct item and tile once and places them.
+TEST_F(IOMapBenchmark, LoadingTheSnapshot) {
+	constexpr uint16_t areasPerSide = 48;
+	const auto path = writeMap(areasPerSide);
+	const auto snapshotPath = IOMapSnapshot::getPath(path);
+	std::filesystem::remove(snapshotPath);
+	std::make_unique<Map>()->load(path, Position(), true);
+	ASSERT_TRUE(std::filesystem::exists(snapshotPath));
+
+	const auto read = std::make_unique<Map>();
+	Benchmark bmOld;
+	read->load(path);
+	const auto oldDuration = bmOld.duration();
+
+	const auto loaded = std::make_unique<Map>();
+	Benchmark bmNew;
+	loaded->load(path, Position(), true);
+	const auto newDuration = bmNew.duration();
+
+	const auto last = (areasPerSide - 1) * 256 + 15;
+	ASSERT_NE(nullptr, cachedTile(*loaded, last, last));
+	EXPECT_EQ(cachedTile(*read, last, last)->hash(), cachedTile(*loaded, last, last)->hash());
+	fmt::print("[ BENCHMARK] {} tiles: map file {:.2f}ms ({} KiB), snapshot {:.2f}ms ({} KiB)\n", size_t { areasPerSide } * areasPerSide * 256, oldDuration, std::filesystem::file_size(path) / 1024, newDuration, std::filesystem::file_size(snapshotPath) / 1024);
+
+	std::filesystem::remove(snapshotPath);
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,114 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "kv/kv.hpp"
+#include "lib/logging/in_memory_logger.hpp"
+
+// A store with nothing in it, counting what reaches the backend
+class BackedKV final : public KVStore {
+public:
+	explicit BackedKV(Logger &logger) :
+		KVStore(logger) { }
+
+	size_t loads = 0;
+
+protected:
+	std::vector<std::string> loadPrefix(const std::string &) override {
+		return {};
+	}
+
+	std::vector<std::pair<std::string, ValueWrapper>> loadPrefixValues(const std::string &) override {
+		return {};
+	}
+
+	std::optional<ValueWrapper> load(const std::string &) override {
+		++loads;
+		return std::nullopt;
+	}
+
+	bool save(const std::string &, const ValueWrapper &) override {
+		return true;
+	}
+};
+
+// Keeps nothing of the traces, which the threads would write at once
+class QuietLogger final : public InMemoryLogger {
+public:
+	void debug(const std::string &) const override { }
+	void trace(const std::string &) const override { }
+};
+
+class KVStoreBenchmark : public ::testing::Test {
+protected:
+	QuietLogger logger;
+	BackedKV kv { logger };
+};
+
+// Old-vs-new cache hits of scripts running on 8 threads, each in its own scope: the old cache took one lock and
+// moved a node of a std::list for every access, the new one locks the key's shard and relinks the entry in place.
+TEST_F(KVStoreBenchmark, ConcurrentScopedAccess) {
+	constexpr size_t threads = 8;
+	constexpr size_t accesses = 100000;
+	constexpr size_t keysPerScope = 64;
+
+	const auto keyOf = [](size_t thread, size_t access) {
+		return fmt::format("player.{}.storage-{}", thread, access % keysPerScope);
+	};
+
+	struct OldStore {
+		std::mutex mutex;
+		phmap::flat_hash_map<std::string, std::pair<ValueWrapper, std::list<std::string>::iterator>> store;
+		std::list<std::string> lruQueue;
+	} old;
+
+	const auto run = [&](auto &&access) {
+		std::vector<std::thread> workers;
+		for (size_t thread = 0; thread < threads; ++thread) {
+			workers.emplace_back([&, thread] {
+				for (size_t i = 0; i < accesses; ++i) {
+					access(keyOf(thread, i), static_cast<int>(i));
+				}
+			});
+		}
+		for (auto &worker : workers) {
+			worker.join();
+		}
+	};
+
+	std::atomic<size_t> oldHits = 0;
+	Benchmark bmOld;
+	run([&](const std::string &key, int i) {
+		std::scoped_lock lock(old.mutex);
+		const auto it = old.store.find(key);
+		if (i % 4 == 0 || it == old.store.end()) {
+			if (it != old.store.end()) {
+				it->second.first = i;
+				old.lruQueue.splice(old.lruQueue.begin(), old.lruQueue, it->second.second);
+			} else {
+				old.lruQueue.push_front(key);
+				old.store.try_emplace(key, std::make_pair(ValueWrapper(i), old.lruQueue.begin()));
+			}
+			return;
+		}
+		old.lruQueue.splice(old.lruQueue.begin(), old.lruQueue, it->second.second);
+		const std::optional<ValueWrapper> value = it->second.first;
+		oldHits += value.has_value() ? 1 : 0;
+	});
+	const auto oldDuration = bmOld.duration();
+
+	std::atomic<size_t> newHits = 0;
+	Benchmark bmNew;
+	run([&](const std::string &key, int i) {
+		if (i % 4 == 0 || i < static_cast<int>(keysPerScope)) {
+			kv.set(key, i);
+			return;
+		}
+		newHits += kv.get(key).has_value() ? 1 : 0;
+	});
+	const auto newDuration = bmNew.duration();
+
+	EXPECT_EQ(oldHits.load(), newHits.load());
+	EXPECT_EQ(std::size_t { 0 }, kv.loads);
+	fmt::print("[ BENCHMARK] {} threads doing {} accesses: one lock {:.2f}ms, sharded {:.2f}ms\n", threads, accesses, oldDuration, newDuration);
+}
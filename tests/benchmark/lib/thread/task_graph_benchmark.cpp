@@ -0,0 +1,65 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "lib/logging/in_memory_logger.hpp"
+#include "lib/thread/task_graph.hpp"
+#include "lib/thread/thread_pool.hpp"
+
+class TaskGraphBenchmark : public ::testing::Test {
+protected:
+	InMemoryLogger logger;
+	ThreadPool threadPool { logger, 4 };
+};
+
+// Old-vs-new startup shaped as loadModules: one after another, as the modules used to load, against the graph,
+// where the XML files and the map load on the thread pool while the scripts load on the calling thread.
+TEST_F(TaskGraphBenchmark, StartupShape) {
+	const auto work = [](size_t rounds) {
+		return [rounds] {
+			volatile uint64_t hash = 14695981039346656037ull;
+			for (size_t i = 0; i < rounds * 100000; ++i) {
+				hash = (hash ^ i) * 1099511628211ull;
+			}
+		};
+	};
+
+	struct Module {
+		std::string name;
+		size_t rounds;
+		bool script;
+		std::vector<std::string> dependencies;
+	};
+	const std::vector<Module> startup {
+		{ "appearances.dat", 20, false, {} },
+		{ "XML/vocations.xml", 2, false, {} },
+		{ "XML/outfits.xml", 2, false, { "appearances.dat" } },
+		{ "XML/imbuements.xml", 2, false, {} },
+		{ "items.xml", 10, false, { "appearances.dat" } },
+		{ "map.otbm", 60, false, { "items.xml" } },
+		{ "core scripts", 20, true, { "XML/vocations.xml", "XML/outfits.xml", "XML/imbuements.xml", "items.xml" } },
+		{ "datapack scripts", 30, true, { "core scripts" } },
+		{ "monsters", 20, true, { "datapack scripts" } },
+	};
+
+	Benchmark bmOld;
+	for (const auto &module : startup) {
+		work(module.rounds)();
+	}
+	const auto oldDuration = bmOld.duration();
+
+	TaskGraph graph(threadPool);
+	for (const auto &module : startup) {
+		if (module.script) {
+			graph.addOnCaller(module.name, work(module.rounds), module.dependencies);
+		} else {
+			graph.add(module.name, work(module.rounds), module.dependencies);
+		}
+	}
+	Benchmark bmNew;
+	graph.run();
+	const auto newDuration = bmNew.duration();
+
+	EXPECT_EQ(startup.size(), graph.getTimings().size());
+	fmt::print("[ BENCHMARK] {} modules on {} threads: one after another {:.2f}ms, task graph {:.2f}ms\n", startup.size(), threadPool.get_thread_count(), oldDuration, newDuration);
+}
@@ -0,0 +1,27 @@
+#include <gtest/gtest.h>
+#include "config/configmanager.hpp"
+#include "database/database.hpp"
+#include "game/scheduling/dispatcher.hpp"
+#include "lib/di/container.hpp"
+#include "lib/logging/in_memory_logger.hpp"
+
+int main(int argc, char** argv) {
+	::testing::InitGoogleTest(&argc, argv);
+
+	static di::extension::injector<> injector {};
+	InMemoryLogger::install(injector);
+	DI::setTestContainer(&injector);
+
+	(void)g_logger();
+	(void)g_configManager();
+	(void)g_database();
+
+	// The network benchmarks hand the packets they receive to the dispatcher
+	g_dispatcher().init();
+
+	const auto result = RUN_ALL_TESTS();
+
+	g_dispatcher().shutdown();
+	g_threadPool().shutdown();
+	return result;
+}
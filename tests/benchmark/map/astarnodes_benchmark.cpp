@@ -0,0 +1,106 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "creatures/creature.hpp"
+#include "map/map.hpp"
+#include "map/utils/astarnodes.hpp"
+#include "utils/tools.hpp"
+
+class AStarNodesBenchmark : public ::testing::Test {
+protected:
+	static constexpr uint16_t BASE = 1000;
+	static constexpr uint16_t AREA = 96;
+	static constexpr uint8_t Z = 7;
+
+	// Serpentine west of the cave, each wall leaves a gap at alternating ends
+	static constexpr uint16_t SERPENTINE_WALLS = 8;
+	static constexpr uint16_t SERPENTINE_HEIGHT = 24;
+
+	void SetUp() override {
+		map = std::make_unique<Map>();
+
+		std::mt19937 rng(42);
+		std::bernoulli_distribution rock(0.18);
+		for (uint16_t x = BASE; x < BASE + AREA; ++x) {
+			for (uint16_t y = BASE; y < BASE + AREA; ++y) {
+				if (isSerpentineWall(x, y) || (x >= BASE + SERPENTINE_WALLS * 4 + 4 && rock(rng))) {
+					continue;
+				}
+				map->getOrCreateTile(x, y, Z);
+			}
+		}
+	}
+
+	static bool isSerpentineWall(uint16_t x, uint16_t y) {
+		const auto column = x - BASE;
+		const auto row = y - BASE;
+		if (column == 0 || column % 4 != 0 || column > SERPENTINE_WALLS * 4 || row > SERPENTINE_HEIGHT) {
+			return row == SERPENTINE_HEIGHT + 1 && column <= SERPENTINE_WALLS * 4;
+		}
+		// Odd walls are open at the top, even ones at the bottom
+		return (column / 4) % 2 == 0 ? row < SERPENTINE_HEIGHT : row > 0;
+	}
+
+	bool findPath(const Position &start, const Position &target, int32_t maxNodes, std::vector<Direction> &dirList) const {
+		FindPathParams fpp;
+		fpp.clearSight = false;
+		fpp.minTargetDist = 1;
+		fpp.maxTargetDist = 1;
+		fpp.maxNodes = maxNodes;
+		dirList.clear();
+		return map->getPathMatching(start, dirList, FrozenPathingConditionCall(target), fpp);
+	}
+
+	// Start and target pairs across the cave, at most 10 tiles apart as monsters usually chase
+	std::vector<std::pair<Position, Position>> cavePairs(size_t amount) const {
+		std::mt19937 rng(7);
+		std::uniform_int_distribution<uint16_t> coords(BASE + SERPENTINE_WALLS * 4 + 16, BASE + AREA - 16);
+		std::uniform_int_distribution<int32_t> offsets(-10, 10);
+		std::vector<std::pair<Position, Position>> pairs;
+		while (pairs.size() < amount) {
+			const Position start(coords(rng), coords(rng), Z);
+			const Position target(start.x + offsets(rng), start.y + offsets(rng), Z);
+			if (map->getTileRaw(start) && map->getTileRaw(target) && Position::getDiagonalDistance(start, target) > 1) {
+				pairs.emplace_back(start, target);
+			}
+		}
+		return pairs;
+	}
+
+	std::unique_ptr<Map> map;
+
+	const Position serpentineStart { BASE + 1, BASE + SERPENTINE_HEIGHT, Z };
+	const Position serpentineEnd { BASE + SERPENTINE_WALLS * 4 + 2, BASE + SERPENTINE_HEIGHT, Z };
+};
+
+// Cave chases with the default budget (vectorized scan) and a large one (binary heap), then the long serpentine path.
+TEST_F(AStarNodesBenchmark, NodeBudgets) {
+	constexpr size_t rounds = 20;
+	const auto pairs = cavePairs(200);
+	std::vector<Direction> dirList;
+
+	const auto run = [&](int32_t maxNodes) {
+		size_t found = 0;
+		Benchmark bm;
+		for (size_t round = 0; round < rounds; ++round) {
+			for (const auto &[start, target] : pairs) {
+				found += findPath(start, target, maxNodes, dirList) ? 1 : 0;
+			}
+		}
+		return std::make_pair(found, bm.duration());
+	};
+
+	const auto [scanFound, scanDuration] = run(AStarNodes::DEFAULT_MAX_NODES);
+	const auto [heapFound, heapDuration] = run(AStarNodes::DEFAULT_MAX_NODES * 8);
+
+	Benchmark bm;
+	for (size_t round = 0; round < rounds; ++round) {
+		findPath(serpentineStart, serpentineEnd, 32768, dirList);
+	}
+	const auto longDuration = bm.duration();
+
+	EXPECT_GE(heapFound, scanFound);
+	std::cout << fmt::format("[ BENCHMARK] {} cave paths: {} nodes {:.3f} ms ({} found), {} nodes {:.3f} ms ({} found)", pairs.size() * rounds, AStarNodes::DEFAULT_MAX_NODES, scanDuration, scanFound, AStarNodes::DEFAULT_MAX_NODES * 8, heapDuration, heapFound) << std::endl;
+	std::cout << fmt::format("[ BENCHMARK] {} serpentine paths of {} steps: {:.3f} ms", rounds, dirList.size(), longDuration) << std::endl;
+}
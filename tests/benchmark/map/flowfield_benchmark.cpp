@@ -0,0 +1,101 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "creatures/creature.hpp"
+#include "map/map.hpp"
+#include "map/utils/flowfield.hpp"
+#include "utils/tools.hpp"
+
+class FlowFieldBenchmark : public ::testing::Test {
+protected:
+	static constexpr uint16_t BASE = 1000;
+	static constexpr uint16_t AREA = 64;
+	static constexpr uint8_t Z = 7;
+	static constexpr Position TARGET { BASE + AREA / 2, BASE + AREA / 2, Z };
+
+	void SetUp() override {
+		map = std::make_unique<Map>();
+		for (uint16_t x = BASE; x < BASE + AREA; ++x) {
+			for (uint16_t y = BASE; y < BASE + AREA; ++y) {
+				// A wall west of the target, with a single gap at its south end
+				if (x == TARGET.x - 3 && y >= TARGET.y - 6 && y < TARGET.y + 6) {
+					continue;
+				}
+				map->getOrCreateTile(x, y, Z);
+			}
+		}
+	}
+
+	// Missing tiles are the obstacles, as for the creature-less A* search
+	bool isWalkable(const Position &pos) const {
+		return map->getTileRaw(pos) != nullptr;
+	}
+
+	FlowField::WalkableFunction walkable() const {
+		return [this](const Position &pos) { return isWalkable(pos); };
+	}
+
+	static Position walk(Position pos, const std::vector<Direction> &dirList) {
+		for (const auto dir : dirList | std::views::reverse) {
+			pos = getNextPosition(dir, pos);
+		}
+		return pos;
+	}
+
+	std::unique_ptr<Map> map;
+};
+
+// 200 monsters chasing one player: a single shared flow field against one A* search per monster.
+TEST_F(FlowFieldBenchmark, HordeAgainstAStar) {
+	constexpr size_t monsters = 200;
+	constexpr size_t rounds = 20;
+
+	std::mt19937 rng(42);
+	std::uniform_int_distribution<int32_t> offsets(-8, 8);
+	std::vector<Position> horde;
+	while (horde.size() < monsters) {
+		const Position pos(TARGET.x + offsets(rng), TARGET.y + offsets(rng), Z);
+		if (isWalkable(pos) && Position::getDiagonalDistance(pos, TARGET) > 1) {
+			horde.emplace_back(pos);
+		}
+	}
+
+	FindPathParams fpp;
+	fpp.clearSight = false;
+	fpp.minTargetDist = 1;
+	fpp.maxTargetDist = 1;
+	const FrozenPathingConditionCall condition(TARGET);
+
+	std::vector<Direction> dirList;
+	size_t aStarFound = 0;
+	Benchmark bm;
+	for (size_t round = 0; round < rounds; ++round) {
+		for (const auto &pos : horde) {
+			dirList.clear();
+			aStarFound += map->getPathMatching(pos, dirList, condition, fpp) ? 1 : 0;
+		}
+	}
+	const auto aStarDuration = bm.duration();
+
+	FlowFieldCache cache;
+	const auto canWalk = walkable();
+	size_t fieldFound = 0;
+	bm.start();
+	for (size_t round = 0; round < rounds; ++round) {
+		// As if the player had moved, the field is rebuilt once for the whole horde
+		cache.invalidate(TARGET);
+		for (const auto &pos : horde) {
+			dirList.clear();
+			const auto field = cache.get(1, TARGET, canWalk);
+			if (field->getPath(pos, 1, dirList, canWalk)) {
+				++fieldFound;
+				EXPECT_EQ(1, field->getDistance(walk(pos, dirList)));
+			}
+		}
+	}
+	const auto fieldDuration = bm.duration();
+
+	EXPECT_GE(fieldFound, aStarFound);
+	std::cout << fmt::format("[ BENCHMARK] {} monsters x {} rounds: flow field {:.3f} ms ({} paths), per-monster A* {:.3f} ms ({} paths)", monsters, rounds, fieldDuration, fieldFound, aStarDuration, aStarFound) << std::endl;
+}
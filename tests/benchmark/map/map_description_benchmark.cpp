@@ -0,0 +1,133 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "items/tile.hpp"
+#include "map/map.hpp"
+#include "server/network/message/networkmessage.hpp"
+
+class MapDescriptionBenchmark : public ::testing::Test {
+protected:
+	static constexpr uint16_t BASE = 1000;
+	static constexpr uint16_t WIDTH = 18;
+	static constexpr uint16_t HEIGHT = 14;
+	static constexpr uint8_t FLOORS = 8;
+
+	// What the old path read from the item and its type to encode it
+	struct TestItem {
+		uint16_t id = 0;
+		uint8_t count = 0;
+		bool stackable = false;
+		bool container = false;
+		uint8_t tier = 0;
+	};
+
+	static void addItem(NetworkMessage &msg, const TestItem &item) {
+		msg.add<uint16_t>(item.id);
+		if (item.stackable) {
+			msg.addByte(item.count);
+		}
+		if (item.container) {
+			msg.addByte(0x00);
+		}
+		if (item.tier > 0) {
+			msg.addByte(item.tier);
+		}
+	}
+
+	void SetUp() override {
+		map = std::make_unique<Map>();
+		for (uint8_t z = 0; z < FLOORS; ++z) {
+			for (uint16_t x = BASE; x < BASE + WIDTH; ++x) {
+				for (uint16_t y = BASE; y < BASE + HEIGHT; ++y) {
+					map->getOrCreateTile(x, y, z);
+
+					// A ground, a border and every fifth tile some stacked coins or a bag
+					auto &tileItems = items[{ x, y, z }];
+					tileItems.push_back({ static_cast<uint16_t>(100 + x % 7) });
+					tileItems.push_back({ static_cast<uint16_t>(4500 + y % 11) });
+					if ((x + y) % 5 == 0) {
+						tileItems.push_back({ 3031, static_cast<uint8_t>(x % 100), true });
+					} else if ((x + y) % 5 == 1) {
+						tileItems.push_back({ 2853, 0, false, true, 1 });
+					}
+				}
+			}
+		}
+	}
+
+	std::unique_ptr<Map> map;
+	std::map<Position, std::vector<TestItem>> items;
+};
+
+// Old-vs-new description of a whole 18x14 viewport over 8 floors, as sent on every login, teleport and floor change:
+// the old path took a shared_ptr of each tile and encoded every item on it again, the new one reads the tiles raw
+// and copies the encoding each tile keeps since it was first described.
+TEST_F(MapDescriptionBenchmark, ViewportDescriptions) {
+	constexpr size_t descriptions = 500;
+
+	NetworkMessage msg;
+	size_t oldLength = 0;
+	Benchmark bmOld;
+	for (size_t description = 0; description < descriptions; ++description) {
+		msg.reset();
+		for (uint8_t z = 0; z < FLOORS; ++z) {
+			for (uint16_t x = BASE; x < BASE + WIDTH; ++x) {
+				for (uint16_t y = BASE; y < BASE + HEIGHT; ++y) {
+					const auto &tile = map->getTile(x, y, z);
+					if (tile) {
+						for (const auto &item : items.at(tile->getPosition())) {
+							addItem(msg, item);
+						}
+					}
+				}
+			}
+		}
+		oldLength += msg.getLength();
+	}
+	const auto oldDuration = bmOld.duration();
+
+	// First descriptions, encoding the tiles
+	NetworkMessage itemMessage;
+	for (const auto &[pos, tileItems] : items) {
+		auto encoding = std::make_unique<TileItemEncoding>();
+		for (const auto &item : tileItems) {
+			itemMessage.reset();
+			addItem(itemMessage, item);
+			const auto length = itemMessage.getLength();
+			const auto* data = itemMessage.getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION;
+			encoding->bytes.emplace_back(static_cast<uint8_t>(length));
+			encoding->bytes.emplace_back(static_cast<uint8_t>(length >> 8));
+			encoding->bytes.insert(encoding->bytes.end(), data, data + length);
+			++encoding->itemCount;
+		}
+		map->getTileRaw(pos)->setItemEncoding(std::move(encoding));
+	}
+
+	size_t newLength = 0;
+	Benchmark bmNew;
+	for (size_t description = 0; description < descriptions; ++description) {
+		msg.reset();
+		for (uint8_t z = 0; z < FLOORS; ++z) {
+			for (uint16_t x = BASE; x < BASE + WIDTH; ++x) {
+				for (uint16_t y = BASE; y < BASE + HEIGHT; ++y) {
+					const auto tile = map->getTileRaw(x, y, z);
+					if (tile) {
+						const auto &encoding = *tile->getItemEncoding();
+						size_t offset = 0;
+						for (uint8_t item = 0; item < encoding.itemCount; ++item) {
+							const auto length = static_cast<size_t>(encoding.bytes[offset] | (encoding.bytes[offset + 1] << 8));
+							msg.addBytes(reinterpret_cast<const char*>(encoding.bytes.data() + offset + 2), length);
+							offset += length + 2;
+						}
+					}
+				}
+			}
+		}
+		newLength += msg.getLength();
+	}
+	const auto newDuration = bmNew.duration();
+
+	EXPECT_EQ(oldLength, newLength);
+	std::cout << fmt::format("[ BENCHMARK] {} viewport descriptions: encoding items {:.0f}/s, copying encodings {:.0f}/s", descriptions, descriptions * 1000 / oldDuration, descriptions * 1000 / newDuration) << std::endl;
+}
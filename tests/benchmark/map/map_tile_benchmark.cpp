@@ -0,0 +1,70 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "items/tile.hpp"
+#include "map/map.hpp"
+
+class MapTileBenchmark : public ::testing::Test {
+protected:
+	static constexpr uint16_t BASE = 1000;
+	static constexpr uint16_t AREA = 64;
+	static constexpr uint8_t Z = 7;
+
+	void SetUp() override {
+		map = std::make_unique<Map>();
+		for (uint16_t x = BASE; x < BASE + AREA; ++x) {
+			for (uint16_t y = BASE; y < BASE + AREA; ++y) {
+				map->getOrCreateTile(x, y, Z);
+			}
+		}
+	}
+
+	std::unique_ptr<Map> map;
+};
+
+// Lock-free raw reads against the previous path, which locked the sector floors mutex and the floor shared mutex and copied the shared_ptr.
+TEST_F(MapTileBenchmark, AgainstLockingRead) {
+	constexpr size_t rounds = 200;
+	constexpr size_t threads = 4;
+
+	std::mutex floorsMutex;
+	const auto lockingGetTile = [&](uint16_t x, uint16_t y) {
+		const auto sector = map->getMapSector(x, y);
+		Floor* floor;
+		{
+			std::scoped_lock lock(floorsMutex);
+			floor = sector->getFloor(Z);
+		}
+		return floor->getTile(x, y);
+	};
+
+	const auto run = [&](auto &&getTile) {
+		Benchmark bm;
+		std::atomic_size_t found = 0;
+		std::vector<std::jthread> workers;
+		for (size_t i = 0; i < threads; ++i) {
+			workers.emplace_back([&] {
+				size_t localFound = 0;
+				for (size_t round = 0; round < rounds; ++round) {
+					for (uint16_t x = BASE; x < BASE + AREA; ++x) {
+						for (uint16_t y = BASE; y < BASE + AREA; ++y) {
+							localFound += getTile(x, y) ? 1 : 0;
+						}
+					}
+				}
+				found += localFound;
+			});
+		}
+		workers.clear();
+		return std::make_pair(found.load(), bm.duration());
+	};
+
+	const auto [rawFound, rawDuration] = run([this](uint16_t x, uint16_t y) { return map->getTileRaw(x, y, Z); });
+	const auto [sharedFound, sharedDuration] = run([this](uint16_t x, uint16_t y) { return map->getTile(x, y, Z); });
+	const auto [lockingFound, lockingDuration] = run(lockingGetTile);
+
+	EXPECT_EQ(lockingFound, rawFound);
+	EXPECT_EQ(lockingFound, sharedFound);
+	std::cout << fmt::format("[ BENCHMARK] {} reads on {} threads: getTileRaw {:.3f} ms, getTile {:.3f} ms, locking getTile {:.3f} ms", rawFound, threads, rawDuration, sharedDuration, lockingDuration) << std::endl;
+}
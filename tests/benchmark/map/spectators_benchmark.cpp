@@ -0,0 +1,93 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "creatures/players/player.hpp"
+#include "map/spectators.hpp"
+
+namespace {
+	std::atomic_size_t allocations = 0;
+}
+
+// Counts the heap allocations of the whole executable, the benchmarks below only look at the difference around their loops.
+void* operator new(std::size_t size) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (auto* ptr = std::malloc(size == 0 ? 1 : size)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+class SpectatorsBenchmark : public ::testing::Test {
+protected:
+	void SetUp() override {
+		for (size_t i = 0; i < 48; ++i) {
+			players.emplace_back(std::make_shared<Player>());
+		}
+	}
+
+	Spectators window(size_t first, size_t last) const {
+		Spectators spectators;
+		for (size_t i = first; i < last; ++i) {
+			spectators.insert(players[i]);
+		}
+		return spectators;
+	}
+
+	std::vector<std::shared_ptr<Creature>> players;
+};
+
+// Old-vs-new spectators pipeline of a creature move: two overlapping windows joined, then the players filtered and notified.
+// The joined result has 24 entries, so it fits the inline storage.
+TEST_F(SpectatorsBenchmark, AllocationsAgainstSharedVector) {
+	constexpr size_t rounds = 100000;
+	static_assert(24 <= Spectators::INLINE_CAPACITY);
+
+	size_t spectatorsVisited = 0;
+	const auto spectatorsAllocations = allocations.load();
+	Benchmark bmSpectators;
+	for (size_t round = 0; round < rounds; ++round) {
+		auto spectators = window(0, 16);
+		spectators.join(window(8, 24));
+		for (const auto &spectator : spectators.filter<Player>()) {
+			spectatorsVisited += spectator ? 1 : 0;
+		}
+	}
+	const auto spectatorsDuration = bmSpectators.duration();
+	const auto spectatorsAllocated = allocations.load() - spectatorsAllocations;
+
+	size_t vectorVisited = 0;
+	const auto vectorAllocations = allocations.load();
+	Benchmark bmVector;
+	for (size_t round = 0; round < rounds; ++round) {
+		CreatureVector creatures(players.begin(), players.begin() + 16);
+		creatures.insert(creatures.end(), players.begin() + 8, players.begin() + 24);
+		std::unordered_set uset(creatures.begin(), creatures.end());
+		creatures.assign(uset.begin(), uset.end());
+
+		CreatureVector playersOnly;
+		playersOnly.reserve(creatures.size());
+		for (const auto &creature : creatures) {
+			if (creature->getPlayer()) {
+				playersOnly.emplace_back(creature);
+			}
+		}
+		for (const auto &spectator : playersOnly) {
+			vectorVisited += spectator ? 1 : 0;
+		}
+	}
+	const auto vectorDuration = bmVector.duration();
+	const auto vectorAllocated = allocations.load() - vectorAllocations;
+
+	EXPECT_EQ(vectorVisited, spectatorsVisited);
+	EXPECT_EQ(0, spectatorsAllocated);
+	fmt::print("[ BENCHMARK] {} moves: inline spectators {} allocations ({:.3f} ms), shared vector {} allocations ({:.3f} ms)\n", rounds, spectatorsAllocated, spectatorsDuration, vectorAllocated, vectorDuration);
+}
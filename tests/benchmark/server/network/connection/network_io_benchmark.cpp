@@ -0,0 +1,22 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "server/network/loopback_service.hpp"
+
+// Many clients sending one packet at a time to the ServiceManager, which accepts their connections and hands each
+// one to the next I/O context. The network runs on the main thread only, as it did before, or on extra I/O threads.
+class NetworkIoBenchmark : public ::testing::Test { };
+
+TEST_F(NetworkIoBenchmark, ShardedIoContexts) {
+	constexpr size_t clients = 256;
+	constexpr size_t packetsPerClient = 200;
+	const auto ioThreads = std::clamp<size_t>(std::thread::hardware_concurrency() / 2, 2, ServiceManager::MAX_IO_THREADS);
+
+	const auto single = LoopbackService::run(0, clients, packetsPerClient, 1);
+	const auto sharded = LoopbackService::run(ioThreads - 1, clients, packetsPerClient, 1);
+
+	EXPECT_EQ(clients * packetsPerClient, single.packets);
+	EXPECT_EQ(clients * packetsPerClient, sharded.packets);
+	fmt::print("[ BENCHMARK] {} clients sending {} packets: one thread {:.0f} packets/s (p99 {:.0f}us), {} threads {:.0f} packets/s (p99 {:.0f}us)\n", clients, packetsPerClient, single.packetsPerSecond, single.p99Microseconds, ioThreads, sharded.packetsPerSecond, sharded.p99Microseconds);
+}
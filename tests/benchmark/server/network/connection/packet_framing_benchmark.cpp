@@ -0,0 +1,23 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "server/network/loopback_service.hpp"
+
+// A flood of clients walking and turning, each writing a walk, a turn and a ping at once, through the ServicePort and
+// Connection of the server. The connection frames all the packets of a read and hands them to the dispatcher as a
+// single task, the network runs on the main thread only so that the framing is all it measures.
+class PacketFramingBenchmark : public ::testing::Test { };
+
+// Takes two sockets per client, the open files limit may have to be raised first
+TEST_F(PacketFramingBenchmark, WalkFlood) {
+	constexpr size_t clients = 1000;
+	constexpr size_t burstsPerClient = 50;
+	constexpr size_t packetsPerBurst = 3;
+
+	const auto result = LoopbackService::run(0, clients, burstsPerClient, packetsPerBurst);
+
+	const auto total = clients * burstsPerClient * packetsPerBurst;
+	EXPECT_EQ(total, result.packets);
+	fmt::print("[ BENCHMARK] {} clients sending {} packets: {:.2f}ms, {:.2f}ms cpu, {:.0f} packets/s (p99 {:.0f}us)\n", clients, total, result.duration, result.cpu, result.packetsPerSecond, result.p99Microseconds);
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "config/configmanager.hpp"
+#include "server/network/connection/connection.hpp"
+#include "server/network/message/networkmessage.hpp"
+#include "server/network/protocol/protocol.hpp"
+#include "server/server.hpp"
+#include "utils/tools.hpp"
+
+/**
+ * Runs the network of the server, ServiceManager with its ServicePort, Connection and Protocol, on a loopback port.
+ *
+ * The clients write packets carrying the time they were written at, the protocol parses them on the dispatcher
+ * and keeps how long each one took to get there. Each client connects from its own loopback address, so that the
+ * limit of connections per IP does not turn it down, which takes a system routing all of 127.0.0.0/8 to loopback.
+ * The main thread of the network is the one of the benchmark, as the dispatcher has an event queue for
+ * MAX_IO_THREADS + 1 threads besides its pool and never gives one back.
+ */
+class LoopbackService {
+public:
+	struct Result {
+		size_t packets = 0;
+		double duration = 0;
+		double cpu = 0;
+		double packetsPerSecond = 0;
+		double p99Microseconds = 0;
+	};
+
+	class TimingProtocol final : public Protocol {
+	public:
+		// Static protocol information.
+		enum { SERVER_SENDS_FIRST = false };
+		enum { PROTOCOL_IDENTIFIER = 0xFE };
+		enum { USE_CHECKSUM = false };
+
+		static const char* protocol_name() {
+			return "loopback benchmark protocol";
+		}
+
+		explicit TimingProtocol(const Connection_ptr &initConnection) :
+			Protocol(initConnection) { }
+
+		void onRecvFirstMessage(NetworkMessage &) override { }
+
+		// On the dispatcher, one packet at a time
+		void parsePacket(NetworkMessage &msg) override {
+			msg.skipBytes(CHECKSUM_LENGTH);
+			const auto sent = msg.get<int64_t>();
+			latencies.emplace_back(static_cast<double>(now() - sent) / 1000);
+			parsed.fetch_add(1, std::memory_order_release);
+		}
+
+		static inline std::vector<double> latencies;
+		static inline std::atomic_size_t parsed = 0;
+	};
+
+	// Nanoseconds of the steady clock, as written in the packets
+	static int64_t now() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// Every client writes its packets in bursts, all of them at once, and the network runs until they were all parsed
+	static Result run(size_t extraThreads, size_t clients, size_t bursts, size_t burstPackets) {
+		loadConfig();
+		TimingProtocol::latencies.clear();
+		TimingProtocol::latencies.reserve(clients * bursts * burstPackets);
+		TimingProtocol::parsed = 0;
+
+		ServiceManager services;
+		const auto port = freePort();
+		if (!services.add<TimingProtocol>(port)) {
+			return {};
+		}
+
+		Result result;
+		std::thread load([&] {
+			result = sendPackets(port, clients, bursts, burstPackets);
+			services.stop();
+		});
+		services.run(extraThreads);
+		load.join();
+
+		ConnectionManager::getInstance().closeAll();
+		return result;
+	}
+
+private:
+	// Body of a packet past its header, the time it was written at between the unused checksum and the padding
+	static constexpr size_t PACKET_BODY_SIZE = CHECKSUM_LENGTH + 16;
+
+	static void loadConfig() {
+		static std::once_flag loaded;
+		std::call_once(loaded, [] {
+			const std::string path = "loopback_service.lua";
+			std::ofstream(path) << "ip = \"127.0.0.1\"\nbindOnlyGlobalAddress = true\nmaxPacketsPerSecond = 1000000000\n";
+			g_configManager().setConfigFileLua(path);
+			g_configManager().load();
+			std::filesystem::remove(path);
+		});
+	}
+
+	static uint16_t freePort() {
+		asio::io_context context;
+		const asio::ip::tcp::acceptor acceptor(context, asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+		return acceptor.local_endpoint().port();
+	}
+
+	static Result sendPackets(uint16_t port, size_t clients, size_t bursts, size_t burstPackets) {
+		const asio::ip::tcp::endpoint endpoint(asio::ip::address_v4::loopback(), port);
+		const auto total = clients * bursts * burstPackets;
+
+		// The protocol identifier after its checksum opens the connection, as a client does
+		const uint8_t identifier = TimingProtocol::PROTOCOL_IDENTIFIER;
+		const auto checksum = adlerChecksum(&identifier, 1);
+		const std::array<uint8_t, static_cast<size_t>(HEADER_LENGTH) + CHECKSUM_LENGTH + 1> firstMessage {
+			CHECKSUM_LENGTH + 1, 0, static_cast<uint8_t>(checksum), static_cast<uint8_t>(checksum >> 8), static_cast<uint8_t>(checksum >> 16), static_cast<uint8_t>(checksum >> 24), identifier
+		};
+
+		asio::io_context clientContext;
+		std::vector<asio::ip::tcp::socket> sockets;
+		sockets.reserve(clients);
+		for (size_t client = 0; client < clients; ++client) {
+			auto &socket = sockets.emplace_back(clientContext);
+			socket.open(asio::ip::tcp::v4());
+			socket.bind(asio::ip::tcp::endpoint(asio::ip::address_v4((127u << 24) | (1u << 16) | static_cast<uint32_t>(client + 1)), 0));
+			socket.connect(endpoint);
+			socket.set_option(asio::ip::tcp::no_delay(true));
+			asio::write(socket, asio::buffer(firstMessage));
+		}
+
+		const auto cpuStart = std::clock();
+		Benchmark bm;
+		std::vector<std::thread> senders;
+		constexpr size_t senderThreads = 4;
+		for (size_t sender = 0; sender < senderThreads; ++sender) {
+			senders.emplace_back([&, sender] {
+				std::vector<uint8_t> burst(burstPackets * (HEADER_LENGTH + PACKET_BODY_SIZE));
+				for (size_t i = 0; i < bursts; ++i) {
+					for (size_t client = sender; client < clients; client += senderThreads) {
+						const auto written = now();
+						for (size_t packet = 0; packet < burstPackets; ++packet) {
+							// Past the first message, the header counts the blocks of 8 bytes after the checksum
+							auto* data = burst.data() + packet * (HEADER_LENGTH + PACKET_BODY_SIZE);
+							data[0] = (PACKET_BODY_SIZE - CHECKSUM_LENGTH) / 8;
+							std::memcpy(data + HEADER_LENGTH + CHECKSUM_LENGTH, &written, sizeof(written));
+						}
+						asio::write(sockets[client], asio::buffer(burst));
+					}
+				}
+			});
+		}
+		for (auto &sender : senders) {
+			sender.join();
+		}
+
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::minutes(1);
+		while (TimingProtocol::parsed.load(std::memory_order_acquire) < total && std::chrono::steady_clock::now() < deadline) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		Result result;
+		result.duration = bm.duration();
+		result.cpu = static_cast<double>(std::clock() - cpuStart) * 1000 / CLOCKS_PER_SEC;
+		result.packets = TimingProtocol::parsed.load(std::memory_order_acquire);
+		result.packetsPerSecond = static_cast<double>(result.packets) * 1000 / result.duration;
+		if (result.packets == total) {
+			auto latencies = TimingProtocol::latencies;
+			std::ranges::sort(latencies);
+			result.p99Microseconds = latencies[latencies.size() * 99 / 100];
+		}
+
+		for (auto &socket : sockets) {
+			socket.close();
+		}
+		return result;
+	}
+};
@@ -0,0 +1,91 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "server/network/protocol/known_creatures.hpp"
+
+// Old-vs-new known creatures of a player walking a crowded city of 2500 creatures, two thirds of them players and a
+// few of those in the walker's party: the old set was scanned from its start for a creature to forget, looking each
+// one up and skipping those protected, the new table mostly checks a few of the least recently seen.
+TEST(KnownCreaturesBenchmark, CrowdedCity) {
+	constexpr uint32_t creatures = 2500;
+	constexpr uint32_t viewWidth = 40;
+	constexpr uint32_t walks = 4;
+
+	constexpr uint32_t party = 1;
+
+	struct TestCreature {
+		bool player = false;
+		// 0 when out of any party
+		uint32_t party = 0;
+	};
+	phmap::flat_hash_map<uint32_t, TestCreature> world;
+	for (uint32_t id = 1; id <= creatures; ++id) {
+		world[id].player = id % 3 != 0;
+		world[id].party = world[id].player && id % 100 == 1 ? party : 0;
+	}
+
+	// The creatures in view are those of the window the player stands at
+	uint32_t step = 0;
+	const auto canSee = [&step](uint32_t id) {
+		const auto position = (id + creatures - step % creatures) % creatures;
+		return position < viewWidth;
+	};
+	const auto canForget = [&](uint32_t id) {
+		const auto it = world.find(id);
+		if (it != world.end() && it->second.player && it->second.party == party) {
+			return false;
+		}
+		return !canSee(id);
+	};
+
+	size_t oldForgottenInView = 0;
+	std::unordered_set<uint32_t> knownSet;
+	Benchmark bmOld;
+	for (step = 0; step < creatures * walks; ++step) {
+		for (uint32_t offset = 0; offset < viewWidth; ++offset) {
+			const auto id = (step + offset) % creatures + 1;
+			if (!knownSet.insert(id).second || knownSet.size() <= KnownCreatures::CAPACITY) {
+				continue;
+			}
+
+			auto removed = knownSet.end();
+			for (auto it = knownSet.begin(); it != knownSet.end(); ++it) {
+				if (*it != id && canForget(*it)) {
+					removed = it;
+					break;
+				}
+			}
+			if (removed == knownSet.end()) {
+				removed = knownSet.begin();
+				if (*removed == id) {
+					++removed;
+				}
+			}
+			oldForgottenInView += canSee(*removed) ? 1 : 0;
+			knownSet.erase(removed);
+		}
+	}
+	const auto oldDuration = bmOld.duration();
+
+	size_t newForgottenInView = 0;
+	KnownCreatures known;
+	Benchmark bmNew;
+	for (step = 0; step < creatures * walks; ++step) {
+		for (uint32_t offset = 0; offset < viewWidth; ++offset) {
+			const auto id = (step + offset) % creatures + 1;
+			if (known.touch(id)) {
+				continue;
+			}
+
+			const auto removedId = known.insert(id, canForget);
+			newForgottenInView += removedId != 0 && canSee(removedId) ? 1 : 0;
+		}
+	}
+	const auto newDuration = bmNew.duration();
+
+	EXPECT_EQ(KnownCreatures::CAPACITY, knownSet.size());
+	EXPECT_EQ(KnownCreatures::CAPACITY, known.size());
+	EXPECT_EQ(0u, newForgottenInView);
+	fmt::print("[ BENCHMARK] {} steps among {} creatures: set scan {:.2f}ms ({} in view forgotten), lru table {:.2f}ms ({} in view forgotten)\n", creatures * walks, creatures, oldDuration, oldForgottenInView, newDuration, newForgottenInView);
+}
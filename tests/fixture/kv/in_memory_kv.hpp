@@ -38,6 +38,9 @@ protected:
 	std::vector<std::string> loadPrefix(const std::string &prefix = "") override {
 		return {};
 	}
+	std::vector<std::pair<std::string, ValueWrapper>> loadPrefixValues(const std::string &prefix) override {
+		return {};
+	}
 	std::optional<ValueWrapper> load(const std::string &key) override {
 		return std::nullopt;
 	}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include "test_env.hpp"
+
+#include <string>
+#include <vector>
+#include <fmt/format.h>
+
+namespace it_database_statement {
+
+	constexpr uint32_t ACCOUNT_ID = 600000100;
+	constexpr uint32_t PLAYER_ID = 600000101;
+	constexpr uint32_t ITEM_ROWS = 2000;
+
+	inline bool createPlayer(Database &db) {
+		const auto accountInserted = db.executeQuery(
+			fmt::format("INSERT INTO `accounts` (`id`,`name`,`password`) VALUES ({}, 'stmt', '')", ACCOUNT_ID)
+		);
+		const auto playerInserted = db.executeQuery(fmt::format(
+			"INSERT INTO `players` (`id`,`name`,`account_id`,`conditions`) VALUES ({}, 'stmt player', {}, '')",
+			PLAYER_ID,
+			ACCOUNT_ID
+		));
+		return accountInserted && playerInserted;
+	}
+
+	// Attributes with bytes that need escaping in text queries, of growing length
+	inline std::string attributes(uint32_t sid) {
+		std::string bytes(sid % 64, '\0');
+		for (size_t i = 0; i < bytes.size(); ++i) {
+			bytes[i] = static_cast<char>((sid + i) * 31);
+		}
+		return bytes;
+	}
+
+	inline bool insertItems(Database &db) {
+		DBInsert insert("INSERT INTO `player_items` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
+		for (uint32_t sid = 101; sid < 101 + ITEM_ROWS; ++sid) {
+			const auto bytes = attributes(sid);
+			if (!insert.addRow(fmt::format("{},{},{},{},{},{}", PLAYER_ID, sid % 10, sid, 2854 + sid % 100, sid % 100, db.escapeBlob(bytes.data(), static_cast<uint32_t>(bytes.size()))))) {
+				return false;
+			}
+		}
+		return insert.execute();
+	}
+
+	class DatabaseStatementTest : public ::testing::Test { };
+
+	TEST_F(DatabaseStatementTest, ParametersAreBoundWithoutEscaping) {
+		auto &db = g_database();
+		databaseTest(db, [&db] {
+			ASSERT_TRUE(createPlayer(db));
+			const std::string quoted = "it's \"quoted\" \\ text";
+			ASSERT_TRUE(db.executeQuery("UPDATE `players` SET `name` = ?, `level` = ?, `balance` = ? WHERE `id` = ?", { quoted, 150, uint64_t { 1 } << 40, PLAYER_ID }));
+
+			const auto result = db.storeQuery("SELECT `name`, `level`, `balance` FROM `players` WHERE `id` = ?", { PLAYER_ID });
+			ASSERT_NE(nullptr, result);
+			EXPECT_EQ(quoted, result->getString("name"));
+			EXPECT_EQ(150u, result->getNumber<uint32_t>("level"));
+			EXPECT_EQ(uint64_t { 1 } << 40, result->getNumber<uint64_t>("balance"));
+			EXPECT_EQ("150", result->getString("level"));
+			EXPECT_FALSE(result->next());
+
+			EXPECT_EQ(nullptr, db.storeQuery("SELECT `name` FROM `players` WHERE `id` = ?", { PLAYER_ID + 1 }));
+			EXPECT_FALSE(db.executeQuery("SELECT `name` FROM `players` WHERE `id` = ?", {}));
+		})();
+	}
+
+	TEST_F(DatabaseStatementTest, BinaryResultMatchesText) {
+		auto &db = g_database();
+		databaseTest(db, [&db] {
+			ASSERT_TRUE(createPlayer(db));
+			ASSERT_TRUE(insertItems(db));
+
+			const auto text = db.storeQuery(fmt::format("SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_items` WHERE `player_id` = {} ORDER BY `sid` DESC", PLAYER_ID));
+			const auto binary = db.storeQuery("SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_items` WHERE `player_id` = ? ORDER BY `sid` DESC", { PLAYER_ID });
+			ASSERT_NE(nullptr, text);
+			ASSERT_NE(nullptr, binary);
+			ASSERT_EQ(ITEM_ROWS, text->countResults());
+			ASSERT_EQ(ITEM_ROWS, binary->countResults());
+
+			const auto attributesColumn = binary->getColumnIndex("attributes");
+			bool more;
+			do {
+				EXPECT_EQ(text->getNumber<uint32_t>("sid"), binary->getNumber<uint32_t>("sid"));
+				EXPECT_EQ(text->getNumber<uint32_t>("pid"), binary->getNumber<uint32_t>("pid"));
+				EXPECT_EQ(text->getNumber<uint16_t>("itemtype"), binary->getNumber<uint16_t>("itemtype"));
+				EXPECT_EQ(text->getNumber<uint16_t>("count"), binary->getNumber<uint16_t>("count"));
+
+				unsigned long textSize;
+				unsigned long binarySize;
+				const char* textBytes = text->getStream("attributes", textSize);
+				const char* binaryBytes = binary->getStream(attributesColumn, binarySize);
+				ASSERT_EQ(textSize, binarySize);
+				EXPECT_EQ(std::string(textBytes, textSize), std::string(binaryBytes, binarySize));
+				more = binary->next();
+				EXPECT_EQ(more, text->next());
+			} while (more);
+		})();
+	}
+
+}
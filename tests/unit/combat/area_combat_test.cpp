@@ -0,0 +1,56 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "creatures/combat/combat.hpp"
+#include "creatures/players/player.hpp"
+
+class AreaCombatTest : public ::testing::Test {
+protected:
+	static std::vector<std::pair<int32_t, int32_t>> cells(const std::vector<AreaOffset> &offsets) {
+		std::vector<std::pair<int32_t, int32_t>> result;
+		for (const auto &offset : offsets) {
+			result.emplace_back(offset.x, offset.y);
+		}
+		return result;
+	}
+
+	const Position center { 100, 100, 7 };
+};
+
+TEST_F(AreaCombatTest, BeamFollowsTheDirection) {
+	AreaCombat area;
+	area.setupArea(3, 0);
+
+	using Cells = std::vector<std::pair<int32_t, int32_t>>;
+	EXPECT_EQ((Cells { { 0, -2 }, { 0, -1 }, { 0, 0 } }), cells(area.getOffsets(center, { 100, 99, 7 })));
+	EXPECT_EQ((Cells { { 0, 0 }, { 1, 0 }, { 2, 0 } }), cells(area.getOffsets(center, { 101, 100, 7 })));
+	EXPECT_EQ((Cells { { 0, 0 }, { 0, 1 }, { 0, 2 } }), cells(area.getOffsets(center, { 100, 101, 7 })));
+	EXPECT_EQ((Cells { { -2, 0 }, { -1, 0 }, { 0, 0 } }), cells(area.getOffsets(center, { 99, 100, 7 })));
+	// On the caster itself, as runes are
+	EXPECT_EQ((Cells { { 0, 0 }, { 0, 1 }, { 0, 2 } }), cells(area.getOffsets(center, center)));
+}
+
+TEST_F(AreaCombatTest, DiagonalsUseTheExtendedArea) {
+	AreaCombat area;
+	area.setupArea({ 0, 1, 0, 1, 3, 1, 0, 1, 0 }, 3);
+	area.setupExtArea({ 1, 0, 0, 0, 1, 0, 0, 0, 3 }, 3);
+
+	using Cells = std::vector<std::pair<int32_t, int32_t>>;
+	EXPECT_EQ((Cells { { -2, -2 }, { -1, -1 }, { 0, 0 } }), cells(area.getOffsets(center, { 99, 99, 7 })));
+	EXPECT_EQ((Cells { { 0, 0 }, { 1, 1 }, { 2, 2 } }), cells(area.getOffsets(center, { 101, 101, 7 })));
+	EXPECT_EQ((Cells { { 0, -1 }, { -1, 0 }, { 0, 0 }, { 1, 0 }, { 0, 1 } }), cells(area.getOffsets(center, { 101, 100, 7 })));
+}
+
+TEST_F(AreaCombatTest, ClonesKeepTheOffsets) {
+	AreaCombat area;
+	area.setupArea(3);
+	const auto clone = area.clone();
+
+	EXPECT_EQ(std::size_t { 9 }, clone->getOffsets(center, center).size());
+	EXPECT_EQ(cells(area.getOffsets(center, center)), cells(clone->getOffsets(center, center)));
+
+	clone->clear();
+	EXPECT_TRUE(clone->getOffsets(center, center).empty());
+	EXPECT_EQ(std::size_t { 9 }, area.getOffsets(center, center).size());
+}
@@ -0,0 +1,63 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "creatures/combat/condition_scheduler.hpp"
+#include "creatures/creature.hpp"
+
+class ConditionSchedulerTest : public ::testing::Test {
+protected:
+	std::vector<uint32_t> takeDue(int64_t now) {
+		std::vector<uint32_t> due;
+		scheduler.takeDue(now, due);
+		return due;
+	}
+
+	ConditionScheduler scheduler;
+};
+
+TEST_F(ConditionSchedulerTest, CreaturesAreTakenWhenDue) {
+	scheduler.schedule(1, 10'500);
+	scheduler.schedule(2, 10'050);
+	scheduler.schedule(3, 12'000);
+
+	EXPECT_TRUE(takeDue(10'000).empty());
+	EXPECT_EQ((std::vector<uint32_t> { 2 }), takeDue(10'060));
+	EXPECT_EQ((std::vector<uint32_t> { 1 }), takeDue(11'000));
+	EXPECT_EQ(std::size_t { 1 }, scheduler.size());
+	EXPECT_EQ((std::vector<uint32_t> { 3 }), takeDue(15'000));
+	EXPECT_TRUE(takeDue(20'000).empty());
+	EXPECT_FALSE(scheduler.isScheduled(3));
+}
+
+TEST_F(ConditionSchedulerTest, SchedulingAgainReplacesTheTime) {
+	takeDue(10'000);
+	scheduler.schedule(1, 10'200);
+	scheduler.schedule(1, 13'000);
+	scheduler.schedule(2, 10'200);
+	scheduler.cancel(2);
+
+	EXPECT_TRUE(takeDue(12'000).empty());
+	EXPECT_EQ((std::vector<uint32_t> { 1 }), takeDue(13'000));
+
+	// Back to an earlier time, and to a time already past
+	scheduler.schedule(1, 20'000);
+	scheduler.schedule(1, 14'000);
+	scheduler.schedule(2, 5'000);
+	EXPECT_EQ((std::vector<uint32_t> { 2 }), takeDue(13'100));
+	EXPECT_EQ((std::vector<uint32_t> { 1 }), takeDue(20'000));
+}
+
+TEST_F(ConditionSchedulerTest, TimesPastTheWheelWaitForTheirTurn) {
+	constexpr int64_t turn = ConditionScheduler::BUCKET_INTERVAL * ConditionScheduler::BUCKETS;
+
+	takeDue(0);
+	scheduler.schedule(1, turn * 2 + 300);
+	EXPECT_TRUE(takeDue(turn + 300).empty());
+	EXPECT_TRUE(takeDue(turn * 2).empty());
+	EXPECT_EQ((std::vector<uint32_t> { 1 }), takeDue(turn * 2 + 300));
+
+	// A stall longer than a whole turn
+	scheduler.schedule(2, turn * 3);
+	EXPECT_EQ((std::vector<uint32_t> { 2 }), takeDue(turn * 10));
+}
@@ -0,0 +1,118 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "game/highscore_ranking.hpp"
+
+class HighscoreRankingTest : public ::testing::Test {
+protected:
+	static constexpr auto EXPERIENCE = static_cast<uint8_t>(HighscoreCategories_t::EXPERIENCE);
+	static constexpr auto FISHING = static_cast<uint8_t>(HighscoreCategories_t::FISHING);
+
+	static HighscoreRanking::Entry entry(uint32_t id, uint64_t experience, uint32_t baseVocation = 1) {
+		HighscoreRanking::Entry result;
+		result.id = id;
+		result.name = fmt::format("Player {}", id);
+		result.level = 8;
+		result.baseVocation = baseVocation;
+		result.points[0] = experience;
+		result.points[7] = id;
+		return result;
+	}
+
+	static std::vector<uint32_t> ids(const std::optional<HighscoreRanking::Page> &page) {
+		std::vector<uint32_t> result;
+		for (const auto &character : page->characters) {
+			result.emplace_back(character.id);
+		}
+		return result;
+	}
+
+	static std::vector<uint32_t> ranks(const std::optional<HighscoreRanking::Page> &page) {
+		std::vector<uint32_t> result;
+		for (const auto &character : page->characters) {
+			result.emplace_back(character.rank);
+		}
+		return result;
+	}
+
+	HighscoreRanking ranking;
+};
+
+TEST_F(HighscoreRankingTest, PagesAreSortedWithDenseRanks) {
+	ranking.update(entry(1, 100));
+	ranking.update(entry(2, 300));
+	ranking.update(entry(3, 300));
+	ranking.update(entry(4, 200));
+	ranking.update(entry(5, 50));
+	ranking.refresh();
+
+	const auto first = ranking.getPage(EXPERIENCE, HighscoreRanking::ALL_VOCATIONS, 1, 2);
+	ASSERT_TRUE(first.has_value());
+	EXPECT_EQ((std::vector<uint32_t> { 2, 3 }), ids(first));
+	EXPECT_EQ((std::vector<uint32_t> { 1, 1 }), ranks(first));
+	EXPECT_EQ(3, first->pages);
+
+	const auto last = ranking.getPage(EXPERIENCE, HighscoreRanking::ALL_VOCATIONS, 3, 2);
+	EXPECT_EQ((std::vector<uint32_t> { 5 }), ids(last));
+	EXPECT_EQ((std::vector<uint32_t> { 4 }), ranks(last));
+
+	EXPECT_FALSE(ranking.getPage(EXPERIENCE, HighscoreRanking::ALL_VOCATIONS, 4, 2).has_value());
+	EXPECT_FALSE(ranking.getPage(EXPERIENCE, HighscoreRanking::ALL_VOCATIONS, 0, 2).has_value());
+	EXPECT_EQ((std::vector<uint32_t> { 5, 4, 3, 2, 1 }), ids(ranking.getPage(FISHING, HighscoreRanking::ALL_VOCATIONS, 1, 5)));
+}
+
+TEST_F(HighscoreRankingTest, VocationsAreRankedApart) {
+	ranking.update(entry(1, 100, 1));
+	ranking.update(entry(2, 300, 2));
+	ranking.update(entry(3, 200, 1));
+	ranking.refresh();
+
+	const auto knights = ranking.getPage(EXPERIENCE, 1, 1, 10);
+	EXPECT_EQ((std::vector<uint32_t> { 3, 1 }), ids(knights));
+	EXPECT_EQ((std::vector<uint32_t> { 1, 2 }), ranks(knights));
+	EXPECT_FALSE(ranking.getPage(EXPERIENCE, 3, 1, 10).has_value());
+}
+
+TEST_F(HighscoreRankingTest, UpdatesMovePlayers) {
+	for (uint32_t id = 1; id <= 100; ++id) {
+		ranking.update(entry(id, id * 10));
+	}
+	ranking.refresh();
+
+	// Few enough changes to be applied in place
+	ranking.update(entry(1, 5000));
+	ranking.update(entry(50, 995));
+	ranking.remove(100);
+	ranking.refresh();
+
+	const auto first = ranking.getPage(EXPERIENCE, HighscoreRanking::ALL_VOCATIONS, 1, 3);
+	EXPECT_EQ((std::vector<uint32_t> { 1, 50, 99 }), ids(first));
+	EXPECT_EQ((std::vector<uint32_t> { 1, 2, 3 }), ranks(first));
+	EXPECT_EQ(33, first->pages);
+	EXPECT_EQ(std::size_t { 99 }, ranking.size());
+
+	const auto last = ranking.getPage(EXPERIENCE, HighscoreRanking::ALL_VOCATIONS, 33, 3);
+	EXPECT_EQ((std::vector<uint32_t> { 4, 3, 2 }), ids(last));
+	EXPECT_EQ((std::vector<uint32_t> { 97, 98, 99 }), ranks(last));
+}
+
+TEST_F(HighscoreRankingTest, PlayerPageHoldsThePlayer) {
+	for (uint32_t id = 1; id <= 10; ++id) {
+		ranking.update(entry(id, id * 10));
+	}
+	ranking.refresh();
+
+	const auto page = ranking.getPlayerPage(EXPERIENCE, HighscoreRanking::ALL_VOCATIONS, 3, 4);
+	ASSERT_TRUE(page.has_value());
+	EXPECT_EQ(2, page->page);
+	EXPECT_EQ((std::vector<uint32_t> { 6, 5, 4, 3 }), ids(page));
+
+	EXPECT_EQ(1, ranking.getPlayerPage(EXPERIENCE, HighscoreRanking::ALL_VOCATIONS, 42, 4)->page);
+}
+
+TEST_F(HighscoreRankingTest, UnrankedCategoriesFallBackToExperience) {
+	EXPECT_EQ(EXPERIENCE, HighscoreRanking::normalizeCategory(static_cast<uint8_t>(HighscoreCategories_t::CHARMS)));
+	EXPECT_EQ(FISHING, HighscoreRanking::normalizeCategory(FISHING));
+	EXPECT_EQ(static_cast<uint8_t>(HighscoreCategories_t::BOSS_POINTS), HighscoreRanking::normalizeCategory(static_cast<uint8_t>(HighscoreCategories_t::BOSS_POINTS)));
+}
@@ -0,0 +1,104 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "game/scheduling/timer_wheel.hpp"
+#include "utils/tools.hpp"
+
+namespace {
+	std::shared_ptr<Task> makeTask(uint32_t delay) {
+		return Task::create([] { }, "TimerWheelTest", delay);
+	}
+
+	std::vector<std::shared_ptr<Task>> drain(TimerWheel &wheel, int64_t now) {
+		std::vector<std::shared_ptr<Task>> fired;
+		wheel.advance(now);
+		while (auto task = wheel.popReady(now)) {
+			fired.emplace_back(std::move(task));
+		}
+		return fired;
+	}
+}
+
+class TimerWheelTest : public ::testing::Test {
+protected:
+	void SetUp() override {
+		now = OTSYS_TIME();
+		wheel.advance(now);
+	}
+
+	TimerWheel wheel;
+	int64_t now = 0;
+};
+
+TEST_F(TimerWheelTest, DoesNotFireBeforeTime) {
+	const auto task = makeTask(120);
+	wheel.insert(task);
+
+	EXPECT_TRUE(drain(wheel, task->getTime() - 1).empty());
+
+	const auto fired = drain(wheel, task->getTime());
+	ASSERT_EQ(1, fired.size());
+	EXPECT_EQ(task, fired.front());
+	EXPECT_TRUE(wheel.empty());
+}
+
+TEST_F(TimerWheelTest, FiresInTimeOrderWithinTheSameTick) {
+	const auto later = makeTask(49);
+	const auto sooner = makeTask(1);
+	wheel.insert(later);
+	wheel.insert(sooner);
+
+	const auto fired = drain(wheel, later->getTime());
+	ASSERT_EQ(2, fired.size());
+	EXPECT_EQ(sooner, fired[0]);
+	EXPECT_EQ(later, fired[1]);
+}
+
+TEST_F(TimerWheelTest, CascadesFarAwayTasks) {
+	// One task for every level of the wheel (seconds, minutes, hours and days)
+	const std::array<uint32_t, 4> delays { 5 * 1000, 10 * 60 * 1000, 5 * 60 * 60 * 1000, 3 * 24 * 60 * 60 * 1000 };
+	std::vector<std::shared_ptr<Task>> tasks;
+	for (const auto delay : delays) {
+		tasks.emplace_back(makeTask(delay));
+		wheel.insert(tasks.back());
+	}
+
+	for (const auto &task : tasks) {
+		EXPECT_TRUE(drain(wheel, task->getTime() - 1).empty());
+		const auto fired = drain(wheel, task->getTime());
+		ASSERT_EQ(1, fired.size());
+		EXPECT_EQ(task, fired.front());
+	}
+	EXPECT_TRUE(wheel.empty());
+}
+
+TEST_F(TimerWheelTest, CanceledTasksAreDropped) {
+	const auto canceled = makeTask(300);
+	const auto kept = makeTask(300);
+	wheel.insert(canceled);
+	wheel.insert(kept);
+	canceled->cancel();
+
+	const auto fired = drain(wheel, kept->getTime());
+	ASSERT_EQ(1, fired.size());
+	EXPECT_EQ(kept, fired.front());
+}
+
+TEST_F(TimerWheelTest, TimeUntilNextTaskNeverOversleeps) {
+	const auto task = makeTask(30 * 1000);
+	wheel.insert(task);
+
+	// Sleeps as the dispatcher would, it must wake up exactly when the task is due
+	auto current = now;
+	size_t fired = 0;
+	while (fired == 0) {
+		const auto sleep = wheel.timeUntilNextTask(current).count();
+		ASSERT_LE(current + sleep, task->getTime());
+		current += sleep;
+		fired = drain(wheel, current).size();
+	}
+
+	EXPECT_EQ(task->getTime(), current);
+	EXPECT_EQ(std::chrono::milliseconds::max(), wheel.timeUntilNextTask(current));
+}
@@ -0,0 +1,228 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "io/filestream.hpp"
+#include "io/io_definitions.hpp"
+#include "io/iomap.hpp"
+#include "io/iomapsnapshot.hpp"
+#include "items/item.hpp"
+#include "map/map.hpp"
+
+// Writes an OTBM file of square tile areas, each tile with a ground and a few items
+class IOMapTest : public ::testing::Test {
+protected:
+	static constexpr uint16_t FIRST_GROUND = 100;
+	static constexpr uint16_t GROUNDS = 8;
+	static constexpr uint16_t FIRST_ITEM = 200;
+	static constexpr uint16_t ITEMS = 40;
+	static constexpr uint8_t Z = 7;
+
+	static void SetUpTestSuite() {
+		auto &itemTypes = Item::items.getItems();
+		if (itemTypes.size() < FIRST_ITEM + ITEMS) {
+			itemTypes.resize(FIRST_ITEM + ITEMS);
+		}
+		for (uint16_t id = FIRST_GROUND; id < FIRST_GROUND + GROUNDS; ++id) {
+			itemTypes[id].id = id;
+			itemTypes[id].group = ITEM_GROUP_GROUND;
+		}
+		for (uint16_t id = FIRST_ITEM; id < FIRST_ITEM + ITEMS; ++id) {
+			itemTypes[id].id = id;
+		}
+	}
+
+	class Writer {
+	public:
+		void u8(uint8_t value) {
+			if (value == OTB::Node::ESCAPE || value == OTB::Node::START || value == OTB::Node::END) {
+				bytes.emplace_back(OTB::Node::ESCAPE);
+			}
+			bytes.emplace_back(value);
+		}
+		void u16(uint16_t value) {
+			u8(value & 0xFF);
+			u8(value >> 8);
+		}
+		void u32(uint32_t value) {
+			u16(value & 0xFFFF);
+			u16(value >> 16);
+		}
+		void start(uint8_t type) {
+			bytes.emplace_back(OTB::Node::START);
+			u8(type);
+		}
+		void end() {
+			bytes.emplace_back(OTB::Node::END);
+		}
+
+		std::vector<uint8_t> bytes { 'O', 'T', 'B', 'M' };
+	};
+
+	// Which items a tile has, the same at the same place of every area for the tiles to be shared
+	static std::pair<uint16_t, std::vector<uint16_t>> tileOf(uint16_t x, uint16_t y) {
+		x &= SECTOR_MASK;
+		y &= SECTOR_MASK;
+		const uint16_t ground = FIRST_GROUND + (x * 7 + y) % GROUNDS;
+		std::vector<uint16_t> items;
+		for (uint16_t i = 0; i < (x + y) % 3; ++i) {
+			items.emplace_back(FIRST_ITEM + (x * 13 + y * 5 + i) % ITEMS);
+		}
+		return { ground, items };
+	}
+
+	static std::string writeMap(uint16_t areasPerSide) {
+		Writer writer;
+		writer.start(0);
+		writer.u32(2);
+		writer.u16(areasPerSide * 256);
+		writer.u16(areasPerSide * 256);
+		writer.u32(3);
+		writer.u32(0);
+
+		writer.start(OTBM_MAP_DATA);
+		for (uint16_t areaX = 0; areaX < areasPerSide; ++areaX) {
+			for (uint16_t areaY = 0; areaY < areasPerSide; ++areaY) {
+				writer.start(OTBM_TILE_AREA);
+				writer.u16(areaX * 256);
+				writer.u16(areaY * 256);
+				writer.u8(Z);
+				for (uint16_t x = 0; x < 16; ++x) {
+					for (uint16_t y = 0; y < 16; ++y) {
+						const auto &[ground, items] = tileOf(areaX * 256 + x, areaY * 256 + y);
+						writer.start(OTBM_TILE);
+						writer.u8(x);
+						writer.u8(y);
+						writer.u8(OTBM_ATTR_ITEM);
+						writer.u16(ground);
+						for (const auto item : items) {
+							writer.start(OTBM_ITEM);
+							writer.u16(item);
+							writer.u8(OTBM_ATTR_COUNT);
+							writer.u8(1);
+							writer.end();
+						}
+						writer.end();
+					}
+				}
+				writer.end();
+			}
+		}
+		writer.end();
+
+		writer.start(OTBM_TOWNS);
+		writer.end();
+		writer.start(OTBM_WAYPOINTS);
+		writer.end();
+		writer.end();
+
+		const auto path = (std::filesystem::temp_directory_path() / fmt::format("iomap_test_{}.otbm", areasPerSide)).string();
+		std::ofstream file(path, std::ios::binary);
+		file.write(reinterpret_cast<const char*>(writer.bytes.data()), static_cast<std::streamsize>(writer.bytes.size()));
+		return path;
+	}
+
+	static std::shared_ptr<BasicTile> cachedTile(const Map &map, uint16_t x, uint16_t y) {
+		const auto sector = map.getMapSector(x, y);
+		if (!sector || !sector->getFloor(Z)) {
+			return nullptr;
+		}
+		return sector->getFloor(Z)->getTileCache(x, y);
+	}
+};
+
+TEST_F(IOMapTest, AreasDecodedApartAreSharedIntoTheMap) {
+	constexpr uint16_t areasPerSide = 6;
+	const auto path = writeMap(areasPerSide);
+	const auto map = std::make_unique<Map>();
+	map->load(path);
+
+	for (uint16_t areaX = 0; areaX < areasPerSide; ++areaX) {
+		for (uint16_t areaY = 0; areaY < areasPerSide; ++areaY) {
+			for (uint16_t x = areaX * 256; x < areaX * 256 + 16; x += 5) {
+				for (uint16_t y = areaY * 256; y < areaY * 256 + 16; y += 3) {
+					const auto tile = cachedTile(*map, x, y);
+					ASSERT_NE(nullptr, tile);
+					const auto &[ground, items] = tileOf(x, y);
+					ASSERT_NE(nullptr, tile->ground);
+					EXPECT_EQ(ground, tile->ground->id);
+					ASSERT_EQ(items.size(), tile->items.size());
+					for (size_t i = 0; i < items.size(); ++i) {
+						EXPECT_EQ(items[i], tile->items[i]->id);
+						EXPECT_EQ(1, tile->items[i]->charges);
+					}
+				}
+			}
+		}
+	}
+
+	// Equal tiles of areas far apart, likely decoded by different threads, are the same one
+	const auto first = cachedTile(*map, 4, 9);
+	const auto last = cachedTile(*map, (areasPerSide - 1) * 256 + 4, (areasPerSide - 1) * 256 + 9);
+	ASSERT_NE(nullptr, first);
+	EXPECT_EQ(first, last);
+	EXPECT_EQ(nullptr, cachedTile(*map, 16, 16));
+
+	std::filesystem::remove(path);
+}
+
+TEST_F(IOMapTest, SnapshotLoadsTheMapAsReadFromTheFile) {
+	constexpr uint16_t areasPerSide = 4;
+	const auto path = writeMap(areasPerSide);
+	const auto snapshotPath = IOMapSnapshot::getPath(path);
+	std::filesystem::remove(snapshotPath);
+
+	const auto read = std::make_unique<Map>();
+	read->load(path, Position(), true);
+	ASSERT_TRUE(std::filesystem::exists(snapshotPath));
+
+	const auto loaded = std::make_unique<Map>();
+	loaded->load(path, Position(), true);
+
+	for (uint16_t x = 0; x < areasPerSide * 256; x += 7) {
+		for (uint16_t y = 0; y < areasPerSide * 256; y += 3) {
+			const auto readTile = cachedTile(*read, x, y);
+			const auto loadedTile = cachedTile(*loaded, x, y);
+			ASSERT_EQ(readTile == nullptr, loadedTile == nullptr);
+			if (!readTile) {
+				continue;
+			}
+			EXPECT_EQ(readTile->hash(), loadedTile->hash());
+			ASSERT_NE(nullptr, loadedTile->ground);
+			EXPECT_EQ(readTile->ground->id, loadedTile->ground->id);
+			ASSERT_EQ(readTile->items.size(), loadedTile->items.size());
+			for (size_t i = 0; i < readTile->items.size(); ++i) {
+				EXPECT_EQ(readTile->items[i]->id, loadedTile->items[i]->id);
+				EXPECT_EQ(readTile->items[i]->charges, loadedTile->items[i]->charges);
+			}
+		}
+	}
+
+	// Equal tiles stay shared
+	EXPECT_EQ(cachedTile(*loaded, 4, 9), cachedTile(*loaded, (areasPerSide - 1) * 256 + 4, (areasPerSide - 1) * 256 + 9));
+
+	std::filesystem::remove(snapshotPath);
+	std::filesystem::remove(path);
+}
+
+TEST_F(IOMapTest, SnapshotIsCompiledAgainWhenTheMapChanges) {
+	const auto path = writeMap(2);
+	const auto snapshotPath = IOMapSnapshot::getPath(path);
+	std::filesystem::remove(snapshotPath);
+	std::make_unique<Map>()->load(path, Position(), true);
+	ASSERT_TRUE(std::filesystem::exists(snapshotPath));
+
+	// The same file grown by a row and a column of areas
+	std::filesystem::rename(writeMap(3), path);
+	const auto grown = std::make_unique<Map>();
+	grown->load(path, Position(), true);
+	EXPECT_NE(nullptr, cachedTile(*grown, 2 * 256 + 4, 2 * 256 + 9));
+
+	// And the snapshot now holds it
+	const auto loaded = std::make_unique<Map>();
+	loaded->load(path, Position(), true);
+	EXPECT_NE(nullptr, cachedTile(*loaded, 2 * 256 + 4, 2 * 256 + 9));
+
+	std::filesystem::remove(snapshotPath);
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,103 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "io/market_order_book.hpp"
+
+class MarketOrderBookTest : public ::testing::Test {
+protected:
+	static MarketOrder order(uint32_t id, MarketAction_t side, uint64_t price, uint32_t created = 1000, uint32_t playerId = 1, uint16_t itemId = 3031, uint8_t tier = 0) {
+		MarketOrder result;
+		result.id = id;
+		result.playerId = playerId;
+		result.side = side;
+		result.price = price;
+		result.created = created;
+		result.amount = 10;
+		result.itemId = itemId;
+		result.tier = tier;
+		result.playerName = fmt::format("Player {}", playerId);
+		return result;
+	}
+
+	static std::vector<uint32_t> ids(const std::vector<MarketOrder> &orders) {
+		std::vector<uint32_t> result;
+		for (const auto &entry : orders) {
+			result.emplace_back(entry.id);
+		}
+		return result;
+	}
+
+	MarketOrderBook book;
+};
+
+TEST_F(MarketOrderBookTest, SidesAreSortedByBestPrice) {
+	book.add(order(1, MARKETACTION_SELL, 300));
+	book.add(order(2, MARKETACTION_SELL, 100));
+	book.add(order(3, MARKETACTION_SELL, 200));
+	book.add(order(4, MARKETACTION_SELL, 100));
+	book.add(order(5, MARKETACTION_BUY, 50));
+	book.add(order(6, MARKETACTION_BUY, 90));
+	book.add(order(7, MARKETACTION_BUY, 70, 1000, 1, 3031, 1));
+
+	EXPECT_EQ((std::vector<uint32_t> { 2, 4, 3, 1 }), ids(book.getOrders(MARKETACTION_SELL, 3031, 0)));
+	EXPECT_EQ((std::vector<uint32_t> { 6, 5 }), ids(book.getOrders(MARKETACTION_BUY, 3031, 0)));
+	EXPECT_EQ((std::vector<uint32_t> { 7 }), ids(book.getOrders(MARKETACTION_BUY, 3031, 1)));
+	EXPECT_TRUE(book.getOrders(MARKETACTION_BUY, 3035, 0).empty());
+	EXPECT_EQ(std::size_t { 3 }, book.getOrders(MARKETACTION_BUY).size());
+}
+
+TEST_F(MarketOrderBookTest, OffersAreFoundByCounter) {
+	const auto offer = order(42, MARKETACTION_SELL, 100, 5000);
+	book.add(offer);
+
+	const auto found = book.getByCounter(5000, offer.getCounter());
+	ASSERT_TRUE(found.has_value());
+	EXPECT_EQ(42u, found->id);
+	EXPECT_FALSE(book.getByCounter(5001, offer.getCounter()).has_value());
+
+	// Same counter, 65536 ids later, in another second
+	book.add(order(42 + 65536, MARKETACTION_SELL, 100, 6000));
+	EXPECT_EQ(42u + 65536, book.getByCounter(6000, offer.getCounter())->id);
+
+	book.remove(42);
+	EXPECT_FALSE(book.getByCounter(5000, offer.getCounter()).has_value());
+	EXPECT_TRUE(book.getByCounter(6000, offer.getCounter()).has_value());
+}
+
+TEST_F(MarketOrderBookTest, AcceptingReducesTheAmount) {
+	book.add(order(1, MARKETACTION_SELL, 100));
+	EXPECT_TRUE(book.reduce(1, 4));
+	EXPECT_EQ(6, book.get(1)->amount);
+	EXPECT_FALSE(book.reduce(1, 7));
+	EXPECT_FALSE(book.reduce(2, 1));
+	EXPECT_TRUE(book.reduce(1, 6));
+	EXPECT_EQ(0, book.get(1)->amount);
+}
+
+TEST_F(MarketOrderBookTest, PlayerOrdersAreCounted) {
+	book.add(order(1, MARKETACTION_SELL, 100, 1000, 7));
+	book.add(order(2, MARKETACTION_BUY, 100, 1000, 7, 3035));
+	book.add(order(3, MARKETACTION_SELL, 100, 1000, 8));
+
+	EXPECT_EQ(std::size_t { 2 }, book.countPlayerOrders(7));
+	EXPECT_EQ((std::vector<uint32_t> { 1 }), ids(book.getPlayerOrders(MARKETACTION_SELL, 7)));
+	EXPECT_EQ((std::vector<uint32_t> { 2 }), ids(book.getPlayerOrders(MARKETACTION_BUY, 7)));
+
+	ASSERT_TRUE(book.remove(1).has_value());
+	EXPECT_FALSE(book.remove(1).has_value());
+	EXPECT_EQ(std::size_t { 1 }, book.countPlayerOrders(7));
+	EXPECT_EQ(std::size_t { 0 }, book.countPlayerOrders(9));
+}
+
+TEST_F(MarketOrderBookTest, ExpiredOffersAreTakenOldestFirst) {
+	book.add(order(1, MARKETACTION_SELL, 100, 3000));
+	book.add(order(2, MARKETACTION_BUY, 100, 1000));
+	book.add(order(3, MARKETACTION_SELL, 100, 2000));
+
+	EXPECT_EQ((std::vector<uint32_t> { 2, 3 }), ids(book.takeExpired(2000)));
+	EXPECT_EQ(std::size_t { 1 }, book.size());
+	EXPECT_TRUE(book.getOrders(MARKETACTION_BUY, 3031, 0).empty());
+	EXPECT_TRUE(book.takeExpired(2999).empty());
+	EXPECT_EQ(1u, book.getMaxId());
+}
@@ -0,0 +1,116 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "kv/kv.hpp"
+#include "lib/logging/in_memory_logger.hpp"
+
+// A store over a map, counting what reaches the backend
+class BackedKV final : public KVStore {
+public:
+	explicit BackedKV(Logger &logger) :
+		KVStore(logger) { }
+
+	std::map<std::string, ValueWrapper> stored;
+	size_t loads = 0;
+	size_t prefixLoads = 0;
+	std::vector<size_t> batches;
+
+protected:
+	std::vector<std::string> loadPrefix(const std::string &prefix = "") override {
+		std::vector<std::string> keys;
+		for (const auto &[key, value] : stored) {
+			if (key.starts_with(prefix)) {
+				keys.emplace_back(key.substr(prefix.size()));
+			}
+		}
+		return keys;
+	}
+
+	std::vector<std::pair<std::string, ValueWrapper>> loadPrefixValues(const std::string &prefix) override {
+		++prefixLoads;
+		std::vector<std::pair<std::string, ValueWrapper>> values;
+		for (const auto &[key, value] : stored) {
+			if (key.starts_with(prefix)) {
+				values.emplace_back(key, value);
+			}
+		}
+		return values;
+	}
+
+	std::optional<ValueWrapper> load(const std::string &key) override {
+		++loads;
+		const auto it = stored.find(key);
+		if (it == stored.end()) {
+			return std::nullopt;
+		}
+		return it->second;
+	}
+
+	bool save(const std::string &key, const ValueWrapper &value) override {
+		if (value.isDeleted()) {
+			stored.erase(key);
+		} else {
+			stored.insert_or_assign(key, value);
+		}
+		return true;
+	}
+
+	bool saveBatch(const std::vector<std::pair<std::string, ValueWrapper>> &values) override {
+		batches.emplace_back(values.size());
+		return KVStore::saveBatch(values);
+	}
+};
+
+class KVStoreTest : public ::testing::Test {
+protected:
+	InMemoryLogger logger;
+	BackedKV kv { logger };
+};
+
+TEST_F(KVStoreTest, SaveAllWritesOnlyChangedValuesInOneBatch) {
+	kv.stored.insert_or_assign("loaded", ValueWrapper(1));
+	kv.stored.insert_or_assign("removed", ValueWrapper(2));
+	ASSERT_TRUE(kv.get("loaded").has_value());
+
+	kv.set("key1", 1);
+	kv.set("key2", 2);
+	kv.remove("removed");
+	EXPECT_TRUE(kv.saveAll());
+	EXPECT_EQ((std::vector<size_t> { 3 }), kv.batches);
+	EXPECT_EQ(2, kv.stored.at("key2").get<int>());
+	EXPECT_FALSE(kv.stored.contains("removed"));
+
+	// Nothing changed since
+	EXPECT_TRUE(kv.saveAll());
+	EXPECT_EQ(std::size_t { 1 }, kv.batches.size());
+}
+
+TEST_F(KVStoreTest, PrefetchLoadsAScopeInOneGo) {
+	kv.stored.insert_or_assign("player.1.mount", ValueWrapper(10));
+	kv.stored.insert_or_assign("player.1.outfit", ValueWrapper(20));
+	kv.stored.insert_or_assign("player.10.mount", ValueWrapper(30));
+
+	auto player = kv.scoped("player")->scoped("1");
+	player->set("outfit", 21);
+	player->prefetch();
+	EXPECT_EQ(std::size_t { 1 }, kv.prefixLoads);
+
+	EXPECT_EQ(10, player->get("mount")->get<int>());
+	// Changed before the prefetch, kept
+	EXPECT_EQ(21, player->get("outfit")->get<int>());
+	EXPECT_EQ(std::size_t { 0 }, kv.loads);
+
+	// Outside of the scope, still loaded on its own
+	EXPECT_EQ(30, kv.get("player.10.mount")->get<int>());
+	EXPECT_EQ(std::size_t { 1 }, kv.loads);
+}
+
+TEST_F(KVStoreTest, FlushWritesAndDropsTheCache) {
+	kv.set("key1", 1);
+	kv.flush();
+	EXPECT_EQ(1, kv.stored.at("key1").get<int>());
+
+	kv.stored.insert_or_assign("key1", ValueWrapper(2));
+	EXPECT_EQ(2, kv.get("key1")->get<int>());
+}
@@ -0,0 +1,76 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "lib/logging/in_memory_logger.hpp"
+#include "lib/thread/task_graph.hpp"
+#include "lib/thread/thread_pool.hpp"
+
+class TaskGraphTest : public ::testing::Test {
+protected:
+	InMemoryLogger logger;
+	ThreadPool threadPool { logger, 4 };
+};
+
+TEST_F(TaskGraphTest, TasksRunAfterTheirDependencies) {
+	std::mutex mutex;
+	std::vector<std::string> order;
+	const auto record = [&](const std::string &name) {
+		return [&, name] {
+			std::scoped_lock lock(mutex);
+			order.emplace_back(name);
+		};
+	};
+
+	TaskGraph graph(threadPool);
+	graph.add("appearances", record("appearances"));
+	graph.add("vocations", record("vocations"));
+	graph.add("items", record("items"), { "appearances" });
+	graph.add("map", record("map"), { "items" });
+	graph.addOnCaller("scripts", record("scripts"), { "items", "vocations" });
+	graph.run();
+
+	const auto position = [&order](const std::string &name) {
+		return std::ranges::find(order, name) - order.begin();
+	};
+	ASSERT_EQ(std::size_t { 5 }, order.size());
+	EXPECT_LT(position("appearances"), position("items"));
+	EXPECT_LT(position("items"), position("map"));
+	EXPECT_LT(position("items"), position("scripts"));
+	EXPECT_LT(position("vocations"), position("scripts"));
+	EXPECT_EQ(std::size_t { 5 }, graph.getTimings().size());
+}
+
+TEST_F(TaskGraphTest, CallerTasksRunOnTheCallingThread) {
+	const auto caller = std::this_thread::get_id();
+	std::thread::id poolThread;
+	std::vector<std::thread::id> callerThreads;
+
+	TaskGraph graph(threadPool);
+	graph.add("pool", [&poolThread] { poolThread = std::this_thread::get_id(); });
+	graph.addOnCaller("first", [&callerThreads] { callerThreads.emplace_back(std::this_thread::get_id()); });
+	graph.addOnCaller("second", [&callerThreads] { callerThreads.emplace_back(std::this_thread::get_id()); }, { "first", "pool" });
+	graph.run();
+
+	EXPECT_NE(caller, poolThread);
+	EXPECT_EQ((std::vector<std::thread::id> { caller, caller }), callerThreads);
+}
+
+TEST_F(TaskGraphTest, FailureStopsTheDependentsAndIsRethrown) {
+	std::atomic<bool> dependentRan = false;
+	std::atomic<bool> independentRan = false;
+
+	TaskGraph graph(threadPool);
+	graph.add("failing", [] { throw std::runtime_error("cannot load"); });
+	graph.addOnCaller("dependent", [&dependentRan] { dependentRan = true; }, { "failing" });
+	graph.add("independent", [&independentRan] { independentRan = true; });
+
+	EXPECT_THROW(graph.run(), std::runtime_error);
+	EXPECT_FALSE(dependentRan);
+	EXPECT_TRUE(independentRan);
+}
+
+TEST_F(TaskGraphTest, DependenciesMustBeAddedFirst) {
+	TaskGraph graph(threadPool);
+	EXPECT_THROW(graph.add("items", [] { }, { "appearances" }), std::invalid_argument);
+}
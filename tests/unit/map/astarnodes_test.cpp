@@ -0,0 +1,117 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "creatures/creature.hpp"
+#include "map/map.hpp"
+#include "map/utils/astarnodes.hpp"
+#include "utils/tools.hpp"
+
+class AStarNodesTest : public ::testing::Test {
+protected:
+	static constexpr uint16_t BASE = 1000;
+	static constexpr uint16_t AREA = 96;
+	static constexpr uint8_t Z = 7;
+
+	// Serpentine west of the cave, each wall leaves a gap at alternating ends
+	static constexpr uint16_t SERPENTINE_WALLS = 8;
+	static constexpr uint16_t SERPENTINE_HEIGHT = 24;
+
+	void SetUp() override {
+		map = std::make_unique<Map>();
+
+		std::mt19937 rng(42);
+		std::bernoulli_distribution rock(0.18);
+		for (uint16_t x = BASE; x < BASE + AREA; ++x) {
+			for (uint16_t y = BASE; y < BASE + AREA; ++y) {
+				if (isSerpentineWall(x, y) || (x >= BASE + SERPENTINE_WALLS * 4 + 4 && rock(rng))) {
+					continue;
+				}
+				map->getOrCreateTile(x, y, Z);
+			}
+		}
+	}
+
+	static bool isSerpentineWall(uint16_t x, uint16_t y) {
+		const auto column = x - BASE;
+		const auto row = y - BASE;
+		if (column == 0 || column % 4 != 0 || column > SERPENTINE_WALLS * 4 || row > SERPENTINE_HEIGHT) {
+			return row == SERPENTINE_HEIGHT + 1 && column <= SERPENTINE_WALLS * 4;
+		}
+		// Odd walls are open at the top, even ones at the bottom
+		return (column / 4) % 2 == 0 ? row < SERPENTINE_HEIGHT : row > 0;
+	}
+
+	bool findPath(const Position &start, const Position &target, int32_t maxNodes, std::vector<Direction> &dirList) const {
+		FindPathParams fpp;
+		fpp.clearSight = false;
+		fpp.minTargetDist = 1;
+		fpp.maxTargetDist = 1;
+		fpp.maxNodes = maxNodes;
+		dirList.clear();
+		return map->getPathMatching(start, dirList, FrozenPathingConditionCall(target), fpp);
+	}
+
+	// Start and target pairs across the cave, at most 10 tiles apart as monsters usually chase
+	std::vector<std::pair<Position, Position>> cavePairs(size_t amount) const {
+		std::mt19937 rng(7);
+		std::uniform_int_distribution<uint16_t> coords(BASE + SERPENTINE_WALLS * 4 + 16, BASE + AREA - 16);
+		std::uniform_int_distribution<int32_t> offsets(-10, 10);
+		std::vector<std::pair<Position, Position>> pairs;
+		while (pairs.size() < amount) {
+			const Position start(coords(rng), coords(rng), Z);
+			const Position target(start.x + offsets(rng), start.y + offsets(rng), Z);
+			if (map->getTileRaw(start) && map->getTileRaw(target) && Position::getDiagonalDistance(start, target) > 1) {
+				pairs.emplace_back(start, target);
+			}
+		}
+		return pairs;
+	}
+
+	std::unique_ptr<Map> map;
+
+	const Position serpentineStart { BASE + 1, BASE + SERPENTINE_HEIGHT, Z };
+	const Position serpentineEnd { BASE + SERPENTINE_WALLS * 4 + 2, BASE + SERPENTINE_HEIGHT, Z };
+};
+
+TEST_F(AStarNodesTest, HeapAndScanFindTheSameTargets) {
+	static_assert(AStarNodes::DEFAULT_MAX_NODES * 8 > AStarNodes::MAX_SCAN_NODES);
+
+	std::vector<Direction> scanPath;
+	std::vector<Direction> heapPath;
+	for (const auto &[start, target] : cavePairs(200)) {
+		const bool scanFound = findPath(start, target, AStarNodes::DEFAULT_MAX_NODES, scanPath);
+		const bool heapFound = findPath(start, target, AStarNodes::DEFAULT_MAX_NODES * 8, heapPath);
+		// The larger budget can only find more
+		EXPECT_TRUE(heapFound || !scanFound);
+		if (!heapFound) {
+			continue;
+		}
+
+		Position pos = start;
+		for (const auto dir : heapPath | std::views::reverse) {
+			pos = getNextPosition(dir, pos);
+			ASSERT_NE(nullptr, map->getTileRaw(pos));
+		}
+		EXPECT_EQ(1, Position::getDiagonalDistance(pos, target));
+	}
+}
+
+TEST_F(AStarNodesTest, LargerBudgetFindsLongPaths) {
+	std::vector<Direction> dirList;
+	EXPECT_FALSE(findPath(serpentineStart, serpentineEnd, AStarNodes::DEFAULT_MAX_NODES, dirList));
+
+	ASSERT_TRUE(findPath(serpentineStart, serpentineEnd, 32768, dirList));
+	EXPECT_GE(dirList.size(), SERPENTINE_WALLS * (SERPENTINE_HEIGHT - 1));
+}
+
+TEST_F(AStarNodesTest, NestedSearchesGetTheirOwnNodes) {
+	AStarNodes outer(BASE, BASE, 0);
+	ASSERT_TRUE(outer.createOpenNode(outer.getBestNode(), BASE + 1, BASE, 10, 0, 0));
+	{
+		AStarNodes inner(BASE + 50, BASE + 50, 0);
+		EXPECT_EQ(nullptr, inner.getNodeByPosition(BASE + 1, BASE));
+		EXPECT_NE(nullptr, inner.getNodeByPosition(BASE + 50, BASE + 50));
+	}
+	EXPECT_NE(nullptr, outer.getNodeByPosition(BASE + 1, BASE));
+}
@@ -0,0 +1,138 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "creatures/creature.hpp"
+#include "map/map.hpp"
+#include "map/utils/flowfield.hpp"
+#include "utils/tools.hpp"
+
+class FlowFieldTest : public ::testing::Test {
+protected:
+	static constexpr uint16_t BASE = 1000;
+	static constexpr uint16_t AREA = 64;
+	static constexpr uint8_t Z = 7;
+	static constexpr Position TARGET { BASE + AREA / 2, BASE + AREA / 2, Z };
+
+	void SetUp() override {
+		map = std::make_unique<Map>();
+		for (uint16_t x = BASE; x < BASE + AREA; ++x) {
+			for (uint16_t y = BASE; y < BASE + AREA; ++y) {
+				// A wall west of the target, with a single gap at its south end
+				if (x == TARGET.x - 3 && y >= TARGET.y - 6 && y < TARGET.y + 6) {
+					continue;
+				}
+				map->getOrCreateTile(x, y, Z);
+			}
+		}
+	}
+
+	// Missing tiles are the obstacles, as for the creature-less A* search
+	bool isWalkable(const Position &pos) const {
+		return map->getTileRaw(pos) != nullptr;
+	}
+
+	FlowField::WalkableFunction walkable() const {
+		return [this](const Position &pos) { return isWalkable(pos); };
+	}
+
+	static Position walk(Position pos, const std::vector<Direction> &dirList) {
+		for (const auto dir : dirList | std::views::reverse) {
+			pos = getNextPosition(dir, pos);
+		}
+		return pos;
+	}
+
+	std::unique_ptr<Map> map;
+};
+
+TEST_F(FlowFieldTest, DistancesGoAroundObstacles) {
+	const FlowField field(TARGET, walkable());
+
+	EXPECT_EQ(0, field.getDistance(TARGET));
+	EXPECT_EQ(1, field.getDistance(Position(TARGET.x + 1, TARGET.y + 1, Z)));
+	EXPECT_EQ(2, field.getDistance(Position(TARGET.x, TARGET.y - 2, Z)));
+	EXPECT_EQ(FlowField::UNREACHABLE, field.getDistance(Position(TARGET.x - 3, TARGET.y, Z)));
+	EXPECT_EQ(FlowField::UNREACHABLE, field.getDistance(Position(TARGET.x + FlowField::RADIUS + 1, TARGET.y, Z)));
+	EXPECT_EQ(FlowField::UNREACHABLE, field.getDistance(Position(TARGET.x, TARGET.y, Z + 1)));
+
+	// Right behind the wall, it has to walk down to the gap and back up
+	const Position behindWall(TARGET.x - 4, TARGET.y, Z);
+	EXPECT_GT(field.getDistance(behindWall), 4);
+	EXPECT_NE(FlowField::UNREACHABLE, field.getDistance(behindWall));
+}
+
+TEST_F(FlowFieldTest, PathReachesTheTarget) {
+	const FlowField field(TARGET, walkable());
+	const auto canWalk = walkable();
+
+	const Position start(TARGET.x - 4, TARGET.y - 2, Z);
+	std::vector<Direction> dirList;
+	ASSERT_TRUE(field.getPath(start, 1, dirList, canWalk));
+	EXPECT_EQ(field.getDistance(start) - 1, dirList.size());
+
+	Position pos = start;
+	for (const auto dir : dirList | std::views::reverse) {
+		pos = getNextPosition(dir, pos);
+		EXPECT_TRUE(isWalkable(pos));
+	}
+	EXPECT_EQ(1, field.getDistance(pos));
+
+	// Already in range or out of the field, the caller falls back to its own search
+	dirList.clear();
+	EXPECT_FALSE(field.getPath(Position(TARGET.x + 1, TARGET.y, Z), 1, dirList, canWalk));
+	EXPECT_FALSE(field.getPath(Position(TARGET.x + FlowField::RADIUS + 2, TARGET.y, Z), 1, dirList, canWalk));
+	EXPECT_TRUE(dirList.empty());
+}
+
+TEST_F(FlowFieldTest, FirstStepAvoidsTakenTiles) {
+	const FlowField field(TARGET, walkable());
+
+	const Position start(TARGET.x + 3, TARGET.y, Z);
+	const Position taken(TARGET.x + 2, TARGET.y, Z);
+	std::vector<Direction> dirList;
+	ASSERT_TRUE(field.getPath(start, 1, dirList, [&](const Position &pos) { return pos != taken; }));
+	EXPECT_NE(taken, getNextPosition(dirList.back(), start));
+	EXPECT_EQ(1, field.getDistance(walk(start, dirList)));
+}
+
+TEST_F(FlowFieldTest, CacheRebuildsOnMoveAndInvalidation) {
+	FlowFieldCache cache;
+	constexpr uint32_t targetId = 0x10000001;
+
+	const auto first = cache.get(targetId, TARGET, walkable());
+	EXPECT_EQ(first, cache.get(targetId, TARGET, walkable()));
+	EXPECT_EQ(1, cache.size());
+
+	const Position moved(TARGET.x + 1, TARGET.y, Z);
+	const auto second = cache.get(targetId, moved, walkable());
+	EXPECT_NE(first, second);
+	EXPECT_EQ(moved, second->getTarget());
+	EXPECT_EQ(1, cache.size());
+
+	// Changes out of the field are ignored
+	cache.invalidate(Position(TARGET.x + FlowField::RADIUS * 3, TARGET.y, Z));
+	EXPECT_EQ(1, cache.size());
+
+	cache.invalidate(Position(TARGET.x - 3, TARGET.y, Z));
+	EXPECT_EQ(0, cache.size());
+	EXPECT_NE(second, cache.get(targetId, moved, walkable()));
+}
+
+TEST_F(FlowFieldTest, CacheIsInvalidatedWhileBuilding) {
+	FlowFieldCache cache;
+	constexpr uint32_t targetId = 0x10000001;
+
+	// Reading a tile may create it, which invalidates the cache from the thread building the field
+	const auto field = cache.get(targetId, TARGET, [&](const Position &pos) {
+		cache.invalidate(pos);
+		return isWalkable(pos);
+	});
+	ASSERT_NE(nullptr, field);
+	EXPECT_EQ(TARGET, field->getTarget());
+	EXPECT_EQ(0, cache.size());
+
+	const auto kept = cache.get(targetId, TARGET, walkable());
+	EXPECT_EQ(1, cache.size());
+	EXPECT_EQ(kept, cache.get(targetId, TARGET, walkable()));
+}
@@ -0,0 +1,30 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "items/tile.hpp"
+#include "map/map.hpp"
+
+class MapDescriptionTest : public ::testing::Test {
+protected:
+	static constexpr uint16_t BASE = 1000;
+
+	void SetUp() override {
+		map = std::make_unique<Map>();
+		map->getOrCreateTile(BASE, BASE, 7);
+	}
+
+	std::unique_ptr<Map> map;
+};
+
+TEST_F(MapDescriptionTest, EncodingIsDroppedWhenTheTileChanges) {
+	const auto tile = map->getTile(BASE, BASE, 7);
+	ASSERT_NE(nullptr, tile);
+	EXPECT_EQ(nullptr, tile->getItemEncoding());
+
+	tile->setItemEncoding(std::make_unique<TileItemEncoding>());
+	EXPECT_NE(nullptr, tile->getItemEncoding());
+
+	tile->setGround(nullptr);
+	EXPECT_EQ(nullptr, tile->getItemEncoding());
+}
@@ -0,0 +1,38 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "items/tile.hpp"
+#include "map/map.hpp"
+
+class MapTileTest : public ::testing::Test {
+protected:
+	static constexpr uint16_t BASE = 1000;
+	static constexpr uint16_t AREA = 64;
+	static constexpr uint8_t Z = 7;
+
+	void SetUp() override {
+		map = std::make_unique<Map>();
+		for (uint16_t x = BASE; x < BASE + AREA; ++x) {
+			for (uint16_t y = BASE; y < BASE + AREA; ++y) {
+				map->getOrCreateTile(x, y, Z);
+			}
+		}
+	}
+
+	std::unique_ptr<Map> map;
+};
+
+TEST_F(MapTileTest, RawReadMatchesSharedRead) {
+	for (uint16_t x = BASE; x < BASE + AREA; x += 7) {
+		for (uint16_t y = BASE; y < BASE + AREA; y += 5) {
+			const auto tile = map->getTile(x, y, Z);
+			ASSERT_NE(nullptr, tile);
+			EXPECT_EQ(tile.get(), map->getTileRaw(x, y, Z));
+			EXPECT_EQ(Position(x, y, Z), tile->getPosition());
+		}
+	}
+
+	EXPECT_EQ(nullptr, map->getTileRaw(BASE, BASE, Z + 1));
+	EXPECT_EQ(nullptr, map->getTileRaw(BASE + AREA * 2, BASE, Z));
+}
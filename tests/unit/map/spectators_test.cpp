@@ -0,0 +1,74 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "creatures/players/player.hpp"
+#include "map/spectators.hpp"
+
+class SpectatorsTest : public ::testing::Test {
+protected:
+	void SetUp() override {
+		for (size_t i = 0; i < 48; ++i) {
+			players.emplace_back(std::make_shared<Player>());
+		}
+	}
+
+	Spectators window(size_t first, size_t last) const {
+		Spectators spectators;
+		for (size_t i = first; i < last; ++i) {
+			spectators.insert(players[i]);
+		}
+		return spectators;
+	}
+
+	std::vector<std::shared_ptr<Creature>> players;
+};
+
+TEST_F(SpectatorsTest, JoinRemovesDuplicates) {
+	auto spectators = window(0, 20);
+	spectators.join(window(10, 30));
+
+	EXPECT_EQ(30, spectators.size());
+	for (size_t i = 0; i < 30; ++i) {
+		EXPECT_TRUE(spectators.contains(players[i]));
+	}
+	EXPECT_FALSE(spectators.contains(players[30]));
+}
+
+TEST_F(SpectatorsTest, JoinKeepsTheOrderTheyWereFoundIn) {
+	auto spectators = window(20, 30);
+	spectators.join(window(0, 25));
+
+	std::vector<std::shared_ptr<Creature>> expected(players.begin() + 20, players.begin() + 30);
+	expected.insert(expected.end(), players.begin(), players.begin() + 20);
+
+	size_t count = 0;
+	for (const auto &spectator : spectators) {
+		ASSERT_LT(count, expected.size());
+		EXPECT_EQ(expected[count++], spectator);
+	}
+	EXPECT_EQ(expected.size(), count);
+}
+
+TEST_F(SpectatorsTest, IteratesSharedCreatures) {
+	const auto spectators = window(0, 5);
+
+	size_t count = 0;
+	for (const auto &spectator : spectators) {
+		EXPECT_EQ(players[count++], spectator);
+	}
+	EXPECT_EQ(5, count);
+	EXPECT_TRUE(std::ranges::all_of(spectators, [](const auto &spectator) { return spectator->getPlayer() != nullptr; }));
+}
+
+TEST_F(SpectatorsTest, FilterAndErase) {
+	auto spectators = window(0, 10);
+
+	EXPECT_EQ(10, spectators.filter<Player>().size());
+	EXPECT_TRUE(spectators.filter<Monster>().empty());
+	EXPECT_TRUE(spectators.filter<Npc>().empty());
+
+	EXPECT_TRUE(spectators.erase(players[3]));
+	EXPECT_FALSE(spectators.erase(players[3]));
+	EXPECT_EQ(9, spectators.size());
+}
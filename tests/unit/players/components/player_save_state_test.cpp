@@ -0,0 +1,98 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "creatures/players/components/player_save_state.hpp"
+
+#include "lib/logging/in_memory_logger.hpp"
+
+class PlayerSaveStateTest : public ::testing::Test {
+protected:
+	static void SetUpTestSuite() {
+		InMemoryLogger::install(injector);
+		DI::setTestContainer(&injector);
+	}
+
+	const std::vector<std::string> items { "1,3,101,2854,1,''", "1,101,102,3031,100,''" };
+
+private:
+	inline static di::extension::injector<> injector {};
+};
+
+TEST_F(PlayerSaveStateTest, FirstSaveWritesEverySection) {
+	PlayerSaveState state;
+	state.begin();
+	EXPECT_TRUE(state.stage(PlayerSaveSection_t::Items, items));
+	EXPECT_TRUE(state.stage(PlayerSaveSection_t::Inbox, {}));
+	state.commit();
+
+	EXPECT_EQ(std::size_t { 0 }, state.getSkippedRows());
+	EXPECT_EQ(std::size_t { 0 }, state.getSkippedBytes());
+}
+
+TEST_F(PlayerSaveStateTest, UnchangedSectionsAreSkipped) {
+	PlayerSaveState state;
+	state.begin();
+	state.stage(PlayerSaveSection_t::Items, items);
+	state.stage(PlayerSaveSection_t::Inbox, {});
+	state.commit();
+
+	auto changed = items;
+	changed.back() = "1,101,102,3031,99,''";
+
+	state.begin();
+	EXPECT_FALSE(state.stage(PlayerSaveSection_t::Items, items));
+	EXPECT_TRUE(state.stage(PlayerSaveSection_t::Inbox, { "1,0,101,3031,1,''" }));
+	state.commit();
+
+	EXPECT_EQ(items.size(), state.getSkippedRows());
+	EXPECT_EQ(items[0].size() + items[1].size(), state.getSkippedBytes());
+
+	state.begin();
+	EXPECT_TRUE(state.stage(PlayerSaveSection_t::Items, changed));
+	EXPECT_FALSE(state.stage(PlayerSaveSection_t::Inbox, { "1,0,101,3031,1,''" }));
+	state.commit();
+	EXPECT_EQ(std::size_t { 1 }, state.getSkippedRows());
+}
+
+TEST_F(PlayerSaveStateTest, RowBoundariesAreHashed) {
+	const auto joined = PlayerSaveState::digest({ "1,2", "3" });
+	const auto split = PlayerSaveState::digest({ "1", ",23" });
+	EXPECT_EQ(joined.bytes, split.bytes);
+	EXPECT_NE(joined.hash, split.hash);
+	EXPECT_NE(PlayerSaveState::digest({}), PlayerSaveState::digest({ "" }));
+}
+
+TEST_F(PlayerSaveStateTest, FailedSaveIsWrittenAgain) {
+	PlayerSaveState state;
+	state.begin();
+	state.stage(PlayerSaveSection_t::Items, items);
+	state.stage(PlayerSaveSection_t::Stash, {});
+	state.commit();
+
+	// Items changed and the save failed: the database may hold anything for them now
+	auto changed = items;
+	changed.pop_back();
+	state.begin();
+	EXPECT_FALSE(state.stage(PlayerSaveSection_t::Stash, {}));
+	EXPECT_TRUE(state.stage(PlayerSaveSection_t::Items, changed));
+	state.discard();
+
+	state.begin();
+	EXPECT_FALSE(state.stage(PlayerSaveSection_t::Stash, {}));
+	EXPECT_TRUE(state.stage(PlayerSaveSection_t::Items, items));
+	EXPECT_TRUE(state.stage(PlayerSaveSection_t::Items, changed));
+	state.commit();
+
+	state.begin();
+	EXPECT_FALSE(state.stage(PlayerSaveSection_t::Items, changed));
+}
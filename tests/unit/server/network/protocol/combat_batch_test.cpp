@@ -0,0 +1,81 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "creatures/players/player.hpp"
+#include "server/network/message/outputmessage.hpp"
+#include "server/network/protocol/protocolgame.hpp"
+
+class CombatBatchTest : public ::testing::Test {
+protected:
+	void SetUp() override {
+		client = std::make_shared<ProtocolGame>(nullptr);
+		viewer = std::make_shared<Player>(client);
+		creature = std::make_shared<Player>();
+		creature->setGUID(1);
+		creature->setID();
+		bool known;
+		uint32_t removedKnown;
+		client->checkCreatureAsKnown(creature->getID(), known, removedKnown);
+	}
+
+	std::vector<uint8_t> written() const {
+		const auto &buffer = client->getCurrentBuffer();
+		if (!buffer) {
+			return {};
+		}
+		const auto* data = buffer->getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION;
+		return { data, data + buffer->getLength() };
+	}
+
+	std::vector<uint8_t> health() const {
+		const auto id = creature->getID();
+		const auto percent = static_cast<uint8_t>(std::min<double>(100, std::ceil((static_cast<double>(creature->getHealth()) / std::max<int32_t>(creature->getMaxHealth(), 1)) * 100)));
+		return { 0x8C, static_cast<uint8_t>(id), static_cast<uint8_t>(id >> 8), static_cast<uint8_t>(id >> 16), static_cast<uint8_t>(id >> 24), percent };
+	}
+
+	static std::vector<uint8_t> closePrivate(uint16_t channelId) {
+		return { 0xB3, static_cast<uint8_t>(channelId), static_cast<uint8_t>(channelId >> 8) };
+	}
+
+	std::shared_ptr<ProtocolGame> client;
+	// Sends through the client, as the game does
+	std::shared_ptr<Player> viewer;
+	std::shared_ptr<Player> creature;
+};
+
+TEST_F(CombatBatchTest, HealthUpdatesAreCoalesced) {
+	{
+		ProtocolGame::CombatBatch batch;
+		viewer->sendCreatureHealth(creature);
+		viewer->sendCreatureHealth(creature);
+		viewer->sendCreatureHealth(creature);
+		EXPECT_TRUE(written().empty());
+	}
+
+	EXPECT_EQ(health(), written());
+}
+
+TEST_F(CombatBatchTest, OtherPacketsWriteTheBatchFirst) {
+	{
+		ProtocolGame::CombatBatch batch;
+		viewer->sendCreatureHealth(creature);
+		viewer->sendCreatureHealth(creature);
+		viewer->sendClosePrivate(7);
+		viewer->sendCreatureHealth(creature);
+	}
+
+	auto expected = health();
+	std::ranges::copy(closePrivate(7), std::back_inserter(expected));
+	std::ranges::copy(health(), std::back_inserter(expected));
+	EXPECT_EQ(expected, written());
+}
+
+TEST_F(CombatBatchTest, WithoutBatchPacketsAreWrittenRightAway) {
+	viewer->sendCreatureHealth(creature);
+	viewer->sendClosePrivate(7);
+
+	auto expected = health();
+	std::ranges::copy(closePrivate(7), std::back_inserter(expected));
+	EXPECT_EQ(expected, written());
+}
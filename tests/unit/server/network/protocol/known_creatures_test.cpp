@@ -0,0 +1,74 @@
+#include "pch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "server/network/protocol/known_creatures.hpp"
+
+TEST(KnownCreaturesTest, CreaturesAreKnownUntilFull) {
+	KnownCreatures known;
+	const auto anyone = [](uint32_t) { return true; };
+
+	for (uint32_t id = 1; id <= KnownCreatures::CAPACITY; ++id) {
+		EXPECT_EQ(0u, known.insert(id, anyone));
+	}
+	EXPECT_EQ(KnownCreatures::CAPACITY, known.size());
+	EXPECT_TRUE(known.contains(1));
+	EXPECT_TRUE(known.touch(KnownCreatures::CAPACITY));
+	EXPECT_FALSE(known.touch(KnownCreatures::CAPACITY + 1));
+	EXPECT_FALSE(known.contains(KnownCreatures::CAPACITY + 1));
+}
+
+TEST(KnownCreaturesTest, LeastRecentlySeenIsForgotten) {
+	KnownCreatures known;
+	const auto anyone = [](uint32_t) { return true; };
+	for (uint32_t id = 1; id <= KnownCreatures::CAPACITY; ++id) {
+		known.insert(id, anyone);
+	}
+
+	// Seen again, so 2 is now the oldest
+	known.touch(1);
+	EXPECT_EQ(2u, known.insert(5000, anyone));
+	EXPECT_FALSE(known.contains(2));
+	EXPECT_TRUE(known.contains(5000));
+
+	// Those that can't be forgotten count as just seen
+	const auto notVisible = [](uint32_t id) { return id > 4; };
+	EXPECT_EQ(5u, known.insert(5001, notVisible));
+	EXPECT_EQ(6u, known.insert(5002, notVisible));
+	EXPECT_TRUE(known.contains(3));
+	EXPECT_TRUE(known.contains(4));
+	EXPECT_EQ(KnownCreatures::CAPACITY, known.size());
+}
+
+TEST(KnownCreaturesTest, OldestIsForgottenWhenNoneCanBe) {
+	KnownCreatures known;
+	const auto anyone = [](uint32_t) { return true; };
+	for (uint32_t id = 1; id <= KnownCreatures::CAPACITY; ++id) {
+		known.insert(id, anyone);
+	}
+
+	size_t checks = 0;
+	const auto nobody = [&checks](uint32_t) {
+		++checks;
+		return false;
+	};
+	EXPECT_EQ(KnownCreatures::EVICTION_CANDIDATES + 1, known.insert(5000, nobody));
+	EXPECT_EQ(KnownCreatures::CAPACITY, checks);
+	EXPECT_TRUE(known.contains(1));
+	EXPECT_TRUE(known.contains(5000));
+}
+
+TEST(KnownCreaturesTest, AllAreCheckedBeforeForgettingOneInView) {
+	KnownCreatures known;
+	const auto anyone = [](uint32_t) { return true; };
+	for (uint32_t id = 1; id <= KnownCreatures::CAPACITY; ++id) {
+		known.insert(id, anyone);
+	}
+
+	// Only the most recently seen is out of view
+	const auto onlyLast = [](uint32_t id) { return id == KnownCreatures::CAPACITY; };
+	EXPECT_EQ(KnownCreatures::CAPACITY, known.insert(5000, onlyLast));
+	EXPECT_TRUE(known.contains(1));
+	EXPECT_TRUE(known.contains(5000));
+	EXPECT_EQ(KnownCreatures::CAPACITY, known.size());
+}